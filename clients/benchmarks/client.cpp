@@ -460,6 +460,10 @@ try
          value<int32_t>(&arg.search_iters)->default_value(10),
          "Iterations to run inside timing loop of each algorithms when search is on. (default: 10)")
 
+        ("alg_candidates",
+         value<int32_t>(&arg.alg_candidates)->default_value(-1),
+         "Number of algorithms the search times, 0 times all applicable ones. (default: -1, the library default)")
+
         ("sparse_b",
          bool_switch(&arg.sparse_b)->default_value(false),
          "Structurted Sparsity Matrix B (A is Dense Matrix)")
@@ -0,0 +1,153 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+
+#include "program_options.hpp"
+
+/*! \file
+ *  \brief Host microbenchmark of the kernel launcher argument builders. It
+ *  builds the argument list of a sparse GEMM kernel with the named
+ *  KernelArguments (with and without logging) and with KernelArgumentsBinary,
+ *  and reports the average time per build.
+ */
+
+#include "kernel_arguments.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace
+{
+    constexpr std::array<char const*, 8> strideNames = {"strideD1",
+                                                        "strideD2",
+                                                        "strideC1",
+                                                        "strideC2",
+                                                        "strideA1",
+                                                        "strideA2",
+                                                        "strideB1",
+                                                        "strideB2"};
+    constexpr std::array<char const*, 4> sizeNames = {"size_0", "size_1", "size_2", "size_3"};
+
+    // Mirrors the argument list built by BuildKernelInvoke() in the kernel launcher for a
+    // kernel with a sparse A and no fused activation.
+    template <typename Args>
+    void build_arguments(Args& args, size_t seed)
+    {
+        args.template appendFields<uint64_t, uint64_t, uint64_t>(
+            {"tensor2dSizeC", "tensor2dSizeA", "tensor2dSizeB"}, seed, seed + 1, seed + 2);
+
+        args.template append<void const*>("d", reinterpret_cast<void const*>(seed));
+        args.template append<void const*>("c", reinterpret_cast<void const*>(seed));
+        args.template append<void const*>("a", reinterpret_cast<void const*>(seed));
+        args.template append<void const*>("b", reinterpret_cast<void const*>(seed));
+        args.template append<unsigned char const*>("metadata", nullptr);
+        args.template append<float>("alpha", 1.0f);
+        args.template append<float>("beta", 0.0f);
+
+        for(size_t i = 0; i < strideNames.size(); i++)
+            args.template append<uint32_t>(strideNames[i], static_cast<uint32_t>(seed * i));
+
+        for(size_t i = 0; i < sizeNames.size(); i++)
+            args.template append<uint32_t>(sizeNames[i], static_cast<uint32_t>(seed + i));
+
+        args.template appendFields<int32_t, uint32_t, uint32_t>(
+            {"staggerUIter", "problemNumGroupTiles0", "problemNumGroupTiles1"}, 3, 8, 8);
+        args.template appendFields<uint32_t, uint32_t, uint32_t>(
+            {"numFullBlocks", "wgmRemainder1", "magicNumberWgmRemainder1"}, 1, 8, 0x10000001);
+        args.template appendFields<uint32_t, uint32_t, uint32_t, uint32_t, uint32_t>(
+            {"offsetD", "offsetC", "offsetA", "offsetB", "pad"}, 0, 0, 0, 0, 0);
+    }
+
+    // Returns the average nanoseconds per call of build(i), and accumulates a checksum of the
+    // built bytes so that the work cannot be optimized away.
+    template <typename F>
+    double time_ns(size_t iters, size_t& checksum, F&& build)
+    {
+        auto start = std::chrono::steady_clock::now();
+        for(size_t i = 0; i < iters; i++)
+            checksum += build(i);
+        auto stop = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::nano>(stop - start).count() / iters;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    size_t iters = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 100000;
+    if(!iters)
+    {
+        std::fprintf(stderr, "usage: %s [iterations]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    size_t checksum = 0;
+
+    // Both builders must produce identical buffers
+    {
+        KernelArguments       named;
+        KernelArgumentsBinary binary;
+        build_arguments(named, 7);
+        build_arguments(binary, 7);
+        if(named.size() != binary.size()
+           || std::memcmp(named.data(), binary.data(), named.size()) != 0)
+        {
+            std::fprintf(stderr, "KernelArgumentsBinary does not match KernelArguments\n");
+            return EXIT_FAILURE;
+        }
+    }
+
+    double log_ns = time_ns(iters, checksum, [](size_t i) {
+        KernelArguments args;
+        args.reserve(1024, 128);
+        build_arguments(args, i);
+        return args.size();
+    });
+
+    double nolog_ns = time_ns(iters, checksum, [](size_t i) {
+        KernelArguments args(false);
+        args.reserve(1024, 128);
+        build_arguments(args, i);
+        return args.size();
+    });
+
+    double binary_ns = time_ns(iters, checksum, [](size_t i) {
+        KernelArgumentsBinary args;
+        build_arguments(args, i);
+        return args.size() + static_cast<uint8_t const*>(args.data())[i % args.size()];
+    });
+
+    std::printf("iterations,KernelArguments(ns),KernelArguments(log=false)(ns),"
+                "KernelArgumentsBinary(ns),speedup\n");
+    std::printf("%zu,%.1f,%.1f,%.1f,%.1fx\n",
+                iters,
+                log_ns,
+                nolog_ns,
+                binary_ns,
+                log_ns / binary_ns);
+
+    return checksum ? EXIT_SUCCESS : EXIT_FAILURE;
+}
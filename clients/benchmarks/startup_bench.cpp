@@ -0,0 +1,252 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+
+/*! \file
+ *  \brief Time to the first matmul of a fresh process. It runs itself as a
+ *  child process a number of times, each child running one half precision
+ *  matmul from a new handle, and reports the minimum, median and maximum over
+ *  the children of the wall time of the child, of its time to the first
+ *  matmul and of the startup phases hipsparseLtGetStartupTiming reports.
+ */
+
+#include <hip/hip_runtime.h>
+#include <hipsparselt/hipsparselt.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#define CHECK_HIP(call)                                                                  \
+    do                                                                                   \
+    {                                                                                    \
+        hipError_t err = call;                                                           \
+        if(err != hipSuccess)                                                            \
+        {                                                                                \
+            std::fprintf(stderr, "%s failed: %s\n", #call, hipGetErrorString(err));      \
+            return EXIT_FAILURE;                                                         \
+        }                                                                                \
+    } while(0)
+
+#define CHECK_HIPSPARSELT(call)                                                          \
+    do                                                                                   \
+    {                                                                                    \
+        hipsparseStatus_t status = call;                                                 \
+        if(status != HIPSPARSE_STATUS_SUCCESS)                                           \
+        {                                                                                \
+            std::fprintf(stderr, "%s failed: %d\n", #call, status);                      \
+            return EXIT_FAILURE;                                                         \
+        }                                                                                \
+    } while(0)
+
+namespace
+{
+    constexpr const char* child_flag = "--child";
+
+    constexpr int phase_count = HIPSPARSELT_STARTUP_FIRST_LAUNCH + 1;
+
+    constexpr const char* phase_names[phase_count] = {"path_discovery",
+                                                      "code_object_glob",
+                                                      "code_object_load",
+                                                      "library_load",
+                                                      "device_properties",
+                                                      "first_solution_query",
+                                                      "first_launch"};
+
+    double elapsed_ms(std::chrono::steady_clock::time_point start)
+    {
+        using ms = std::chrono::duration<double, std::milli>;
+        return ms(std::chrono::steady_clock::now() - start).count();
+    }
+
+    // Runs the first matmul of the process and prints its time to it, then the
+    // total time of each startup phase, on one line.
+    int run_child(int64_t m, int64_t n, int64_t k)
+    {
+        auto start = std::chrono::steady_clock::now();
+
+        hipsparseLtHandle_t             handle;
+        hipsparseLtMatDescriptor_t      matA, matB, matC, matD;
+        hipsparseLtMatmulDescriptor_t   matmul;
+        hipsparseLtMatmulAlgSelection_t alg_sel;
+        hipsparseLtMatmulPlan_t         plan;
+
+        CHECK_HIPSPARSELT(hipsparseLtInit(&handle));
+        CHECK_HIPSPARSELT(hipsparseLtStructuredDescriptorInit(&handle,
+                                                              &matA,
+                                                              m,
+                                                              k,
+                                                              m,
+                                                              16,
+                                                              HIP_R_16F,
+                                                              HIPSPARSE_ORDER_COL,
+                                                              HIPSPARSELT_SPARSITY_50_PERCENT));
+        CHECK_HIPSPARSELT(hipsparseLtDenseDescriptorInit(
+            &handle, &matB, k, n, k, 16, HIP_R_16F, HIPSPARSE_ORDER_COL));
+        CHECK_HIPSPARSELT(hipsparseLtDenseDescriptorInit(
+            &handle, &matC, m, n, m, 16, HIP_R_16F, HIPSPARSE_ORDER_COL));
+        CHECK_HIPSPARSELT(hipsparseLtDenseDescriptorInit(
+            &handle, &matD, m, n, m, 16, HIP_R_16F, HIPSPARSE_ORDER_COL));
+        CHECK_HIPSPARSELT(hipsparseLtMatmulDescriptorInit(&handle,
+                                                          &matmul,
+                                                          HIPSPARSE_OPERATION_NON_TRANSPOSE,
+                                                          HIPSPARSE_OPERATION_NON_TRANSPOSE,
+                                                          &matA,
+                                                          &matB,
+                                                          &matC,
+                                                          &matD,
+                                                          HIPSPARSELT_COMPUTE_32F));
+        CHECK_HIPSPARSELT(hipsparseLtMatmulAlgSelectionInit(
+            &handle, &alg_sel, &matmul, HIPSPARSELT_MATMUL_ALG_DEFAULT));
+        CHECK_HIPSPARSELT(hipsparseLtMatmulPlanInit(&handle, &plan, &matmul, &alg_sel));
+
+        size_t workspace_size, compressed_size, compress_buffer_size;
+        CHECK_HIPSPARSELT(hipsparseLtMatmulGetWorkspace(&handle, &plan, &workspace_size));
+        CHECK_HIPSPARSELT(hipsparseLtSpMMACompressedSize(
+            &handle, &plan, &compressed_size, &compress_buffer_size));
+
+        // The values do not matter, only the time to the first matmul
+        void *d_compressed, *db, *dc, *dd, *d_workspace = nullptr;
+        CHECK_HIP(hipMalloc(&d_compressed, compressed_size));
+        CHECK_HIP(hipMalloc(&db, k * n * sizeof(uint16_t)));
+        CHECK_HIP(hipMalloc(&dc, m * n * sizeof(uint16_t)));
+        CHECK_HIP(hipMalloc(&dd, m * n * sizeof(uint16_t)));
+        if(workspace_size > 0)
+            CHECK_HIP(hipMalloc(&d_workspace, workspace_size));
+        CHECK_HIP(hipMemset(d_compressed, 0, compressed_size));
+        CHECK_HIP(hipMemset(db, 0, k * n * sizeof(uint16_t)));
+        CHECK_HIP(hipMemset(dc, 0, m * n * sizeof(uint16_t)));
+
+        float       alpha = 1.0f, beta = 0.0f;
+        hipStream_t stream = nullptr;
+        CHECK_HIPSPARSELT(hipsparseLtMatmul(
+            &handle, &plan, &alpha, d_compressed, db, &beta, dc, dd, d_workspace, &stream, 1));
+        CHECK_HIP(hipStreamSynchronize(stream));
+        double first_matmul_ms = elapsed_ms(start);
+
+        std::printf("%f", first_matmul_ms);
+        for(int phase = 0; phase < phase_count; phase++)
+        {
+            hipsparseLtStartupTiming_t timing;
+            CHECK_HIPSPARSELT(
+                hipsparseLtGetStartupTiming(hipsparseLtStartupPhase_t(phase), &timing));
+            std::printf(" %f", timing.total_ms);
+        }
+        std::printf("\n");
+
+        (void)hipFree(d_workspace);
+        (void)hipFree(dd);
+        (void)hipFree(dc);
+        (void)hipFree(db);
+        (void)hipFree(d_compressed);
+        (void)hipsparseLtMatmulPlanDestroy(&plan);
+        (void)hipsparseLtMatDescriptorDestroy(&matD);
+        (void)hipsparseLtMatDescriptorDestroy(&matC);
+        (void)hipsparseLtMatDescriptorDestroy(&matB);
+        (void)hipsparseLtMatDescriptorDestroy(&matA);
+        (void)hipsparseLtDestroy(&handle);
+        return EXIT_SUCCESS;
+    }
+
+    void print_stats(const char* name, std::vector<double> values)
+    {
+        std::sort(values.begin(), values.end());
+        std::printf("%-22s %12.3f %12.3f %12.3f\n",
+                    name,
+                    values.front(),
+                    values[values.size() / 2],
+                    values.back());
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    if(argc > 1 && std::strcmp(argv[1], child_flag) == 0)
+    {
+        if(argc != 5)
+            return EXIT_FAILURE;
+        return run_child(std::atoll(argv[2]), std::atoll(argv[3]), std::atoll(argv[4]));
+    }
+
+    int     runs = argc > 1 ? std::atoi(argv[1]) : 10;
+    int64_t m    = argc > 2 ? std::atoll(argv[2]) : 1024;
+    int64_t n    = argc > 3 ? std::atoll(argv[3]) : 1024;
+    int64_t k    = argc > 4 ? std::atoll(argv[4]) : 1024;
+    if(runs <= 0 || m <= 0 || n <= 0 || k <= 0)
+    {
+        std::fprintf(stderr, "usage: %s [runs] [m] [n] [k]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    // Each run is a fresh process, so that nothing is loaded or cached yet.
+    std::string command = std::string("\"") + argv[0] + "\" " + child_flag + " "
+                          + std::to_string(m) + " " + std::to_string(n) + " "
+                          + std::to_string(k);
+
+    std::vector<double>              process_ms, first_matmul_ms;
+    std::vector<std::vector<double>> phase_ms(phase_count);
+    for(int run = 0; run < runs; run++)
+    {
+        auto  start = std::chrono::steady_clock::now();
+        FILE* child = popen(command.c_str(), "r");
+        if(!child)
+        {
+            std::perror("popen");
+            return EXIT_FAILURE;
+        }
+
+        double values[1 + phase_count];
+        int    read = 0;
+        while(read < 1 + phase_count && std::fscanf(child, "%lf", &values[read]) == 1)
+            read++;
+        int status = pclose(child);
+        if(status != 0 || read != 1 + phase_count)
+        {
+            std::fprintf(stderr, "run %d failed with status %d\n", run, status);
+            return EXIT_FAILURE;
+        }
+
+        process_ms.push_back(elapsed_ms(start));
+        first_matmul_ms.push_back(values[0]);
+        for(int phase = 0; phase < phase_count; phase++)
+            phase_ms[phase].push_back(values[1 + phase]);
+    }
+
+    std::printf("time to first matmul of %d processes, M=%lld N=%lld K=%lld, in ms\n",
+                runs,
+                (long long)m,
+                (long long)n,
+                (long long)k);
+    std::printf("%-22s %12s %12s %12s\n", "", "min", "median", "max");
+    print_stats("process", process_ms);
+    print_stats("first_matmul", first_matmul_ms);
+    for(int phase = 0; phase < phase_count; phase++)
+        print_stats(phase_names[phase], phase_ms[phase]);
+    return EXIT_SUCCESS;
+}
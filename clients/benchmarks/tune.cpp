@@ -0,0 +1,256 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+
+// hipsparselt-tune searches the algorithm of every problem it is given and
+// leaves the results in a tuning file. HIPSPARSELT_TUNING_DB makes the library
+// select them in hipsparseLtMatmulAlgSelectionInit(), so the search is run once
+// per GPU model instead of on every node.
+
+#include "program_options.hpp"
+
+#include "hipsparselt_data.hpp"
+#include "hipsparselt_parse_data.hpp"
+#include "hipsparselt_tune.hpp"
+#include "type_dispatch.hpp"
+#include "utility.hpp"
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <hipsparselt/hipsparselt.h>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+#include "testing_spmm.hpp"
+#undef I
+
+using namespace roc; // For emulated program_options
+
+// The types hipsparselt-bench runs spmm with
+template <typename Ti, typename To = Ti, typename Tc = To, typename TBias = Ti, typename = void>
+struct tune_sparse : hipsparselt_test_invalid
+{
+};
+
+template <typename Ti, typename To, typename Tc, typename TBias>
+struct tune_sparse<
+    Ti,
+    To,
+    Tc,
+    TBias,
+    std::enable_if_t<
+        (std::is_same<Ti, To>{} && (std::is_same<Ti, __half>{} || std::is_same<Ti, hip_bfloat16>{})
+         && std::is_same<Tc, float>{})
+        || (std::is_same<Ti, To>{} && (std::is_same<Ti, int8_t>{}) && std::is_same<Tc, int32_t>{})
+        || (std::is_same<Ti, int8_t>{} && (std::is_same<To, __half>{})
+            && std::is_same<Tc, int32_t>{})
+        || (std::is_same<Ti, int8_t>{} && (std::is_same<To, hip_bfloat16>{})
+            && std::is_same<Tc, int32_t>{})>> : hipsparselt_test_valid
+{
+    void operator()(const Arguments& arg)
+    {
+        if(!strcmp(arg.function, "spmm"))
+            testing_spmm<Ti, To, Tc, TBias>(arg);
+        else
+            testing_spmm<Ti, To, Tc, TBias, hipsparselt_batch_type::strided_batched>(arg);
+    }
+};
+
+template <typename... T>
+struct tune_filter
+{
+    bool operator()(const Arguments&)
+    {
+        return static_cast<bool>(tune_sparse<T...>{});
+    }
+};
+
+static void tune_read(std::vector<Arguments>& problems,
+                      const std::string&      path,
+                      std::vector<Arguments> (*parse)(std::istream&, const std::string&),
+                      const std::string& precision)
+{
+    std::ifstream is(path);
+    if(!is)
+        throw std::invalid_argument("Cannot open " + path);
+    auto read = parse(is, precision);
+    problems.insert(problems.end(), read.begin(), read.end());
+}
+
+int main(int argc, char* argv[])
+try
+{
+    std::string csv;
+    std::string log;
+    std::string output;
+    std::string precision;
+    int32_t     search_iters;
+    int32_t     alg_candidates;
+    int32_t     iters;
+    int32_t     cold_iters;
+    int         device_id;
+    bool        dry_run  = false;
+    bool        datafile = hipsparselt_parse_data(argc, argv);
+
+    options_description desc("hipsparselt-tune command line options");
+    desc.add_options()
+        // clang-format off
+        ("csv",
+         value<std::string>(&csv),
+         "CSV file with the problems, e.g. the output of hipsparselt-bench. "
+         "Problems are also read from --yaml and --data like in hipsparselt-bench.")
+
+        ("log",
+         value<std::string>(&log),
+         "Log with the hipsparselt-bench command lines of the problems, e.g. of HIPSPARSELT_LOG_BENCH")
+
+        ("output,o",
+         value<std::string>(&output)->default_value("hipsparselt_tuning.db"),
+         "Tuning file to add the results to. Set HIPSPARSELT_TUNING_DB to it to use them.")
+
+        ("precision,r",
+         value<std::string>(&precision)->default_value("f16_r"),
+         "Precision of the problems which do not give one. "
+         "Options: h,s,f16_r,f32_r,bf16_r,i8_r")
+
+        ("search_iters",
+         value<int32_t>(&search_iters)->default_value(10),
+         "Iterations to time each algorithm with. (default: 10)")
+
+        ("alg_candidates",
+         value<int32_t>(&alg_candidates)->default_value(0),
+         "Number of algorithms to time for each problem. (default: 0, all applicable ones)")
+
+        ("iters,i",
+         value<int32_t>(&iters)->default_value(10),
+         "Iterations to time the selected algorithm with. (default: 10)")
+
+        ("cold_iters,j",
+         value<int32_t>(&cold_iters)->default_value(2),
+         "Cold iterations before the selected algorithm is timed. (default: 2)")
+
+        ("device",
+         value<int>(&device_id)->default_value(0),
+         "Set default device to be used for subsequent program runs")
+
+        ("dry_run",
+         bool_switch(&dry_run)->default_value(false),
+         "Only prints the problems which would be tuned")
+
+        ("help,h", "produces this help message");
+    // clang-format on
+
+    variables_map vm;
+    store(parse_command_line(argc, argv, desc), vm);
+    notify(vm);
+
+    if((argc <= 1 && !datafile) || vm.count("help"))
+    {
+        hipsparselt_cout << desc << std::endl;
+        return 0;
+    }
+
+    std::vector<Arguments> problems;
+    if(datafile)
+    {
+        for(Arguments arg : HipSparseLt_TestData())
+            if(!strcmp(arg.function, "spmm") || !strcmp(arg.function, "spmm_batched")
+               || !strcmp(arg.function, "spmm_strided_batched"))
+                problems.push_back(arg);
+        test_cleanup::cleanup();
+    }
+    if(!csv.empty())
+        tune_read(problems, csv, hipsparselt_tune_parse_csv, precision);
+    if(!log.empty())
+        tune_read(problems, log, hipsparselt_tune_parse_log, precision);
+
+    auto unique = hipsparselt_tune_unique(problems);
+    hipsparselt_cout << "hipsparselt-tune: " << unique.size() << " problems, "
+                     << problems.size() - unique.size() << " repeated ones dropped" << std::endl;
+
+    if(dry_run)
+    {
+        for(auto& arg : unique)
+            hipsparselt_cout << arg;
+        return 0;
+    }
+
+#ifdef __HIP_PLATFORM_AMD__
+    // The library adds the result of each search to the tuning file, it must
+    // be named before the first handle is initialized.
+#ifdef WIN32
+    _putenv_s("HIPSPARSELT_TUNING_DB", output.c_str());
+#else
+    setenv("HIPSPARSELT_TUNING_DB", output.c_str(), 1);
+#endif
+#else
+    throw std::invalid_argument("hipsparselt-tune is not supported by the NVIDIA backend");
+#endif
+
+    int64_t device_count = query_device_property();
+    hipsparselt_cout << std::endl;
+    if(device_count <= device_id)
+        throw std::invalid_argument("Invalid Device ID");
+    set_device(device_id);
+
+    hipsparseLtInitialize();
+    hipsparselt_cout << std::setiosflags(std::ios::fixed) << std::setprecision(7);
+
+    int skipped = 0;
+    for(auto& arg : unique)
+    {
+        arg.search         = true;
+        arg.search_iters   = search_iters;
+        arg.alg_candidates = alg_candidates;
+        arg.iters          = iters;
+        arg.cold_iters     = cold_iters;
+        arg.unit_check     = 0;
+        arg.norm_check     = 0;
+        arg.timing         = 1;
+        arg.streams        = 0;
+        arg.threads        = 0;
+
+        if(!hipsparselt_spmm_dispatch<tune_filter>(arg))
+        {
+            hipsparselt_cerr << "hipsparselt-tune: skipping a problem with unsupported types: "
+                             << arg;
+            skipped++;
+            continue;
+        }
+        hipsparselt_spmm_dispatch<tune_sparse>(arg);
+    }
+    test_cleanup::cleanup();
+
+    hipsparselt_cout << "hipsparselt-tune: " << unique.size() - skipped << " problems tuned into "
+                     << output << std::endl;
+    return skipped ? -1 : 0;
+}
+catch(const std::invalid_argument& exp)
+{
+    hipsparselt_cerr << exp.what() << std::endl;
+    return -1;
+}
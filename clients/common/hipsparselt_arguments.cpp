@@ -103,6 +103,7 @@ void Arguments::init()
     HMM             = false;
     search          = false;
     search_iters    = 10;
+    alg_candidates  = -1;
 }
 
 // Function to print Arguments out to stream in YAML format
@@ -0,0 +1,431 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include "hipsparselt_tune.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_set>
+
+namespace
+{
+    // hipsparselt-bench options named differently than the Arguments members
+    const std::map<std::string, std::string> tune_aliases = {{"m", "M"},
+                                                             {"sizem", "M"},
+                                                             {"n", "N"},
+                                                             {"sizen", "N"},
+                                                             {"k", "K"},
+                                                             {"sizek", "K"},
+                                                             {"r", "precision"},
+                                                             {"f", "function"},
+                                                             {"transposeA", "transA"},
+                                                             {"transposeB", "transB"},
+                                                             {"batch", "batch_count"},
+                                                             {"order_a", "orderA"},
+                                                             {"order_b", "orderB"},
+                                                             {"order_c", "orderC"},
+                                                             {"order_d", "orderD"}};
+
+    // hipsparselt-bench options which do not take a value
+    const char* const tune_switches[] = {"bias_vector",
+                                         "sparse_b",
+                                         "alpha_vector_scaling",
+                                         "search",
+                                         "c_noalias_d",
+                                         "log_function_name",
+                                         "help",
+                                         "h",
+                                         "version"};
+
+    const std::map<std::string, int64_t Arguments::*> tune_int64_fields
+        = {{"M", &Arguments::M},
+           {"N", &Arguments::N},
+           {"K", &Arguments::K},
+           {"lda", &Arguments::lda},
+           {"ldb", &Arguments::ldb},
+           {"ldc", &Arguments::ldc},
+           {"ldd", &Arguments::ldd},
+           {"stride_a", &Arguments::stride_a},
+           {"stride_b", &Arguments::stride_b},
+           {"stride_c", &Arguments::stride_c},
+           {"stride_d", &Arguments::stride_d},
+           {"bias_stride", &Arguments::bias_stride}};
+
+    const std::map<std::string, hipDataType Arguments::*> tune_type_fields
+        = {{"a_type", &Arguments::a_type},
+           {"b_type", &Arguments::b_type},
+           {"c_type", &Arguments::c_type},
+           {"d_type", &Arguments::d_type}};
+
+    const std::map<std::string, bool Arguments::*> tune_bool_fields
+        = {{"bias_vector", &Arguments::bias_vector},
+           {"sparse_b", &Arguments::sparse_b},
+           {"alpha_vector_scaling", &Arguments::alpha_vector_scaling}};
+
+    const std::map<std::string, char Arguments::*> tune_order_fields
+        = {{"orderA", &Arguments::orderA},
+           {"orderB", &Arguments::orderB},
+           {"orderC", &Arguments::orderC},
+           {"orderD", &Arguments::orderD}};
+
+    std::string tune_trim(const std::string& str)
+    {
+        size_t begin = 0, end = str.size();
+        while(begin < end && std::isspace(static_cast<unsigned char>(str[begin])))
+            begin++;
+        while(end > begin && std::isspace(static_cast<unsigned char>(str[end - 1])))
+            end--;
+        if(end - begin >= 2 && (str[begin] == '\'' || str[begin] == '"')
+           && str[end - 1] == str[begin])
+        {
+            begin++;
+            end--;
+        }
+        return str.substr(begin, end - begin);
+    }
+
+    std::vector<std::string> tune_split(const std::string& line, char delim)
+    {
+        std::vector<std::string> columns;
+        std::istringstream       is(line);
+        std::string              column;
+        while(std::getline(is, column, delim))
+            columns.push_back(tune_trim(column));
+        if(!line.empty() && line.back() == delim)
+            columns.push_back("");
+        return columns;
+    }
+
+    std::string tune_name(const std::string& name)
+    {
+        auto alias = tune_aliases.find(name);
+        return alias == tune_aliases.end() ? name : alias->second;
+    }
+
+    std::invalid_argument tune_invalid(const std::string& name, const std::string& value)
+    {
+        return std::invalid_argument("Invalid value for " + name + " " + value);
+    }
+
+    int64_t tune_int(const std::string& name, const std::string& value)
+    {
+        size_t  pos = 0;
+        int64_t result;
+        try
+        {
+            result = std::stoll(value, &pos);
+        }
+        catch(const std::exception&)
+        {
+            throw tune_invalid(name, value);
+        }
+        if(pos != value.size())
+            throw tune_invalid(name, value);
+        return result;
+    }
+
+    bool tune_bool(const std::string& name, const std::string& value)
+    {
+        if(value == "1" || value == "true" || value == "True")
+            return true;
+        if(value == "0" || value == "false" || value == "False")
+            return false;
+        throw tune_invalid(name, value);
+    }
+
+    char tune_char(const std::string& name, const std::string& value, const char* allowed)
+    {
+        char c = value.size() == 1 ? std::toupper(static_cast<unsigned char>(value[0])) : 0;
+        if(c == 0 || !strchr(allowed, c))
+            throw tune_invalid(name, value);
+        return c;
+    }
+
+    hipDataType tune_type(const std::string& name, const std::string& value)
+    {
+        auto type = string_to_hip_datatype(value);
+        if(type == static_cast<hipDataType>(-1))
+            throw tune_invalid(name, value);
+        return type;
+    }
+}
+
+bool hipsparselt_tune_shape(Arguments&                     arg,
+                            const hipsparselt_tune_fields& fields,
+                            const std::string&             precision)
+{
+    arg.init();
+
+    // The hipsparselt-bench defaults which are not the ones of Arguments::init()
+    arg.stride_a             = -1;
+    arg.stride_b             = -1;
+    arg.stride_c             = -1;
+    arg.stride_d             = -1;
+    arg.transA               = 'N';
+    arg.transB               = 'N';
+    arg.bias_vector          = false;
+    arg.bias_stride          = 0;
+    arg.sparse_b             = false;
+    arg.func_version         = 1;
+    arg.alpha_vector_scaling = false;
+
+    std::string prec = precision, compute_type, bias_type;
+    char        order = 'C';
+    for(auto& field : fields)
+    {
+        auto name = tune_name(field.first);
+        if(name == "function" && field.second.find("spmm") == std::string::npos)
+            return false;
+        else if(name == "precision")
+            prec = field.second;
+        else if(name == "order")
+            order = tune_char(name, field.second, "CR");
+    }
+
+    arg.a_type = arg.b_type = arg.c_type = arg.d_type = tune_type("precision", prec);
+    arg.orderA = arg.orderB = arg.orderC = arg.orderD = order;
+
+    for(auto& field : fields)
+    {
+        auto        name  = tune_name(field.first);
+        const auto& value = field.second;
+        if(tune_int64_fields.count(name))
+            arg.*tune_int64_fields.at(name) = tune_int(name, value);
+        else if(tune_type_fields.count(name))
+            arg.*tune_type_fields.at(name) = tune_type(name, value);
+        else if(tune_bool_fields.count(name))
+            arg.*tune_bool_fields.at(name) = tune_bool(name, value);
+        else if(tune_order_fields.count(name))
+        {
+            // 'N' is the default of hipsparselt-bench, it stands for --order
+            if(value != "N")
+                arg.*tune_order_fields.at(name) = tune_char(name, value, "CR");
+        }
+        else if(name == "batch_count")
+            arg.batch_count = int32_t(tune_int(name, value));
+        else if(name == "transA")
+            arg.transA = tune_char(name, value, "NT");
+        else if(name == "transB")
+            arg.transB = tune_char(name, value, "NT");
+        else if(name == "compute_type")
+            compute_type = value;
+        else if(name == "bias_type")
+            bias_type = value;
+        else if(name == "activation_type")
+        {
+            arg.activation_type = string_to_hipsparselt_activation_type(value);
+            if(arg.activation_type == static_cast<hipsparselt_activation_type>(-1))
+                throw tune_invalid(name, value);
+        }
+    }
+
+    bool is_f16 = arg.a_type == HIP_R_16F || arg.a_type == HIP_R_16BF;
+    if(compute_type.empty())
+    {
+#ifdef __HIP_PLATFORM_AMD__
+        arg.compute_type = is_f16 ? HIPSPARSELT_COMPUTE_32F : HIPSPARSELT_COMPUTE_32I;
+#else
+        arg.compute_type = is_f16                     ? HIPSPARSELT_COMPUTE_16F
+                           : arg.a_type == HIP_R_32F ? HIPSPARSELT_COMPUTE_TF32
+                                                     : HIPSPARSELT_COMPUTE_32I;
+#endif
+    }
+    else
+    {
+        arg.compute_type = string_to_hipsparselt_computetype(compute_type);
+        if(arg.compute_type == static_cast<hipsparseLtComputetype_t>(-1))
+            throw tune_invalid("compute_type", compute_type);
+    }
+
+    if(bias_type.empty())
+        arg.bias_type = is_f16 ? arg.a_type : HIP_R_32F;
+    else
+    {
+        arg.bias_type = tune_type("bias_type", bias_type);
+        if(arg.bias_type != arg.a_type && arg.bias_type != HIP_R_32F)
+            throw tune_invalid("bias_type", bias_type);
+    }
+
+    if(arg.M < 0)
+        throw tune_invalid("M", std::to_string(arg.M));
+    if(arg.N < 0)
+        throw tune_invalid("N", std::to_string(arg.N));
+    if(arg.K < 0)
+        throw tune_invalid("K", std::to_string(arg.K));
+    if(arg.batch_count < 1)
+        throw tune_invalid("batch_count", std::to_string(arg.batch_count));
+
+    hipsparselt_tune_normalize(arg);
+    return true;
+}
+
+std::vector<Arguments> hipsparselt_tune_parse_csv(std::istream& is, const std::string& precision)
+{
+    std::vector<Arguments>   problems;
+    std::vector<std::string> header;
+    std::string              line;
+    while(std::getline(is, line))
+    {
+        auto columns = tune_split(line, ',');
+        auto has     = [&](const char* name) {
+            return std::find(columns.begin(), columns.end(), name) != columns.end();
+        };
+        if(has("M") && has("N") && has("K"))
+        {
+            header = columns;
+            continue;
+        }
+        if(header.empty() || columns.size() != header.size())
+            continue;
+
+        hipsparselt_tune_fields fields;
+        for(size_t i = 0; i < columns.size(); i++)
+            fields.emplace_back(header[i], columns[i]);
+
+        Arguments arg;
+        if(hipsparselt_tune_shape(arg, fields, precision))
+            problems.push_back(arg);
+    }
+    return problems;
+}
+
+std::vector<Arguments> hipsparselt_tune_parse_log(std::istream& is, const std::string& precision)
+{
+    static constexpr char bench[] = "hipsparselt-bench";
+
+    std::vector<Arguments> problems;
+    std::string            line;
+    while(std::getline(is, line))
+    {
+        auto pos = line.find(bench);
+        if(pos == std::string::npos)
+            continue;
+
+        std::istringstream       tokens(line.substr(pos + sizeof(bench) - 1));
+        std::vector<std::string> words;
+        for(std::string word; tokens >> word;)
+            words.push_back(word);
+
+        // Options start with '-' and a letter, a value like -1 does not.
+        auto is_option = [](const std::string& word) {
+            return word.size() > 1 && word[0] == '-'
+                   && (word[1] == '-' || std::isalpha(static_cast<unsigned char>(word[1])));
+        };
+        // Skips the messages hipsparselt-bench prints, e.g. "hipsparselt-bench INFO: ..."
+        if(words.empty() || !is_option(words[0]))
+            continue;
+
+        hipsparselt_tune_fields fields;
+        for(size_t i = 0; i < words.size(); i++)
+        {
+            if(!is_option(words[i]))
+                continue;
+            std::string name = words[i].substr(words[i][1] == '-' ? 2 : 1);
+            auto        eq   = name.find('=');
+            if(eq != std::string::npos)
+                fields.emplace_back(name.substr(0, eq), tune_trim(name.substr(eq + 1)));
+            else if(std::find(std::begin(tune_switches), std::end(tune_switches), name)
+                    != std::end(tune_switches))
+                fields.emplace_back(name, "1");
+            else if(i + 1 < words.size())
+                fields.emplace_back(name, tune_trim(words[++i]));
+        }
+
+        Arguments arg;
+        if(hipsparselt_tune_shape(arg, fields, precision))
+            problems.push_back(arg);
+    }
+    return problems;
+}
+
+void hipsparselt_tune_normalize(Arguments& arg)
+{
+    // The same adjustments as hipsparselt-bench, without --any_stride
+    int64_t min_lda = arg.transA == 'N' ? (arg.orderA == 'C' ? arg.M : arg.K)
+                                        : (arg.orderA == 'C' ? arg.K : arg.M);
+    int64_t min_ldb = arg.transB == 'N' ? (arg.orderB == 'C' ? arg.K : arg.N)
+                                        : (arg.orderB == 'C' ? arg.N : arg.K);
+    int64_t min_ldc = arg.orderC == 'C' ? arg.M : arg.N;
+    int64_t min_ldd = arg.orderD == 'C' ? arg.M : arg.N;
+    arg.lda         = std::max(arg.lda, min_lda);
+    arg.ldb         = std::max(arg.ldb, min_ldb);
+    arg.ldc         = std::max(arg.ldc, min_ldc);
+    arg.ldd         = std::max(arg.ldd, min_ldd);
+
+    int64_t min_stride_a = arg.lda
+                           * (arg.transA == 'N' ? (arg.orderA == 'C' ? arg.K : arg.M)
+                                                : (arg.orderA == 'C' ? arg.M : arg.K));
+    int64_t min_stride_b = arg.ldb
+                           * (arg.transB == 'N' ? (arg.orderB == 'C' ? arg.N : arg.K)
+                                                : (arg.orderB == 'C' ? arg.K : arg.N));
+    int64_t min_stride_c = arg.ldc * (arg.orderC == 'C' ? arg.N : arg.M);
+    int64_t min_stride_d = arg.ldd * (arg.orderD == 'C' ? arg.N : arg.M);
+
+    // A stride of 0 broadcasts A or B to all batches
+    if(arg.stride_a == -1 || (arg.stride_a < min_stride_a && arg.stride_a != 0))
+        arg.stride_a = min_stride_a;
+    if(arg.stride_b == -1 || (arg.stride_b < min_stride_b && arg.stride_b != 0))
+        arg.stride_b = min_stride_b;
+    arg.stride_c = std::max(arg.stride_c, min_stride_c);
+    arg.stride_d = std::max(arg.stride_d, min_stride_d);
+    if(arg.bias_stride == -1 || (arg.bias_stride < arg.M && arg.bias_stride != 0))
+        arg.bias_stride = arg.M;
+
+    strcpy(arg.function, arg.batch_count > 1 ? "spmm_strided_batched" : "spmm");
+}
+
+std::string hipsparselt_tune_key(const Arguments& arg)
+{
+    std::ostringstream key;
+    key << arg.transA << arg.transB << arg.orderA << arg.orderB << arg.orderC << arg.orderD << ','
+        << arg.M << ',' << arg.N << ',' << arg.K << ',' << arg.lda << ',' << arg.ldb << ','
+        << arg.ldc << ',' << arg.ldd << ',' << arg.batch_count << ',' << arg.a_type << ','
+        << arg.b_type << ',' << arg.c_type << ',' << arg.d_type << ',' << arg.compute_type << ','
+        << arg.sparse_b << ',' << int(arg.activation_type) << ',' << arg.alpha_vector_scaling
+        << ',' << arg.bias_vector;
+    // The strides of a single batch and the type of a missing bias are not used.
+    if(arg.batch_count > 1)
+        key << ',' << arg.stride_a << ',' << arg.stride_b << ',' << arg.stride_c << ','
+            << arg.stride_d;
+    if(arg.bias_vector)
+        key << ',' << arg.bias_type;
+    return key.str();
+}
+
+std::vector<Arguments> hipsparselt_tune_unique(const std::vector<Arguments>& problems)
+{
+    std::vector<Arguments>          unique;
+    std::unordered_set<std::string> keys;
+    for(auto arg : problems)
+    {
+        hipsparselt_tune_normalize(arg);
+        if(keys.insert(hipsparselt_tune_key(arg)).second)
+            unique.push_back(arg);
+    }
+    return unique;
+}
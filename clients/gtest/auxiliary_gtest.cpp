@@ -106,6 +106,10 @@ namespace
                 testing_aux_matmul_alg_assign(arg);
             else if(!strcmp(arg.function, "aux_matmul_alg_set_attr_bad_arg"))
                 testing_aux_matmul_alg_set_attr_bad_arg(arg);
+            else if(!strcmp(arg.function, "aux_matmul_alg_candidates"))
+                testing_aux_matmul_alg_candidates(arg);
+            else if(!strcmp(arg.function, "aux_matmul_alg_split_k"))
+                testing_aux_matmul_alg_split_k(arg);
             else if(!strcmp(arg.function, "aux_matmul_alg_get_attr_bad_arg"))
                 testing_aux_matmul_alg_get_attr_bad_arg(arg);
             else if(!strcmp(arg.function, "aux_matmul_plan_init_bad_arg"))
@@ -155,6 +159,8 @@ namespace
                    || !strcmp(arg.function, "aux_matmul_alg_init")
                    || !strcmp(arg.function, "aux_matmul_alg_assign")
                    || !strcmp(arg.function, "aux_matmul_alg_set_attr_bad_arg")
+                   || !strcmp(arg.function, "aux_matmul_alg_candidates")
+                   || !strcmp(arg.function, "aux_matmul_alg_split_k")
                    || !strcmp(arg.function, "aux_matmul_alg_get_attr_bad_arg")
                    || !strcmp(arg.function, "aux_matmul_plan_init_bad_arg")
                    || !strcmp(arg.function, "aux_matmul_plan_init")
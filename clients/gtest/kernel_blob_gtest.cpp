@@ -0,0 +1,146 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+
+// Host tests of the packed kernel blob written by addKernels, they read back the
+// generated source and do not use the GPU.
+
+#include "kernel_blob.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <map>
+#include <random>
+#include <sstream>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+namespace
+{
+    struct parsed_blob
+    {
+        std::vector<unsigned char>                       bytes;
+        size_t                                           declared_size = 0;
+        std::vector<std::string>                         names;
+        std::map<std::string, std::pair<size_t, size_t>> index;
+    };
+
+    // Read back the array and the index of the generated source
+    parsed_blob parse_source(const std::string& source)
+    {
+        parsed_blob blob;
+
+        auto begin = source.find("kernel_blob[");
+        EXPECT_NE(begin, std::string::npos);
+        blob.declared_size = std::stoul(source.substr(begin + 12));
+        auto end           = source.find("};", begin);
+        for(auto pos = source.find("0x", begin); pos < end; pos = source.find("0x", pos + 4))
+            blob.bytes.push_back((unsigned char)std::stoul(source.substr(pos + 2, 2), nullptr, 16));
+
+        begin = source.find("kernel_index[");
+        end   = source.find("};", begin);
+        for(auto pos = source.find("{\"", begin); pos < end; pos = source.find("{\"", pos + 1))
+        {
+            auto        quote = source.find('"', pos + 2);
+            std::string name  = source.substr(pos + 2, quote - pos - 2);
+            size_t      offset, size;
+            EXPECT_EQ(sscanf(source.c_str() + quote, "\", %zu, %zu}", &offset, &size), 2);
+            blob.names.push_back(name);
+            blob.index[name] = {offset, size};
+        }
+        return blob;
+    }
+
+    TEST(kernel_blob, round_trip)
+    {
+        std::mt19937                  rng(7);
+        std::vector<kernel_blob_file> files;
+        for(size_t size : {5000, 0, 1, 4095, 4096, 4097, 100})
+        {
+            kernel_blob_file file;
+            file.name = "kernel_" + std::to_string(rng() % 1000) + "_" + std::to_string(size);
+            for(size_t i = 0; i < size; i++)
+                file.bytes.push_back((unsigned char)rng());
+            files.push_back(file);
+        }
+
+        std::ostringstream source;
+        kernel_blob_write_source(source, files);
+        auto blob = parse_source(source.str());
+
+        ASSERT_EQ(blob.index.size(), files.size());
+        EXPECT_TRUE(std::is_sorted(blob.names.begin(), blob.names.end()));
+        EXPECT_GE(blob.declared_size, blob.bytes.size());
+        for(auto& file : files)
+        {
+            ASSERT_EQ(blob.index.count(file.name), 1) << file.name;
+            auto [offset, size] = blob.index[file.name];
+            EXPECT_EQ(offset % kernel_blob_alignment, 0) << file.name;
+            ASSERT_EQ(size, file.bytes.size()) << file.name;
+            ASSERT_LE(offset + size, blob.declared_size) << file.name;
+
+            // The bytes after the written ones are zero-initialized
+            std::vector<unsigned char> bytes(size);
+            for(size_t i = 0; i < size; i++)
+                bytes[i] = offset + i < blob.bytes.size() ? blob.bytes[offset + i] : 0;
+            EXPECT_EQ(bytes, file.bytes) << file.name;
+        }
+    }
+
+    TEST(kernel_blob, read_file)
+    {
+        std::vector<unsigned char> bytes = {0x7f, 'E', 'L', 'F', 0x00, 0xff, 0x0a, 0x1a};
+
+        char path[] = "/tmp/kernel_blob_XXXXXX";
+        int  fd     = mkstemp(path);
+        ASSERT_NE(fd, -1);
+        close(fd);
+        std::string co = std::string(path) + ".co";
+        {
+            std::ofstream out(co, std::ios_base::binary);
+            out.write((const char*)bytes.data(), bytes.size());
+        }
+
+        kernel_blob_file file;
+        ASSERT_TRUE(kernel_blob_read_file(co, &file));
+        EXPECT_EQ(file.bytes, bytes);
+        EXPECT_EQ(file.name, co.substr(5, co.size() - 8));
+        remove(co.c_str());
+        remove(path);
+
+        EXPECT_FALSE(kernel_blob_read_file(co, &file));
+    }
+
+    TEST(kernel_blob, empty)
+    {
+        std::ostringstream source;
+        kernel_blob_write_source(source, {});
+        auto blob = parse_source(source.str());
+        EXPECT_TRUE(blob.index.empty());
+        EXPECT_NE(source.str().find("kernel_count = 0;"), std::string::npos);
+    }
+}
@@ -0,0 +1,114 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+
+// Host tests of the LRU cache which keeps the solutions found for a problem.
+
+#include "lru_cache.hpp"
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    TEST(lru_cache, get_put)
+    {
+        rocsparselt_lru_cache<int, std::string> cache(4);
+        std::string                             value;
+        EXPECT_FALSE(cache.get(1, &value));
+
+        cache.put(1, "one");
+        cache.put(2, "two");
+        ASSERT_TRUE(cache.get(1, &value));
+        EXPECT_EQ(value, "one");
+        ASSERT_TRUE(cache.get(2, &value));
+        EXPECT_EQ(value, "two");
+
+        // A put of a key which is there replaces its value.
+        cache.put(1, "uno");
+        ASSERT_TRUE(cache.get(1, &value));
+        EXPECT_EQ(value, "uno");
+        EXPECT_EQ(cache.size(), 2);
+
+        cache.clear();
+        EXPECT_EQ(cache.size(), 0);
+        EXPECT_FALSE(cache.get(1, &value));
+    }
+
+    TEST(lru_cache, evicts_least_recently_used)
+    {
+        rocsparselt_lru_cache<int, int> cache(3);
+        int                             value;
+        for(int i = 0; i < 3; i++)
+            cache.put(i, i * 10);
+
+        // 0 is used, so 1 is the least recently used entry.
+        ASSERT_TRUE(cache.get(0, &value));
+        cache.put(3, 30);
+        EXPECT_EQ(cache.size(), 3);
+        EXPECT_FALSE(cache.get(1, &value));
+        EXPECT_TRUE(cache.get(0, &value));
+        EXPECT_TRUE(cache.get(2, &value));
+        EXPECT_TRUE(cache.get(3, &value));
+
+        // A put of a key which is there makes it the most recently used one.
+        cache.put(0, 0);
+        cache.put(2, 20);
+        cache.put(4, 40);
+        EXPECT_FALSE(cache.get(3, &value));
+        EXPECT_TRUE(cache.get(0, &value));
+    }
+
+    TEST(lru_cache, disabled)
+    {
+        rocsparselt_lru_cache<int, int> cache(0);
+        int                             value;
+        cache.put(1, 1);
+        EXPECT_EQ(cache.size(), 0);
+        EXPECT_FALSE(cache.get(1, &value));
+    }
+
+    TEST(lru_cache, threads)
+    {
+        rocsparselt_lru_cache<int, std::vector<int>> cache(64);
+        std::vector<std::thread>                      threads;
+        for(int t = 0; t < 8; t++)
+            threads.emplace_back([&cache, t] {
+                for(int i = 0; i < 1000; i++)
+                {
+                    int              key = (i * 7 + t) % 128;
+                    std::vector<int> value;
+                    if(cache.get(key, &value))
+                        ASSERT_EQ(value, std::vector<int>(3, key));
+                    else
+                        cache.put(key, std::vector<int>(3, key));
+                }
+            });
+        for(auto& thread : threads)
+            thread.join();
+        EXPECT_LE(cache.size(), 64);
+    }
+}
@@ -0,0 +1,76 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+
+// Host tests of the worker pool which loads the libraries at initialization.
+
+#include "parallel_for.hpp"
+#include <atomic>
+#include <gtest/gtest.h>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    TEST(parallel_for, calls_each_index_once)
+    {
+        for(size_t workers : {0, 1, 3, 8, 64})
+        {
+            std::vector<std::atomic<int>> calls(100);
+            rocsparselt_parallel_for(calls.size(), workers, [&](size_t i) { calls[i]++; });
+            for(auto& c : calls)
+                EXPECT_EQ(c.load(), 1) << workers << " workers";
+        }
+    }
+
+    TEST(parallel_for, uses_the_workers)
+    {
+        // Each call waits for the others, so they must run at the same time.
+        std::mutex                mutex;
+        std::set<std::thread::id> ids;
+        std::atomic<int>          started{0};
+        rocsparselt_parallel_for(4, 4, [&](size_t) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                ids.insert(std::this_thread::get_id());
+            }
+            started++;
+            while(started < 4)
+                std::this_thread::yield();
+        });
+        EXPECT_EQ(ids.size(), 4);
+        EXPECT_EQ(ids.count(std::this_thread::get_id()), 1);
+    }
+
+    TEST(parallel_for, empty)
+    {
+        int calls = 0;
+        rocsparselt_parallel_for(0, 4, [&](size_t) { calls++; });
+        EXPECT_EQ(calls, 0);
+        EXPECT_GE(rocsparselt_init_workers(), 1);
+    }
+}
@@ -0,0 +1,176 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+
+// Host tests of the performance model with the tables of the logic of every
+// architecture, they do not use the GPU.
+
+#include "perf_model.hpp"
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace
+{
+    // The solutions which are the fastest for some size of the table
+    std::vector<int32_t> perf_winners(const rocsparselt_perf_entry* entries, size_t count)
+    {
+        std::set<int32_t> winners;
+        for(size_t i = 0; i < count; i++)
+            winners.insert(entries[i].solution);
+        return std::vector<int32_t>(winners.begin(), winners.end());
+    }
+
+    TEST(perf_model, tables)
+    {
+        if(rocsparselt_perf_table_count == 0)
+            GTEST_SKIP() << "the logic has no exact sizes";
+        for(size_t t = 0; t < rocsparselt_perf_table_count; t++)
+        {
+            auto& table = rocsparselt_perf_tables[t];
+            EXPECT_EQ(std::string(table.arch).compare(0, 3, "gfx"), 0) << table.logic;
+            ASSERT_GT(table.entry_count, 0);
+            for(size_t i = 0; i < table.entry_count; i++)
+            {
+                ASSERT_GE(table.entries[i].solution, 0);
+                ASSERT_LT(table.entries[i].solution, table.solution_count);
+                EXPECT_STRNE(table.solutions[table.entries[i].solution], "");
+            }
+        }
+    }
+
+    TEST(perf_model, tuned_sizes)
+    {
+        // A tuned size ranks the solution which was the fastest for it first.
+        for(size_t t = 0; t < rocsparselt_perf_table_count; t++)
+        {
+            auto&                  table = rocsparselt_perf_tables[t];
+            rocsparselt_perf_model model(table.entries, table.entry_count);
+            auto                   winners = perf_winners(table.entries, table.entry_count);
+            std::vector<size_t>    order;
+            for(size_t i = 0; i < table.entry_count; i++)
+            {
+                model.rank(table.entries[i].size, winners, &order);
+                ASSERT_EQ(order.size(), winners.size());
+                EXPECT_EQ(winners[order[0]], table.entries[i].solution) << table.logic;
+            }
+        }
+    }
+
+    TEST(perf_model, held_out_sizes)
+    {
+        // Each size is left out of its table in turn, and the model of the other
+        // sizes ranks the solution which was the fastest for it. The model must
+        // do at least as well as ranking the solutions by how often they win.
+        if(rocsparselt_perf_table_count == 0)
+            GTEST_SKIP() << "the logic has no exact sizes";
+        size_t tried = 0, model_top3 = 0, frequent_top3 = 0;
+        for(size_t t = 0; t < rocsparselt_perf_table_count; t++)
+        {
+            auto& table   = rocsparselt_perf_tables[t];
+            auto  winners = perf_winners(table.entries, table.entry_count);
+            if(winners.size() <= 3)
+                continue;
+
+            for(size_t i = 0; i < table.entry_count; i++)
+            {
+                std::vector<rocsparselt_perf_entry> others(table.entries,
+                                                           table.entries + table.entry_count);
+                others.erase(others.begin() + i);
+                int32_t expected = table.entries[i].solution;
+
+                rocsparselt_perf_model model(others.data(), others.size());
+                std::vector<size_t>    order;
+                model.rank(table.entries[i].size, winners, &order);
+                for(size_t r = 0; r < 3; r++)
+                    model_top3 += winners[order[r]] == expected;
+
+                std::map<int32_t, int> wins;
+                for(auto& entry : others)
+                    wins[entry.solution]++;
+                auto frequent = winners;
+                std::stable_sort(frequent.begin(), frequent.end(), [&](int32_t l, int32_t r) {
+                    return wins[l] > wins[r];
+                });
+                for(size_t r = 0; r < 3; r++)
+                    frequent_top3 += frequent[r] == expected;
+
+                tried++;
+            }
+        }
+        if(tried == 0)
+            GTEST_SKIP() << "no table has more than 3 fastest solutions";
+        double model_rate    = double(model_top3) / tried;
+        double frequent_rate = double(frequent_top3) / tried;
+        EXPECT_GE(model_rate, frequent_rate);
+        EXPECT_GE(model_rate, 0.25);
+        std::cout << "perf_model: the fastest solution of " << tried
+                  << " held out sizes is in the top 3 for " << model_rate * 100
+                  << "%, by the number of wins for " << frequent_rate * 100 << "%" << std::endl;
+    }
+
+    TEST(perf_model, unknown_solutions)
+    {
+        rocsparselt_perf_entry entries[] = {{{1024, 1024, 1, 1024}, 0, 100.f},
+                                            {{128, 128, 1, 128}, 1, 10.f},
+                                            {{1024, 1024, 1, 1024}, 2, 50.f}};
+        rocsparselt_perf_model model(entries, 3);
+        std::vector<size_t>    order;
+
+        // Solutions without an entry keep their order, after the others.
+        int64_t size[4] = {256, 256, 1, 256};
+        model.rank(size, {7, 1, 5, 0}, &order);
+        EXPECT_EQ(order, (std::vector<size_t>{1, 3, 0, 2}));
+
+        // At the same distance, the faster solution is first.
+        int64_t large[4] = {1024, 1024, 1, 1024};
+        model.rank(large, {2, 0, 1}, &order);
+        EXPECT_EQ(order, (std::vector<size_t>{1, 0, 2}));
+    }
+
+    TEST(perf_model, rank_names)
+    {
+        if(rocsparselt_perf_table_count == 0)
+            GTEST_SKIP() << "the logic has no exact sizes";
+        auto&                    table = rocsparselt_perf_tables[0];
+        std::vector<std::string> names;
+        for(auto solution : perf_winners(table.entries, table.entry_count))
+            names.push_back(table.solutions[solution]);
+        names.push_back("unknown");
+        std::reverse(names.begin(), names.end());
+
+        std::vector<size_t> order;
+        ASSERT_TRUE(rocsparselt_perf_model_rank(table.arch, table.entries[0].size, names, &order));
+        ASSERT_EQ(order.size(), names.size());
+        EXPECT_EQ(names[order[0]], table.solutions[table.entries[0].solution]);
+        EXPECT_EQ(order.back(), 0);
+
+        EXPECT_FALSE(rocsparselt_perf_model_rank("gfx000", table.entries[0].size, names, &order));
+        EXPECT_FALSE(rocsparselt_perf_model_rank(table.arch, table.entries[0].size, {"x"}, &order));
+    }
+}
@@ -0,0 +1,184 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+
+// Host tests of the format of the plan blobs, they do not use the GPU.
+
+#include "plan_blob.hpp"
+#include <cstring>
+#include <gtest/gtest.h>
+#include <vector>
+
+namespace
+{
+    constexpr char arch[]    = "gfx942";
+    constexpr char version[] = "0.2.3-0/tensile";
+
+    rocsparselt_plan_blob_header plan_blob_header(uint32_t config_count)
+    {
+        rocsparselt_plan_blob_header header;
+        rocsparselt_plan_blob_clear(&header);
+        header.config_count = config_count;
+        strcpy(header.arch, arch);
+        strcpy(header.version, version);
+        for(int i = 0; i < 4; i++)
+        {
+            header.matrices[i].m_type      = i == 0 ? 1 : 0;
+            header.matrices[i].m           = 128 + i;
+            header.matrices[i].n           = 256 + i;
+            header.matrices[i].ld          = 128 + i;
+            header.matrices[i].num_batches = 1;
+            header.matrices[i].c_k         = i == 0 ? 64 : -1;
+        }
+        header.op_a                       = 111;
+        header.op_b                       = 112;
+        header.activation_relu_upperbound = 6.f;
+        header.swap_ab                    = 1;
+        header.m                          = 128;
+        header.n                          = 256;
+        header.k                          = 512;
+        header._m                         = 256;
+        header._n                         = 128;
+        header.config_id                  = config_count - 1;
+        header.search_min_time            = 0.5f;
+        return header;
+    }
+
+    std::vector<rocsparselt_plan_blob_config> plan_blob_configs(uint32_t count)
+    {
+        std::vector<rocsparselt_plan_blob_config> configs(count);
+        for(uint32_t i = 0; i < count; i++)
+        {
+            configs[i]                     = {};
+            configs[i].index               = 1000 + i;
+            configs[i].use_bias            = i % 3;
+            configs[i].split_k             = 1 << i;
+            configs[i].max_workspace_bytes = uint64_t(i) << 33;
+        }
+        return configs;
+    }
+
+    std::vector<char> plan_blob(const rocsparselt_plan_blob_header&              header,
+                                const std::vector<rocsparselt_plan_blob_config>& configs)
+    {
+        std::vector<char> blob(rocsparselt_plan_blob_size(header.config_count));
+        rocsparselt_plan_blob_write(header, configs.data(), blob.data());
+        return blob;
+    }
+
+    TEST(plan_blob, round_trip)
+    {
+        auto header  = plan_blob_header(5);
+        auto configs = plan_blob_configs(5);
+        auto blob    = plan_blob(header, configs);
+        EXPECT_EQ(blob.size(),
+                  sizeof(rocsparselt_plan_blob_header) + 5 * sizeof(rocsparselt_plan_blob_config));
+
+        rocsparselt_plan_blob_header              read;
+        std::vector<rocsparselt_plan_blob_config> read_configs;
+        ASSERT_EQ(rocsparselt_plan_blob_read(
+                      blob.data(), blob.size(), arch, version, &read, &read_configs),
+                  rocsparselt_plan_blob_error::none);
+
+        // All but the fields the write fills in are the ones written.
+        EXPECT_EQ(memcmp(read.magic, rocsparselt_plan_blob_magic, sizeof(read.magic)), 0);
+        EXPECT_EQ(read.format, rocsparselt_plan_blob_format);
+        EXPECT_EQ(read.size, blob.size());
+        memcpy(header.magic, read.magic, sizeof(header.magic));
+        header.format   = read.format;
+        header.size     = read.size;
+        header.checksum = read.checksum;
+        EXPECT_EQ(memcmp(&read, &header, sizeof(header)), 0);
+
+        ASSERT_EQ(read_configs.size(), configs.size());
+        EXPECT_EQ(memcmp(read_configs.data(),
+                         configs.data(),
+                         configs.size() * sizeof(rocsparselt_plan_blob_config)),
+                  0);
+
+        // The same plan is the same blob.
+        EXPECT_EQ(plan_blob(plan_blob_header(5), configs), blob);
+    }
+
+    TEST(plan_blob, unaligned)
+    {
+        auto              configs = plan_blob_configs(3);
+        auto              blob    = plan_blob(plan_blob_header(3), configs);
+        std::vector<char> shifted(blob.size() + 1);
+        memcpy(shifted.data() + 1, blob.data(), blob.size());
+
+        // The blob may be followed by other data.
+        shifted.push_back('x');
+        rocsparselt_plan_blob_header              read;
+        std::vector<rocsparselt_plan_blob_config> read_configs;
+        ASSERT_EQ(rocsparselt_plan_blob_read(
+                      shifted.data() + 1, blob.size() + 1, arch, version, &read, &read_configs),
+                  rocsparselt_plan_blob_error::none);
+        EXPECT_EQ(read_configs[2].index, configs[2].index);
+        EXPECT_EQ(read.config_id, 2);
+    }
+
+    TEST(plan_blob, guards)
+    {
+        auto blob = plan_blob(plan_blob_header(2), plan_blob_configs(2));
+
+        rocsparselt_plan_blob_header              read;
+        std::vector<rocsparselt_plan_blob_config> read_configs;
+        auto read_blob = [&](const std::vector<char>& b, size_t n, const char* a, const char* v) {
+            return rocsparselt_plan_blob_read(b.data(), n, a, v, &read, &read_configs);
+        };
+
+        EXPECT_EQ(read_blob(blob, blob.size(), "gfx90a", version),
+                  rocsparselt_plan_blob_error::arch);
+        EXPECT_EQ(read_blob(blob, blob.size(), arch, "0.2.4-0/tensile"),
+                  rocsparselt_plan_blob_error::version);
+        EXPECT_EQ(read_blob(blob, blob.size(), arch, "0.2.3-0/hip"),
+                  rocsparselt_plan_blob_error::version);
+
+        // Truncated
+        EXPECT_EQ(read_blob(blob, blob.size() - 1, arch, version),
+                  rocsparselt_plan_blob_error::invalid);
+        EXPECT_EQ(read_blob(blob, sizeof(rocsparselt_plan_blob_header) - 1, arch, version),
+                  rocsparselt_plan_blob_error::invalid);
+        EXPECT_EQ(rocsparselt_plan_blob_read(nullptr, 0, arch, version, &read, &read_configs),
+                  rocsparselt_plan_blob_error::invalid);
+
+        // Any changed byte is detected.
+        for(size_t i = 0; i < blob.size(); i++)
+        {
+            auto changed = blob;
+            changed[i] ^= 0x10;
+            EXPECT_EQ(read_blob(changed, changed.size(), arch, version),
+                      rocsparselt_plan_blob_error::invalid)
+                << "byte " << i;
+        }
+
+        // Another format
+        auto other = blob;
+        reinterpret_cast<rocsparselt_plan_blob_header*>(other.data())->format++;
+        EXPECT_EQ(read_blob(other, other.size(), arch, version),
+                  rocsparselt_plan_blob_error::invalid);
+    }
+}
@@ -68,6 +68,24 @@ namespace
                 testing_spmm<Ti, To, Tc, TBias, hipsparselt_batch_type::strided_batched>(arg);
             else if(!strcmp(arg.function, "spmm_bad_arg"))
                 testing_spmm_bad_arg<Ti, To, Tc>(arg);
+            else if(!strcmp(arg.function, "spmm_alloc_free"))
+                testing_spmm_alloc_free<Ti, To, Tc>(arg);
+            else if(!strcmp(arg.function, "spmm_grouped"))
+                testing_spmm_grouped<Ti, To, Tc>(arg);
+            else if(!strcmp(arg.function, "spmm_device_pointer_mode"))
+                testing_spmm_device_pointer_mode<Ti, To, Tc>(arg);
+            else if(!strcmp(arg.function, "spmm_workspace_pool"))
+                testing_spmm_workspace_pool<Ti, To, Tc>(arg);
+            else if(!strcmp(arg.function, "spmm_multi_stream"))
+                testing_spmm_multi_stream<Ti, To, Tc>(arg);
+            else if(!strcmp(arg.function, "spmm_capture"))
+                testing_spmm_capture<Ti, To, Tc>(arg);
+            else if(!strcmp(arg.function, "spmm_dynamic_m"))
+                testing_spmm_dynamic_m<Ti, To, Tc>(arg);
+            else if(!strcmp(arg.function, "spmm_tuning_db"))
+                testing_spmm_tuning_db<Ti, To, Tc>(arg);
+            else if(!strcmp(arg.function, "spmm_search_results"))
+                testing_spmm_search_results<Ti, To, Tc>(arg);
             else if(!strcmp(arg.function, "aux_plan_assign"))
                 testing_aux_plan_assign<Ti, To, Tc>(arg);
             else
@@ -89,6 +107,15 @@ namespace
             return !strcmp(arg.function, "spmm") || !strcmp(arg.function, "spmm_batched")
                    || !strcmp(arg.function, "spmm_strided_batched")
                    || !strcmp(arg.function, "spmm_bad_arg")
+                   || !strcmp(arg.function, "spmm_alloc_free")
+                   || !strcmp(arg.function, "spmm_grouped")
+                   || !strcmp(arg.function, "spmm_device_pointer_mode")
+                   || !strcmp(arg.function, "spmm_workspace_pool")
+                   || !strcmp(arg.function, "spmm_multi_stream")
+                   || !strcmp(arg.function, "spmm_capture")
+                   || !strcmp(arg.function, "spmm_dynamic_m")
+                   || !strcmp(arg.function, "spmm_tuning_db")
+                   || !strcmp(arg.function, "spmm_search_results")
                    || !strcmp(arg.function, "aux_plan_assign");
         }
 
@@ -0,0 +1,132 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+
+// Host tests of the startup timing, they do not use the GPU.
+
+#include "startup_timing.hpp"
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    constexpr int code_object_load = 2;
+    constexpr int first_launch     = 6;
+
+    TEST(startup_timing, record)
+    {
+        rocsparselt_startup_reset();
+        EXPECT_FALSE(rocsparselt_startup_recorded(code_object_load));
+        EXPECT_EQ(rocsparselt_startup_get(code_object_load).count, 0);
+
+        rocsparselt_startup_record(code_object_load, 2.0);
+        rocsparselt_startup_record(code_object_load, 3.0);
+        auto time = rocsparselt_startup_get(code_object_load);
+        EXPECT_TRUE(rocsparselt_startup_recorded(code_object_load));
+        EXPECT_EQ(time.count, 2);
+        EXPECT_DOUBLE_EQ(time.first_ms, 2.0);
+        EXPECT_DOUBLE_EQ(time.total_ms, 5.0);
+
+        // Only the first occurrence of a phase timed once is kept.
+        EXPECT_TRUE(rocsparselt_startup_record_first(first_launch, 1.0));
+        EXPECT_FALSE(rocsparselt_startup_record_first(first_launch, 4.0));
+        time = rocsparselt_startup_get(first_launch);
+        EXPECT_EQ(time.count, 1);
+        EXPECT_DOUBLE_EQ(time.total_ms, 1.0);
+
+        rocsparselt_startup_reset();
+        EXPECT_FALSE(rocsparselt_startup_recorded(first_launch));
+    }
+
+    TEST(startup_timing, invalid_phase)
+    {
+        rocsparselt_startup_reset();
+        rocsparselt_startup_record(-1, 1.0);
+        rocsparselt_startup_record(rocsparselt_startup_phase_count, 1.0);
+        EXPECT_FALSE(rocsparselt_startup_record_first(rocsparselt_startup_phase_count, 1.0));
+        EXPECT_EQ(rocsparselt_startup_get(rocsparselt_startup_phase_count).count, 0);
+        EXPECT_EQ(rocsparselt_startup_phase_name(-1), nullptr);
+        EXPECT_EQ(rocsparselt_startup_summary(), "");
+    }
+
+    TEST(startup_timing, timer)
+    {
+        rocsparselt_startup_reset();
+        {
+            rocsparselt_startup_timer timer(code_object_load);
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        }
+        auto time = rocsparselt_startup_get(code_object_load);
+        EXPECT_EQ(time.count, 1);
+        EXPECT_GE(time.total_ms, 2.0);
+
+        // A timer stopped by hand does not record again when destroyed.
+        rocsparselt_startup_timer stopped(code_object_load);
+        EXPECT_TRUE(stopped.stop());
+        EXPECT_FALSE(stopped.stop());
+        EXPECT_EQ(rocsparselt_startup_get(code_object_load).count, 2);
+
+        // Once the phase has an occurrence, a timer timed once does nothing.
+        rocsparselt_startup_timer first(first_launch, true);
+        rocsparselt_startup_timer second(first_launch, true);
+        EXPECT_TRUE(second.stop());
+        EXPECT_FALSE(first.stop());
+        rocsparselt_startup_timer third(first_launch, true);
+        EXPECT_FALSE(third.stop());
+        EXPECT_EQ(rocsparselt_startup_get(first_launch).count, 1);
+    }
+
+    TEST(startup_timing, threads)
+    {
+        rocsparselt_startup_reset();
+        std::vector<std::thread> threads;
+        for(int t = 0; t < 8; t++)
+            threads.emplace_back([] {
+                for(int i = 0; i < 100; i++)
+                    rocsparselt_startup_record(code_object_load, 0.5);
+                rocsparselt_startup_record_first(first_launch, 1.0);
+            });
+        for(auto& t : threads)
+            t.join();
+
+        EXPECT_EQ(rocsparselt_startup_get(code_object_load).count, 800);
+        EXPECT_DOUBLE_EQ(rocsparselt_startup_get(code_object_load).total_ms, 400.0);
+        EXPECT_EQ(rocsparselt_startup_get(first_launch).count, 1);
+    }
+
+    TEST(startup_timing, summary)
+    {
+        rocsparselt_startup_reset();
+        rocsparselt_startup_record(0, 0.25);
+        rocsparselt_startup_record(code_object_load, 10.0);
+        rocsparselt_startup_record(code_object_load, 5.5);
+        rocsparselt_startup_record_first(first_launch, 1.0);
+        EXPECT_EQ(rocsparselt_startup_summary(),
+                  "path_discovery 0.250 ms, code_object_load 15.500 ms (2), first_launch 1.000 ms");
+        rocsparselt_startup_reset();
+    }
+}
@@ -0,0 +1,212 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+
+// Host tests of hipsparselt-tune, they do not use the GPU.
+
+#include "hipsparselt_tune.hpp"
+#include "utility.hpp"
+#include <cstdio>
+#include <cstring>
+#include <gtest/gtest.h>
+#include <sstream>
+#include <stdexcept>
+#ifdef __HIP_PLATFORM_AMD__
+#include "tuning_db.hpp"
+#endif
+
+namespace
+{
+    TEST(tune, parse_csv)
+    {
+        // Two runs of hipsparselt-bench, with the messages it prints in between.
+        std::istringstream is("transA,transB,M,N,K,alpha,lda,stride_a,beta,ldb,stride_b,"
+                              "ldc,stride_c,ldd,stride_d,hipsparselt-Gflops,us\n"
+                              "N,T,256,512,1024,1,256,262144,0,512,524288,256,131072,256,"
+                              "131072,100.5,12.5\n"
+                              "hipsparselt-bench INFO: lda < min_lda, set lda = 128\n"
+                              "M,N,K,precision,c_type,batch_count\n"
+                              "64,32,128,i8_r,bf16_r,4\n");
+        auto               problems = hipsparselt_tune_parse_csv(is, "bf16_r");
+        ASSERT_EQ(problems.size(), 2);
+
+        EXPECT_EQ(problems[0].transA, 'N');
+        EXPECT_EQ(problems[0].transB, 'T');
+        EXPECT_EQ(problems[0].M, 256);
+        EXPECT_EQ(problems[0].N, 512);
+        EXPECT_EQ(problems[0].K, 1024);
+        EXPECT_EQ(problems[0].ldb, 512);
+        EXPECT_EQ(problems[0].a_type, HIP_R_16BF);
+        EXPECT_EQ(problems[0].d_type, HIP_R_16BF);
+        EXPECT_STREQ(problems[0].function, "spmm");
+
+        EXPECT_EQ(problems[1].a_type, HIP_R_8I);
+        EXPECT_EQ(problems[1].b_type, HIP_R_8I);
+        EXPECT_EQ(problems[1].c_type, HIP_R_16BF);
+        EXPECT_EQ(problems[1].d_type, HIP_R_8I);
+        EXPECT_EQ(problems[1].lda, 64);
+        EXPECT_EQ(problems[1].stride_a, 64 * 128);
+        EXPECT_EQ(problems[1].stride_d, 64 * 32);
+        EXPECT_STREQ(problems[1].function, "spmm_strided_batched");
+
+        std::istringstream bad("M,N,K\n-1,2,3\n");
+        EXPECT_THROW(hipsparselt_tune_parse_csv(bad), std::invalid_argument);
+    }
+
+    TEST(tune, parse_log)
+    {
+        std::istringstream is(
+            "./hipsparselt-bench -f spmm -r f16_r -m 1024 -n 512 -k 256 --transposeA T "
+            "--lda 2048 --bias_vector --bias_type f32_r --activation_type relu\n"
+            "hipsparselt-bench INFO: ldc < min_ldc, set ldc = 1024\n"
+            "hipsparselt-bench -f prune -m 64 -n 64 -k 64\n"
+            "some other line\n"
+            "hipsparselt-bench --function spmm_strided_batched --precision i8_r --sizem 64 "
+            "--sizen=32 --sizek 128 --batch_count 2 --stride_a 0 --ldc -1 --sparse_b "
+            "--order R\n");
+        auto problems = hipsparselt_tune_parse_log(is);
+        ASSERT_EQ(problems.size(), 2);
+
+        EXPECT_EQ(problems[0].M, 1024);
+        EXPECT_EQ(problems[0].N, 512);
+        EXPECT_EQ(problems[0].K, 256);
+        EXPECT_EQ(problems[0].transA, 'T');
+        EXPECT_EQ(problems[0].transB, 'N');
+        EXPECT_EQ(problems[0].lda, 2048);
+        EXPECT_EQ(problems[0].a_type, HIP_R_16F);
+        EXPECT_TRUE(problems[0].bias_vector);
+        EXPECT_EQ(problems[0].bias_type, HIP_R_32F);
+        EXPECT_EQ(problems[0].activation_type, hipsparselt_activation_type::relu);
+
+        EXPECT_EQ(problems[1].a_type, HIP_R_8I);
+        EXPECT_EQ(problems[1].N, 32);
+        EXPECT_EQ(problems[1].batch_count, 2);
+        EXPECT_TRUE(problems[1].sparse_b);
+        EXPECT_EQ(problems[1].orderA, 'R');
+        EXPECT_EQ(problems[1].orderD, 'R');
+        EXPECT_EQ(problems[1].ldc, 32);
+        // A stride of 0 broadcasts A and is kept.
+        EXPECT_EQ(problems[1].stride_a, 0);
+        EXPECT_STREQ(problems[1].function, "spmm_strided_batched");
+    }
+
+    TEST(tune, unique)
+    {
+        hipsparselt_tune_fields fields = {{"M", "128"}, {"N", "64"}, {"K", "256"}};
+        Arguments               a, b, c, d;
+        ASSERT_TRUE(hipsparselt_tune_shape(a, fields));
+
+        // The default leading dimension, and a stride which a single batch does not use
+        fields.emplace_back("lda", "128");
+        fields.emplace_back("stride_c", "100000");
+        ASSERT_TRUE(hipsparselt_tune_shape(b, fields));
+
+        fields.emplace_back("transB", "T");
+        ASSERT_TRUE(hipsparselt_tune_shape(c, fields));
+
+        // The bias type is only part of the problem with a bias vector
+        fields.emplace_back("bias_type", "f32_r");
+        ASSERT_TRUE(hipsparselt_tune_shape(d, fields));
+
+        EXPECT_EQ(hipsparselt_tune_key(a), hipsparselt_tune_key(b));
+        EXPECT_NE(hipsparselt_tune_key(a), hipsparselt_tune_key(c));
+        EXPECT_EQ(hipsparselt_tune_key(c), hipsparselt_tune_key(d));
+
+        auto unique = hipsparselt_tune_unique({a, b, c, a, d});
+        ASSERT_EQ(unique.size(), 2);
+        EXPECT_EQ(unique[0].transB, 'N');
+        EXPECT_EQ(unique[1].transB, 'T');
+
+        Arguments prune;
+        EXPECT_FALSE(hipsparselt_tune_shape(prune, {{"function", "prune"}}));
+        EXPECT_THROW(hipsparselt_tune_shape(prune, {{"transA", "X"}}), std::invalid_argument);
+        EXPECT_THROW(hipsparselt_tune_shape(prune, {{"a_type", "f64_r"}}), std::invalid_argument);
+        EXPECT_THROW(hipsparselt_tune_shape(prune, {{"M", "12x"}}), std::invalid_argument);
+    }
+
+#ifdef __HIP_PLATFORM_AMD__
+    rocsparselt_tuning_entry tune_entry(int64_t m, int32_t solution_index, float ms)
+    {
+        rocsparselt_tuning_entry entry;
+        memset(&entry, 0, sizeof(entry));
+        rocsparselt_tuning_key_clear(&entry.key);
+        strcpy(entry.key.arch, "gfx942");
+        strcpy(entry.key.version, "test");
+        entry.key.rows[0]    = m;
+        entry.solution_index = solution_index;
+        entry.split_k        = 1;
+        entry.ms             = ms;
+        return entry;
+    }
+
+    TEST(tune, tuning_file)
+    {
+        // hipsparselt_tempname() leaves an empty file, which is not a tuning file yet.
+        std::string              path = hipsparselt_tempname();
+        rocsparselt_tuning_db    db(path);
+        rocsparselt_tuning_entry found;
+        EXPECT_FALSE(db.lookup(tune_entry(1, 0, 0).key, &found));
+
+        rocsparselt_tuning_entry entries[] = {tune_entry(300, 3, 3.f), tune_entry(100, 1, 1.f)};
+        ASSERT_TRUE(db.update(entries, 2));
+
+        // Another reader of the file sees the entries, sorted by key.
+        rocsparselt_tuning_db                 reader(path);
+        std::vector<rocsparselt_tuning_entry> read;
+        ASSERT_TRUE(reader.read(&read));
+        ASSERT_EQ(read.size(), 2);
+        EXPECT_TRUE(read[0].key < read[1].key);
+        EXPECT_EQ(read[0].solution_index + read[1].solution_index, 4);
+
+        // An update replaces the entry of the same key and keeps the others.
+        rocsparselt_tuning_entry replace[] = {tune_entry(300, 7, 0.5f), tune_entry(200, 2, 2.f)};
+        replace[0].split_k      = 4;
+        replace[0].split_k_mode = 1;
+        replace[0].atomics      = 1;
+        ASSERT_TRUE(db.update(replace, 2));
+        ASSERT_TRUE(reader.lookup(tune_entry(300, 0, 0).key, &found));
+        EXPECT_EQ(found.solution_index, 7);
+        EXPECT_EQ(found.split_k, 4);
+        EXPECT_EQ(found.split_k_mode, 1);
+        EXPECT_EQ(found.atomics, 1);
+        EXPECT_EQ(found.ms, 0.5f);
+        ASSERT_TRUE(reader.read(&read));
+        EXPECT_EQ(read.size(), 3);
+        EXPECT_FALSE(reader.lookup(tune_entry(400, 0, 0).key, &found));
+
+        // A file of another format is not read.
+        FILE* file = fopen(path.c_str(), "r+b");
+        ASSERT_NE(file, nullptr);
+        fwrite("X", 1, 1, file);
+        fclose(file);
+        rocsparselt_tuning_db other(path);
+        EXPECT_FALSE(other.read(&read));
+        EXPECT_TRUE(read.empty());
+
+        remove(path.c_str());
+        remove((path + ".lock").c_str());
+    }
+#endif
+}
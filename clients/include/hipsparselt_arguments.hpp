@@ -122,6 +122,7 @@ struct Arguments
 
     bool    search;
     int32_t search_iters;
+    int32_t alg_candidates; // -1 keeps the default number of candidates of the library
 
     bool sparse_b;
     int  func_version;
@@ -193,6 +194,7 @@ struct Arguments
     OPER(HMM) SEP                    \
     OPER(search) SEP                 \
     OPER(search_iters) SEP           \
+    OPER(alg_candidates) SEP         \
     OPER(sparse_b) SEP               \
     OPER(func_version) SEP           \
     OPER(alpha_vector_scaling) SEP   \
@@ -0,0 +1,71 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+
+#pragma once
+
+#include "hipsparselt_arguments.hpp"
+#include <istream>
+#include <string>
+#include <utility>
+#include <vector>
+
+/*******************************************************************************
+ * Problem shapes of hipsparselt-tune. They are read from the CSV a benchmark
+ * prints, or from the hipsparselt-bench command lines of a log, and only need
+ * the host. The field names are the ones of the hipsparselt-bench options or
+ * of Arguments, e.g. "M", "sizem", "m", "transA", "precision" or "a_type".
+ * Invalid values throw std::invalid_argument, unknown fields are ignored.
+ *******************************************************************************/
+
+using hipsparselt_tune_fields = std::vector<std::pair<std::string, std::string>>;
+
+// Sets arg to the spmm problem of the fields, with the defaults of hipsparselt-bench
+// and precision for the fields which are not given. Returns false if the fields
+// name a function which is not a matmul.
+bool hipsparselt_tune_shape(Arguments&                     arg,
+                            const hipsparselt_tune_fields& fields,
+                            const std::string&             precision = "f16_r");
+
+// Reads the problems of a CSV file. Every line with the columns M, N and K is
+// a header, the lines after it with as many columns are its problems.
+std::vector<Arguments> hipsparselt_tune_parse_csv(std::istream&      is,
+                                                  const std::string& precision = "f16_r");
+
+// Reads the problems of the hipsparselt-bench command lines of a log, e.g. of
+// HIPSPARSELT_LOG_BENCH, other lines are skipped.
+std::vector<Arguments> hipsparselt_tune_parse_log(std::istream&      is,
+                                                  const std::string& precision = "f16_r");
+
+// Sets the leading dimensions and strides hipsparselt-bench would use, and the
+// spmm function for the batch count.
+void hipsparselt_tune_normalize(Arguments& arg);
+
+// The parts of a normalized problem a search depends on, problems with the same
+// key share their tuning entry.
+std::string hipsparselt_tune_key(const Arguments& arg);
+
+// Normalizes the problems and drops the repeated ones, keeping the first.
+std::vector<Arguments> hipsparselt_tune_unique(const std::vector<Arguments>& problems);
@@ -28,6 +28,7 @@
 
 #include "cblas_interface.hpp"
 #include "flops.hpp"
+#include "hipsparselt_alloc_counter.hpp"
 #include "hipsparselt_datatype2string.hpp"
 #include "hipsparselt_init.hpp"
 #include "hipsparselt_math.hpp"
@@ -38,9 +39,15 @@
 #include "norm.hpp"
 #include "unit.hpp"
 #include "utility.hpp"
+#include <algorithm>
 #include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
 #include <hipsparselt/hipsparselt.h>
+#include <memory>
 #include <omp.h>
+#include <vector>
 
 template <typename T, typename Tb = T, typename To = T, hipsparseOrder_t order>
 void bias(int64_t m, int64_t n, int64_t ld, T* src, To* dest, Tb* bias)
@@ -237,6 +244,1191 @@ void testing_spmm_bad_arg(const Arguments& arg)
         HIPSPARSE_STATUS_INVALID_VALUE);
 }
 
+template <typename Ti, typename To, typename Tc>
+void testing_spmm_alloc_free(const Arguments& arg)
+{
+    hipsparseOperation_t transA = char_to_hipsparselt_operation(arg.transA);
+    hipsparseOperation_t transB = char_to_hipsparselt_operation(arg.transB);
+
+    using Talpha = float;
+
+    int64_t M       = arg.M;
+    int64_t N       = arg.N;
+    int64_t K       = arg.K;
+    Talpha  h_alpha = arg.get_alpha<Talpha>();
+    Talpha  h_beta  = arg.get_beta<Talpha>();
+    int64_t lda     = arg.lda;
+    int64_t ldb     = arg.ldb;
+    int64_t ldc     = arg.ldc;
+    int64_t ldd     = arg.ldd;
+
+    int64_t A_row = transA == HIPSPARSE_OPERATION_NON_TRANSPOSE ? M : K;
+    int64_t A_col = transA == HIPSPARSE_OPERATION_NON_TRANSPOSE ? K : M;
+    int64_t B_row = transB == HIPSPARSE_OPERATION_NON_TRANSPOSE ? K : N;
+    int64_t B_col = transB == HIPSPARSE_OPERATION_NON_TRANSPOSE ? N : K;
+
+    hipsparselt_local_handle handle{arg};
+    hipStream_t              stream;
+    CHECK_HIP_ERROR(hipStreamCreate(&stream));
+
+    hipsparselt_local_mat_descr matA(hipsparselt_matrix_type_structured,
+                                     handle,
+                                     A_row,
+                                     A_col,
+                                     lda,
+                                     arg.a_type,
+                                     HIPSPARSE_ORDER_COL);
+    hipsparselt_local_mat_descr matB(
+        hipsparselt_matrix_type_dense, handle, B_row, B_col, ldb, arg.b_type, HIPSPARSE_ORDER_COL);
+    hipsparselt_local_mat_descr matC(
+        hipsparselt_matrix_type_dense, handle, M, N, ldc, arg.c_type, HIPSPARSE_ORDER_COL);
+    hipsparselt_local_mat_descr matD(
+        hipsparselt_matrix_type_dense, handle, M, N, ldd, arg.d_type, HIPSPARSE_ORDER_COL);
+    EXPECT_HIPSPARSE_STATUS(matA.status(), HIPSPARSE_STATUS_SUCCESS);
+    EXPECT_HIPSPARSE_STATUS(matB.status(), HIPSPARSE_STATUS_SUCCESS);
+    EXPECT_HIPSPARSE_STATUS(matC.status(), HIPSPARSE_STATUS_SUCCESS);
+    EXPECT_HIPSPARSE_STATUS(matD.status(), HIPSPARSE_STATUS_SUCCESS);
+
+    hipsparselt_local_matmul_descr matmul(
+        handle, transA, transB, matA, matB, matC, matD, arg.compute_type);
+    hipsparselt_local_matmul_alg_selection alg_sel(handle, matmul, HIPSPARSELT_MATMUL_ALG_DEFAULT);
+    hipsparselt_local_matmul_plan          plan(handle, matmul, alg_sel);
+
+    size_t workspace_size = 0, compressed_size = 0, compress_buffer_size = 0;
+    EXPECT_HIPSPARSE_STATUS(hipsparseLtMatmulGetWorkspace(handle, plan, &workspace_size),
+                            HIPSPARSE_STATUS_SUCCESS);
+    EXPECT_HIPSPARSE_STATUS(
+        hipsparseLtSpMMACompressedSize(handle, plan, &compressed_size, &compress_buffer_size),
+        HIPSPARSE_STATUS_SUCCESS);
+
+    const size_t size_A = lda * A_col;
+    const size_t size_B = ldb * B_col;
+    const size_t size_C = ldc * N;
+    const size_t size_D = ldd * N;
+
+    // Two sets of buffers, a caller which alternates between them must not allocate either.
+    device_vector<Ti>            dA(size_A);
+    device_vector<Ti>            dB(size_B), dB2(size_B);
+    device_vector<To>            dC(size_C), dC2(size_C);
+    device_vector<To>            dD(size_D), dD2(size_D);
+    device_vector<unsigned char> dA_compressed(compressed_size), dA_compressed2(compressed_size);
+    device_vector<unsigned char> dA_compressBuffer(compress_buffer_size);
+    device_vector<unsigned char> dWorkspace(workspace_size), dWorkspace2(workspace_size);
+    CHECK_DEVICE_ALLOCATION(dA.memcheck());
+    CHECK_DEVICE_ALLOCATION(dB.memcheck());
+    CHECK_DEVICE_ALLOCATION(dB2.memcheck());
+    CHECK_DEVICE_ALLOCATION(dC.memcheck());
+    CHECK_DEVICE_ALLOCATION(dC2.memcheck());
+    CHECK_DEVICE_ALLOCATION(dD.memcheck());
+    CHECK_DEVICE_ALLOCATION(dD2.memcheck());
+    CHECK_DEVICE_ALLOCATION(dA_compressed.memcheck());
+    CHECK_DEVICE_ALLOCATION(dA_compressed2.memcheck());
+    CHECK_DEVICE_ALLOCATION(dWorkspace.memcheck());
+    CHECK_DEVICE_ALLOCATION(dWorkspace2.memcheck());
+
+    host_vector<Ti> hA(size_A);
+    host_vector<Ti> hB(size_B);
+    host_vector<To> hC(size_C);
+
+    hipsparselt_seedrand();
+    hipsparselt_init<Ti>(hA, A_row, A_col, lda, size_A, 1);
+    hipsparselt_init<Ti>(hB, B_row, B_col, ldb, size_B, 1);
+    hipsparselt_init<To>(hC, M, N, ldc, size_C, 1);
+
+    CHECK_HIP_ERROR(dA.transfer_from(hA));
+    CHECK_HIP_ERROR(dB.transfer_from(hB));
+    CHECK_HIP_ERROR(dB2.transfer_from(hB));
+    CHECK_HIP_ERROR(dC.transfer_from(hC));
+    CHECK_HIP_ERROR(dC2.transfer_from(hC));
+
+    EXPECT_HIPSPARSE_STATUS(
+        hipsparseLtSpMMAPrune(handle, matmul, dA, dA, HIPSPARSELT_PRUNE_SPMMA_STRIP, stream),
+        HIPSPARSE_STATUS_SUCCESS);
+    EXPECT_HIPSPARSE_STATUS(
+        hipsparseLtSpMMACompress(handle, plan, dA, dA_compressed, dA_compressBuffer, stream),
+        HIPSPARSE_STATUS_SUCCESS);
+    EXPECT_HIPSPARSE_STATUS(
+        hipsparseLtSpMMACompress(handle, plan, dA, dA_compressed2, dA_compressBuffer, stream),
+        HIPSPARSE_STATUS_SUCCESS);
+
+    auto run = [&](int set) {
+        if(set % 2)
+            return hipsparseLtMatmul(handle,
+                                     plan,
+                                     &h_alpha,
+                                     dA_compressed2,
+                                     dB2,
+                                     &h_beta,
+                                     dC2,
+                                     dD2,
+                                     dWorkspace2,
+                                     &stream,
+                                     1);
+        return hipsparseLtMatmul(
+            handle, plan, &h_alpha, dA_compressed, dB, &h_beta, dC, dD, dWorkspace, &stream, 1);
+    };
+
+    // The first calls resolve and cache everything the plan needs.
+    EXPECT_HIPSPARSE_STATUS(run(0), HIPSPARSE_STATUS_SUCCESS);
+    EXPECT_HIPSPARSE_STATUS(run(1), HIPSPARSE_STATUS_SUCCESS);
+    CHECK_HIP_ERROR(hipStreamSynchronize(stream));
+
+    // Nothing in the counted region may allocate, not even a failing EXPECT.
+    constexpr int     calls = 10;
+    hipsparseStatus_t status[calls];
+    hipsparselt_alloc_counter_start();
+    for(int i = 0; i < calls; i++)
+        status[i] = run(i);
+    size_t allocations = hipsparselt_alloc_counter_stop();
+
+    CHECK_HIP_ERROR(hipStreamSynchronize(stream));
+    for(int i = 0; i < calls; i++)
+        EXPECT_HIPSPARSE_STATUS(status[i], HIPSPARSE_STATUS_SUCCESS);
+    EXPECT_EQ(allocations, 0) << "hipsparseLtMatmul() allocated " << allocations
+                              << " times in " << calls << " steady-state calls";
+
+    // Both sets hold the same inputs, the calls on the second one must not write the first.
+    host_vector<To> hD(size_D), hD2(size_D);
+    CHECK_HIP_ERROR(hD.transfer_from(dD));
+    CHECK_HIP_ERROR(hD2.transfer_from(dD2));
+    unit_check_general<To>(M, N, ldd, hD, hD2);
+
+    CHECK_HIP_ERROR(hipStreamDestroy(stream));
+}
+
+// One problem of the tests below, with M scaled per group. The transposes and orders are the
+// ones of arg, the leading dimensions are packed since those of arg only fit arg.M.
+template <typename Ti, typename To>
+struct testing_spmm_group
+{
+    // The buffer sizes are only known once the plan exists.
+    struct buffer_sizes
+    {
+        size_t workspace = 0, compressed = 0, compress_buffer = 0;
+
+        buffer_sizes(hipsparselt_local_handle& handle, hipsparselt_local_matmul_plan& plan)
+        {
+            EXPECT_HIPSPARSE_STATUS(hipsparseLtMatmulGetWorkspace(handle, plan, &workspace),
+                                    HIPSPARSE_STATUS_SUCCESS);
+            EXPECT_HIPSPARSE_STATUS(
+                hipsparseLtSpMMACompressedSize(handle, plan, &compressed, &compress_buffer),
+                HIPSPARSE_STATUS_SUCCESS);
+        }
+    };
+
+    hipsparseOperation_t transA, transB;
+    hipsparseOrder_t     orderA, orderB, orderC, orderD;
+    int64_t              M, N, K;
+    int64_t              A_row, A_col, B_row, B_col;
+    int64_t              lda, ldb, ldc, ldd;
+
+    hipsparselt_local_mat_descr            matA, matB, matC, matD;
+    hipsparselt_local_matmul_descr         matmul;
+    hipsparselt_local_matmul_alg_selection alg_sel;
+    hipsparselt_local_matmul_plan          plan;
+    buffer_sizes                           bytes;
+
+    device_vector<Ti>            dA, dB;
+    device_vector<To>            dC, dD, dD_ref;
+    device_vector<unsigned char> dA_compressed, dA_compressBuffer, dWorkspace;
+    host_vector<To>              hC;
+
+    testing_spmm_group(const Arguments& arg, hipsparselt_local_handle& handle, int64_t M)
+        : transA(char_to_hipsparselt_operation(arg.transA))
+        , transB(char_to_hipsparselt_operation(arg.transB))
+        , orderA(char_to_hipsparselt_order(arg.orderA))
+        , orderB(char_to_hipsparselt_order(arg.orderB))
+        , orderC(char_to_hipsparselt_order(arg.orderC))
+        , orderD(char_to_hipsparselt_order(arg.orderD))
+        , M(M)
+        , N(arg.N)
+        , K(arg.K)
+        , A_row(transA == HIPSPARSE_OPERATION_NON_TRANSPOSE ? M : K)
+        , A_col(transA == HIPSPARSE_OPERATION_NON_TRANSPOSE ? K : M)
+        , B_row(transB == HIPSPARSE_OPERATION_NON_TRANSPOSE ? K : N)
+        , B_col(transB == HIPSPARSE_OPERATION_NON_TRANSPOSE ? N : K)
+        , lda(orderA == HIPSPARSE_ORDER_COL ? A_row : A_col)
+        , ldb(orderB == HIPSPARSE_ORDER_COL ? B_row : B_col)
+        , ldc(orderC == HIPSPARSE_ORDER_COL ? M : N)
+        , ldd(orderD == HIPSPARSE_ORDER_COL ? M : N)
+        , matA(hipsparselt_matrix_type_structured, handle, A_row, A_col, lda, arg.a_type, orderA)
+        , matB(hipsparselt_matrix_type_dense, handle, B_row, B_col, ldb, arg.b_type, orderB)
+        , matC(hipsparselt_matrix_type_dense, handle, M, N, ldc, arg.c_type, orderC)
+        , matD(hipsparselt_matrix_type_dense, handle, M, N, ldd, arg.d_type, orderD)
+        , matmul(handle, transA, transB, matA, matB, matC, matD, arg.compute_type)
+        , alg_sel(handle, matmul, HIPSPARSELT_MATMUL_ALG_DEFAULT)
+        , plan(handle, matmul, alg_sel)
+        , bytes(handle, plan)
+        , dA(A_row * A_col)
+        , dB(B_row * B_col)
+        , dC(M * N)
+        , dD(M * N)
+        , dD_ref(M * N)
+        , dA_compressed(bytes.compressed)
+        , dA_compressBuffer(bytes.compress_buffer)
+        , dWorkspace(bytes.workspace)
+        , hC(M * N)
+    {
+    }
+
+    hipError_t memcheck() const
+    {
+        for(hipError_t error : {dA.memcheck(),
+                                dB.memcheck(),
+                                dC.memcheck(),
+                                dD.memcheck(),
+                                dD_ref.memcheck(),
+                                dA_compressed.memcheck(),
+                                dA_compressBuffer.memcheck(),
+                                dWorkspace.memcheck()})
+            if(error != hipSuccess)
+                return error;
+        return hipSuccess;
+    }
+
+    // Fills A, B and C, then prunes and compresses A on stream.
+    void init(hipsparselt_local_handle& handle, hipStream_t stream)
+    {
+        host_vector<Ti> hA(A_row * A_col);
+        host_vector<Ti> hB(B_row * B_col);
+
+        hipsparselt_seedrand();
+        hipsparselt_init<Ti>(hA, lda, A_row * A_col / lda, lda, A_row * A_col, 1);
+        hipsparselt_init<Ti>(hB, ldb, B_row * B_col / ldb, ldb, B_row * B_col, 1);
+        hipsparselt_init<To>(hC, ldc, M * N / ldc, ldc, M * N, 1);
+
+        CHECK_HIP_ERROR(dA.transfer_from(hA));
+        CHECK_HIP_ERROR(dB.transfer_from(hB));
+        CHECK_HIP_ERROR(dC.transfer_from(hC));
+
+        EXPECT_HIPSPARSE_STATUS(
+            hipsparseLtSpMMAPrune(handle, matmul, dA, dA, HIPSPARSELT_PRUNE_SPMMA_STRIP, stream),
+            HIPSPARSE_STATUS_SUCCESS);
+        EXPECT_HIPSPARSE_STATUS(
+            hipsparseLtSpMMACompress(handle, plan, dA, dA_compressed, dA_compressBuffer, stream),
+            HIPSPARSE_STATUS_SUCCESS);
+    }
+
+    // Compares an output of the shape of D with hD_ref.
+    void check(const host_vector<To>& hD_ref, const device_vector<To>& out) const
+    {
+        host_vector<To> hD(M * N);
+        CHECK_HIP_ERROR(hD.transfer_from(out));
+        unit_check_general<To>(ldd, M * N / ldd, ldd, hD_ref, hD);
+    }
+
+    // Compares an output of the shape of D with dD_ref.
+    void check(const device_vector<To>& out) const
+    {
+        host_vector<To> hD_ref(M * N);
+        CHECK_HIP_ERROR(hD_ref.transfer_from(dD_ref));
+        check(hD_ref, out);
+    }
+};
+
+template <typename Ti, typename To, typename Tc>
+void testing_spmm_grouped(const Arguments& arg)
+{
+    using Talpha = float;
+
+    constexpr int groups  = 4;
+    constexpr int streams = 2;
+    Talpha        h_alpha = arg.get_alpha<Talpha>();
+    Talpha        h_beta  = arg.get_beta<Talpha>();
+
+    hipsparselt_local_handle handle{arg};
+    hipStream_t              stream[streams];
+    for(auto& s : stream)
+        CHECK_HIP_ERROR(hipStreamCreate(&s));
+
+    // Every group multiplies a differently sized problem, like the experts of an MoE layer.
+    std::vector<std::unique_ptr<testing_spmm_group<Ti, To>>> group;
+    for(int g = 0; g < groups; g++)
+    {
+        group.emplace_back(
+            std::make_unique<testing_spmm_group<Ti, To>>(arg, handle, arg.M * (g + 1)));
+        auto& p = *group.back();
+        CHECK_DEVICE_ALLOCATION(p.memcheck());
+        p.init(handle, stream[0]);
+
+        // The reference result is computed one group at a time.
+        EXPECT_HIPSPARSE_STATUS(hipsparseLtMatmul(handle,
+                                                  p.plan,
+                                                  &h_alpha,
+                                                  p.dA_compressed,
+                                                  p.dB,
+                                                  &h_beta,
+                                                  p.dC,
+                                                  p.dD_ref,
+                                                  p.dWorkspace,
+                                                  stream,
+                                                  1),
+                                HIPSPARSE_STATUS_SUCCESS);
+        CHECK_HIP_ERROR(hipStreamSynchronize(stream[0]));
+    }
+
+    const hipsparseLtMatmulPlan_t* plans[groups];
+    const void*                    alpha[groups];
+    const void*                    beta[groups];
+    const void*                    d_A[groups];
+    const void*                    d_B[groups];
+    const void*                    d_C[groups];
+    void*                          d_D[groups];
+    void*                          workspace[groups];
+    for(int g = 0; g < groups; g++)
+    {
+        plans[g]     = group[g]->plan;
+        alpha[g]     = &h_alpha;
+        beta[g]      = &h_beta;
+        d_A[g]       = group[g]->dA_compressed;
+        d_B[g]       = group[g]->dB;
+        d_C[g]       = group[g]->dC;
+        d_D[g]       = group[g]->dD;
+        workspace[g] = group[g]->dWorkspace;
+    }
+
+    EXPECT_HIPSPARSE_STATUS(hipsparseLtMatmulGrouped(handle,
+                                                     plans,
+                                                     alpha,
+                                                     d_A,
+                                                     d_B,
+                                                     beta,
+                                                     d_C,
+                                                     d_D,
+                                                     workspace,
+                                                     groups,
+                                                     stream,
+                                                     streams),
+                            HIPSPARSE_STATUS_SUCCESS);
+
+    // All groups are joined back into stream[0].
+    CHECK_HIP_ERROR(hipStreamSynchronize(stream[0]));
+
+    for(auto& p : group)
+        p->check(p->dD);
+
+    EXPECT_HIPSPARSE_STATUS(hipsparseLtMatmulGrouped(handle,
+                                                     plans,
+                                                     alpha,
+                                                     d_A,
+                                                     d_B,
+                                                     beta,
+                                                     d_C,
+                                                     d_D,
+                                                     workspace,
+                                                     -1,
+                                                     stream,
+                                                     streams),
+                            HIPSPARSE_STATUS_INVALID_VALUE);
+
+    for(auto& s : stream)
+        CHECK_HIP_ERROR(hipStreamDestroy(s));
+}
+
+template <typename Ti, typename To, typename Tc>
+void testing_spmm_device_pointer_mode(const Arguments& arg)
+{
+    using Talpha = float;
+
+    Talpha h_alpha = arg.get_alpha<Talpha>();
+
+    hipsparselt_local_handle handle{arg};
+    hipStream_t              stream;
+    CHECK_HIP_ERROR(hipStreamCreate(&stream));
+
+    hipsparsePointerMode_t mode;
+    EXPECT_HIPSPARSE_STATUS(hipsparseLtGetPointerMode(handle, &mode), HIPSPARSE_STATUS_SUCCESS);
+    EXPECT_EQ(mode, HIPSPARSE_POINTER_MODE_HOST);
+
+    // A descriptor takes the pointer mode of the handle when it is initialized.
+    testing_spmm_group<Ti, To> host(arg, handle, arg.M);
+    EXPECT_HIPSPARSE_STATUS(hipsparseLtSetPointerMode(handle, HIPSPARSE_POINTER_MODE_DEVICE),
+                            HIPSPARSE_STATUS_SUCCESS);
+    testing_spmm_group<Ti, To> device(arg, handle, arg.M);
+
+    EXPECT_HIPSPARSE_STATUS(hipsparseLtGetPointerMode(handle, &mode), HIPSPARSE_STATUS_SUCCESS);
+    EXPECT_EQ(mode, HIPSPARSE_POINTER_MODE_DEVICE);
+
+    // Both are filled with the same seed.
+    for(auto* p : {&host, &device})
+    {
+        CHECK_DEVICE_ALLOCATION(p->memcheck());
+        p->init(handle, stream);
+    }
+
+    device_vector<Talpha> d_alpha(1), d_beta(1);
+    CHECK_DEVICE_ALLOCATION(d_alpha.memcheck());
+    CHECK_DEVICE_ALLOCATION(d_beta.memcheck());
+    CHECK_HIP_ERROR(hipMemcpy(d_alpha, &h_alpha, sizeof(Talpha), hipMemcpyHostToDevice));
+
+    // beta * C is rounded to To ahead of the kernel in the device pointer mode, so a beta which
+    // does not scale C exactly may move D by one unit in the last place. beta == 0 must not
+    // read C.
+    const double ulp = std::is_same<To, int8_t>{}   ? 1.0
+                       : std::is_same<To, __half>{} ? 1.0 / (1 << 10)
+                                                    : 1.0 / (1 << 7);
+    for(Talpha h_beta : {arg.get_beta<Talpha>(), Talpha(0.3), Talpha(0)})
+    {
+        CHECK_HIP_ERROR(hipMemcpy(d_beta, &h_beta, sizeof(Talpha), hipMemcpyHostToDevice));
+
+        EXPECT_HIPSPARSE_STATUS(
+            hipsparseLtSetPointerMode(handle, HIPSPARSE_POINTER_MODE_HOST),
+            HIPSPARSE_STATUS_SUCCESS);
+        EXPECT_HIPSPARSE_STATUS(hipsparseLtMatmul(handle,
+                                                  host.plan,
+                                                  &h_alpha,
+                                                  host.dA_compressed,
+                                                  host.dB,
+                                                  &h_beta,
+                                                  host.dC,
+                                                  host.dD,
+                                                  host.dWorkspace,
+                                                  &stream,
+                                                  1),
+                                HIPSPARSE_STATUS_SUCCESS);
+
+        // A plan only runs with the pointer mode it was created with.
+        EXPECT_HIPSPARSE_STATUS(hipsparseLtMatmul(handle,
+                                                  device.plan,
+                                                  d_alpha,
+                                                  device.dA_compressed,
+                                                  device.dB,
+                                                  d_beta,
+                                                  device.dC,
+                                                  device.dD,
+                                                  device.dWorkspace,
+                                                  &stream,
+                                                  1),
+                                HIPSPARSE_STATUS_INVALID_VALUE);
+
+        EXPECT_HIPSPARSE_STATUS(
+            hipsparseLtSetPointerMode(handle, HIPSPARSE_POINTER_MODE_DEVICE),
+            HIPSPARSE_STATUS_SUCCESS);
+        EXPECT_HIPSPARSE_STATUS(hipsparseLtMatmul(handle,
+                                                  device.plan,
+                                                  d_alpha,
+                                                  device.dA_compressed,
+                                                  device.dB,
+                                                  d_beta,
+                                                  device.dC,
+                                                  device.dD,
+                                                  device.dWorkspace,
+                                                  &stream,
+                                                  1),
+                                HIPSPARSE_STATUS_SUCCESS);
+        CHECK_HIP_ERROR(hipStreamSynchronize(stream));
+
+        host_vector<To> hD(arg.M * arg.N);
+        host_vector<To> hD_ref(arg.M * arg.N);
+        CHECK_HIP_ERROR(hD.transfer_from(device.dD));
+        CHECK_HIP_ERROR(hD_ref.transfer_from(host.dD));
+        for(size_t i = 0; i < hD.size(); i++)
+        {
+            // the element of C at the position of D, C may be stored in the other order
+            size_t ic  = host.orderC == host.orderD ? i : i % host.ldd * host.ldc + i / host.ldd;
+            double ref = double(hD_ref[i]);
+            double c   = std::abs(double(h_beta) * double(host.hC[ic]));
+            double tol = std::is_same<To, int8_t>{}
+                             ? ulp
+                             : 2 * ulp * std::max({std::abs(ref), c, 1.0});
+            ASSERT_NEAR(ref, double(hD[i]), tol) << "at " << i << ", beta " << h_beta;
+        }
+    }
+
+    CHECK_HIP_ERROR(hipStreamDestroy(stream));
+}
+
+template <typename Ti, typename To, typename Tc>
+void testing_spmm_workspace_pool(const Arguments& arg)
+{
+    using Talpha = float;
+
+    constexpr int groups  = 2;
+    Talpha        h_alpha = arg.get_alpha<Talpha>();
+    Talpha        h_beta  = arg.get_beta<Talpha>();
+
+    hipsparselt_local_handle handle{arg};
+    hipStream_t              stream;
+    CHECK_HIP_ERROR(hipStreamCreate(&stream));
+
+    size_t pool_size = 1;
+    EXPECT_HIPSPARSE_STATUS(hipsparseLtGetWorkspacePoolSize(handle, &pool_size),
+                            HIPSPARSE_STATUS_SUCCESS);
+    EXPECT_EQ(pool_size, 0);
+    EXPECT_HIPSPARSE_STATUS(hipsparseLtSetWorkspacePool(handle, 2),
+                            HIPSPARSE_STATUS_INVALID_VALUE);
+    EXPECT_HIPSPARSE_STATUS(hipsparseLtSetWorkspacePool(handle, 1), HIPSPARSE_STATUS_SUCCESS);
+
+    // The plans are initialized with the pool enabled, it grows to the larger of them.
+    std::vector<std::unique_ptr<testing_spmm_group<Ti, To>>> group;
+    size_t                                                   max_workspace_size = 0;
+    for(int g = 0; g < groups; g++)
+    {
+        group.emplace_back(
+            std::make_unique<testing_spmm_group<Ti, To>>(arg, handle, arg.M * (g + 1)));
+        auto& p            = *group.back();
+        max_workspace_size = std::max(max_workspace_size, p.bytes.workspace);
+        CHECK_DEVICE_ALLOCATION(p.memcheck());
+        p.init(handle, stream);
+
+        EXPECT_HIPSPARSE_STATUS(hipsparseLtMatmul(handle,
+                                                  p.plan,
+                                                  &h_alpha,
+                                                  p.dA_compressed,
+                                                  p.dB,
+                                                  &h_beta,
+                                                  p.dC,
+                                                  p.dD_ref,
+                                                  p.dWorkspace,
+                                                  &stream,
+                                                  1),
+                                HIPSPARSE_STATUS_SUCCESS);
+    }
+
+    for(auto& p : group)
+        EXPECT_HIPSPARSE_STATUS(hipsparseLtMatmul(handle,
+                                                  p->plan,
+                                                  &h_alpha,
+                                                  p->dA_compressed,
+                                                  p->dB,
+                                                  &h_beta,
+                                                  p->dC,
+                                                  p->dD,
+                                                  nullptr,
+                                                  &stream,
+                                                  1),
+                                HIPSPARSE_STATUS_SUCCESS);
+    CHECK_HIP_ERROR(hipStreamSynchronize(stream));
+
+    for(auto& p : group)
+        p->check(p->dD);
+
+    // One stream holds a single slice, shared by both plans. It is sized to the larger of
+    // their selected algorithms, the workspace hipsparseLtMatmulGetWorkspace() returns.
+    EXPECT_HIPSPARSE_STATUS(hipsparseLtGetWorkspacePoolSize(handle, &pool_size),
+                            HIPSPARSE_STATUS_SUCCESS);
+    EXPECT_EQ(pool_size, max_workspace_size);
+
+    EXPECT_HIPSPARSE_STATUS(hipsparseLtSetWorkspacePool(handle, 0), HIPSPARSE_STATUS_SUCCESS);
+    EXPECT_HIPSPARSE_STATUS(hipsparseLtGetWorkspacePoolSize(handle, &pool_size),
+                            HIPSPARSE_STATUS_SUCCESS);
+    EXPECT_EQ(pool_size, 0);
+
+    // Without the pool a plan which needs a workspace must be given one.
+    if(max_workspace_size != 0)
+    {
+        auto& p = *group.back();
+        EXPECT_HIPSPARSE_STATUS(hipsparseLtMatmul(handle,
+                                                  p.plan,
+                                                  &h_alpha,
+                                                  p.dA_compressed,
+                                                  p.dB,
+                                                  &h_beta,
+                                                  p.dC,
+                                                  p.dD,
+                                                  nullptr,
+                                                  &stream,
+                                                  1),
+                                HIPSPARSE_STATUS_INVALID_VALUE);
+    }
+
+    CHECK_HIP_ERROR(hipStreamDestroy(stream));
+}
+
+template <typename Ti, typename To, typename Tc>
+void testing_spmm_multi_stream(const Arguments& arg)
+{
+    using Talpha = float;
+
+    constexpr int streams = 4;
+    Talpha        h_alpha = arg.get_alpha<Talpha>();
+    Talpha        h_beta  = arg.get_beta<Talpha>();
+
+    hipsparselt_local_handle handle{arg};
+    hipStream_t              stream[streams];
+    for(auto& s : stream)
+        CHECK_HIP_ERROR(hipStreamCreate(&s));
+
+    // A matmul without a workspace of its own may be split across the streams, each part
+    // takes a slice of the pool.
+    EXPECT_HIPSPARSE_STATUS(hipsparseLtSetWorkspacePool(handle, 1), HIPSPARSE_STATUS_SUCCESS);
+
+    testing_spmm_group<Ti, To> p(arg, handle, arg.M);
+    CHECK_DEVICE_ALLOCATION(p.memcheck());
+    p.init(handle, stream[0]);
+
+    // The reference runs on stream[0] alone.
+    EXPECT_HIPSPARSE_STATUS(hipsparseLtMatmul(handle,
+                                              p.plan,
+                                              &h_alpha,
+                                              p.dA_compressed,
+                                              p.dB,
+                                              &h_beta,
+                                              p.dC,
+                                              p.dD_ref,
+                                              nullptr,
+                                              stream,
+                                              1),
+                            HIPSPARSE_STATUS_SUCCESS);
+
+    auto run = [&](void* workspace) {
+        CHECK_HIP_ERROR(hipMemsetAsync(p.dD, 0, p.M * p.N * sizeof(To), stream[0]));
+        EXPECT_HIPSPARSE_STATUS(hipsparseLtMatmul(handle,
+                                                  p.plan,
+                                                  &h_alpha,
+                                                  p.dA_compressed,
+                                                  p.dB,
+                                                  &h_beta,
+                                                  p.dC,
+                                                  p.dD,
+                                                  workspace,
+                                                  stream,
+                                                  streams),
+                                HIPSPARSE_STATUS_SUCCESS);
+
+        // The parts are joined back into stream[0].
+        CHECK_HIP_ERROR(hipStreamSynchronize(stream[0]));
+        p.check(p.dD);
+    };
+
+    // Twice, the second call runs with what the first one validated and cached.
+    for(int i = 0; i < 2; i++)
+        run(nullptr);
+
+#ifdef __HIP_PLATFORM_AMD__
+    // The workspace of the caller is split into a slice for each of the streams set by
+    // HIPSPARSELT_MATMUL_WORKSPACE_STREAMS, hipsparseLtMatmulGetWorkspace() sizes it for them.
+    EXPECT_HIPSPARSE_STATUS(hipsparseLtSetWorkspacePool(handle, 0), HIPSPARSE_STATUS_SUCCESS);
+    for(int bad : {0, 9})
+        EXPECT_HIPSPARSE_STATUS(
+            hipsparseLtMatmulAlgSetAttribute(
+                handle, p.alg_sel, HIPSPARSELT_MATMUL_WORKSPACE_STREAMS, &bad, sizeof(bad)),
+            HIPSPARSE_STATUS_INVALID_VALUE);
+
+    int workspace_streams = streams;
+    EXPECT_HIPSPARSE_STATUS(hipsparseLtMatmulAlgSetAttribute(handle,
+                                                             p.alg_sel,
+                                                             HIPSPARSELT_MATMUL_WORKSPACE_STREAMS,
+                                                             &workspace_streams,
+                                                             sizeof(workspace_streams)),
+                            HIPSPARSE_STATUS_SUCCESS);
+    size_t split_workspace_size = 0;
+    EXPECT_HIPSPARSE_STATUS(hipsparseLtMatmulGetWorkspace(handle, p.plan, &split_workspace_size),
+                            HIPSPARSE_STATUS_SUCCESS);
+    EXPECT_GE(split_workspace_size, p.bytes.workspace * streams);
+
+    device_vector<unsigned char> dSplitWorkspace(split_workspace_size);
+    CHECK_DEVICE_ALLOCATION(dSplitWorkspace.memcheck());
+    run(dSplitWorkspace);
+#endif
+
+    for(auto& s : stream)
+        CHECK_HIP_ERROR(hipStreamDestroy(s));
+}
+
+template <typename Ti, typename To, typename Tc>
+void testing_spmm_dynamic_m(const Arguments& arg)
+{
+    using Talpha = float;
+
+    Talpha h_alpha = arg.get_alpha<Talpha>();
+    Talpha h_beta  = arg.get_beta<Talpha>();
+
+    hipsparselt_local_handle handle{arg};
+    hipStream_t              stream;
+    CHECK_HIP_ERROR(hipStreamCreate(&stream));
+
+    // The structured matrix of a dynamic-M plan is B, a structured A is rejected.
+    {
+        testing_spmm_group<Ti, To>    probe(arg, handle, arg.M);
+        hipsparselt_local_matmul_plan plan(handle, probe.matmul, probe.alg_sel, 1);
+        EXPECT_HIPSPARSE_STATUS(plan.status(), HIPSPARSE_STATUS_NOT_SUPPORTED);
+    }
+
+    hipsparseOperation_t transA = char_to_hipsparselt_operation(arg.transA);
+    hipsparseOperation_t transB = char_to_hipsparselt_operation(arg.transB);
+
+    int64_t M = arg.M, N = arg.N, K = arg.K;
+
+    int64_t A_row = transA == HIPSPARSE_OPERATION_NON_TRANSPOSE ? M : K;
+    int64_t A_col = transA == HIPSPARSE_OPERATION_NON_TRANSPOSE ? K : M;
+    int64_t B_row = transB == HIPSPARSE_OPERATION_NON_TRANSPOSE ? K : N;
+    int64_t B_col = transB == HIPSPARSE_OPERATION_NON_TRANSPOSE ? N : K;
+
+    // D is column major, the rows past m a smaller M does not write are checked in place.
+    hipsparselt_local_mat_descr matA(hipsparselt_matrix_type_dense,
+                                     handle,
+                                     A_row,
+                                     A_col,
+                                     A_row,
+                                     arg.a_type,
+                                     HIPSPARSE_ORDER_COL);
+    hipsparselt_local_mat_descr matB(hipsparselt_matrix_type_structured,
+                                     handle,
+                                     B_row,
+                                     B_col,
+                                     B_row,
+                                     arg.b_type,
+                                     HIPSPARSE_ORDER_COL);
+    hipsparselt_local_mat_descr matC(
+        hipsparselt_matrix_type_dense, handle, M, N, M, arg.c_type, HIPSPARSE_ORDER_COL);
+    hipsparselt_local_mat_descr matD(
+        hipsparselt_matrix_type_dense, handle, M, N, M, arg.d_type, HIPSPARSE_ORDER_COL);
+    hipsparselt_local_matmul_descr matmul(
+        handle, transA, transB, matA, matB, matC, matD, arg.compute_type);
+    hipsparselt_local_matmul_alg_selection alg_sel(handle, matmul, HIPSPARSELT_MATMUL_ALG_DEFAULT);
+    hipsparselt_local_matmul_plan          plan_ref(handle, matmul, alg_sel);
+    hipsparselt_local_matmul_plan          plan(handle, matmul, alg_sel, 1);
+    EXPECT_HIPSPARSE_STATUS(plan_ref.status(), HIPSPARSE_STATUS_SUCCESS);
+    EXPECT_HIPSPARSE_STATUS(plan.status(), HIPSPARSE_STATUS_SUCCESS);
+
+    {
+        hipsparselt_local_matmul_plan bad(handle, matmul, alg_sel, 0);
+        EXPECT_HIPSPARSE_STATUS(bad.status(), HIPSPARSE_STATUS_INVALID_VALUE);
+    }
+
+    // The workspace of the plan covers its buckets.
+    size_t workspace_size = 0, workspace_size_ref = 0, compressed_size = 0,
+           compress_buffer_size = 0;
+    EXPECT_HIPSPARSE_STATUS(hipsparseLtMatmulGetWorkspace(handle, plan, &workspace_size),
+                            HIPSPARSE_STATUS_SUCCESS);
+    EXPECT_HIPSPARSE_STATUS(hipsparseLtMatmulGetWorkspace(handle, plan_ref, &workspace_size_ref),
+                            HIPSPARSE_STATUS_SUCCESS);
+    EXPECT_GE(workspace_size, workspace_size_ref);
+    EXPECT_HIPSPARSE_STATUS(
+        hipsparseLtSpMMACompressedSize(handle, plan, &compressed_size, &compress_buffer_size),
+        HIPSPARSE_STATUS_SUCCESS);
+
+    device_vector<Ti>            dA(M * K), dB(K * N);
+    device_vector<To>            dC(M * N), dD(M * N), dD_ref(M * N);
+    device_vector<unsigned char> dB_compressed(compressed_size);
+    device_vector<unsigned char> dB_compressBuffer(compress_buffer_size);
+    device_vector<unsigned char> dWorkspace(workspace_size);
+    CHECK_DEVICE_ALLOCATION(dA.memcheck());
+    CHECK_DEVICE_ALLOCATION(dB.memcheck());
+    CHECK_DEVICE_ALLOCATION(dC.memcheck());
+    CHECK_DEVICE_ALLOCATION(dD.memcheck());
+    CHECK_DEVICE_ALLOCATION(dD_ref.memcheck());
+    CHECK_DEVICE_ALLOCATION(dB_compressed.memcheck());
+    CHECK_DEVICE_ALLOCATION(dWorkspace.memcheck());
+
+    host_vector<Ti> hA(M * K);
+    host_vector<Ti> hB(K * N);
+    host_vector<To> hC(M * N), hD_init(M * N);
+
+    hipsparselt_seedrand();
+    hipsparselt_init<Ti>(hA, A_row, A_col, A_row, M * K, 1);
+    hipsparselt_init<Ti>(hB, B_row, B_col, B_row, K * N, 1);
+    hipsparselt_init<To>(hC, M, N, M, M * N, 1);
+    hipsparselt_init<To>(hD_init, M, N, M, M * N, 1);
+
+    CHECK_HIP_ERROR(dA.transfer_from(hA));
+    CHECK_HIP_ERROR(dB.transfer_from(hB));
+    CHECK_HIP_ERROR(dC.transfer_from(hC));
+    EXPECT_HIPSPARSE_STATUS(
+        hipsparseLtSpMMAPrune(handle, matmul, dB, dB, HIPSPARSELT_PRUNE_SPMMA_STRIP, stream),
+        HIPSPARSE_STATUS_SUCCESS);
+    EXPECT_HIPSPARSE_STATUS(
+        hipsparseLtSpMMACompress(handle, plan, dB, dB_compressed, dB_compressBuffer, stream),
+        HIPSPARSE_STATUS_SUCCESS);
+
+    EXPECT_HIPSPARSE_STATUS(hipsparseLtMatmul(handle,
+                                              plan_ref,
+                                              &h_alpha,
+                                              dA,
+                                              dB_compressed,
+                                              &h_beta,
+                                              dC,
+                                              dD_ref,
+                                              dWorkspace,
+                                              &stream,
+                                              1),
+                            HIPSPARSE_STATUS_SUCCESS);
+    host_vector<To> hD_ref(M * N);
+    CHECK_HIP_ERROR(hipStreamSynchronize(stream));
+    CHECK_HIP_ERROR(hD_ref.transfer_from(dD_ref));
+
+    // M itself, the largest bucket, a size between two buckets and the smallest bucket.
+    for(int64_t m : {M, M / 2, M / 4 + 3, int64_t(1)})
+    {
+        if(m < 1 || m > M)
+            continue;
+
+        // the search picks the algorithm of the bucket, the run after it uses it
+        for(bool search : {true, false})
+        {
+            CHECK_HIP_ERROR(dD.transfer_from(hD_init));
+            if(search)
+                EXPECT_HIPSPARSE_STATUS(hipsparseLtMatmulSearchDynamicM(handle,
+                                                                        plan,
+                                                                        m,
+                                                                        &h_alpha,
+                                                                        dA,
+                                                                        dB_compressed,
+                                                                        &h_beta,
+                                                                        dC,
+                                                                        dD,
+                                                                        dWorkspace,
+                                                                        &stream,
+                                                                        1),
+                                        HIPSPARSE_STATUS_SUCCESS);
+            else
+                EXPECT_HIPSPARSE_STATUS(hipsparseLtMatmulDynamicM(handle,
+                                                                  plan,
+                                                                  m,
+                                                                  &h_alpha,
+                                                                  dA,
+                                                                  dB_compressed,
+                                                                  &h_beta,
+                                                                  dC,
+                                                                  dD,
+                                                                  dWorkspace,
+                                                                  &stream,
+                                                                  1),
+                                        HIPSPARSE_STATUS_SUCCESS);
+            CHECK_HIP_ERROR(hipStreamSynchronize(stream));
+
+            // The first m rows are the ones of the full matmul, the others are not written.
+            host_vector<To> hD(M * N);
+            CHECK_HIP_ERROR(hD.transfer_from(dD));
+            unit_check_general<To>(m, N, M, hD_ref, hD);
+            if(m < M)
+                unit_check_general<To>(M - m, N, M, hD_init.data() + m, hD.data() + m);
+        }
+    }
+
+    // The M seen before launch the kernels kept for them again, nothing allocates.
+    std::vector<int64_t> seen;
+    for(int64_t m : {M, M / 2, M / 4 + 3, int64_t(1)})
+        if(m >= 1 && m <= M)
+            seen.push_back(m);
+
+    constexpr int     calls = 8;
+    hipsparseStatus_t status[calls];
+    hipsparselt_alloc_counter_start();
+    for(int i = 0; i < calls; i++)
+        status[i] = hipsparseLtMatmulDynamicM(handle,
+                                              plan,
+                                              seen[i % seen.size()],
+                                              &h_alpha,
+                                              dA,
+                                              dB_compressed,
+                                              &h_beta,
+                                              dC,
+                                              dD,
+                                              dWorkspace,
+                                              &stream,
+                                              1);
+    size_t allocations = hipsparselt_alloc_counter_stop();
+
+    CHECK_HIP_ERROR(hipStreamSynchronize(stream));
+    for(int i = 0; i < calls; i++)
+        EXPECT_HIPSPARSE_STATUS(status[i], HIPSPARSE_STATUS_SUCCESS);
+    EXPECT_EQ(allocations, 0) << "hipsparseLtMatmulDynamicM() allocated " << allocations
+                              << " times in " << calls << " calls with known M";
+
+    for(int64_t m : {int64_t(0), M + 1})
+        EXPECT_HIPSPARSE_STATUS(hipsparseLtMatmulDynamicM(handle,
+                                                          plan,
+                                                          m,
+                                                          &h_alpha,
+                                                          dA,
+                                                          dB_compressed,
+                                                          &h_beta,
+                                                          dC,
+                                                          dD,
+                                                          dWorkspace,
+                                                          &stream,
+                                                          1),
+                                HIPSPARSE_STATUS_INVALID_VALUE);
+
+    // A plan of a single M has no range.
+    EXPECT_HIPSPARSE_STATUS(hipsparseLtMatmulDynamicM(handle,
+                                                      plan_ref,
+                                                      M,
+                                                      &h_alpha,
+                                                      dA,
+                                                      dB_compressed,
+                                                      &h_beta,
+                                                      dC,
+                                                      dD,
+                                                      dWorkspace,
+                                                      &stream,
+                                                      1),
+                            HIPSPARSE_STATUS_INVALID_VALUE);
+
+    CHECK_HIP_ERROR(hipStreamDestroy(stream));
+}
+
+template <typename Ti, typename To, typename Tc>
+void testing_spmm_capture(const Arguments& arg)
+{
+    using Talpha = float;
+
+    Talpha h_alpha = arg.get_alpha<Talpha>();
+    Talpha h_beta  = arg.get_beta<Talpha>();
+
+    hipsparselt_local_handle handle{arg};
+    hipStream_t              stream;
+    CHECK_HIP_ERROR(hipStreamCreate(&stream));
+
+    testing_spmm_group<Ti, To> p(arg, handle, arg.M);
+    device_vector<To>          dD_update(p.M * p.N);
+    CHECK_DEVICE_ALLOCATION(p.memcheck());
+    CHECK_DEVICE_ALLOCATION(dD_update.memcheck());
+    p.init(handle, stream);
+
+    EXPECT_HIPSPARSE_STATUS(hipsparseLtMatmul(handle,
+                                              p.plan,
+                                              &h_alpha,
+                                              p.dA_compressed,
+                                              p.dB,
+                                              &h_beta,
+                                              p.dC,
+                                              p.dD_ref,
+                                              p.dWorkspace,
+                                              &stream,
+                                              1),
+                            HIPSPARSE_STATUS_SUCCESS);
+    CHECK_HIP_ERROR(hipStreamSynchronize(stream));
+
+    hipGraph_t graph;
+    CHECK_HIP_ERROR(hipGraphCreate(&graph, 0));
+
+    // A node list which is too small reports the number of nodes needed.
+    int32_t num_nodes = 0;
+    EXPECT_HIPSPARSE_STATUS(hipsparseLtMatmulCapture(handle,
+                                                     p.plan,
+                                                     &h_alpha,
+                                                     p.dA_compressed,
+                                                     p.dB,
+                                                     &h_beta,
+                                                     p.dC,
+                                                     p.dD,
+                                                     p.dWorkspace,
+                                                     graph,
+                                                     nullptr,
+                                                     0,
+                                                     nullptr,
+                                                     &num_nodes),
+                            HIPSPARSE_STATUS_INVALID_VALUE);
+    ASSERT_GT(num_nodes, 0);
+
+    std::vector<hipGraphNode_t> nodes(num_nodes);
+    EXPECT_HIPSPARSE_STATUS(hipsparseLtMatmulCapture(handle,
+                                                     p.plan,
+                                                     &h_alpha,
+                                                     p.dA_compressed,
+                                                     p.dB,
+                                                     &h_beta,
+                                                     p.dC,
+                                                     p.dD,
+                                                     p.dWorkspace,
+                                                     graph,
+                                                     nullptr,
+                                                     0,
+                                                     nodes.data(),
+                                                     &num_nodes),
+                            HIPSPARSE_STATUS_SUCCESS);
+    ASSERT_EQ(num_nodes, nodes.size());
+
+    hipGraphExec_t graph_exec;
+    CHECK_HIP_ERROR(hipGraphInstantiate(&graph_exec, graph, nullptr, nullptr, 0));
+    CHECK_HIP_ERROR(hipGraphLaunch(graph_exec, stream));
+    CHECK_HIP_ERROR(hipStreamSynchronize(stream));
+
+    p.check(p.dD);
+
+    // Point the nodes to another D without instantiating the graph again. The update only
+    // changes the arguments of the nodes, nothing runs until the graph is launched.
+    CHECK_HIP_ERROR(hipMemset(dD_update, 0, p.M * p.N * sizeof(To)));
+    EXPECT_HIPSPARSE_STATUS(hipsparseLtMatmulCaptureUpdate(handle,
+                                                           p.plan,
+                                                           &h_alpha,
+                                                           p.dA_compressed,
+                                                           p.dB,
+                                                           &h_beta,
+                                                           p.dC,
+                                                           dD_update,
+                                                           p.dWorkspace,
+                                                           graph_exec,
+                                                           nodes.data(),
+                                                           num_nodes + 1),
+                            HIPSPARSE_STATUS_INVALID_VALUE);
+    EXPECT_HIPSPARSE_STATUS(hipsparseLtMatmulCaptureUpdate(handle,
+                                                           p.plan,
+                                                           &h_alpha,
+                                                           p.dA_compressed,
+                                                           p.dB,
+                                                           &h_beta,
+                                                           p.dC,
+                                                           dD_update,
+                                                           p.dWorkspace,
+                                                           graph_exec,
+                                                           nodes.data(),
+                                                           num_nodes),
+                            HIPSPARSE_STATUS_SUCCESS);
+    CHECK_HIP_ERROR(hipDeviceSynchronize());
+    host_vector<To> hD_zero(p.M * p.N, static_cast<To>(0.0f));
+    p.check(hD_zero, dD_update);
+
+    CHECK_HIP_ERROR(hipGraphLaunch(graph_exec, stream));
+    CHECK_HIP_ERROR(hipStreamSynchronize(stream));
+    p.check(dD_update);
+
+    CHECK_HIP_ERROR(hipGraphExecDestroy(graph_exec));
+    CHECK_HIP_ERROR(hipGraphDestroy(graph));
+    CHECK_HIP_ERROR(hipStreamDestroy(stream));
+}
+
+template <typename Ti, typename To, typename Tc>
+void testing_spmm_tuning_db(const Arguments& arg)
+{
+    using Talpha = float;
+
+    Talpha h_alpha = arg.get_alpha<Talpha>();
+    Talpha h_beta  = arg.get_beta<Talpha>();
+
+    std::string db_path = hipsparselt_tempname();
+    setenv("HIPSPARSELT_TUNING_DB", db_path.c_str(), 1);
+
+    hipsparselt_local_handle handle{arg};
+    hipStream_t              stream;
+    CHECK_HIP_ERROR(hipStreamCreate(&stream));
+
+    testing_spmm_group<Ti, To> p(arg, handle, arg.M);
+    CHECK_DEVICE_ALLOCATION(p.memcheck());
+    p.init(handle, stream);
+
+    EXPECT_HIPSPARSE_STATUS(hipsparseLtMatmulSearch(handle,
+                                                    p.plan,
+                                                    &h_alpha,
+                                                    p.dA_compressed,
+                                                    p.dB,
+                                                    &h_beta,
+                                                    p.dC,
+                                                    p.dD,
+                                                    p.dWorkspace,
+                                                    &stream,
+                                                    1),
+                            HIPSPARSE_STATUS_SUCCESS);
+    CHECK_HIP_ERROR(hipStreamSynchronize(stream));
+
+    int searched_id = -1;
+    EXPECT_HIPSPARSE_STATUS(
+        hipsparseLtMatmulAlgGetAttribute(
+            handle, p.alg_sel, HIPSPARSELT_MATMUL_ALG_CONFIG_ID, &searched_id, sizeof(int)),
+        HIPSPARSE_STATUS_SUCCESS);
+
+    // The search result was written out, a new selection for the same problem starts from it.
+    std::ifstream db_file(db_path, std::ios::binary | std::ios::ate);
+    EXPECT_GT(db_file.tellg(), 0);
+
+    testing_spmm_group<Ti, To> q(arg, handle, arg.M);
+    int                        selected_id = -1;
+    EXPECT_HIPSPARSE_STATUS(
+        hipsparseLtMatmulAlgGetAttribute(
+            handle, q.alg_sel, HIPSPARSELT_MATMUL_ALG_CONFIG_ID, &selected_id, sizeof(int)),
+        HIPSPARSE_STATUS_SUCCESS);
+    EXPECT_EQ(selected_id, searched_id);
+
+    unsetenv("HIPSPARSELT_TUNING_DB");
+    std::remove(db_path.c_str());
+    std::remove((db_path + ".lock").c_str());
+    CHECK_HIP_ERROR(hipStreamDestroy(stream));
+}
+
+template <typename Ti, typename To, typename Tc>
+void testing_spmm_search_results(const Arguments& arg)
+{
+    using Talpha = float;
+
+    Talpha h_alpha = arg.get_alpha<Talpha>();
+    Talpha h_beta  = arg.get_beta<Talpha>();
+
+    hipsparselt_local_handle handle{arg};
+    hipStream_t              stream;
+    CHECK_HIP_ERROR(hipStreamCreate(&stream));
+
+    testing_spmm_group<Ti, To> p(arg, handle, arg.M);
+    CHECK_DEVICE_ALLOCATION(p.memcheck());
+    p.init(handle, stream);
+
+    // Cold runs, ranked by their median, each config timed for at least 1 ms.
+    int   flush_cache = 1;
+    int   statistic   = HIPSPARSELT_SEARCH_STATISTIC_MEDIAN;
+    float min_time    = 1.0f;
+    EXPECT_HIPSPARSE_STATUS(hipsparseLtMatmulAlgSetAttribute(handle,
+                                                             p.alg_sel,
+                                                             HIPSPARSELT_MATMUL_SEARCH_FLUSH_CACHE,
+                                                             &flush_cache,
+                                                             sizeof(flush_cache)),
+                            HIPSPARSE_STATUS_SUCCESS);
+    EXPECT_HIPSPARSE_STATUS(
+        hipsparseLtMatmulAlgSetAttribute(
+            handle, p.alg_sel, HIPSPARSELT_MATMUL_SEARCH_STATISTIC, &statistic, sizeof(statistic)),
+        HIPSPARSE_STATUS_SUCCESS);
+    EXPECT_HIPSPARSE_STATUS(
+        hipsparseLtMatmulAlgSetAttribute(
+            handle, p.alg_sel, HIPSPARSELT_MATMUL_SEARCH_MIN_TIME, &min_time, sizeof(min_time)),
+        HIPSPARSE_STATUS_SUCCESS);
+
+    EXPECT_HIPSPARSE_STATUS(hipsparseLtMatmulSearch(handle,
+                                                    p.plan,
+                                                    &h_alpha,
+                                                    p.dA_compressed,
+                                                    p.dB,
+                                                    &h_beta,
+                                                    p.dC,
+                                                    p.dD,
+                                                    p.dWorkspace,
+                                                    &stream,
+                                                    1),
+                            HIPSPARSE_STATUS_SUCCESS);
+    CHECK_HIP_ERROR(hipStreamSynchronize(stream));
+
+    int config_id = -1, config_max_id = 0;
+    EXPECT_HIPSPARSE_STATUS(
+        hipsparseLtMatmulAlgGetAttribute(
+            handle, p.alg_sel, HIPSPARSELT_MATMUL_ALG_CONFIG_ID, &config_id, sizeof(config_id)),
+        HIPSPARSE_STATUS_SUCCESS);
+    EXPECT_HIPSPARSE_STATUS(hipsparseLtMatmulAlgGetAttribute(handle,
+                                                             p.alg_sel,
+                                                             HIPSPARSELT_MATMUL_ALG_CONFIG_MAX_ID,
+                                                             &config_max_id,
+                                                             sizeof(config_max_id)),
+                            HIPSPARSE_STATUS_SUCCESS);
+    ASSERT_GT(config_max_id, 0);
+
+    std::vector<hipsparseLtMatmulSearchResult_t> results(config_max_id);
+    EXPECT_HIPSPARSE_STATUS(
+        hipsparseLtMatmulAlgGetAttribute(handle,
+                                         p.alg_sel,
+                                         HIPSPARSELT_MATMUL_SEARCH_RESULTS,
+                                         results.data(),
+                                         (config_max_id - 1) * sizeof(results[0])),
+        HIPSPARSE_STATUS_INVALID_VALUE);
+    EXPECT_HIPSPARSE_STATUS(hipsparseLtMatmulAlgGetAttribute(handle,
+                                                             p.alg_sel,
+                                                             HIPSPARSELT_MATMUL_SEARCH_RESULTS,
+                                                             results.data(),
+                                                             config_max_id * sizeof(results[0])),
+                            HIPSPARSE_STATUS_SUCCESS);
+
+    const auto& best = results[config_id];
+    EXPECT_GT(best.runs, 0);
+    EXPECT_GT(best.ms, 0.0f);
+    EXPECT_EQ(best.ms, best.median_ms);
+    EXPECT_GE(best.ms * best.runs, min_time * 0.99f);
+    for(const auto& result : results)
+    {
+        EXPECT_LE(result.min_ms, result.median_ms);
+        EXPECT_LE(result.median_ms, result.max_ms);
+    }
+
+    CHECK_HIP_ERROR(hipStreamDestroy(stream));
+}
+
 template <typename Ti,
           typename To,
           typename Tc,
@@ -575,6 +1767,16 @@ void testing_spmm(const Arguments& arg)
 
         if(arg.search)
         {
+#ifdef __HIP_PLATFORM_AMD__
+            if(arg.alg_candidates >= 0)
+                EXPECT_HIPSPARSE_STATUS(
+                    hipsparseLtMatmulAlgSetAttribute(handle,
+                                                     alg_sel,
+                                                     HIPSPARSELT_MATMUL_ALG_CANDIDATES,
+                                                     &arg.alg_candidates,
+                                                     sizeof(int)),
+                    HIPSPARSE_STATUS_SUCCESS);
+#endif
             int config_max_id = 0;
             hipsparseLtMatmulAlgGetAttribute(
                 handle, alg_sel, HIPSPARSELT_MATMUL_ALG_CONFIG_MAX_ID, &config_max_id, sizeof(int));
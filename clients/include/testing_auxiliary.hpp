@@ -1154,6 +1154,23 @@ void testing_aux_matmul_alg_init(const Arguments& arg)
 
     hipsparselt_local_matmul_alg_selection alg_sel(handle, matmul, HIPSPARSELT_MATMUL_ALG_DEFAULT);
     EXPECT_HIPSPARSE_STATUS(alg_sel.status(), HIPSPARSE_STATUS_SUCCESS);
+
+    // A destroyed alg selection can be initialized again.
+    hipsparseLtMatmulAlgSelection_t alg_sel2;
+    for(int i = 0; i < 2; i++)
+    {
+        EXPECT_HIPSPARSE_STATUS(hipsparseLtMatmulAlgSelectionInit(
+                                    handle, &alg_sel2, matmul, HIPSPARSELT_MATMUL_ALG_DEFAULT),
+                                HIPSPARSE_STATUS_SUCCESS);
+        EXPECT_HIPSPARSE_STATUS(hipsparseLtMatmulAlgSelectionDestroy(&alg_sel2),
+                                HIPSPARSE_STATUS_SUCCESS);
+    }
+    EXPECT_HIPSPARSE_STATUS(hipsparseLtMatmulAlgSelectionDestroy(nullptr),
+                            HIPSPARSE_STATUS_INVALID_VALUE);
+#ifdef __HIP_PLATFORM_AMD__
+    EXPECT_HIPSPARSE_STATUS(hipsparseLtMatmulAlgSelectionDestroy(&alg_sel2),
+                            HIPSPARSE_STATUS_INVALID_VALUE);
+#endif
 }
 
 void testing_aux_matmul_alg_assign(const Arguments& arg)
@@ -1292,10 +1309,11 @@ void testing_aux_matmul_alg_set_attr_bad_arg(const Arguments& arg)
         HIPSPARSE_STATUS_INVALID_VALUE);
 
 #ifdef __HIP_PLATFORM_AMD__
-    //TODO hip backend not support split k yet. Remove this test once hip backend support splitk
-    EXPECT_HIPSPARSE_STATUS(hipsparseLtMatmulAlgSetAttribute(
-                                handle, alg_sel, HIPSPARSELT_MATMUL_SPLIT_K, &data, sizeof(data)),
-                            HIPSPARSE_STATUS_NOT_SUPPORTED);
+    //TODO hip backend not support split k buffers yet. Remove this test once it does
+    EXPECT_HIPSPARSE_STATUS(
+        hipsparseLtMatmulAlgSetAttribute(
+            handle, alg_sel, HIPSPARSELT_MATMUL_SPLIT_K_BUFFERS, &data, sizeof(data)),
+        HIPSPARSE_STATUS_NOT_SUPPORTED);
 #endif
 
     EXPECT_HIPSPARSE_STATUS(
@@ -1317,6 +1335,298 @@ void testing_aux_matmul_alg_set_attr_bad_arg(const Arguments& arg)
         hipsparseLtMatmulAlgSetAttribute(
             handle, alg_sel, HIPSPARSELT_MATMUL_ALG_CONFIG_MAX_ID, &data, sizeof(data)),
         HIPSPARSE_STATUS_INVALID_VALUE);
+
+#ifdef __HIP_PLATFORM_AMD__
+    data = -1;
+    EXPECT_HIPSPARSE_STATUS(
+        hipsparseLtMatmulAlgSetAttribute(
+            handle, alg_sel, HIPSPARSELT_MATMUL_ALG_CANDIDATES, &data, sizeof(data)),
+        HIPSPARSE_STATUS_INVALID_VALUE);
+
+    data = 5;
+    EXPECT_HIPSPARSE_STATUS(
+        hipsparseLtMatmulAlgSetAttribute(
+            handle, alg_sel, HIPSPARSELT_MATMUL_SEARCH_STATISTIC, &data, sizeof(data)),
+        HIPSPARSE_STATUS_INVALID_VALUE);
+
+    data = 2;
+    EXPECT_HIPSPARSE_STATUS(
+        hipsparseLtMatmulAlgSetAttribute(
+            handle, alg_sel, HIPSPARSELT_MATMUL_SEARCH_FLUSH_CACHE, &data, sizeof(data)),
+        HIPSPARSE_STATUS_INVALID_VALUE);
+
+    float min_time = -1.0f;
+    EXPECT_HIPSPARSE_STATUS(
+        hipsparseLtMatmulAlgSetAttribute(
+            handle, alg_sel, HIPSPARSELT_MATMUL_SEARCH_MIN_TIME, &min_time, sizeof(min_time)),
+        HIPSPARSE_STATUS_INVALID_VALUE);
+
+    hipsparseLtMatmulSearchResult_t result{};
+    EXPECT_HIPSPARSE_STATUS(
+        hipsparseLtMatmulAlgSetAttribute(
+            handle, alg_sel, HIPSPARSELT_MATMUL_SEARCH_RESULTS, &result, sizeof(result)),
+        HIPSPARSE_STATUS_INVALID_VALUE);
+
+    data = -1;
+    EXPECT_HIPSPARSE_STATUS(hipsparseLtMatmulAlgSetAttribute(
+                                handle, alg_sel, HIPSPARSELT_MATMUL_SPLIT_K, &data, sizeof(data)),
+                            HIPSPARSE_STATUS_INVALID_VALUE);
+
+    data = 2;
+    EXPECT_HIPSPARSE_STATUS(
+        hipsparseLtMatmulAlgSetAttribute(
+            handle, alg_sel, HIPSPARSELT_MATMUL_SPLIT_K_MODE, &data, sizeof(data)),
+        HIPSPARSE_STATUS_INVALID_VALUE);
+
+    EXPECT_HIPSPARSE_STATUS(
+        hipsparseLtMatmulAlgSetAttribute(
+            handle, alg_sel, HIPSPARSELT_MATMUL_ATOMICS_MODE, &data, sizeof(data)),
+        HIPSPARSE_STATUS_INVALID_VALUE);
+#endif
+}
+
+void testing_aux_matmul_alg_split_k(const Arguments& arg)
+{
+    const int64_t M = 128;
+    const int64_t N = 128;
+    const int64_t K = 128;
+
+    const int64_t lda = 128;
+    const int64_t ldb = 128;
+    const int64_t ldc = 128;
+
+    const hipsparseOperation_t opA = HIPSPARSE_OPERATION_TRANSPOSE;
+    const hipsparseOperation_t opB = HIPSPARSE_OPERATION_NON_TRANSPOSE;
+
+    hipsparselt_local_handle handle{arg};
+
+    hipsparselt_local_mat_descr matA(
+        hipsparselt_matrix_type_structured, handle, K, M, lda, arg.a_type, HIPSPARSE_ORDER_COL);
+    EXPECT_HIPSPARSE_STATUS(matA.status(), HIPSPARSE_STATUS_SUCCESS);
+
+    hipsparselt_local_mat_descr matB(
+        hipsparselt_matrix_type_dense, handle, K, N, ldb, arg.b_type, HIPSPARSE_ORDER_COL);
+    EXPECT_HIPSPARSE_STATUS(matB.status(), HIPSPARSE_STATUS_SUCCESS);
+
+    hipsparselt_local_mat_descr matC(
+        hipsparselt_matrix_type_dense, handle, M, N, ldc, arg.c_type, HIPSPARSE_ORDER_COL);
+    EXPECT_HIPSPARSE_STATUS(matC.status(), HIPSPARSE_STATUS_SUCCESS);
+
+    hipsparselt_local_mat_descr matD(
+        hipsparselt_matrix_type_dense, handle, M, N, ldc, arg.d_type, HIPSPARSE_ORDER_COL);
+    EXPECT_HIPSPARSE_STATUS(matD.status(), HIPSPARSE_STATUS_SUCCESS);
+
+    hipsparselt_local_matmul_descr matmul(
+        handle, opA, opB, matA, matB, matC, matD, arg.compute_type);
+    EXPECT_HIPSPARSE_STATUS(matmul.status(), HIPSPARSE_STATUS_SUCCESS);
+
+    hipsparselt_local_matmul_alg_selection alg_sel(handle, matmul, HIPSPARSELT_MATMUL_ALG_DEFAULT);
+    EXPECT_HIPSPARSE_STATUS(alg_sel.status(), HIPSPARSE_STATUS_SUCCESS);
+
+#ifdef __HIP_PLATFORM_AMD__
+    int atomics = -1, config_max_id = 0, all_config_max_id = 0;
+    EXPECT_HIPSPARSE_STATUS(
+        hipsparseLtMatmulAlgGetAttribute(
+            handle, alg_sel, HIPSPARSELT_MATMUL_ATOMICS_MODE, &atomics, sizeof(atomics)),
+        HIPSPARSE_STATUS_SUCCESS);
+    EXPECT_EQ(atomics, HIPSPARSELT_ATOMICS_ALLOWED);
+    EXPECT_HIPSPARSE_STATUS(hipsparseLtMatmulAlgGetAttribute(handle,
+                                                             alg_sel,
+                                                             HIPSPARSELT_MATMUL_ALG_CONFIG_MAX_ID,
+                                                             &all_config_max_id,
+                                                             sizeof(all_config_max_id)),
+                            HIPSPARSE_STATUS_SUCCESS);
+    ASSERT_GT(all_config_max_id, 0);
+
+    // Until it is set, the split-K factor is the one of the selected config.
+    std::vector<int> factors;
+    for(int config_id = 0; config_id < all_config_max_id; config_id++)
+    {
+        int split_k = 0, split_k_mode = -1;
+        EXPECT_HIPSPARSE_STATUS(
+            hipsparseLtMatmulAlgSetAttribute(
+                handle, alg_sel, HIPSPARSELT_MATMUL_ALG_CONFIG_ID, &config_id, sizeof(config_id)),
+            HIPSPARSE_STATUS_SUCCESS);
+        EXPECT_HIPSPARSE_STATUS(
+            hipsparseLtMatmulAlgGetAttribute(
+                handle, alg_sel, HIPSPARSELT_MATMUL_SPLIT_K, &split_k, sizeof(split_k)),
+            HIPSPARSE_STATUS_SUCCESS);
+        EXPECT_HIPSPARSE_STATUS(hipsparseLtMatmulAlgGetAttribute(handle,
+                                                                 alg_sel,
+                                                                 HIPSPARSELT_MATMUL_SPLIT_K_MODE,
+                                                                 &split_k_mode,
+                                                                 sizeof(split_k_mode)),
+                                HIPSPARSE_STATUS_SUCCESS);
+        EXPECT_GE(split_k, 1);
+        EXPECT_TRUE(split_k_mode == HIPSPARSELT_SPLIT_K_MODE_ONE_KERNEL
+                    || split_k_mode == HIPSPARSELT_SPLIT_K_MODE_TWO_KERNELS);
+        if(std::find(factors.begin(), factors.end(), split_k) == factors.end())
+            factors.push_back(split_k);
+    }
+
+    // Setting a factor keeps its configs only, the plan makes room for their reduction.
+    int split_k = factors.back();
+    EXPECT_HIPSPARSE_STATUS(
+        hipsparseLtMatmulAlgSetAttribute(
+            handle, alg_sel, HIPSPARSELT_MATMUL_SPLIT_K, &split_k, sizeof(split_k)),
+        HIPSPARSE_STATUS_SUCCESS);
+    EXPECT_HIPSPARSE_STATUS(hipsparseLtMatmulAlgGetAttribute(handle,
+                                                             alg_sel,
+                                                             HIPSPARSELT_MATMUL_ALG_CONFIG_MAX_ID,
+                                                             &config_max_id,
+                                                             sizeof(config_max_id)),
+                            HIPSPARSE_STATUS_SUCCESS);
+    EXPECT_GT(config_max_id, 0);
+    {
+        hipsparselt_local_matmul_plan plan(handle, matmul, alg_sel);
+        EXPECT_HIPSPARSE_STATUS(plan.status(), HIPSPARSE_STATUS_SUCCESS);
+        size_t workspace_size = 0;
+        EXPECT_HIPSPARSE_STATUS(hipsparseLtMatmulGetWorkspace(handle, plan, &workspace_size),
+                                HIPSPARSE_STATUS_SUCCESS);
+    }
+
+    // A factor without configs is refused and the previous one is kept.
+    int no_split_k = static_cast<int>(K) + 1;
+    EXPECT_HIPSPARSE_STATUS(
+        hipsparseLtMatmulAlgSetAttribute(
+            handle, alg_sel, HIPSPARSELT_MATMUL_SPLIT_K, &no_split_k, sizeof(no_split_k)),
+        HIPSPARSE_STATUS_NOT_SUPPORTED);
+    EXPECT_HIPSPARSE_STATUS(
+        hipsparseLtMatmulAlgGetAttribute(
+            handle, alg_sel, HIPSPARSELT_MATMUL_SPLIT_K, &no_split_k, sizeof(no_split_k)),
+        HIPSPARSE_STATUS_SUCCESS);
+    EXPECT_EQ(no_split_k, split_k);
+
+    // 0 brings all factors back.
+    split_k = 0;
+    EXPECT_HIPSPARSE_STATUS(
+        hipsparseLtMatmulAlgSetAttribute(
+            handle, alg_sel, HIPSPARSELT_MATMUL_SPLIT_K, &split_k, sizeof(split_k)),
+        HIPSPARSE_STATUS_SUCCESS);
+    EXPECT_HIPSPARSE_STATUS(hipsparseLtMatmulAlgGetAttribute(handle,
+                                                             alg_sel,
+                                                             HIPSPARSELT_MATMUL_ALG_CONFIG_MAX_ID,
+                                                             &config_max_id,
+                                                             sizeof(config_max_id)),
+                            HIPSPARSE_STATUS_SUCCESS);
+    EXPECT_EQ(config_max_id, all_config_max_id);
+
+    // Configs without atomics are always left.
+    atomics = HIPSPARSELT_ATOMICS_NOT_ALLOWED;
+    EXPECT_HIPSPARSE_STATUS(
+        hipsparseLtMatmulAlgSetAttribute(
+            handle, alg_sel, HIPSPARSELT_MATMUL_ATOMICS_MODE, &atomics, sizeof(atomics)),
+        HIPSPARSE_STATUS_SUCCESS);
+#else
+    int atomics = 0;
+    EXPECT_HIPSPARSE_STATUS(
+        hipsparseLtMatmulAlgSetAttribute(
+            handle, alg_sel, HIPSPARSELT_MATMUL_ATOMICS_MODE, &atomics, sizeof(atomics)),
+        HIPSPARSE_STATUS_NOT_SUPPORTED);
+#endif
+}
+
+void testing_aux_matmul_alg_candidates(const Arguments& arg)
+{
+    const int64_t M = 128;
+    const int64_t N = 128;
+    const int64_t K = 128;
+
+    const int64_t lda = 128;
+    const int64_t ldb = 128;
+    const int64_t ldc = 128;
+
+    const hipsparseOperation_t opA = HIPSPARSE_OPERATION_TRANSPOSE;
+    const hipsparseOperation_t opB = HIPSPARSE_OPERATION_NON_TRANSPOSE;
+
+    hipsparselt_local_handle handle{arg};
+
+    hipsparselt_local_mat_descr matA(
+        hipsparselt_matrix_type_structured, handle, K, M, lda, arg.a_type, HIPSPARSE_ORDER_COL);
+    EXPECT_HIPSPARSE_STATUS(matA.status(), HIPSPARSE_STATUS_SUCCESS);
+
+    hipsparselt_local_mat_descr matB(
+        hipsparselt_matrix_type_dense, handle, K, N, ldb, arg.b_type, HIPSPARSE_ORDER_COL);
+    EXPECT_HIPSPARSE_STATUS(matB.status(), HIPSPARSE_STATUS_SUCCESS);
+
+    hipsparselt_local_mat_descr matC(
+        hipsparselt_matrix_type_dense, handle, M, N, ldc, arg.c_type, HIPSPARSE_ORDER_COL);
+    EXPECT_HIPSPARSE_STATUS(matC.status(), HIPSPARSE_STATUS_SUCCESS);
+
+    hipsparselt_local_mat_descr matD(
+        hipsparselt_matrix_type_dense, handle, M, N, ldc, arg.d_type, HIPSPARSE_ORDER_COL);
+    EXPECT_HIPSPARSE_STATUS(matD.status(), HIPSPARSE_STATUS_SUCCESS);
+
+    hipsparselt_local_matmul_descr matmul(
+        handle, opA, opB, matA, matB, matC, matD, arg.compute_type);
+    EXPECT_HIPSPARSE_STATUS(matmul.status(), HIPSPARSE_STATUS_SUCCESS);
+
+    hipsparselt_local_matmul_alg_selection alg_sel(handle, matmul, HIPSPARSELT_MATMUL_ALG_DEFAULT);
+    EXPECT_HIPSPARSE_STATUS(alg_sel.status(), HIPSPARSE_STATUS_SUCCESS);
+
+    int candidates = -1, config_max_id = 0, all_config_max_id = 0, config_id = -1;
+
+#ifdef __HIP_PLATFORM_AMD__
+    EXPECT_HIPSPARSE_STATUS(
+        hipsparseLtMatmulAlgGetAttribute(
+            handle, alg_sel, HIPSPARSELT_MATMUL_ALG_CANDIDATES, &candidates, sizeof(candidates)),
+        HIPSPARSE_STATUS_SUCCESS);
+    EXPECT_EQ(candidates, 10);
+    EXPECT_HIPSPARSE_STATUS(hipsparseLtMatmulAlgGetAttribute(handle,
+                                                             alg_sel,
+                                                             HIPSPARSELT_MATMUL_ALG_CONFIG_MAX_ID,
+                                                             &config_max_id,
+                                                             sizeof(config_max_id)),
+                            HIPSPARSE_STATUS_SUCCESS);
+    EXPECT_LE(config_max_id, candidates);
+
+    // 0 collects all applicable configs, at least as many as the default.
+    candidates = 0;
+    EXPECT_HIPSPARSE_STATUS(
+        hipsparseLtMatmulAlgSetAttribute(
+            handle, alg_sel, HIPSPARSELT_MATMUL_ALG_CANDIDATES, &candidates, sizeof(candidates)),
+        HIPSPARSE_STATUS_SUCCESS);
+    EXPECT_HIPSPARSE_STATUS(hipsparseLtMatmulAlgGetAttribute(handle,
+                                                             alg_sel,
+                                                             HIPSPARSELT_MATMUL_ALG_CONFIG_MAX_ID,
+                                                             &all_config_max_id,
+                                                             sizeof(all_config_max_id)),
+                            HIPSPARSE_STATUS_SUCCESS);
+    EXPECT_GE(all_config_max_id, config_max_id);
+
+    // Any config can be selected before a plan is made with it.
+    config_id = all_config_max_id - 1;
+    EXPECT_HIPSPARSE_STATUS(
+        hipsparseLtMatmulAlgSetAttribute(
+            handle, alg_sel, HIPSPARSELT_MATMUL_ALG_CONFIG_ID, &config_id, sizeof(config_id)),
+        HIPSPARSE_STATUS_SUCCESS);
+    hipsparselt_local_matmul_plan plan(handle, matmul, alg_sel);
+    EXPECT_HIPSPARSE_STATUS(plan.status(), HIPSPARSE_STATUS_SUCCESS);
+
+    // Collecting again resets the selected config.
+    candidates = 1;
+    EXPECT_HIPSPARSE_STATUS(
+        hipsparseLtMatmulAlgSetAttribute(
+            handle, alg_sel, HIPSPARSELT_MATMUL_ALG_CANDIDATES, &candidates, sizeof(candidates)),
+        HIPSPARSE_STATUS_SUCCESS);
+    EXPECT_HIPSPARSE_STATUS(hipsparseLtMatmulAlgGetAttribute(handle,
+                                                             alg_sel,
+                                                             HIPSPARSELT_MATMUL_ALG_CONFIG_MAX_ID,
+                                                             &config_max_id,
+                                                             sizeof(config_max_id)),
+                            HIPSPARSE_STATUS_SUCCESS);
+    EXPECT_EQ(config_max_id, 1);
+    EXPECT_HIPSPARSE_STATUS(
+        hipsparseLtMatmulAlgGetAttribute(
+            handle, alg_sel, HIPSPARSELT_MATMUL_ALG_CONFIG_ID, &config_id, sizeof(config_id)),
+        HIPSPARSE_STATUS_SUCCESS);
+    EXPECT_EQ(config_id, 0);
+#else
+    EXPECT_HIPSPARSE_STATUS(
+        hipsparseLtMatmulAlgSetAttribute(
+            handle, alg_sel, HIPSPARSELT_MATMUL_ALG_CANDIDATES, &candidates, sizeof(candidates)),
+        HIPSPARSE_STATUS_NOT_SUPPORTED);
+#endif
 }
 
 void testing_aux_matmul_alg_get_attr_bad_arg(const Arguments& arg)
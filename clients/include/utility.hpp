@@ -277,7 +277,11 @@ public:
         this->m_status = hipsparseLtMatmulAlgSelectionInit(handle, &this->m_alg_sel, matmul, alg);
     }
 
-    ~hipsparselt_local_matmul_alg_selection() {}
+    ~hipsparselt_local_matmul_alg_selection()
+    {
+        if(this->m_status == HIPSPARSE_STATUS_SUCCESS)
+            hipsparseLtMatmulAlgSelectionDestroy(&this->m_alg_sel);
+    }
 
     hipsparselt_local_matmul_alg_selection(const hipsparselt_local_matmul_alg_selection&) = delete;
     hipsparselt_local_matmul_alg_selection(hipsparselt_local_matmul_alg_selection&&)      = delete;
@@ -325,6 +329,16 @@ public:
         this->m_status = hipsparseLtMatmulPlanInit(handle, &this->m_plan, matmul, alg_sel);
     }
 
+    // A plan for the matmuls of M from min_m up to the M of matmul.
+    hipsparselt_local_matmul_plan(const hipsparseLtHandle_t*             handle,
+                                  const hipsparseLtMatmulDescriptor_t*   matmul,
+                                  const hipsparseLtMatmulAlgSelection_t* alg_sel,
+                                  int64_t                                min_m)
+    {
+        this->m_status
+            = hipsparseLtMatmulPlanInitDynamicM(handle, &this->m_plan, matmul, alg_sel, min_m);
+    }
+
     ~hipsparselt_local_matmul_plan()
     {
         if(this->m_status == HIPSPARSE_STATUS_SUCCESS)
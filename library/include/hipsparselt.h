@@ -259,11 +259,71 @@ typedef enum {
    HIPSPARSELT_MATMUL_ALG_CONFIG_ID = 0,     // READ/WRITE
    HIPSPARSELT_MATMUL_ALG_CONFIG_MAX_ID = 1, // READ-ONLY
    HIPSPARSELT_MATMUL_SEARCH_ITERATIONS = 2,  // READ/WRITE
-   HIPSPARSELT_MATMUL_SPLIT_K = 3,
-   HIPSPARSELT_MATMUL_SPLIT_K_MODE = 4,
+   HIPSPARSELT_MATMUL_SPLIT_K = 3,            // READ/WRITE, int
+   HIPSPARSELT_MATMUL_SPLIT_K_MODE = 4,       // READ/WRITE, hipsparseLtSplitKMode_t
    HIPSPARSELT_MATMUL_SPLIT_K_BUFFERS = 5,
+   HIPSPARSELT_MATMUL_ALG_CANDIDATES = 6,     // READ/WRITE, not supported by the NVIDIA backend
+   HIPSPARSELT_MATMUL_SEARCH_STATISTIC = 7,   // READ/WRITE, hipsparseLtSearchStatistic_t, not supported by the NVIDIA backend
+   HIPSPARSELT_MATMUL_SEARCH_FLUSH_CACHE = 8, // READ/WRITE, int, not supported by the NVIDIA backend
+   HIPSPARSELT_MATMUL_SEARCH_MIN_TIME = 9,    // READ/WRITE, float ms, not supported by the NVIDIA backend
+   HIPSPARSELT_MATMUL_SEARCH_RESULTS = 10,    // READ-ONLY, hipsparseLtMatmulSearchResult_t per algorithm, not supported by the NVIDIA backend
+   HIPSPARSELT_MATMUL_ATOMICS_MODE = 11,      // READ/WRITE, hipsparseLtAtomicsMode_t, not supported by the NVIDIA backend
+   HIPSPARSELT_MATMUL_WORKSPACE_STREAMS = 12, // READ/WRITE, int in [1, 8], not supported by the NVIDIA backend
 } hipsparseLtMatmulAlgAttribute_t;
 
+/*! \ingroup types_module
+ *  \brief Specify how \ref hipsparseLtMatmulSearch sums up the timed runs of an algorithm.
+ */
+typedef enum {
+   HIPSPARSELT_SEARCH_STATISTIC_MEAN = 0,         /**< Mean time of the runs. */
+   HIPSPARSELT_SEARCH_STATISTIC_MEDIAN = 1,       /**< Median time of the runs. */
+   HIPSPARSELT_SEARCH_STATISTIC_TRIMMED_MEAN = 2, /**< Mean time without the fastest and the slowest 10% of the runs. */
+} hipsparseLtSearchStatistic_t;
+
+/*! \ingroup types_module
+ *  \brief Times of an algorithm measured by \ref hipsparseLtMatmulSearch, in ms.
+ *
+ *  \details
+ *  HIPSPARSELT_MATMUL_SEARCH_RESULTS is an array of one hipsparseLtMatmulSearchResult_t per
+ *  algorithm, HIPSPARSELT_MATMUL_ALG_CONFIG_MAX_ID of them.
+ */
+typedef struct {
+   float ms;        /**< Time of one run by the search statistic, 0 if the algorithm was not timed. */
+   float min_ms;    /**< Time of the fastest run. */
+   float median_ms; /**< Median time of the runs. */
+   float max_ms;    /**< Time of the slowest run. */
+   int   runs;      /**< Number of timed runs. */
+} hipsparseLtMatmulSearchResult_t;
+
+/*! \ingroup types_module
+ *  \brief Specify a phase of the startup of hipSPARSELt, before the first matmul.
+ *
+ *  \details
+ *  The \ref hipsparseLtStartupPhase_t is used in the \ref hipsparseLtGetStartupTiming function.
+ */
+typedef enum {
+   HIPSPARSELT_STARTUP_PATH_DISCOVERY = 0,       /**< Finding the directory of the kernel files. */
+   HIPSPARSELT_STARTUP_CODE_OBJECT_GLOB = 1,     /**< Listing the code object files of the device. */
+   HIPSPARSELT_STARTUP_CODE_OBJECT_LOAD = 2,     /**< Loading a code object file on a device. */
+   HIPSPARSELT_STARTUP_LIBRARY_LOAD = 3,         /**< Loading the kernel library, i.e. its solutions. */
+   HIPSPARSELT_STARTUP_DEVICE_PROPERTIES = 4,    /**< Querying the properties of a device. */
+   HIPSPARSELT_STARTUP_FIRST_SOLUTION_QUERY = 5, /**< First query of the solutions of a problem. */
+   HIPSPARSELT_STARTUP_FIRST_LAUNCH = 6,         /**< First launch of the kernels of a matmul. */
+} hipsparseLtStartupPhase_t;
+
+/*! \ingroup types_module
+ *  \brief Times of a startup phase measured by \ref hipsparseLtGetStartupTiming, in ms.
+ *
+ *  \details
+ *  A phase may happen several times, e.g. once per code object file and device, and on several threads at once,
+ *  so the total may exceed the wall time of the phase.
+ */
+typedef struct {
+   double first_ms; /**< Time of the first occurrence of the phase. */
+   double total_ms; /**< Sum of the times of all the occurrences. */
+   int    count;    /**< Number of occurrences, 0 if the phase did not happen yet. */
+} hipsparseLtStartupTiming_t;
+
 /*! \ingroup types_module
  *  \brief Specify the pruning algorithm to apply to the structured matrix before the compression.
  *
@@ -286,6 +346,18 @@ typedef enum {
    HIPSPARSELT_SPLIT_K_MODE_TWO_KERNELS = 1, /**< Use another kernel to do the final reduction */
 } hipsparseLtSplitKMode_t;
 
+/*! \ingroup types_module
+ *  \brief Specify if the algorithms may accumulate with atomics.
+ *
+ *  \details
+ *  The \ref hipsparseLtAtomicsMode_t is used by HIPSPARSELT_MATMUL_ATOMICS_MODE attribute in \ref hipsparseLtMatmulAlgAttribute_t.
+ *  Atomics make the results of a split-K algorithm depend on the order of its workgroups.
+ */
+typedef enum {
+   HIPSPARSELT_ATOMICS_NOT_ALLOWED = 0, /**< Only keep the algorithms which do not use atomics */
+   HIPSPARSELT_ATOMICS_ALLOWED = 1,     /**< Keep the algorithms which use atomics, default */
+} hipsparseLtAtomicsMode_t;
+
 // clang-format on
 
 #ifdef __cplusplus
@@ -293,16 +365,56 @@ extern "C" {
 #endif
 
 /*! \ingroup aux_module
- *  \brief Initialize hipSPARSELt for the current HIP device
+ *  \brief Initialize hipSPARSELt for all the visible HIP devices
  *
  *  \details
- *  \p hipsparseLtInitialize Initialize hipSPARSELt for the current HIP device, to avoid costly startup time at the first call on that device.
+ *  \p hipsparseLtInitialize Initialize hipSPARSELt for all the visible HIP devices at once, to avoid costly startup time at the first call on a device.
+ *  The code objects of a device are loaded by a few threads, set by the environment variable HIPSPARSELT_INIT_THREADS.
  *  Only work when using HIP backend.
  *
  */
 HIPSPARSELT_EXPORT
 void hipsparseLtInitialize();
 
+/*! \ingroup aux_module
+ *  \brief Choose whether the kernels are loaded on demand
+ *
+ *  \details
+ *  With \p enable non-zero, \p hipsparseLtSetLazyLoading makes hipSPARSELt load the code object of a kernel when a plan first selects it, instead of loading all of them at initialization.
+ *  It needs a library built with Tensile_LAZY_LIBRARY_LOADING, and takes effect if called before the first initialization (see hipsparseLtInitialize()).
+ *  The environment variable HIPSPARSELT_TENSILE_LAZY_LOAD sets the default.
+ *  Only work when using HIP backend.
+ *
+ *  @param[in]
+ *  enable  non-zero to load the kernels on demand.
+ */
+HIPSPARSELT_EXPORT
+void hipsparseLtSetLazyLoading(int enable);
+
+/*! \ingroup aux_module
+ *  \brief Get the time hipSPARSELt spent in a phase of its startup
+ *
+ *  \details
+ *  \p hipsparseLtGetStartupTiming returns the time the process spent so far in a phase of the startup of hipSPARSELt,
+ *  from finding and loading the kernels to the first matmul, e.g. to tell what the time to the first matmul goes to.
+ *  With the environment variable HIPSPARSELT_STARTUP_SUMMARY set to 1, the times of all the phases are also logged
+ *  in one line after the first matmul.
+ *  Only work when using HIP backend.
+ *
+ *  @param[in]
+ *  phase   the startup phase.
+ *
+ *  @param[out]
+ *  timing  the times of the phase, all 0 if it did not happen yet.
+ *
+ *  \retval HIPSPARSE_STATUS_SUCCESS the operation completed successfully.
+ *  \retval HIPSPARSE_STATUS_INVALID_VALUE \p timing is nullptr or \p phase is invalid.
+ *  \retval HIPSPARSE_STATUS_NOT_SUPPORTED the CUDA backend does not measure the startup.
+ */
+HIPSPARSELT_EXPORT
+hipsparseStatus_t hipsparseLtGetStartupTiming(hipsparseLtStartupPhase_t   phase,
+                                              hipsparseLtStartupTiming_t* timing);
+
 /*! \ingroup library_module
  *  \brief Retrive the version number of the hipSPARSELt library.
  *
@@ -377,6 +489,94 @@ hipsparseStatus_t hipsparseLtInit(hipsparseLtHandle_t* handle);
 HIPSPARSELT_EXPORT
 hipsparseStatus_t hipsparseLtDestroy(const hipsparseLtHandle_t* handle);
 
+/*! \ingroup library_module
+ *  \brief Specify where the alpha and beta scalars of a matrix multiplication are stored
+ *
+ *  \details
+ *  \p hipsparseLtSetPointerMode sets the pointer mode of the handle. A matrix multiplication
+ *  descriptor takes the pointer mode of its handle when it is initialized, the plans created
+ *  from it keep using that mode. With HIPSPARSE_POINTER_MODE_DEVICE, alpha and beta of
+ *  \ref hipsparseLtMatmul are device pointers read when the multiplication runs, so they can be
+ *  produced by a previous kernel on the same stream without a host synchronization.
+ *
+ *  \note
+ *  The kernels take alpha and beta by value. In HIPSPARSE_POINTER_MODE_DEVICE, each
+ *  multiplication launches two more kernels on the first stream: one fills the alpha vector
+ *  from alpha, one writes beta * C to D before the multiplication. The second one reads C and
+ *  writes D once more, which costs as much as a memory bound pass over C. beta * C is also
+ *  rounded to the type of D before alpha * A * B is added to it, so with a half or int8 D,
+ *  results may differ from HIPSPARSE_POINTER_MODE_HOST by one unit in the last place.
+ *
+ *  @param[in]
+ *  handle  hipsparselt library handle
+ *  @param[in]
+ *  mode    HIPSPARSE_POINTER_MODE_HOST or HIPSPARSE_POINTER_MODE_DEVICE
+ *
+ *  \retval HIPSPARSE_STATUS_SUCCESS the operation completed successfully.
+ *  \retval HIPSPARSE_STATUS_NOT_INITIALIZED \p handle is invalid.
+ *  \retval HIPSPARSE_STATUS_NOT_SUPPORTED \p mode is not supported by the backend.
+ */
+HIPSPARSELT_EXPORT
+hipsparseStatus_t hipsparseLtSetPointerMode(hipsparseLtHandle_t*   handle,
+                                            hipsparsePointerMode_t mode);
+
+/*! \ingroup library_module
+ *  \brief Get the pointer mode of a handle
+ *
+ *  @param[in]
+ *  handle  hipsparselt library handle
+ *  @param[out]
+ *  mode    the pointer mode
+ *
+ *  \retval HIPSPARSE_STATUS_SUCCESS the operation completed successfully.
+ *  \retval HIPSPARSE_STATUS_NOT_INITIALIZED \p handle is invalid.
+ *  \retval HIPSPARSE_STATUS_INVALID_VALUE \p mode is invalid.
+ */
+HIPSPARSELT_EXPORT
+hipsparseStatus_t hipsparseLtGetPointerMode(const hipsparseLtHandle_t* handle,
+                                            hipsparsePointerMode_t*    mode);
+
+/*! \ingroup library_module
+ *  \brief Enable or disable the workspace pool of a handle
+ *
+ *  \details
+ *  With the workspace pool enabled, \ref hipsparseLtMatmul, \ref hipsparseLtMatmulSearch and
+ *  \ref hipsparseLtMatmulGrouped accept a NULL workspace and take it from the handle instead.
+ *  The pool keeps one slice of device memory per stream, sized to the largest workspace the
+ *  selected algorithms of the plans initialized while it is enabled need, so the plans of a
+ *  handle share their workspace. A multiplication split across several streams takes the slice
+ *  of each of them, a search grows the slice of its stream to the workspace of all algorithms.
+ *  A slice is reused by the multiplications queued on its stream in stream order.
+ *
+ *  @param[in]
+ *  handle  hipsparselt library handle
+ *  @param[in]
+ *  enable  1 to enable the pool, 0 to disable it and free its memory
+ *
+ *  \retval HIPSPARSE_STATUS_SUCCESS the operation completed successfully.
+ *  \retval HIPSPARSE_STATUS_NOT_INITIALIZED \p handle is invalid.
+ *  \retval HIPSPARSE_STATUS_INVALID_VALUE \p enable is invalid.
+ *  \retval HIPSPARSE_STATUS_NOT_SUPPORTED the backend has no workspace pool.
+ */
+HIPSPARSELT_EXPORT
+hipsparseStatus_t hipsparseLtSetWorkspacePool(hipsparseLtHandle_t* handle, int enable);
+
+/*! \ingroup library_module
+ *  \brief Get the device memory held by the workspace pool of a handle
+ *
+ *  @param[in]
+ *  handle  hipsparselt library handle
+ *  @param[out]
+ *  size    bytes allocated by the pool over all streams, 0 if it is disabled
+ *
+ *  \retval HIPSPARSE_STATUS_SUCCESS the operation completed successfully.
+ *  \retval HIPSPARSE_STATUS_NOT_INITIALIZED \p handle is invalid.
+ *  \retval HIPSPARSE_STATUS_INVALID_VALUE \p size is invalid.
+ */
+HIPSPARSELT_EXPORT
+hipsparseStatus_t hipsparseLtGetWorkspacePoolSize(const hipsparseLtHandle_t* handle,
+                                                  size_t*                    size);
+
 /* matrix descriptor */
 /*! \ingroup matrix_desc_module
  *  \brief Create a descriptor for dense matrix
@@ -634,6 +834,7 @@ hipsparseStatus_t
  *  \brief Initializes the algorithm selection descriptor
  *  \details
  *  \p hipsparseLtMatmulAlgSelectionInit creates a algorithm selection descriptor.
+ *  It should be destroyed at the end using \ref hipsparseLtMatmulAlgSelectionDestroy.
  *
  *  @param[in]
  *  handle           the hipsparselt handle
@@ -675,6 +876,15 @@ hipsparseStatus_t
  *  \retval HIPSPARSE_STATUS_SUCCESS the operation completed successfully.
  *  \retval HIPSPARSE_STATUS_INVALID_VALUE \p handle , \p  algSelection , \p attribute , \p data or \p dataSize is invalid.
  *  \retval HIPSPARSE_STATUS_NOT_SUPPORTED \p attribute is not supported.
+ *
+ *  \note
+ *  Setting HIPSPARSELT_MATMUL_ALG_CANDIDATES collects the algorithms of \p algSelection again,
+ *  for the matmul descriptor it was initialized with, and resets HIPSPARSELT_MATMUL_ALG_CONFIG_ID.
+ *  So do HIPSPARSELT_MATMUL_SPLIT_K, HIPSPARSELT_MATMUL_SPLIT_K_MODE and
+ *  HIPSPARSELT_MATMUL_ATOMICS_MODE, which only keep the algorithms with that split-K factor,
+ *  reduction mode or use of atomics. A split-K factor of 0 keeps all factors again.
+ *  Until they are set, hipsparseLtMatmulAlgGetAttribute() returns the split-K factor and mode of
+ *  the selected algorithm.
  */
 HIPSPARSELT_EXPORT
 hipsparseStatus_t hipsparseLtMatmulAlgSetAttribute(const hipsparseLtHandle_t*       handle,
@@ -714,12 +924,34 @@ hipsparseStatus_t
                                      void*                                  data,
                                      size_t                                 dataSize);
 
+/*! \ingroup matmul_algo_module
+ *  \brief Destroy an algorithm selection descriptor
+ *  \details
+ *  \p hipsparseLtMatmulAlgSelectionDestroy releases the algorithms collected by
+ *  \ref hipsparseLtMatmulAlgSelectionInit. This function is the last call with a specific
+ *  algorithm selection instance, the plans initialized with it must be destroyed before.
+ *  Without it, the algorithms are released when the handle is destroyed.
+ *
+ *  @param[in]
+ *  algSelection the algorithm selection descriptor
+ *
+ *  \retval HIPSPARSE_STATUS_SUCCESS the operation completed successfully.
+ *  \retval HIPSPARSE_STATUS_INVALID_VALUE \p algSelection is invalid.
+ */
+HIPSPARSELT_EXPORT
+hipsparseStatus_t
+    hipsparseLtMatmulAlgSelectionDestroy(const hipsparseLtMatmulAlgSelection_t* algSelection);
+
 /* matmul plan */
 /*! \ingroup matmul_module
  *  \brief Determines the required workspace size.
  *  \details
  *  \p hipsparseLtMatmulGetWorkspace determines the required workspace size
- *  associated to the selected algorithm.
+ *  associated to the selected algorithm. Split-K algorithms which reduce in a second
+ *  kernel keep their partial results there. With HIPSPARSELT_MATMUL_WORKSPACE_STREAMS
+ *  set, it holds a slice for each of that many streams. hipsparseLtMatmulSearch() allocates the
+ *  workspace of the other algorithms it times itself, and may select one which needs
+ *  more: query the size again after a search.
  *
  *  @param[in]
  *  handle           hipsparselt library handle
@@ -760,6 +992,104 @@ hipsparseStatus_t hipsparseLtMatmulPlanInit(const hipsparseLtHandle_t*
                                             const hipsparseLtMatmulDescriptor_t*   matmulDescr,
                                             const hipsparseLtMatmulAlgSelection_t* algSelection);
 
+/*! \ingroup matmul_module
+ *  \brief Initializes the matrix multiplication plan descriptor for a range of M
+ *  \details
+ *  \p hipsparseLtMatmulPlanInitDynamicM creates a matrix multiplication plan descriptor whose
+ *  matmuls may have any M from \p minM up to the M of \p matmulDescr, see
+ *  \ref hipsparseLtMatmulDynamicM. The matrices A, C and D of \p matmulDescr are the ones of the
+ *  largest M, their leading dimensions and batch strides stay the same for a smaller M.
+ *  M is bucketed by powers of two, the algorithms of each bucket are selected for its M with the
+ *  attributes of \p algSelection, from the tuning database if it has that M. Attributes set on
+ *  \p algSelection later do not change the buckets.
+ *  It should be destroyed at the end using \ref hipsparseLtMatmulPlanDestroy.
+ *
+ *  \note
+ *  Only the dense matrix A may have fewer rows, the structured matrix must be B.
+ *
+ *  @param[in]
+ *  handle           hipsparselt library handle
+ *  @param[out]
+ *  plan             the matrix multiplication plan descriptor
+ *  @param[in]
+ *  matmulDescr      the matrix multiplication descriptor
+ *  @param[in]
+ *  algSelection     the algorithm selection descriptor
+ *  @param[in]
+ *  minM             the smallest M of the matmuls of the plan
+ *
+ *  \retval HIPSPARSE_STATUS_SUCCESS the operation completed successfully.
+ *  \retval HIPSPARSE_STATUS_INVALID_VALUE \p handle , \p plan , \p matmulDescr , \p algSelection or \p minM is invalid. \ref HIPSPARSELT_MAT_NUM_BATCHES from matrix A to D are inconsistent
+ *  \retval HIPSPARSE_STATUS_NOT_SUPPORTED the structured matrix is A or a bucket has no algorithm.
+ */
+HIPSPARSELT_EXPORT
+hipsparseStatus_t
+    hipsparseLtMatmulPlanInitDynamicM(const hipsparseLtHandle_t*             handle,
+                                      hipsparseLtMatmulPlan_t*               plan,
+                                      const hipsparseLtMatmulDescriptor_t*   matmulDescr,
+                                      const hipsparseLtMatmulAlgSelection_t* algSelection,
+                                      int64_t                                minM);
+
+/*! \ingroup matmul_module
+ *  \brief Writes a matrix multiplication plan descriptor to memory
+ *  \details
+ *  \p hipsparseLtMatmulPlanSerialize writes the matrix multiplication descriptor of \p plan
+ *  and the algorithms of its algorithm selection, with the selected one, to \p data, so that
+ *  \ref hipsparseLtMatmulPlanDeserialize can make the plan again, in this or in another
+ *  process, without selecting the algorithm. If \p data is a NULL pointer, the size of the
+ *  data is returned in \p dataSize.
+ *
+ *  \note
+ *  Plans with a bias vector and plans initialized by \ref hipsparseLtMatmulPlanInitDynamicM
+ *  are not supported.
+ *
+ *  @param[in]
+ *  handle           hipsparselt library handle
+ *  @param[in]
+ *  plan             the matrix multiplication plan descriptor
+ *  @param[out]
+ *  data             the memory the plan is written to, or NULL
+ *  @param[inout]
+ *  dataSize         the size of \p data in bytes, set to the size of the data written
+ *
+ *  \retval HIPSPARSE_STATUS_SUCCESS the operation completed successfully.
+ *  \retval HIPSPARSE_STATUS_INVALID_VALUE \p handle , \p plan or \p dataSize is invalid, or \p dataSize is smaller than the size of the data.
+ *  \retval HIPSPARSE_STATUS_NOT_SUPPORTED \p plan has a bias vector or a dynamic M.
+ */
+HIPSPARSELT_EXPORT
+hipsparseStatus_t hipsparseLtMatmulPlanSerialize(const hipsparseLtHandle_t*     handle,
+                                                 const hipsparseLtMatmulPlan_t* plan,
+                                                 void*                          data,
+                                                 size_t*                        dataSize);
+
+/*! \ingroup matmul_module
+ *  \brief Initializes a matrix multiplication plan descriptor from memory
+ *  \details
+ *  \p hipsparseLtMatmulPlanDeserialize creates a matrix multiplication plan descriptor from
+ *  the data written by \ref hipsparseLtMatmulPlanSerialize, with the same descriptor and
+ *  algorithms. The data must have been written on the same GPU architecture, with the same
+ *  version of the library. The algorithm selection of the plan is its own.
+ *  It should be destroyed at the end using \ref hipsparseLtMatmulPlanDestroy.
+ *
+ *  @param[in]
+ *  handle           hipsparselt library handle
+ *  @param[out]
+ *  plan             the matrix multiplication plan descriptor
+ *  @param[in]
+ *  data             the memory the plan was written to
+ *  @param[in]
+ *  dataSize         the size of \p data in bytes
+ *
+ *  \retval HIPSPARSE_STATUS_SUCCESS the operation completed successfully.
+ *  \retval HIPSPARSE_STATUS_INVALID_VALUE \p handle , \p plan or \p data is invalid, \p data is not a plan, is truncated or corrupted, or was written by another version of the library.
+ *  \retval HIPSPARSE_STATUS_ARCH_MISMATCH \p data was written for another GPU architecture.
+ */
+HIPSPARSELT_EXPORT
+hipsparseStatus_t hipsparseLtMatmulPlanDeserialize(const hipsparseLtHandle_t* handle,
+                                                   hipsparseLtMatmulPlan_t*   plan,
+                                                   const void*                data,
+                                                   size_t                     dataSize);
+
 /*! \ingroup matmul_module
  *  \brief Destroy a matrix multiplication plan descriptor
  *  \details
@@ -794,6 +1124,14 @@ hipsparseStatus_t hipsparseLtMatmulPlanDestroy(const hipsparseLtMatmulPlan_t* pl
  *  \note
  *  Currently, only supports the case where D has the same shape of C.
  *
+ *  \note
+ *  With several \p streams, a batched multiplication spreads its batches across them, and a
+ *  large one with a structured A splits N into a column block per stream. The streams start
+ *  after the work queued on streams[0], which waits for all of them. If the selected algorithm
+ *  needs a workspace, each stream needs its own slice: the workspace pool has one, a
+ *  \p workspace of the caller is split across at most HIPSPARSELT_MATMUL_WORKSPACE_STREAMS
+ *  streams, which \ref hipsparseLtMatmulGetWorkspace sizes it for.
+ *
  *  @param[in]
  *  handle      hipsparselt library handle
  *  @param[in]
@@ -811,7 +1149,8 @@ hipsparseStatus_t hipsparseLtMatmulPlanDestroy(const hipsparseLtMatmulPlan_t* pl
  *  @param[out]
  *  d_D         Pointer to the dense matrix D
  *  @param[in]
- *  workspace   Pointor to the worksapce
+ *  workspace   Pointor to the worksapce, can be NULL if the workspace pool of \p handle is
+ *              enabled, see \ref hipsparseLtSetWorkspacePool
  *  @param[in]
  *  streams     Pointer to HIP stream array for the computation
  *  @param[in]
@@ -854,8 +1193,34 @@ hipsparseStatus_t hipsparseLtMatmul(const hipsparseLtHandle_t*     handle,
  *  This function is NOT asynchronous with respect to streams[0] (blocking call)
  *
  *  \note
+ *  If the environment variable HIPSPARSELT_TUNING_DB names a file, the selected algorithm
+ *  is stored in it, and hipsparseLtMatmulAlgSelectionInit() selects it again for the same problem
+ *  on the same GPU architecture, also in other processes.
+ *
+ *  \note
  *  The number of iterations for the evaluation can be set by using
  *  hipsparseLtMatmulAlgSetAttribute() with HIPSPARSELT_MATMUL_SEARCH_ITERATIONS.
+ *  The algorithms are timed in rounds, after each round the slower half drops out and the
+ *  others run twice as often in the next one, so only the fastest ones are run that many
+ *  times.
+ *
+ *  \note
+ *  By default the runs of an algorithm are timed back to back and ranked by their mean time. With
+ *  HIPSPARSELT_MATMUL_SEARCH_FLUSH_CACHE set to 1 the L2 cache is flushed before each run, so that
+ *  the inputs are read from device memory as in most applications.
+ *  HIPSPARSELT_MATMUL_SEARCH_STATISTIC selects the median or a trimmed mean of the runs instead,
+ *  and HIPSPARSELT_MATMUL_SEARCH_MIN_TIME makes each algorithm be timed for at least that many ms.
+ *  hipsparseLtMatmulAlgGetAttribute() with HIPSPARSELT_MATMUL_SEARCH_RESULTS returns the times of
+ *  each algorithm.
+ *
+ *  \note
+ *  The algorithms evaluated are the ones collected by hipsparseLtMatmulAlgSelectionInit(),
+ *  the 10 best ranked ones by default. Setting HIPSPARSELT_MATMUL_ALG_CANDIDATES with
+ *  hipsparseLtMatmulAlgSetAttribute() collects that many again, or all applicable ones if it
+ *  is 0, before the plan is initialized. A larger number makes the search take longer.
+ *  Only that many are looked up in the library, unless HIPSPARSELT_MATMUL_SPLIT_K,
+ *  HIPSPARSELT_MATMUL_SPLIT_K_MODE or HIPSPARSELT_MATMUL_ATOMICS_MODE is set: then all
+ *  applicable ones are, and the best algorithm of each split-K factor is always kept.
  *
  *  \note
  *	The selected algorithm id can be retrieved by using
@@ -878,7 +1243,8 @@ hipsparseStatus_t hipsparseLtMatmul(const hipsparseLtHandle_t*     handle,
  *  @param[out]
  *  d_D         Pointer to the dense matrix D
  *  @param[in]
- *  workspace   Pointor to the worksapce
+ *  workspace   Pointor to the worksapce, can be NULL if the workspace pool of \p handle is
+ *              enabled, see \ref hipsparseLtSetWorkspacePool
  *  @param[in]
  *  streams     Pointer to HIP stream array for the computation
  *  @param[in]
@@ -902,6 +1268,311 @@ hipsparseStatus_t hipsparseLtMatmulSearch(const hipsparseLtHandle_t* handle,
                                           hipStream_t*               streams,
                                           int32_t                    numStreams);
 
+/*! \ingroup matmul_module
+ *  \brief Sparse matrix dense matrix multiplication of a given M
+ *
+ *  \details
+ *  \p hipsparseLtMatmulDynamicM computes the first \p m rows of D as \ref hipsparseLtMatmul,
+ *  with a plan initialized by \ref hipsparseLtMatmulPlanInitDynamicM. It runs the algorithm
+ *  selected for the smallest bucket of the plan whose M is at least \p m, so a changing M does
+ *  not need a new descriptor, algorithm selection or plan. The rows from \p m on of D are not
+ *  written, A, C and D keep the leading dimensions of the plan.
+ *
+ *  \note
+ *  This function is non blocking and executed asynchronously with respect to the host.
+ *  It may return before the actual computation has finished.
+ *
+ *  \note
+ *  The workspace must have the size \ref hipsparseLtMatmulGetWorkspace returns for the plan,
+ *  it covers all of its buckets.
+ *
+ *  @param[in]
+ *  handle      hipsparselt library handle
+ *  @param[in]
+ *  plan        Matrix multiplication plan
+ *  @param[in]
+ *  m           number of rows of A, C and D
+ *  @param[in]
+ *  alpha       scalar \f$\alpha\f$. (float)
+ *  @param[in]
+ *  d_A         Pointer to the dense matrix A
+ *  @param[in]
+ *  d_B         Pointer to the structured matrix B
+ *  @param[in]
+ *  beta        scalar \f$\beta\f$. (float)
+ *  @param[in]
+ *  d_C         Pointer to the dense matrix C
+ *  @param[out]
+ *  d_D         Pointer to the dense matrix D
+ *  @param[in]
+ *  workspace   Pointer to the workspace, can be NULL if the workspace pool of \p handle is
+ *              enabled, see \ref hipsparseLtSetWorkspacePool
+ *  @param[in]
+ *  streams     Pointer to HIP stream array for the computation
+ *  @param[in]
+ *  numStreams  Number of HIP streams in \p streams
+ *
+ *  \retval     HIPSPARSE_STATUS_SUCCESS the operation completed successfully.
+ *  \retval     HIPSPARSE_STATUS_NOT_INITIALIZED \p handle or \p plan is invalid.
+ *  \retval     HIPSPARSE_STATUS_INVALID_VALUE \p plan has no dynamic M, \p m is not in its range or \p alpha, \p d_A, \p d_B, \p beta, \p d_C , \p d_D , \p workspace \p streams or \p numStreams is invalid.
+ *  \retval     HIPSPARSE_STATUS_NOT_SUPPORTED the problem is not supported.
+ */
+HIPSPARSELT_EXPORT
+hipsparseStatus_t hipsparseLtMatmulDynamicM(const hipsparseLtHandle_t*     handle,
+                                            const hipsparseLtMatmulPlan_t* plan,
+                                            int64_t                        m,
+                                            const void*                    alpha,
+                                            const void*                    d_A,
+                                            const void*                    d_B,
+                                            const void*                    beta,
+                                            const void*                    d_C,
+                                            void*                          d_D,
+                                            void*                          workspace,
+                                            hipStream_t*                   streams,
+                                            int32_t                        numStreams);
+
+/*! \ingroup matmul_module
+ *  \brief Sparse matrix dense matrix multiplication of a given M
+ *
+ *  \details
+ *  \p hipsparseLtMatmulSearchDynamicM evaluates the algorithms of the bucket of \p m as
+ *  \ref hipsparseLtMatmulSearch, and selects the fastest one for the matmuls of that bucket.
+ *  The tuning database remembers it for the M of the bucket.
+ *
+ *  \note
+ *  This function is NOT asynchronous with respect to streams[0] (blocking call)
+ *
+ *  @param[in]
+ *  handle      hipsparselt library handle
+ *  @param[in]
+ *  plan        Matrix multiplication plan
+ *  @param[in]
+ *  m           number of rows of A, C and D
+ *  @param[in]
+ *  alpha       scalar \f$\alpha\f$. (float)
+ *  @param[in]
+ *  d_A         Pointer to the dense matrix A
+ *  @param[in]
+ *  d_B         Pointer to the structured matrix B
+ *  @param[in]
+ *  beta        scalar \f$\beta\f$. (float)
+ *  @param[in]
+ *  d_C         Pointer to the dense matrix C
+ *  @param[out]
+ *  d_D         Pointer to the dense matrix D
+ *  @param[in]
+ *  workspace   Pointer to the workspace, can be NULL if the workspace pool of \p handle is
+ *              enabled, see \ref hipsparseLtSetWorkspacePool
+ *  @param[in]
+ *  streams     Pointer to HIP stream array for the computation
+ *  @param[in]
+ *  numStreams  Number of HIP streams in \p streams
+ *
+ *  \retval     HIPSPARSE_STATUS_SUCCESS the operation completed successfully.
+ *  \retval     HIPSPARSE_STATUS_NOT_INITIALIZED \p handle or \p plan is invalid.
+ *  \retval     HIPSPARSE_STATUS_INVALID_VALUE \p plan has no dynamic M, \p m is not in its range or \p alpha, \p d_A, \p d_B, \p beta, \p d_C , \p d_D , \p workspace \p streams or \p numStreams is invalid.
+ *  \retval     HIPSPARSE_STATUS_NOT_SUPPORTED the problem is not supported.
+ */
+HIPSPARSELT_EXPORT
+hipsparseStatus_t hipsparseLtMatmulSearchDynamicM(const hipsparseLtHandle_t* handle,
+                                                  hipsparseLtMatmulPlan_t*   plan,
+                                                  int64_t                    m,
+                                                  const void*                alpha,
+                                                  const void*                d_A,
+                                                  const void*                d_B,
+                                                  const void*                beta,
+                                                  const void*                d_C,
+                                                  void*                      d_D,
+                                                  void*                      workspace,
+                                                  hipStream_t*               streams,
+                                                  int32_t                    numStreams);
+
+/*! \ingroup matmul_module
+ *  \brief Grouped sparse matrix dense matrix multiplication
+ *
+ *  \details
+ *  \p hipsparseLtMatmulGrouped computes \p groupCount independent matrix multiplications,
+ *  each one described by its own plan, as if \ref hipsparseLtMatmul was called once per group.
+ *  The groups may differ in their sizes, types and layouts, e.g. the expert GEMMs of a
+ *  mixture-of-experts layer.
+ *
+ *  \note
+ *  This function is non blocking and executed asynchronously with respect to the host.
+ *  It may return before the actual computation has finished.
+ *
+ *  \note
+ *  The groups are distributed over \p streams. All of them start after the work queued on
+ *  streams[0] and all of them have finished when the work queued on streams[0] afterwards starts.
+ *
+ *  @param[in]
+ *  handle      hipsparselt library handle
+ *  @param[in]
+ *  plans       Array of \p groupCount matrix multiplication plans
+ *  @param[in]
+ *  alpha       Array of \p groupCount pointers to the scalars \f$\alpha\f$. (float)
+ *  @param[in]
+ *  d_A         Array of \p groupCount pointers to the structured matrices A
+ *  @param[in]
+ *  d_B         Array of \p groupCount pointers to the dense matrices B
+ *  @param[in]
+ *  beta        Array of \p groupCount pointers to the scalars \f$\beta\f$. (float)
+ *  @param[in]
+ *  d_C         Array of \p groupCount pointers to the dense matrices C
+ *  @param[out]
+ *  d_D         Array of \p groupCount pointers to the dense matrices D
+ *  @param[in]
+ *  workspace   Array of \p groupCount pointers to the workspaces, can be NULL if no plan needs
+ *              a workspace or the workspace pool of \p handle is enabled
+ *  @param[in]
+ *  groupCount  Number of groups
+ *  @param[in]
+ *  streams     Pointer to HIP stream array for the computation
+ *  @param[in]
+ *  numStreams  Number of HIP streams in \p streams
+ *
+ *  \retval     HIPSPARSE_STATUS_SUCCESS the operation completed successfully.
+ *  \retval     HIPSPARSE_STATUS_NOT_INITIALIZED \p handle or one of the \p plans is invalid.
+ *  \retval     HIPSPARSE_STATUS_INVALID_VALUE \p groupCount, one of the arrays or their pointers, \p streams or \p numStreams is invalid.
+ *  \retval     HIPSPARSE_STATUS_NOT_SUPPORTED the problem of a group is not supported.
+ */
+HIPSPARSELT_EXPORT
+hipsparseStatus_t hipsparseLtMatmulGrouped(const hipsparseLtHandle_t*            handle,
+                                           const hipsparseLtMatmulPlan_t* const* plans,
+                                           const void* const*                    alpha,
+                                           const void* const*                    d_A,
+                                           const void* const*                    d_B,
+                                           const void* const*                    beta,
+                                           const void* const*                    d_C,
+                                           void* const*                          d_D,
+                                           void* const*                          workspace,
+                                           int32_t                               groupCount,
+                                           hipStream_t*                          streams,
+                                           int32_t                               numStreams);
+
+/*! \ingroup matmul_module
+ *  \brief Append a sparse matrix dense matrix multiplication to a HIP graph
+ *
+ *  \details
+ *  \p hipsparseLtMatmulCapture appends the kernels \ref hipsparseLtMatmul would launch for
+ *  the given arguments to \p graph, as a chain of kernel nodes, e.g. to build the graph of a
+ *  whole decoder step. The first node depends on \p dependencies, the nodes are returned in
+ *  \p nodes in launch order. Nothing runs on the device. The kernel arguments are copied into
+ *  the nodes, \ref hipsparseLtMatmulCaptureUpdate changes them in an executable graph.
+ *
+ *  \note
+ *  The plan must outlive the graph. A plan which needs a workspace must be given one.
+ *
+ *  \note
+ *  With HIPSPARSE_POINTER_MODE_DEVICE, the nodes of every graph captured from a plan write
+ *  alpha to the same buffer of the plan. These graphs must not run at the same time, e.g. on
+ *  two streams without an order between them; capture them from a plan each instead.
+ *
+ *  @param[in]
+ *  handle          hipsparselt library handle
+ *  @param[in]
+ *  plan            Matrix multiplication plan
+ *  @param[in]
+ *  alpha           scalar \f$\alpha\f$. (float)
+ *  @param[in]
+ *  d_A             Pointer to the structured matrix A
+ *  @param[in]
+ *  d_B             Pointer to the dense matrix B
+ *  @param[in]
+ *  beta            scalar \f$\beta\f$. (float)
+ *  @param[in]
+ *  d_C             Pointer to the dense matrix C
+ *  @param[in]
+ *  d_D             Pointer to the dense matrix D
+ *  @param[in]
+ *  workspace       Pointor to the worksapce
+ *  @param[in]
+ *  graph           the graph the kernel nodes are added to
+ *  @param[in]
+ *  dependencies    the nodes the first kernel node depends on
+ *  @param[in]
+ *  numDependencies Number of nodes in \p dependencies
+ *  @param[out]
+ *  nodes           the kernel nodes added to \p graph
+ *  @param[inout]
+ *  numNodes        the capacity of \p nodes, then the number of nodes added. If \p nodes is
+ *                  too small, the number of nodes needed and nothing is added.
+ *
+ *  \retval     HIPSPARSE_STATUS_SUCCESS the operation completed successfully.
+ *  \retval     HIPSPARSE_STATUS_NOT_INITIALIZED \p handle or \p plan is invalid.
+ *  \retval     HIPSPARSE_STATUS_INVALID_VALUE a pointer, \p workspace or \p numNodes is invalid.
+ *  \retval     HIPSPARSE_STATUS_NOT_SUPPORTED the problem is not supported.
+ */
+HIPSPARSELT_EXPORT
+hipsparseStatus_t hipsparseLtMatmulCapture(const hipsparseLtHandle_t*     handle,
+                                           const hipsparseLtMatmulPlan_t* plan,
+                                           const void*                    alpha,
+                                           const void*                    d_A,
+                                           const void*                    d_B,
+                                           const void*                    beta,
+                                           const void*                    d_C,
+                                           void*                          d_D,
+                                           void*                          workspace,
+                                           hipGraph_t                     graph,
+                                           const hipGraphNode_t*          dependencies,
+                                           size_t                         numDependencies,
+                                           hipGraphNode_t*                nodes,
+                                           int32_t*                       numNodes);
+
+/*! \ingroup matmul_module
+ *  \brief Update the kernel nodes of a captured matrix multiplication in an executable graph
+ *
+ *  \details
+ *  \p hipsparseLtMatmulCaptureUpdate points the kernel nodes \ref hipsparseLtMatmulCapture
+ *  added for \p plan to new matrices, scalars or workspace with
+ *  hipGraphExecKernelNodeSetParams(), so the graph does not have to be instantiated again.
+ *  The plan and its selected algorithm must be the ones the nodes were captured with.
+ *  Only the kernel arguments are rebuilt, from the ones kept for the plan, except in the
+ *  device pointer mode, where the matrix multiplication is captured again.
+ *
+ *  @param[in]
+ *  handle      hipsparselt library handle
+ *  @param[in]
+ *  plan        Matrix multiplication plan
+ *  @param[in]
+ *  alpha       scalar \f$\alpha\f$. (float)
+ *  @param[in]
+ *  d_A         Pointer to the structured matrix A
+ *  @param[in]
+ *  d_B         Pointer to the dense matrix B
+ *  @param[in]
+ *  beta        scalar \f$\beta\f$. (float)
+ *  @param[in]
+ *  d_C         Pointer to the dense matrix C
+ *  @param[in]
+ *  d_D         Pointer to the dense matrix D
+ *  @param[in]
+ *  workspace   Pointor to the worksapce
+ *  @param[in]
+ *  graphExec   the executable graph instantiated from the graph of the nodes
+ *  @param[in]
+ *  nodes       the nodes returned by \ref hipsparseLtMatmulCapture
+ *  @param[in]
+ *  numNodes    Number of nodes in \p nodes
+ *
+ *  \retval     HIPSPARSE_STATUS_SUCCESS the operation completed successfully.
+ *  \retval     HIPSPARSE_STATUS_NOT_INITIALIZED \p handle or \p plan is invalid.
+ *  \retval     HIPSPARSE_STATUS_INVALID_VALUE a pointer, \p workspace or \p numNodes is invalid.
+ *  \retval     HIPSPARSE_STATUS_NOT_SUPPORTED the problem is not supported.
+ */
+HIPSPARSELT_EXPORT
+hipsparseStatus_t hipsparseLtMatmulCaptureUpdate(const hipsparseLtHandle_t*     handle,
+                                                 const hipsparseLtMatmulPlan_t* plan,
+                                                 const void*                    alpha,
+                                                 const void*                    d_A,
+                                                 const void*                    d_B,
+                                                 const void*                    beta,
+                                                 const void*                    d_C,
+                                                 void*                          d_D,
+                                                 void*                          workspace,
+                                                 hipGraphExec_t                 graphExec,
+                                                 const hipGraphNode_t*          nodes,
+                                                 int32_t                        numNodes);
+
 /* helper */
 // prune
 /*! \ingroup helper_module
@@ -192,6 +192,32 @@ hipsparseOrder_t HCCOrderToHIPOrder(rocsparselt_order_ op)
     }
 }
 
+rocsparselt_pointer_mode_ HIPPointerModeToHCCPointerMode(hipsparsePointerMode_t mode)
+{
+    switch(mode)
+    {
+    case HIPSPARSE_POINTER_MODE_HOST:
+        return rocsparselt_pointer_mode_host;
+    case HIPSPARSE_POINTER_MODE_DEVICE:
+        return rocsparselt_pointer_mode_device;
+    default:
+        throw HIPSPARSE_STATUS_NOT_SUPPORTED;
+    }
+}
+
+hipsparsePointerMode_t HCCPointerModeToHIPPointerMode(rocsparselt_pointer_mode_ mode)
+{
+    switch(mode)
+    {
+    case rocsparselt_pointer_mode_host:
+        return HIPSPARSE_POINTER_MODE_HOST;
+    case rocsparselt_pointer_mode_device:
+        return HIPSPARSE_POINTER_MODE_DEVICE;
+    default:
+        throw HIPSPARSE_STATUS_NOT_SUPPORTED;
+    }
+}
+
 rocsparselt_sparsity_ HIPSparsityToRocSparseLtSparsity(hipsparseLtSparsity_t sparsity)
 {
     switch(sparsity)
@@ -352,6 +378,30 @@ hipsparseLtMatmulAlg_t RocSparseLtMatmulAlgToHIPMatmulAlg(rocsparselt_matmul_alg
     }
 }
 
+// The data of the search attributes is passed on as it is.
+static_assert((int)HIPSPARSELT_SEARCH_STATISTIC_MEAN == (int)rocsparselt_search_statistic_mean
+                  && (int)HIPSPARSELT_SEARCH_STATISTIC_MEDIAN
+                         == (int)rocsparselt_search_statistic_median
+                  && (int)HIPSPARSELT_SEARCH_STATISTIC_TRIMMED_MEAN
+                         == (int)rocsparselt_search_statistic_trimmed_mean,
+              "search statistics must match");
+static_assert(sizeof(hipsparseLtMatmulSearchResult_t) == sizeof(rocsparselt_matmul_search_result),
+              "search results must match");
+// So is the data of the split-K attributes.
+static_assert((int)HIPSPARSELT_SPLIT_K_MODE_ONE_KERNEL == (int)rocsparselt_splik_k_mode_one_kernel
+                  && (int)HIPSPARSELT_SPLIT_K_MODE_TWO_KERNELS
+                         == (int)rocsparselt_split_k_mode_two_kernels,
+              "split-K modes must match");
+static_assert((int)HIPSPARSELT_ATOMICS_NOT_ALLOWED == (int)rocsparselt_atomics_not_allowed
+                  && (int)HIPSPARSELT_ATOMICS_ALLOWED == (int)rocsparselt_atomics_allowed,
+              "atomics modes must match");
+// So are the startup phases and their times.
+static_assert((int)HIPSPARSELT_STARTUP_PATH_DISCOVERY == (int)rocsparselt_startup_path_discovery
+                  && (int)HIPSPARSELT_STARTUP_FIRST_LAUNCH == (int)rocsparselt_startup_first_launch,
+              "startup phases must match");
+static_assert(sizeof(hipsparseLtStartupTiming_t) == sizeof(rocsparselt_startup_timing),
+              "startup timings must match");
+
 rocsparselt_matmul_alg_attribute_
     HIPMatmulAlgAttributeToRocSparseLtAlgAttribute(hipsparseLtMatmulAlgAttribute_t alg)
 {
@@ -369,6 +419,20 @@ rocsparselt_matmul_alg_attribute_
         return rocsparselt_matmul_split_k_mode;
     case HIPSPARSELT_MATMUL_SPLIT_K_BUFFERS:
         return rocsparselt_matmul_split_k_buffers;
+    case HIPSPARSELT_MATMUL_ALG_CANDIDATES:
+        return rocsparselt_matmul_alg_candidates;
+    case HIPSPARSELT_MATMUL_SEARCH_STATISTIC:
+        return rocsparselt_matmul_search_statistic;
+    case HIPSPARSELT_MATMUL_SEARCH_FLUSH_CACHE:
+        return rocsparselt_matmul_search_flush_cache;
+    case HIPSPARSELT_MATMUL_SEARCH_MIN_TIME:
+        return rocsparselt_matmul_search_min_time;
+    case HIPSPARSELT_MATMUL_SEARCH_RESULTS:
+        return rocsparselt_matmul_search_results;
+    case HIPSPARSELT_MATMUL_ATOMICS_MODE:
+        return rocsparselt_matmul_atomics_mode;
+    case HIPSPARSELT_MATMUL_WORKSPACE_STREAMS:
+        return rocsparselt_matmul_workspace_streams;
     default:
         throw HIPSPARSE_STATUS_NOT_SUPPORTED;
     }
@@ -391,6 +455,20 @@ hipsparseLtMatmulAlgAttribute_t
         return HIPSPARSELT_MATMUL_SPLIT_K_MODE;
     case rocsparselt_matmul_split_k_buffers:
         return HIPSPARSELT_MATMUL_SPLIT_K_BUFFERS;
+    case rocsparselt_matmul_alg_candidates:
+        return HIPSPARSELT_MATMUL_ALG_CANDIDATES;
+    case rocsparselt_matmul_search_statistic:
+        return HIPSPARSELT_MATMUL_SEARCH_STATISTIC;
+    case rocsparselt_matmul_search_flush_cache:
+        return HIPSPARSELT_MATMUL_SEARCH_FLUSH_CACHE;
+    case rocsparselt_matmul_search_min_time:
+        return HIPSPARSELT_MATMUL_SEARCH_MIN_TIME;
+    case rocsparselt_matmul_search_results:
+        return HIPSPARSELT_MATMUL_SEARCH_RESULTS;
+    case rocsparselt_matmul_atomics_mode:
+        return HIPSPARSELT_MATMUL_ATOMICS_MODE;
+    case rocsparselt_matmul_workspace_streams:
+        return HIPSPARSELT_MATMUL_WORKSPACE_STREAMS;
     default:
         throw HIPSPARSE_STATUS_NOT_SUPPORTED;
     }
@@ -483,6 +561,59 @@ catch(...)
     return exception_to_hipsparselt_status();
 }
 
+hipsparseStatus_t hipsparseLtSetPointerMode(hipsparseLtHandle_t*   handle,
+                                            hipsparsePointerMode_t mode)
+try
+{
+    return RocSparseLtStatusToHIPStatus(rocsparselt_set_pointer_mode(
+        (rocsparselt_handle*)handle, HIPPointerModeToHCCPointerMode(mode)));
+}
+catch(...)
+{
+    return exception_to_hipsparselt_status();
+}
+
+hipsparseStatus_t hipsparseLtGetPointerMode(const hipsparseLtHandle_t* handle,
+                                            hipsparsePointerMode_t*    mode)
+try
+{
+    if(mode == nullptr)
+        return HIPSPARSE_STATUS_INVALID_VALUE;
+
+    rocsparselt_pointer_mode rocMode;
+    RETURN_IF_ROCSPARSELT_ERROR(
+        rocsparselt_get_pointer_mode((const rocsparselt_handle*)handle, &rocMode));
+    *mode = HCCPointerModeToHIPPointerMode(rocMode);
+    return HIPSPARSE_STATUS_SUCCESS;
+}
+catch(...)
+{
+    return exception_to_hipsparselt_status();
+}
+
+hipsparseStatus_t hipsparseLtSetWorkspacePool(hipsparseLtHandle_t* handle, int enable)
+try
+{
+    return RocSparseLtStatusToHIPStatus(
+        rocsparselt_set_workspace_pool((rocsparselt_handle*)handle, enable));
+}
+catch(...)
+{
+    return exception_to_hipsparselt_status();
+}
+
+hipsparseStatus_t hipsparseLtGetWorkspacePoolSize(const hipsparseLtHandle_t* handle,
+                                                  size_t*                    size)
+try
+{
+    return RocSparseLtStatusToHIPStatus(
+        rocsparselt_get_workspace_pool_size((const rocsparselt_handle*)handle, size));
+}
+catch(...)
+{
+    return exception_to_hipsparselt_status();
+}
+
 /* matrix descriptor */
 // dense matrix
 hipsparseStatus_t hipsparseLtDenseDescriptorInit(const hipsparseLtHandle_t*  handle,
@@ -713,6 +844,18 @@ catch(...)
     return exception_to_hipsparselt_status();
 }
 
+hipsparseStatus_t
+    hipsparseLtMatmulAlgSelectionDestroy(const hipsparseLtMatmulAlgSelection_t* algSelection)
+try
+{
+    return RocSparseLtStatusToHIPStatus(rocsparselt_matmul_alg_selection_destroy(
+        (const rocsparselt_matmul_alg_selection*)algSelection));
+}
+catch(...)
+{
+    return exception_to_hipsparselt_status();
+}
+
 /* matmul plan */
 hipsparseStatus_t hipsparseLtMatmulGetWorkspace(const hipsparseLtHandle_t*     handle,
                                                 const hipsparseLtMatmulPlan_t* plan,
@@ -744,6 +887,60 @@ catch(...)
     return exception_to_hipsparselt_status();
 }
 
+hipsparseStatus_t
+    hipsparseLtMatmulPlanInitDynamicM(const hipsparseLtHandle_t*             handle,
+                                      hipsparseLtMatmulPlan_t*               plan,
+                                      const hipsparseLtMatmulDescriptor_t*   matmulDescr,
+                                      const hipsparseLtMatmulAlgSelection_t* algSelection,
+                                      int64_t                                minM)
+try
+{
+    return RocSparseLtStatusToHIPStatus(rocsparselt_matmul_plan_init_dynamic_m(
+        (const rocsparselt_handle*)handle,
+        (rocsparselt_matmul_plan*)plan,
+        (const rocsparselt_matmul_descr*)matmulDescr,
+        (const rocsparselt_matmul_alg_selection*)algSelection,
+        minM));
+}
+catch(...)
+{
+    return exception_to_hipsparselt_status();
+}
+
+hipsparseStatus_t hipsparseLtMatmulPlanSerialize(const hipsparseLtHandle_t*     handle,
+                                                 const hipsparseLtMatmulPlan_t* plan,
+                                                 void*                          data,
+                                                 size_t*                        dataSize)
+try
+{
+    return RocSparseLtStatusToHIPStatus(
+        rocsparselt_matmul_plan_serialize((const rocsparselt_handle*)handle,
+                                          (const rocsparselt_matmul_plan*)plan,
+                                          data,
+                                          dataSize));
+}
+catch(...)
+{
+    return exception_to_hipsparselt_status();
+}
+
+hipsparseStatus_t hipsparseLtMatmulPlanDeserialize(const hipsparseLtHandle_t* handle,
+                                                   hipsparseLtMatmulPlan_t*   plan,
+                                                   const void*                data,
+                                                   size_t                     dataSize)
+try
+{
+    return RocSparseLtStatusToHIPStatus(
+        rocsparselt_matmul_plan_deserialize((const rocsparselt_handle*)handle,
+                                            (rocsparselt_matmul_plan*)plan,
+                                            data,
+                                            dataSize));
+}
+catch(...)
+{
+    return exception_to_hipsparselt_status();
+}
+
 hipsparseStatus_t hipsparseLtMatmulPlanDestroy(const hipsparseLtMatmulPlan_t* plan)
 try
 {
@@ -816,6 +1013,175 @@ catch(...)
     return exception_to_hipsparselt_status();
 }
 
+hipsparseStatus_t hipsparseLtMatmulDynamicM(const hipsparseLtHandle_t*     handle,
+                                            const hipsparseLtMatmulPlan_t* plan,
+                                            int64_t                        m,
+                                            const void*                    alpha,
+                                            const void*                    d_A,
+                                            const void*                    d_B,
+                                            const void*                    beta,
+                                            const void*                    d_C,
+                                            void*                          d_D,
+                                            void*                          workspace,
+                                            hipStream_t*                   streams,
+                                            int32_t                        numStreams)
+try
+{
+    return RocSparseLtStatusToHIPStatus(
+        rocsparselt_matmul_dynamic_m((const rocsparselt_handle*)handle,
+                                     (const rocsparselt_matmul_plan*)plan,
+                                     m,
+                                     alpha,
+                                     d_A,
+                                     d_B,
+                                     beta,
+                                     d_C,
+                                     d_D,
+                                     workspace,
+                                     streams,
+                                     numStreams));
+}
+catch(...)
+{
+    return exception_to_hipsparselt_status();
+}
+
+hipsparseStatus_t hipsparseLtMatmulSearchDynamicM(const hipsparseLtHandle_t* handle,
+                                                  hipsparseLtMatmulPlan_t*   plan,
+                                                  int64_t                    m,
+                                                  const void*                alpha,
+                                                  const void*                d_A,
+                                                  const void*                d_B,
+                                                  const void*                beta,
+                                                  const void*                d_C,
+                                                  void*                      d_D,
+                                                  void*                      workspace,
+                                                  hipStream_t*               streams,
+                                                  int32_t                    numStreams)
+try
+{
+    return RocSparseLtStatusToHIPStatus(
+        rocsparselt_matmul_search_dynamic_m((const rocsparselt_handle*)handle,
+                                            (rocsparselt_matmul_plan*)plan,
+                                            m,
+                                            alpha,
+                                            d_A,
+                                            d_B,
+                                            beta,
+                                            d_C,
+                                            d_D,
+                                            workspace,
+                                            streams,
+                                            numStreams));
+}
+catch(...)
+{
+    return exception_to_hipsparselt_status();
+}
+
+hipsparseStatus_t hipsparseLtMatmulGrouped(const hipsparseLtHandle_t*            handle,
+                                           const hipsparseLtMatmulPlan_t* const* plans,
+                                           const void* const*                    alpha,
+                                           const void* const*                    d_A,
+                                           const void* const*                    d_B,
+                                           const void* const*                    beta,
+                                           const void* const*                    d_C,
+                                           void* const*                          d_D,
+                                           void* const*                          workspace,
+                                           int32_t                               groupCount,
+                                           hipStream_t*                          streams,
+                                           int32_t                               numStreams)
+try
+{
+    return RocSparseLtStatusToHIPStatus(
+        rocsparselt_matmul_grouped((const rocsparselt_handle*)handle,
+                                   (const rocsparselt_matmul_plan* const*)plans,
+                                   alpha,
+                                   d_A,
+                                   d_B,
+                                   beta,
+                                   d_C,
+                                   d_D,
+                                   workspace,
+                                   groupCount,
+                                   streams,
+                                   numStreams));
+}
+catch(...)
+{
+    return exception_to_hipsparselt_status();
+}
+
+hipsparseStatus_t hipsparseLtMatmulCapture(const hipsparseLtHandle_t*     handle,
+                                           const hipsparseLtMatmulPlan_t* plan,
+                                           const void*                    alpha,
+                                           const void*                    d_A,
+                                           const void*                    d_B,
+                                           const void*                    beta,
+                                           const void*                    d_C,
+                                           void*                          d_D,
+                                           void*                          workspace,
+                                           hipGraph_t                     graph,
+                                           const hipGraphNode_t*          dependencies,
+                                           size_t                         numDependencies,
+                                           hipGraphNode_t*                nodes,
+                                           int32_t*                       numNodes)
+try
+{
+    return RocSparseLtStatusToHIPStatus(
+        rocsparselt_matmul_capture((const rocsparselt_handle*)handle,
+                                   (const rocsparselt_matmul_plan*)plan,
+                                   alpha,
+                                   d_A,
+                                   d_B,
+                                   beta,
+                                   d_C,
+                                   d_D,
+                                   workspace,
+                                   graph,
+                                   dependencies,
+                                   numDependencies,
+                                   nodes,
+                                   numNodes));
+}
+catch(...)
+{
+    return exception_to_hipsparselt_status();
+}
+
+hipsparseStatus_t hipsparseLtMatmulCaptureUpdate(const hipsparseLtHandle_t*     handle,
+                                                 const hipsparseLtMatmulPlan_t* plan,
+                                                 const void*                    alpha,
+                                                 const void*                    d_A,
+                                                 const void*                    d_B,
+                                                 const void*                    beta,
+                                                 const void*                    d_C,
+                                                 void*                          d_D,
+                                                 void*                          workspace,
+                                                 hipGraphExec_t                 graphExec,
+                                                 const hipGraphNode_t*          nodes,
+                                                 int32_t                        numNodes)
+try
+{
+    return RocSparseLtStatusToHIPStatus(
+        rocsparselt_matmul_capture_update((const rocsparselt_handle*)handle,
+                                          (const rocsparselt_matmul_plan*)plan,
+                                          alpha,
+                                          d_A,
+                                          d_B,
+                                          beta,
+                                          d_C,
+                                          d_D,
+                                          workspace,
+                                          graphExec,
+                                          nodes,
+                                          numNodes));
+}
+catch(...)
+{
+    return exception_to_hipsparselt_status();
+}
+
 /* helper */
 // prune
 hipsparseStatus_t hipsparseLtSpMMAPrune(const hipsparseLtHandle_t*           handle,
@@ -992,6 +1358,23 @@ void hipsparseLtInitialize()
     rocsparselt_initialize();
 }
 
+void hipsparseLtSetLazyLoading(int enable)
+{
+    rocsparselt_set_lazy_loading(enable);
+}
+
+hipsparseStatus_t hipsparseLtGetStartupTiming(hipsparseLtStartupPhase_t   phase,
+                                              hipsparseLtStartupTiming_t* timing)
+try
+{
+    return RocSparseLtStatusToHIPStatus(rocsparselt_get_startup_timing(
+        (rocsparselt_startup_phase)phase, (rocsparselt_startup_timing*)timing));
+}
+catch(...)
+{
+    return exception_to_hipsparselt_status();
+}
+
 hipsparseStatus_t hipsparseLtGetVersion(const hipsparseLtHandle_t* handle, int* version)
 try
 {
@@ -71,6 +71,94 @@ rocsparselt_status rocsparselt_init(rocsparselt_handle* handle);
  */
 rocsparselt_status rocsparselt_destroy(const rocsparselt_handle* handle);
 
+/*! \ingroup aux_module
+ *  \brief Specify where the alpha and beta scalars of a matrix multiplication are stored
+ *
+ *  \details
+ *  \p rocsparselt_set_pointer_mode sets the \ref rocsparselt_pointer_mode of the handle.
+ *  A matrix multiplication descriptor takes the pointer mode of its handle when it is
+ *  initialized, the plans created from it keep using that mode.
+ *  In \ref rocsparselt_pointer_mode_device, alpha and beta are read by the device when the
+ *  multiplication runs, so they can be produced by a previous kernel on the same stream.
+ *
+ *  \note
+ *  \ref rocsparselt_pointer_mode_device is only supported with the Tensile backend.
+ *
+ *  \note
+ *  The kernels take alpha and beta by value. In \ref rocsparselt_pointer_mode_device, each
+ *  multiplication launches two more kernels on the first stream: one fills the alpha vector
+ *  from alpha, one writes beta * C to D before the multiplication, at the cost of one more
+ *  pass over C and D. beta * C is also rounded to the type of D before alpha * A * B is added
+ *  to it, so with a half or int8 D, results may differ from
+ *  \ref rocsparselt_pointer_mode_host by one unit in the last place.
+ *
+ *  @param[in]
+ *  handle  rocsparselt library handle
+ *  mode    the pointer mode
+ *
+ *  \retval rocsparselt_status_success the operation completed successfully.
+ *  \retval rocsparselt_status_invalid_handle \p handle is invalid.
+ *  \retval rocsparselt_status_invalid_value \p mode is invalid.
+ */
+rocsparselt_status rocsparselt_set_pointer_mode(rocsparselt_handle*      handle,
+                                               rocsparselt_pointer_mode mode);
+
+/*! \ingroup aux_module
+ *  \brief Get the pointer mode of a handle
+ *
+ *  @param[in]
+ *  handle  rocsparselt library handle
+ *
+ *  @param[out]
+ *  mode    the pointer mode
+ *
+ *  \retval rocsparselt_status_success the operation completed successfully.
+ *  \retval rocsparselt_status_invalid_handle \p handle is invalid.
+ *  \retval rocsparselt_status_invalid_pointer \p mode is invalid.
+ */
+rocsparselt_status rocsparselt_get_pointer_mode(const rocsparselt_handle* handle,
+                                               rocsparselt_pointer_mode* mode);
+
+/*! \ingroup aux_module
+ *  \brief Enable or disable the workspace pool of a handle
+ *
+ *  \details
+ *  With the workspace pool enabled, \ref rocsparselt_matmul, \ref rocsparselt_matmul_search
+ *  and \ref rocsparselt_matmul_grouped accept a NULL workspace and take it from the handle
+ *  instead. The pool keeps one slice of device memory per stream, sized to the largest
+ *  workspace the selected configs of the plans initialized while it is enabled need, so the
+ *  plans of a handle share their workspace instead of each holding its own. A matmul split
+ *  across several streams takes the slice of each of them, a search grows the slice of its
+ *  stream to the workspace of all configs. A slice is reused by the matmuls queued
+ *  on its stream in stream order. Disabling the pool, or destroying the handle, waits for
+ *  the device and frees the slices.
+ *
+ *  @param[in]
+ *  handle  rocsparselt library handle
+ *  enable  1 to enable the pool, 0 to disable it
+ *
+ *  \retval rocsparselt_status_success the operation completed successfully.
+ *  \retval rocsparselt_status_invalid_handle \p handle is invalid.
+ *  \retval rocsparselt_status_invalid_value \p enable is invalid.
+ */
+rocsparselt_status rocsparselt_set_workspace_pool(rocsparselt_handle* handle, int enable);
+
+/*! \ingroup aux_module
+ *  \brief Get the device memory held by the workspace pool of a handle
+ *
+ *  @param[in]
+ *  handle  rocsparselt library handle
+ *
+ *  @param[out]
+ *  size    bytes allocated by the pool over all streams, 0 if it is disabled
+ *
+ *  \retval rocsparselt_status_success the operation completed successfully.
+ *  \retval rocsparselt_status_invalid_handle \p handle is invalid.
+ *  \retval rocsparselt_status_invalid_pointer \p size is invalid.
+ */
+rocsparselt_status rocsparselt_get_workspace_pool_size(const rocsparselt_handle* handle,
+                                                       size_t*                   size);
+
 /*! \ingroup aux_module
  *  \brief Create a descriptor for dense matrix
  *  \details
@@ -364,6 +452,22 @@ rocsparselt_status
                                          void*                                   data,
                                          size_t                                  dataSize);
 
+/*! \ingroup aux_module
+ *  \brief Destroy an algorithm selection descriptor
+ *  \details
+ *  \p rocsparselt_matmul_alg_selection_destroy releases the algorithms collected by
+ *  rocsparselt_matmul_alg_selection_init(). This function is the last call with a specific
+ *  algorithm selection instance, the plans initialized with it must be destroyed before.
+ *
+ *  @param[in]
+ *  algSelection the algorithm selection descriptor
+ *
+ *  \retval rocsparselt_status_success the operation completed successfully.
+ *  \retval rocsparselt_status_invalid_handle \p algSelection is invalid.
+ */
+rocsparselt_status
+    rocsparselt_matmul_alg_selection_destroy(const rocsparselt_matmul_alg_selection* algSelection);
+
 /*! \ingroup aux_module
  *  \brief Initializes the matrix multiplication plan descriptor
  *  \details
@@ -384,6 +488,102 @@ rocsparselt_status
                                  const rocsparselt_matmul_descr*         matmulDescr,
                                  const rocsparselt_matmul_alg_selection* algSelection);
 
+/*! \ingroup aux_module
+ *  \brief Initializes a matrix multiplication plan descriptor for a range of M
+ *  \details
+ *  \p rocsparselt_matmul_plan_init_dynamic_m creates a matrix multiplication plan descriptor
+ *  whose matmuls may have any M from \p minM up to the M of \p matmulDescr, see
+ *  rocsparselt_matmul_dynamic_m(). The matrices A, C and D of \p matmulDescr are the ones of
+ *  the largest M, their leading dimensions and batch strides stay the same for a smaller M.
+ *  M is bucketed by powers of two, the algorithms of each bucket are selected for its M with
+ *  the attributes of \p algSelection, from the tuning database if it has that M. Attributes
+ *  set on \p algSelection later do not change the buckets.
+ *  It should be destroyed at the end using rocsparselt_matmul_matmul_plan_destroy().
+ *
+ *  \note
+ *  Only the dense matrix A may have fewer rows, the structured matrix must be B.
+ *
+ *  @param[out]
+ *  plan the pointer to the matrix multiplication plan descriptor
+ *
+ *  @param[in]
+ *  minM the smallest M of the matmuls of the plan
+ *
+ *  \retval rocsparselt_status_success the operation completed successfully.
+ *  \retval rocsparselt_status_invalid_pointer \p plan pointer is invalid.
+ *  \retval rocsparselt_status_invalid_handle \p handle or \p matmulDescr or \p algSelection is invalid.
+ *  \retval rocsparselt_status_invalid_size \p minM is not in [1, M] or values of \p rocsparselt_mat_num_batches from matrix A to D are inconsistent
+ *  \retval rocsparselt_status_not_implemented the structured matrix is A or a bucket has no algorithm
+ */
+rocsparselt_status
+    rocsparselt_matmul_plan_init_dynamic_m(const rocsparselt_handle*               handle,
+                                           rocsparselt_matmul_plan*                plan,
+                                           const rocsparselt_matmul_descr*         matmulDescr,
+                                           const rocsparselt_matmul_alg_selection* algSelection,
+                                           int64_t                                 minM);
+
+/*! \ingroup aux_module
+ *  \brief Writes a matrix multiplication plan descriptor to memory
+ *  \details
+ *  \p rocsparselt_matmul_plan_serialize writes the matrix multiplication descriptor of
+ *  \p plan and the algorithms of its algorithm selection, with the selected one, to \p data,
+ *  so that rocsparselt_matmul_plan_deserialize() can make the plan again, in this or in
+ *  another process, without selecting the algorithm. If \p data is a NULL pointer, the
+ *  size of the data is returned in \p dataSize.
+ *
+ *  \note
+ *  Plans with a bias vector and plans initialized by rocsparselt_matmul_plan_init_dynamic_m()
+ *  are not supported.
+ *
+ *  @param[in]
+ *  plan the matrix multiplication plan descriptor
+ *
+ *  @param[out]
+ *  data the memory the plan is written to, or NULL
+ *
+ *  @param[inout]
+ *  dataSize the size of \p data in bytes, set to the size of the data written
+ *
+ *  \retval rocsparselt_status_success the operation completed successfully.
+ *  \retval rocsparselt_status_invalid_pointer \p dataSize pointer is invalid.
+ *  \retval rocsparselt_status_invalid_handle \p handle or \p plan is invalid.
+ *  \retval rocsparselt_status_invalid_size \p dataSize is smaller than the size of the data.
+ *  \retval rocsparselt_status_not_implemented \p plan has a bias vector or a dynamic M.
+ */
+rocsparselt_status rocsparselt_matmul_plan_serialize(const rocsparselt_handle*      handle,
+                                                     const rocsparselt_matmul_plan* plan,
+                                                     void*                          data,
+                                                     size_t*                        dataSize);
+
+/*! \ingroup aux_module
+ *  \brief Initializes a matrix multiplication plan descriptor from memory
+ *  \details
+ *  \p rocsparselt_matmul_plan_deserialize creates a matrix multiplication plan descriptor
+ *  from the data written by rocsparselt_matmul_plan_serialize(), with the same descriptor and
+ *  algorithms. The data must have been written on the same GPU architecture, with the same
+ *  version of the library. The algorithm selection of the plan is its own.
+ *  It should be destroyed at the end using rocsparselt_matmul_matmul_plan_destroy().
+ *
+ *  @param[out]
+ *  plan the pointer to the matrix multiplication plan descriptor
+ *
+ *  @param[in]
+ *  data the memory the plan was written to
+ *
+ *  @param[in]
+ *  dataSize the size of \p data in bytes
+ *
+ *  \retval rocsparselt_status_success the operation completed successfully.
+ *  \retval rocsparselt_status_invalid_pointer \p plan or \p data pointer is invalid.
+ *  \retval rocsparselt_status_invalid_handle \p handle is invalid.
+ *  \retval rocsparselt_status_invalid_value \p data is not a plan, is truncated or corrupted, or was written by another version of the library.
+ *  \retval rocsparselt_status_arch_mismatch \p data was written for another GPU architecture.
+ */
+rocsparselt_status rocsparselt_matmul_plan_deserialize(const rocsparselt_handle* handle,
+                                                       rocsparselt_matmul_plan*  plan,
+                                                       const void*               data,
+                                                       size_t                    dataSize);
+
 /*! \ingroup aux_module
  *  \brief Destroy a matrix multiplication plan descriptor
  *  \details
@@ -37,15 +37,49 @@
 extern "C" {
 #endif
 
-/*! \brief Initialize rocSPARSELt on the current HIP device, to avoid costly startup time at the first call on that device.
+/*! \brief Initialize rocSPARSELt on all the visible HIP devices, to avoid costly startup time at the first call on a device.
     \details
 
     Calling `rocsparselt_initialize()`` allows upfront intialization including device specific kernel setup,
     otherwise this function is automatically called on the first function call that requires these initializations (mainly SPMM).
+    The devices are initialized at once, and the code objects of a device are loaded by a few threads
+    (set by the environment variable HIPSPARSELT_INIT_THREADS). The time of each phase is logged at the info level.
 
  ******************************************************************************/
 void rocsparselt_initialize(void);
 
+/*! \brief Choose whether Tensile code objects are loaded on demand.
+    \details
+
+    With \p enable non-zero, the code object of a kernel is loaded when a plan first selects it,
+    instead of loading all of them at initialization. It needs a library built with Tensile_LAZY_LIBRARY_LOADING,
+    otherwise all the code objects are loaded. It takes effect if called before the first initialization,
+    and overrides the environment variable HIPSPARSELT_TENSILE_LAZY_LOAD.
+
+ ******************************************************************************/
+void rocsparselt_set_lazy_loading(int enable);
+
+/*! \brief Get the time rocSPARSELt spent in a phase of its startup.
+    \details
+
+    The times are measured for the process, from finding and loading the kernels to the first matmul.
+    With the environment variable HIPSPARSELT_STARTUP_SUMMARY set to 1, the times of all the phases are
+    also logged in one line after the first matmul.
+
+    @param[in]
+    phase   the startup phase.
+
+    @param[out]
+    timing  the times of the phase, all 0 if it did not happen yet.
+
+    \retval rocsparselt_status_success the operation completed successfully.
+    \retval rocsparselt_status_invalid_pointer \p timing is nullptr.
+    \retval rocsparselt_status_invalid_value \p phase is invalid.
+
+ ******************************************************************************/
+rocsparselt_status rocsparselt_get_startup_timing(rocsparselt_startup_phase   phase,
+                                                  rocsparselt_startup_timing* timing);
+
 /*
 * ===========================================================================
 *    SPARSE Matrix Multiplication
@@ -56,7 +90,11 @@ void rocsparselt_initialize(void);
  *  \brief Determines the required workspace size.
  *  \details
  *  \p rocsparselt_matmul_get_workspace determines the required workspace size
- *  associated to the selected algorithm.
+ *  associated to the selected algorithm. Split-K algorithms which reduce in a second
+ *  kernel keep their partial results there. With rocsparselt_matmul_workspace_streams
+ *  set, it holds a slice for each of that many streams. rocsparselt_matmul_search() allocates the
+ *  workspace of the other algorithms it times itself, and may select one which needs
+ *  more: query the size again after a search.
  *
  *  @param[out]
  *  workspaceSize    Workspace size in bytes
@@ -90,6 +128,12 @@ rocsparselt_status rocsparselt_matmul_get_workspace(const rocsparselt_handle*
  *  \note
  *  Currently, only supports the case where D has the same shape of C.
  *
+ *  \note
+ *  With several \p streams, a batched multiplication spreads its batches across them, and a
+ *  large one with a structured A splits N into a column block per stream. If the selected
+ *  config needs a workspace, a \p workspace of the caller is split across at most
+ *  rocsparselt_matmul_workspace_streams streams, one slice each.
+ *
  *  @param[out]
  *  d_D         Pointer to the dense matrix D
  *
@@ -143,8 +187,32 @@ rocsparselt_status rocsparselt_matmul(const rocsparselt_handle*      handle,
  *  This function is NOT asynchronous with respect to streams[0] (blocking call)
  *
  *  \note
+ *  If the environment variable HIPSPARSELT_TUNING_DB names a file, the selected algorithm
+ *  is stored in it, and rocsparselt_matmul_alg_selection_init() selects it again for the same
+ *  problem on the same GPU architecture, also in other processes.
+ *
+ *  \note
  *  The number of iterations for the evaluation can be set by using
  *  rocsparselt_matmul_alg_set_attribute() with rocsparselt_matmul_search_iterations.
+ *  The algorithms are timed in rounds, after each round the slower half drops out and the
+ *  others run twice as often in the next one, so only the fastest ones are run that many
+ *  times.
+ *
+ *  \note
+ *  By default the runs of an algorithm are timed back to back and ranked by their mean time. With
+ *  rocsparselt_matmul_search_flush_cache set to 1 the L2 cache is flushed before each run, so that
+ *  the inputs are read from device memory as in most applications.
+ *  rocsparselt_matmul_search_statistic selects the median or a trimmed mean of the runs instead,
+ *  and rocsparselt_matmul_search_min_time makes each algorithm be timed for at least that many ms.
+ *  rocsparselt_matmul_alg_get_attribute() with rocsparselt_matmul_search_results returns the times
+ *  of each algorithm.
+ *
+ *  \note
+ *  The algorithms evaluated are the ones collected by rocsparselt_matmul_alg_selection_init(),
+ *  the 10 best ranked ones by default. Setting rocsparselt_matmul_alg_candidates with
+ *  rocsparselt_matmul_alg_set_attribute() collects that many again, or all applicable ones if
+ *  it is 0, before the plan is initialized. A larger number makes the search take longer.
+ *  The best algorithm of each split-K factor is always among them.
  *
  *  \note
 o*	The selected algorithm id can be retrieved by using
@@ -183,6 +251,277 @@ rocsparselt_status rocsparselt_matmul_search(const rocsparselt_handle* handle,
                                              hipStream_t*              streams,
                                              int32_t                   numStreams);
 
+/*! \ingroup spmm_module
+ *  \brief Sparse matrix dense matrix multiplication of a given M
+ *
+ *  \details
+ *  \p rocsparselt_matmul_dynamic_m computes the first \p m rows of D as \ref rocsparselt_matmul,
+ *  with a plan initialized by rocsparselt_matmul_plan_init_dynamic_m(). It runs the algorithm
+ *  selected for the smallest bucket of the plan whose M is at least \p m. The rows from \p m
+ *  on of D are not written, A, C and D keep the leading dimensions of the plan.
+ *
+ *  \note
+ *  The workspace must have the size rocsparselt_matmul_get_workspace() returns for the plan,
+ *  it covers all of its buckets.
+ *
+ *  @param[out]
+ *  d_D         Pointer to the dense matrix D
+ *
+ *  @param[in]
+ *  handle      rocsparselt library handle
+ *  plan        Matrix multiplication plan
+ *  m           number of rows of A, C and D
+ *  alpha       scalar \f$\alpha\f$. (float)
+ *  d_A         Pointer to the dense matrix A
+ *  d_B         Pointer to the structured matrix B
+ *  beta        scalar \f$\beta\f$. (float)
+ *  d_C         Pointer to the dense matrix C
+ *  workspace   Pointer to the workspace
+ *  streams     Pointer to HIP stream array for the computation
+ *  numStreams  Number of HIP streams in \p streams
+
+ *  \retval     rocsparselt_status_success the operation completed successfully.
+ *  \retval     rocsparselt_status_invalid_handle \p handle or \p plan is invalid.
+ *  \retval     rocsparselt_status_invalid_pointer \p alpha, \p A, \p B, \p beta, \p C or \p D
+ *              pointer is invalid.
+ *  \retval     rocsparselt_status_invalid_value \p plan has no dynamic M, workspace is invalid
+ *              or streams and numStreams are invalid
+ *  \retval     rocsparselt_status_invalid_size \p m is not in the range of the plan
+ *  \retval     rocsparselt_status_not_implemented the problem is not supported
+ */
+rocsparselt_status rocsparselt_matmul_dynamic_m(const rocsparselt_handle*      handle,
+                                                const rocsparselt_matmul_plan* plan,
+                                                int64_t                        m,
+                                                const void*                    alpha,
+                                                const void*                    d_A,
+                                                const void*                    d_B,
+                                                const void*                    beta,
+                                                const void*                    d_C,
+                                                void*                          d_D,
+                                                void*                          workspace,
+                                                hipStream_t*                   streams,
+                                                int32_t                        numStreams);
+
+/*! \ingroup spmm_module
+ *  \brief Sparse matrix dense matrix multiplication of a given M
+ *
+ *  \details
+ *  \p rocsparselt_matmul_search_dynamic_m evaluates the algorithms of the bucket of \p m as
+ *  \ref rocsparselt_matmul_search, and selects the fastest one for the matmuls of that bucket.
+ *  The tuning database remembers it for the M of the bucket.
+ *
+ *  \note
+ *  This function is NOT asynchronous with respect to streams[0] (blocking call)
+ *
+ *  @param[out]
+ *  d_D         Pointer to the dense matrix D
+ *
+ *  @param[in]
+ *  handle      rocsparselt library handle
+ *  plan        Matrix multiplication plan
+ *  m           number of rows of A, C and D
+ *  alpha       scalar \f$\alpha\f$. (float)
+ *  d_A         Pointer to the dense matrix A
+ *  d_B         Pointer to the structured matrix B
+ *  beta        scalar \f$\beta\f$. (float)
+ *  d_C         Pointer to the dense matrix C
+ *  workspace   Pointer to the workspace
+ *  streams     Pointer to HIP stream array for the computation
+ *  numStreams  Number of HIP streams in \p streams
+
+ *  \retval     rocsparselt_status_success the operation completed successfully.
+ *  \retval     rocsparselt_status_invalid_handle \p handle or \p plan is invalid.
+ *  \retval     rocsparselt_status_invalid_pointer \p alpha, \p A, \p B, \p beta, \p C or \p D
+ *              pointer is invalid.
+ *  \retval     rocsparselt_status_invalid_value \p plan has no dynamic M, workspace is invalid
+ *              or streams and numStreams are invalid
+ *  \retval     rocsparselt_status_invalid_size \p m is not in the range of the plan
+ *  \retval     rocsparselt_status_not_implemented the problem is not supported
+ */
+rocsparselt_status rocsparselt_matmul_search_dynamic_m(const rocsparselt_handle* handle,
+                                                       rocsparselt_matmul_plan*  plan,
+                                                       int64_t                   m,
+                                                       const void*               alpha,
+                                                       const void*               d_A,
+                                                       const void*               d_B,
+                                                       const void*               beta,
+                                                       const void*               d_C,
+                                                       void*                     d_D,
+                                                       void*                     workspace,
+                                                       hipStream_t*              streams,
+                                                       int32_t                   numStreams);
+
+/*! \ingroup spmm_module
+ *  \brief Grouped sparse matrix dense matrix multiplication
+ *
+ *  \details
+ *  \p rocsparselt_matmul_grouped computes \p groupCount independent matrix multiplications,
+ *  each one described by its own plan, as if \ref rocsparselt_matmul was called once per group.
+ *  The groups may differ in their sizes, types and layouts.
+ *
+ *  \note
+ *  This function is non blocking and executed asynchronously with respect to the host.
+ *  It may return before the actual computation has finished.
+ *
+ *  \note
+ *  The groups are distributed round-robin over \p streams. All of them start after the work
+ *  queued on streams[0] and all of them have finished when the work queued on streams[0]
+ *  afterwards starts.
+ *
+ *  \note
+ *  Every group is checked before any of them is queued.
+ *
+ *  @param[out]
+ *  d_D         Array of \p groupCount pointers to the dense matrices D
+ *
+ *  @param[in]
+ *  handle      rocsparselt library handle
+ *  plans       Array of \p groupCount matrix multiplication plans
+ *  alpha       Array of \p groupCount pointers to the scalars \f$\alpha\f$. (float)
+ *  d_A         Array of \p groupCount pointers to the structured matrices A
+ *  d_B         Array of \p groupCount pointers to the dense matrices B
+ *  beta        Array of \p groupCount pointers to the scalars \f$\beta\f$. (float)
+ *  d_C         Array of \p groupCount pointers to the dense matrices C
+ *  workspace   Array of \p groupCount pointers to the workspaces, can be NULL if no plan
+ *              needs a workspace
+ *  groupCount  Number of groups
+ *  streams     Pointer to HIP stream array for the computation
+ *  numStreams  Number of HIP streams in \p streams
+
+ *  \retval     rocsparselt_status_success the operation completed successfully.
+ *  \retval     rocsparselt_status_invalid_handle \p handle or one of the \p plans is invalid.
+ *  \retval     rocsparselt_status_invalid_pointer one of the arrays or one of their pointers is
+ *              invalid.
+ *  \retval     rocsparselt_status_invalid_value \p groupCount, a workspace or streams and
+ *              numStreams are invalid
+ *  \retval     rocsparselt_status_not_implemented the problem of a group is not supported
+ */
+rocsparselt_status rocsparselt_matmul_grouped(const rocsparselt_handle*             handle,
+                                              const rocsparselt_matmul_plan* const* plans,
+                                              const void* const*                    alpha,
+                                              const void* const*                    d_A,
+                                              const void* const*                    d_B,
+                                              const void* const*                    beta,
+                                              const void* const*                    d_C,
+                                              void* const*                          d_D,
+                                              void* const*                          workspace,
+                                              int32_t                               groupCount,
+                                              hipStream_t*                          streams,
+                                              int32_t                               numStreams);
+
+/*! \ingroup spmm_module
+ *  \brief Append a sparse matrix dense matrix multiplication to a HIP graph
+ *
+ *  \details
+ *  \p rocsparselt_matmul_capture appends the kernels \ref rocsparselt_matmul would launch for
+ *  the given arguments to \p graph, as a chain of kernel nodes. The first node depends on
+ *  \p dependencies, the nodes are returned in \p nodes in launch order. Nothing runs on the
+ *  device. The kernel arguments are copied into the nodes, \p alpha and \p beta are read
+ *  when the function is called, unless the plan uses \ref rocsparselt_pointer_mode_device.
+ *
+ *  \note
+ *  The plan must outlive the graph. A plan which needs a workspace must be given one, the
+ *  slices of the workspace pool belong to streams and a graph may be launched on any.
+ *
+ *  \note
+ *  With \ref rocsparselt_pointer_mode_device, the nodes of every graph captured from a plan
+ *  write alpha to the same buffer of the plan. These graphs must not run at the same time,
+ *  e.g. on two streams without an order between them; capture them from a plan each instead.
+ *
+ *  \note
+ *  \ref rocsparselt_matmul may also be captured with hipStreamBeginCapture(). Its first call
+ *  on several streams creates the events which fork and join them, and the first use of a
+ *  workspace pool slice allocates it, both should happen before a stream is captured.
+ *
+ *  @param[in]
+ *  handle          rocsparselt library handle
+ *  plan            Matrix multiplication plan
+ *  alpha           scalar \f$\alpha\f$. (float)
+ *  d_A             Pointer to the structured matrix A
+ *  d_B             Pointer to the dense matrix B
+ *  beta            scalar \f$\beta\f$. (float)
+ *  d_C             Pointer to the dense matrix C
+ *  d_D             Pointer to the dense matrix D
+ *  workspace       Pointor to the worksapce
+ *  graph           the graph the kernel nodes are added to
+ *  dependencies    the nodes the first kernel node depends on
+ *  numDependencies Number of nodes in \p dependencies
+ *
+ *  @param[out]
+ *  nodes           the kernel nodes added to \p graph
+ *
+ *  @param[inout]
+ *  numNodes        the capacity of \p nodes, then the number of nodes added. If \p nodes is
+ *                  too small, the number of nodes needed and nothing is added.
+ *
+ *  \retval     rocsparselt_status_success the operation completed successfully.
+ *  \retval     rocsparselt_status_invalid_handle \p handle or \p plan is invalid.
+ *  \retval     rocsparselt_status_invalid_pointer \p alpha, \p A, \p B, \p beta, \p C, \p D,
+ *              \p graph, \p dependencies, \p nodes or \p numNodes pointer is invalid.
+ *  \retval     rocsparselt_status_invalid_value \p workspace is invalid.
+ *  \retval     rocsparselt_status_invalid_size \p nodes has not enough room.
+ *  \retval     rocsparselt_status_not_implemented the problme is not supported
+ */
+rocsparselt_status rocsparselt_matmul_capture(const rocsparselt_handle*      handle,
+                                              const rocsparselt_matmul_plan* plan,
+                                              const void*                    alpha,
+                                              const void*                    d_A,
+                                              const void*                    d_B,
+                                              const void*                    beta,
+                                              const void*                    d_C,
+                                              void*                          d_D,
+                                              void*                          workspace,
+                                              hipGraph_t                     graph,
+                                              const hipGraphNode_t*          dependencies,
+                                              size_t                         numDependencies,
+                                              hipGraphNode_t*                nodes,
+                                              int32_t*                       numNodes);
+
+/*! \ingroup spmm_module
+ *  \brief Update the kernel nodes of a captured matrix multiplication in an executable graph
+ *
+ *  \details
+ *  \p rocsparselt_matmul_capture_update points the kernel nodes \ref rocsparselt_matmul_capture
+ *  added for \p plan to new matrices, scalars or workspace, with
+ *  hipGraphExecKernelNodeSetParams(), so the graph does not have to be instantiated again.
+ *  The plan and its selected algorithm must be the ones the nodes were captured with.
+ *  Only the kernel arguments are rebuilt, from the ones kept for the plan, except in the
+ *  device pointer mode, where the matrix multiplication is captured again.
+ *
+ *  @param[in]
+ *  handle      rocsparselt library handle
+ *  plan        Matrix multiplication plan
+ *  alpha       scalar \f$\alpha\f$. (float)
+ *  d_A         Pointer to the structured matrix A
+ *  d_B         Pointer to the dense matrix B
+ *  beta        scalar \f$\beta\f$. (float)
+ *  d_C         Pointer to the dense matrix C
+ *  d_D         Pointer to the dense matrix D
+ *  workspace   Pointor to the worksapce
+ *  graphExec   the executable graph instantiated from the graph of the nodes
+ *  nodes       the nodes returned by \ref rocsparselt_matmul_capture
+ *  numNodes    Number of nodes in \p nodes
+ *
+ *  \retval     rocsparselt_status_success the operation completed successfully.
+ *  \retval     rocsparselt_status_invalid_handle \p handle or \p plan is invalid.
+ *  \retval     rocsparselt_status_invalid_pointer \p alpha, \p A, \p B, \p beta, \p C, \p D,
+ *              \p graphExec or \p nodes pointer is invalid.
+ *  \retval     rocsparselt_status_invalid_value \p workspace or \p numNodes is invalid.
+ *  \retval     rocsparselt_status_not_implemented the problme is not supported
+ */
+rocsparselt_status rocsparselt_matmul_capture_update(const rocsparselt_handle*      handle,
+                                                     const rocsparselt_matmul_plan* plan,
+                                                     const void*                    alpha,
+                                                     const void*                    d_A,
+                                                     const void*                    d_B,
+                                                     const void*                    beta,
+                                                     const void*                    d_C,
+                                                     void*                          d_D,
+                                                     void*                          workspace,
+                                                     hipGraphExec_t                 graphExec,
+                                                     const hipGraphNode_t*          nodes,
+                                                     int32_t                        numNodes);
+
 /*! \ingroup spmm_module
  *  \brief Purnes a dense matrix.
  *
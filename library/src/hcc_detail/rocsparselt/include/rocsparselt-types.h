@@ -165,8 +165,7 @@ typedef enum rocsparselt_order_
  *
  *  \details
  *  The \ref rocsparselt_pointer_mode indicates whether scalar values (alpha/beta) are passed by
- *  reference on the host or device.
- *  Note, only support rocsparselt_pointer_mode_host.
+ *  reference on the host or device, see rocsparselt_set_pointer_mode().
  */
 typedef enum rocsparselt_pointer_mode_
 {
@@ -322,13 +321,59 @@ typedef enum rocsparselt_matmul_alg_attribute_
     = 2, /**< Number of iterations (kernel launches per algorithm)
                                                   for rocsparselt_matmul_search, default=10. */
     rocsparselt_matmul_split_k
-    = 3, /**< Split-K factor, default=not set. Valid range: [1, K]. Value 1 is equivalent to the Split-K feature is disabled */
+    = 3, /**< Split-K factor, default=not set. Valid range: [1, K]. Value 1 is equivalent to the Split-K feature is disabled, 0 unsets it */
     rocsparselt_matmul_split_k_mode
-    = 4, /**< Number of kernels to call for Split-K. Values are specified in rocsparselt_split_k_mode. */
+    = 4, /**< Number of kernels to call for Split-K, default=not set. Values are specified in rocsparselt_split_k_mode. */
     rocsparselt_matmul_split_k_buffers
     = 5, /**< Device memory buffers to store partial results for the reduction. The valid range is [1, SplitK - 1] */
+    rocsparselt_matmul_alg_candidates
+    = 6, /**< Number of configs collected for rocsparselt_matmul_search, 0 for all applicable, default=10. */
+    rocsparselt_matmul_search_statistic
+    = 7, /**< How rocsparselt_matmul_search sums up the runs of a config, a rocsparselt_search_statistic, default=mean. */
+    rocsparselt_matmul_search_flush_cache
+    = 8, /**< Flush the L2 cache before each run timed by rocsparselt_matmul_search (int 0 or 1), default=0. */
+    rocsparselt_matmul_search_min_time
+    = 9, /**< Least time in ms rocsparselt_matmul_search times each config for (float), default=0. */
+    rocsparselt_matmul_search_results
+    = 10, /**< rocsparselt_matmul_search_result of each config of the last rocsparselt_matmul_search (query only). */
+    rocsparselt_matmul_atomics_mode
+    = 11, /**< Whether the configs may accumulate with atomics, a rocsparselt_atomics_mode, default=allowed. */
+    rocsparselt_matmul_workspace_streams
+    = 12, /**< Streams rocsparselt_matmul may split a matmul across with the workspace of the caller, which holds a slice for each, default=1. Valid range: [1, 8]. */
 } rocsparselt_matmul_alg_attribute;
 
+/*! \ingroup types_module
+ *  \brief Specify how rocsparselt_matmul_search() sums up the timed runs of a config.
+ *
+ *  \details
+ *  The \ref rocsparselt_search_statistic is set with the rocsparselt_matmul_search_statistic
+ *  attribute of an algorithm selection.
+ */
+typedef enum rocsparselt_search_statistic_
+{
+    rocsparselt_search_statistic_mean         = 0, /**< Mean time of the runs. */
+    rocsparselt_search_statistic_median       = 1, /**< Median time of the runs. */
+    rocsparselt_search_statistic_trimmed_mean = 2, /**< Mean time without the fastest and the slowest 10% of the runs. */
+} rocsparselt_search_statistic;
+
+/*! \ingroup types_module
+ *  \brief Times of a config measured by rocsparselt_matmul_search(), in ms.
+ *
+ *  \details
+ *  The rocsparselt_matmul_search_results attribute of an algorithm selection is an array of
+ *  one \ref rocsparselt_matmul_search_result per config. Without a cache flush and with the
+ *  mean statistic, the runs of a config are timed in batches and the distribution is the one
+ *  of the batches.
+ */
+typedef struct rocsparselt_matmul_search_result_
+{
+    float ms; /**< Time of one run by the search statistic, 0 if the config was not timed. */
+    float min_ms; /**< Time of the fastest run. */
+    float median_ms; /**< Median time of the runs. */
+    float max_ms; /**< Time of the slowest run. */
+    int   runs; /**< Number of timed runs. */
+} rocsparselt_matmul_search_result;
+
 /*! \ingroup types_module
  *  \brief Specify the pruning algorithm to apply to the structured matrix before the compression.
  *
@@ -359,6 +404,37 @@ typedef enum rocsparselt_split_k_mode_
     rocsparselt_split_k_mode_two_kernels = 1, /**< Use anoghter kernel to do the final reduction */
 } rocsparselt_split_k_mode;
 
+/*! \ingroup types_module
+ *  \brief Specify a phase of the startup of the library, before the first matmul.
+ *
+ *  \details
+ *  The \ref rocsparselt_startup_phase is used in the \ref rocsparselt_get_startup_timing function.
+ */
+typedef enum rocsparselt_startup_phase_
+{
+    rocsparselt_startup_path_discovery = 0, /**< Finding the directory of the kernel files. */
+    rocsparselt_startup_code_object_glob = 1, /**< Listing the code object files of the device. */
+    rocsparselt_startup_code_object_load = 2, /**< Loading a code object file on a device. */
+    rocsparselt_startup_library_load = 3, /**< Loading the kernel library, i.e. its solutions. */
+    rocsparselt_startup_device_properties = 4, /**< Querying the properties of a device. */
+    rocsparselt_startup_first_solution_query = 5, /**< First query of the solutions of a problem. */
+    rocsparselt_startup_first_launch = 6, /**< First launch of the kernels of a matmul. */
+} rocsparselt_startup_phase;
+
+/*! \ingroup types_module
+ *  \brief Times of a startup phase measured by the library, in ms.
+ *
+ *  \details
+ *  A phase may happen several times, e.g. once per code object file and device, and on
+ *  several threads at once, so the total may exceed the wall time of the phase.
+ */
+typedef struct rocsparselt_startup_timing_
+{
+    double first_ms; /**< Time of the first occurrence of the phase. */
+    double total_ms; /**< Sum of the times of all the occurrences. */
+    int    count; /**< Number of occurrences, 0 if the phase did not happen yet. */
+} rocsparselt_startup_timing;
+
 #ifdef __cplusplus
 }
 #endif
@@ -31,13 +31,13 @@
 #include "utility.hpp"
 
 #include <hip/hip_runtime.h>
+#include <algorithm>
 
 ROCSPARSELT_KERNEL void init_kernel(){};
 
-void _rocsparselt_handle::init()
+int rocsparselt_internal_env_layer_mode()
 {
-    // Layer mode
-    log_bench = false;
+    int   layer_mode;
     char* str_layer_mode;
     if((str_layer_mode = getenv("HIPSPARSELT_LOG_LEVEL")) == NULL)
     {
@@ -68,7 +68,34 @@ void _rocsparselt_handle::init()
             break;
         }
     }
+    return layer_mode;
+}
+
+std::ostream* rocsparselt_internal_log_trace_os()
+{
+    static std::ofstream log_trace_ofs;
+    static std::ostream* log_trace_os = [] {
+        std::ostream* os;
+        open_log_stream(&os, &log_trace_ofs, "HIPSPARSELT_LOG_FILE");
+        return os;
+    }();
+    return log_trace_os;
+}
 
+void rocsparselt_internal_log_write(std::ostream* os, const std::string& line)
+{
+    static std::mutex           mutex;
+    std::lock_guard<std::mutex> lock(mutex);
+    *os << line << std::flush;
+}
+
+void _rocsparselt_handle::init()
+{
+    // Layer mode
+    log_bench  = false;
+    layer_mode = rocsparselt_internal_env_layer_mode();
+
+    char* str_layer_mode;
     if((str_layer_mode = getenv("HIPSPARSELT_LOG_BENCH")) != NULL)
     {
         log_bench = (atoi(str_layer_mode) > 0);
@@ -76,10 +103,7 @@ void _rocsparselt_handle::init()
 
     // Open log file
     if(layer_mode & 0xff)
-    {
-        log_trace_ofs = new std::ofstream();
-        open_log_stream(&log_trace_os, log_trace_ofs, "HIPSPARSELT_LOG_FILE");
-    }
+        log_trace_os = rocsparselt_internal_log_trace_os();
 
     // Open log_bench file
     if(log_bench)
@@ -105,12 +129,19 @@ void _rocsparselt_handle::init()
     asic_rev = 0;
 #endif
 
+    config_storage = new _rocsparselt_config_storage;
+
     is_init = (uintptr_t)(this);
 }
 
 void _rocsparselt_handle::destroy()
 {
     is_init = 0;
+    delete workspace_pool;
+    workspace_pool = nullptr;
+    if(config_storage != nullptr)
+        config_storage->drop();
+    config_storage = nullptr;
     // Close log files
     if(log_trace_ofs)
     {
@@ -128,6 +159,88 @@ void _rocsparselt_handle::destroy()
     }
 }
 
+void _rocsparselt_workspace_pool::reserve(size_t bytes)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    slice_bytes = std::max(slice_bytes, bytes);
+}
+
+rocsparselt_status
+    _rocsparselt_workspace_pool::acquire(hipStream_t stream, size_t bytes, void** workspace)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    bytes = std::max(slice_bytes, bytes);
+
+    auto it = std::find_if(
+        slices.begin(), slices.end(), [stream](const slice& s) { return s.stream == stream; });
+    if(it == slices.end())
+        it = slices.insert(it, slice{stream, nullptr, 0});
+
+    if(it->bytes < bytes)
+    {
+        // hipFree() waits for the work still queued on the old slice.
+        if(it->ptr != nullptr)
+            RETURN_IF_HIP_ERROR(hipFree(it->ptr));
+        it->ptr   = nullptr;
+        it->bytes = 0;
+        RETURN_IF_HIP_ERROR(hipMalloc(&it->ptr, bytes));
+        it->bytes = bytes;
+    }
+    *workspace = it->ptr;
+    return rocsparselt_status_success;
+}
+
+size_t _rocsparselt_workspace_pool::size()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    size_t                      bytes = 0;
+    for(auto& s : slices)
+        bytes += s.bytes;
+    return bytes;
+}
+
+void _rocsparselt_workspace_pool::clear()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    for(auto& s : slices)
+        if(s.ptr != nullptr)
+            (void)hipFree(s.ptr);
+    slices.clear();
+}
+
+rocsparselt_status _rocsparselt_matmul_capture::init()
+{
+    RETURN_IF_HIP_ERROR(hipStreamCreateWithFlags(&stream, hipStreamNonBlocking));
+    return rocsparselt_status_success;
+}
+
+_rocsparselt_matmul_config*
+    _rocsparselt_config_storage::assign(const void*                               owner,
+                                        const _rocsparselt_matmul_descr&          matmul_descr,
+                                        std::vector<_rocsparselt_matmul_config>&& configs)
+{
+    auto descr = std::make_unique<_rocsparselt_matmul_descr>(matmul_descr);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto&                       e = entries[owner];
+    e.matmul_descr                = std::move(descr);
+    e.configs                     = std::move(configs);
+    return e.configs.data();
+}
+
+const _rocsparselt_matmul_descr* _rocsparselt_config_storage::matmul_descr(const void* owner)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    auto                        it = entries.find(owner);
+    return it == entries.end() ? nullptr : it->second.matmul_descr.get();
+}
+
+void _rocsparselt_config_storage::release(const void* owner)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    entries.erase(owner);
+}
+
 std::ostream& operator<<(std::ostream& stream, const _rocsparselt_mat_descr& t)
 {
     stream << "{"
@@ -169,7 +282,11 @@ std::ostream& operator<<(std::ostream& stream, const _rocsparselt_matmul_alg_sel
     stream << "{"
            << "ptr=" << (&t) << ", alg=" << t.alg << ", config_id=" << t.config_id
            << ", config_max_id=" << t.config_max_id << ", search_iterations=" << t.search_iterations
-           << "}";
+           << ", candidates=" << t.candidates << ", search_statistic=" << t.search_statistic
+           << ", search_flush_cache=" << t.search_flush_cache
+           << ", search_min_time=" << t.search_min_time << ", split_k=" << t.split_k
+           << ", split_k_mode=" << t.split_k_mode << ", atomics=" << t.atomics
+           << ", workspace_streams=" << t.workspace_streams << "}";
     return stream;
 }
 
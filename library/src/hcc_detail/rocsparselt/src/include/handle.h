@@ -28,12 +28,52 @@
 
 #include "rocsparselt.h"
 
+#include <algorithm>
+#include <atomic>
 #include <fstream>
 #include <hip/hip_runtime_api.h>
 #include <iostream>
 #include <memory>
+#include <mutex>
+#include <unordered_map>
 #include <vector>
 
+/********************************************************************************
+ * \brief _rocsparselt_workspace_pool holds the device workspace of the matmuls
+ * called without one. Its slices are sized to the largest workspace the selected
+ * configs of the plans created while it is enabled need, and each stream gets its
+ * own slice, so the matmuls queued on a stream reuse it in stream order. A slice
+ * grows further for a matmul which needs more, like a search.
+ *******************************************************************************/
+struct _rocsparselt_workspace_pool
+{
+    ~_rocsparselt_workspace_pool()
+    {
+        clear();
+    }
+
+    // Grows the slices to at least bytes, they are reallocated on their next use.
+    void reserve(size_t bytes);
+    // Returns the slice of stream, with at least bytes bytes and the reserved ones.
+    rocsparselt_status acquire(hipStream_t stream, size_t bytes, void** workspace);
+    // Device memory held by all slices.
+    size_t size();
+    void   clear();
+
+    struct slice
+    {
+        hipStream_t stream;
+        void*       ptr;
+        size_t      bytes;
+    };
+
+    std::mutex         mutex;
+    size_t             slice_bytes = 0;
+    std::vector<slice> slices;
+};
+
+struct _rocsparselt_config_storage;
+
 /********************************************************************************
  * \brief rocsparse_handle is a structure holding the rocsparselt library context.
  * It must be initialized using rocsparse_create_handle()
@@ -71,10 +111,11 @@ struct _rocsparselt_handle
     int  layer_mode;
     bool log_bench = false;
 
-    // device buffer
-    size_t    buffer_size;
-    void*     buffer;
-    uintptr_t is_init = 0;
+    // workspace of the matmuls called without one, only allocated if enabled
+    _rocsparselt_workspace_pool* workspace_pool = nullptr;
+    // configs collected for the alg selections of the handle
+    _rocsparselt_config_storage* config_storage = nullptr;
+    uintptr_t                    is_init        = 0;
 
     // logging streams
     std::ofstream* log_trace_ofs = nullptr;
@@ -83,6 +124,17 @@ struct _rocsparselt_handle
     std::ostream*  log_bench_os  = nullptr;
 };
 
+// The logging mode set by HIPSPARSELT_LOG_LEVEL or HIPSPARSELT_LOG_MASK
+int rocsparselt_internal_env_layer_mode();
+
+// The stream of HIPSPARSELT_LOG_FILE, opened once for the process so that the
+// handles and the initialization of the devices do not truncate each other's log
+std::ostream* rocsparselt_internal_log_trace_os();
+
+// Writes a line of a log to os. The streams are shared by the handles and the threads of the
+// process, the writes hold a lock so that the lines do not interleave.
+void rocsparselt_internal_log_write(std::ostream* os, const std::string& line);
+
 /********************************************************************************
  * \brief rocsparse_mat_descr is a structure holding the rocsparselt matrix
  * content. It must be initialized using rocsparselt_dense_descr_init() or
@@ -216,6 +268,7 @@ struct _rocsparselt_matmul_descr
         , n(rhs.n)
         , k(rhs.k)
         , is_sparse_a(rhs.is_sparse_a)
+        , pointer_mode(rhs.pointer_mode)
         , _op_A(rhs._op_A)
         , _op_B(rhs._op_B)
         , _m(rhs._m)
@@ -288,6 +341,9 @@ struct _rocsparselt_matmul_descr
     int64_t     k                    = 0;
     bool        is_sparse_a          = true;
 
+    // pointer mode of the handle when the descriptor was initialized
+    rocsparselt_pointer_mode pointer_mode = rocsparselt_pointer_mode_host;
+
     rocsparselt_operation _op_A;
     rocsparselt_operation _op_B;
     int64_t               _m           = 0;
@@ -314,15 +370,40 @@ struct __attribute__((packed, aligned(8))) _rocsparselt_matmul_config
     _rocsparselt_matmul_config(const _rocsparselt_matmul_config& rhs)
     {
         this->index               = rhs.index;
+        this->use_bias            = rhs.use_bias;
+        this->use_scale_alpha_vec = rhs.use_scale_alpha_vec;
         this->max_workspace_bytes = rhs.max_workspace_bytes;
+        this->split_k             = rhs.split_k;
+        this->split_k_mode        = rhs.split_k_mode;
+        this->atomics             = rhs.atomics;
+        this->search              = rhs.search;
     }
 
     int    index;
     int    use_bias            = 0;
     int    use_scale_alpha_vec = 0;
     size_t max_workspace_bytes = 0;
+    // how the kernel splits the K loop, a rocsparselt_split_k_mode and whether it uses atomics
+    int split_k      = 1;
+    int split_k_mode = rocsparselt_splik_k_mode_one_kernel;
+    int atomics      = 0;
+    // times measured by the last rocsparselt_matmul_search(), all 0 if not measured
+    rocsparselt_matmul_search_result search = {};
 };
 
+// Number of configs rocsparselt_matmul_alg_selection_init() collects, unless the
+// rocsparselt_matmul_alg_candidates attribute changes it.
+constexpr int rocsparselt_default_candidates = 10;
+
+// The workspace slices of the streams a matmul is split across start on this alignment.
+constexpr size_t rocsparselt_workspace_slice_align = 256;
+
+inline size_t rocsparselt_workspace_slice_bytes(size_t bytes)
+{
+    return (bytes + rocsparselt_workspace_slice_align - 1) / rocsparselt_workspace_slice_align
+           * rocsparselt_workspace_slice_align;
+}
+
 /********************************************************************************
  * \brief rocsparselt_matmul_alg_selection holds the description of the matrix
  * multiplication algorithm.
@@ -354,16 +435,147 @@ struct _rocsparselt_matmul_alg_selection
     const _rocsparselt_handle* handle = nullptr;
     //
 
-    _rocsparselt_matmul_config configs[100];
+    // config_max_id configs, owned by the config storage of the handle
+    _rocsparselt_matmul_config* configs = nullptr;
+
+    // The workspace a matmul needs with the selected config.
+    size_t selected_workspace_bytes() const
+    {
+        return config_max_id == 0 ? 0 : configs[config_id].max_workspace_bytes;
+    }
+
+    // The workspace of the caller for a matmul with the selected config, with a slice for each
+    // of the workspace_streams streams the matmul may be split across.
+    size_t matmul_workspace_bytes() const
+    {
+        size_t bytes = selected_workspace_bytes();
+        if(workspace_streams < 2 || bytes == 0)
+            return bytes;
+        return rocsparselt_workspace_slice_bytes(bytes) * workspace_streams;
+    }
+
+    // The workspace a matmul may use with any of the configs, the search runs them all.
+    size_t workspace_bytes() const
+    {
+        size_t bytes = 0;
+        for(int i = 0; i < config_max_id; i++)
+            bytes = std::max(bytes, configs[i].max_workspace_bytes);
+        return bytes;
+    }
 
     rocsparselt_matmul_alg alg;
     //data of rocsparselt_matmul_alg_attribute
-    int       config_id         = 0;
-    int       config_max_id     = 0;
-    int       search_iterations = 10;
+    int   config_id          = 0;
+    int   config_max_id      = 0;
+    int   search_iterations  = 10;
+    int   candidates         = rocsparselt_default_candidates;
+    int   search_statistic   = rocsparselt_search_statistic_mean;
+    int   search_flush_cache = 0;
+    float search_min_time    = 0.0f;
+    // 0 and -1 keep the configs of all split-K factors and modes
+    int split_k      = 0;
+    int split_k_mode = -1;
+    int atomics      = rocsparselt_atomics_allowed;
+    // streams a matmul with the workspace of the caller may be split across
+    int       workspace_streams = 1;
     uintptr_t is_init           = 0;
 };
 
+/********************************************************************************
+ * \brief _rocsparselt_config_storage holds the configs of the alg selections of
+ * a handle, with a copy of the matmul descriptor they were collected for, so
+ * that changing the number of candidates can collect them again. The configs
+ * are freed when the alg selection is destroyed or initialized again, or when
+ * the storage is freed. The handle and the plans which own their alg selection
+ * hold a reference to it, so a plan may be destroyed after its handle.
+ *******************************************************************************/
+struct _rocsparselt_config_storage
+{
+    struct entry
+    {
+        std::unique_ptr<_rocsparselt_matmul_descr> matmul_descr;
+        std::vector<_rocsparselt_matmul_config>    configs;
+    };
+
+    // Replaces the configs of owner, returns where they are stored.
+    _rocsparselt_matmul_config* assign(const void*                               owner,
+                                       const _rocsparselt_matmul_descr&          matmul_descr,
+                                       std::vector<_rocsparselt_matmul_config>&& configs);
+    // The descriptor the configs of owner were collected for, nullptr if there are none.
+    const _rocsparselt_matmul_descr* matmul_descr(const void* owner);
+    // Frees the configs of owner.
+    void release(const void* owner);
+
+    _rocsparselt_config_storage* retain()
+    {
+        refs.fetch_add(1, std::memory_order_relaxed);
+        return this;
+    }
+    // Drops a reference, the last one frees the storage.
+    void drop()
+    {
+        if(refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            delete this;
+    }
+
+    std::atomic<int>                       refs{1};
+    std::mutex                             mutex;
+    std::unordered_map<const void*, entry> entries;
+};
+
+/********************************************************************************
+ * \brief _rocsparselt_matmul_exec_cache holds the objects which are resolved once
+ * per plan by the active backend (tensile_host.cpp or kernel_launcher.cpp), so
+ * that each rocsparselt_matmul() call only has to patch pointers and scalars.
+ * Its layout is private to the backend.
+ *******************************************************************************/
+struct _rocsparselt_matmul_exec_cache;
+
+// Number of independently cached slots of an exec cache. A multi-stream matmul runs part i of
+// its problem through slot i, so it never spreads the work across more streams than this.
+constexpr int rocsparselt_exec_cache_slots = 8;
+
+_rocsparselt_matmul_exec_cache*
+     rocsparselt_internal_exec_cache_create(const _rocsparselt_handle* handle);
+void rocsparselt_internal_exec_cache_destroy(_rocsparselt_matmul_exec_cache* cache);
+
+/********************************************************************************
+ * \brief _rocsparselt_launch_sink takes the kernels of a matmul instead of the
+ * device. While it is set for a thread, the backends hand it the argument buffers
+ * of the kernels they would launch, in launch order, and launch nothing. It lets
+ * rocsparselt_matmul_capture_update() reuse the arguments the exec cache patched.
+ *******************************************************************************/
+struct _rocsparselt_launch_sink
+{
+    std::vector<std::vector<uint8_t>> kernel_args;
+};
+
+inline _rocsparselt_launch_sink*& rocsparselt_internal_launch_sink()
+{
+    thread_local _rocsparselt_launch_sink* t_sink = nullptr;
+    return t_sink;
+}
+
+/********************************************************************************
+ * \brief _rocsparselt_matmul_capture holds the stream a plan records its kernels
+ * on for rocsparselt_matmul_capture(). It is created with the plan, so that
+ * nothing is created while the stream captures. The mutex keeps two threads from
+ * capturing the stream at the same time.
+ *******************************************************************************/
+struct _rocsparselt_matmul_capture
+{
+    ~_rocsparselt_matmul_capture()
+    {
+        if(stream != nullptr)
+            (void)hipStreamDestroy(stream);
+    }
+
+    rocsparselt_status init();
+
+    std::mutex  mutex;
+    hipStream_t stream = nullptr;
+};
+
 /********************************************************************************
  * \brief rocsparselt_matmul_plan holds the matrix multiplication execution plan,
  * namely all the information necessary to execute the rocsparselt_matmul() operation.
@@ -393,10 +605,32 @@ struct _rocsparselt_matmul_plan
 
     void clear()
     {
+        for(int i = 0; i < bucket_count; i++)
+            delete buckets[i];
+        delete[] buckets;
+        if(owns_alg_selection)
+        {
+            if(config_storage != nullptr)
+                config_storage->release(alg_selection);
+            delete alg_selection;
+        }
+        if(config_storage != nullptr)
+            config_storage->drop();
         delete matmul_descr;
-        matmul_descr  = nullptr;
-        alg_selection = nullptr;
-        is_init       = 0;
+        rocsparselt_internal_exec_cache_destroy(exec_cache);
+        delete device_alpha;
+        delete capture;
+        matmul_descr       = nullptr;
+        alg_selection      = nullptr;
+        owns_alg_selection = false;
+        config_storage     = nullptr;
+        exec_cache         = nullptr;
+        device_alpha       = nullptr;
+        capture            = nullptr;
+        buckets            = nullptr;
+        bucket_count       = 0;
+        min_m              = 0;
+        is_init            = 0;
     }
 
     friend std::ostream& operator<<(std::ostream& stream, const _rocsparselt_matmul_plan& t);
@@ -406,6 +640,27 @@ struct _rocsparselt_matmul_plan
     _rocsparselt_matmul_descr* matmul_descr = nullptr;
     //
     _rocsparselt_matmul_alg_selection* alg_selection = nullptr;
+    // whether alg_selection is the plan's own, as for the buckets of a dynamic-M plan and
+    // a plan made by rocsparselt_matmul_plan_deserialize(), rather than the caller's
+    bool owns_alg_selection = false;
+    // a reference to the config storage of the handle holding the configs of the plan's own
+    // alg selection, since the plan may outlive the handle
+    _rocsparselt_config_storage* config_storage = nullptr;
+    // resolved problem/solution, owned by the plan and filled by the backend
+    _rocsparselt_matmul_exec_cache* exec_cache = nullptr;
+    // alpha broadcast to every row of D, only for the device pointer mode. It is staged in a
+    // slice per stream, like the workspace pool, so that the streams sharing the plan do not
+    // overwrite the alpha of each other.
+    _rocsparselt_workspace_pool* device_alpha = nullptr;
+    // stream of rocsparselt_matmul_capture(), a bucket of a dynamic-M plan has none
+    _rocsparselt_matmul_capture* capture = nullptr;
+    // The smallest M of a plan initialized by rocsparselt_matmul_plan_init_dynamic_m(), 0 for
+    // other plans. Its buckets are plans for the powers of two between min_m and the M of
+    // matmul_descr, by increasing M. A matmul runs with the first one whose M is not smaller
+    // than its own, or with the plan itself.
+    int64_t                    min_m        = 0;
+    _rocsparselt_matmul_plan** buckets      = nullptr;
+    int                        bucket_count = 0;
 
     //
     uintptr_t is_init = 0;
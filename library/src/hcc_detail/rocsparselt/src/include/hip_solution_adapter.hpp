@@ -32,6 +32,7 @@
 
 #include <map>
 #include <mutex>
+#include <shared_mutex>
 
 class SolutionAdapter
 {
@@ -58,6 +59,37 @@ public:
                                hipEvent_t                 startEvent,
                                hipEvent_t                 stopEvent,
                                int                        iter = 1);
+    hipError_t    launchKernel(const _rocsparselt_handle* handle,
+                               KernelInvocation const&    kernel,
+                               void*                      args,
+                               size_t                     argsSize,
+                               hipStream_t                stream,
+                               hipEvent_t                 startEvent,
+                               hipEvent_t                 stopEvent,
+                               int                        iter = 1);
+    hipError_t    launchKernel(const _rocsparselt_handle* handle,
+                               hipFunction_t              function,
+                               KernelInvocation const&    kernel,
+                               void*                      args,
+                               size_t                     argsSize,
+                               hipStream_t                stream,
+                               hipEvent_t                 startEvent,
+                               hipEvent_t                 stopEvent,
+                               int                        iter = 1);
+    hipError_t    launchKernel(const _rocsparselt_handle* handle,
+                               hipFunction_t              function,
+                               dim3                       numWorkItems,
+                               dim3                       workGroupSize,
+                               size_t                     sharedMemBytes,
+                               void*                      args,
+                               size_t                     argsSize,
+                               hipStream_t                stream,
+                               hipEvent_t                 startEvent,
+                               hipEvent_t                 stopEvent,
+                               int                        iter = 1);
+    hipError_t    resolveKernel(const _rocsparselt_handle* handle,
+                                std::string const&         name,
+                                hipFunction_t&             function);
     hipError_t    launchKernels(const _rocsparselt_handle*           handle,
                                 std::vector<KernelInvocation> const& kernels);
     hipError_t    launchKernels(const _rocsparselt_handle*           handle,
@@ -71,14 +103,15 @@ public:
                                 std::vector<hipEvent_t> const&       startEvents,
                                 std::vector<hipEvent_t> const&       stopEvents);
     hipError_t    initKernel(std::string const& name);
-    size_t        getKernelCounts(std::string const& category);
-    KernelParams* getKernelParams(std::string const& category);
+    const KernelParams* getKernelParams(uint32_t category, size_t* count);
 
 private:
     using function_table = std::map<std::string, void*>;
 
     hipError_t getKernel(hipFunction_t& rv, std::string const& name);
-    std::mutex m_access;
+    // m_modules and m_kernels are read on every launch and written once per kernel, so
+    // lookups take a shared lock and only insertions take it exclusively.
+    std::shared_mutex                              m_access;
     std::unordered_map<std::string, hipModule_t>   m_modules;
     std::unordered_map<std::string, hipFunction_t> m_kernels;
     std::string                                    m_name = "HipSolutionAdapter";
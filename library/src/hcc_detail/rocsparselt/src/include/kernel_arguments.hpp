@@ -27,11 +27,14 @@
 #pragma once
 
 #include "hipsparselt_ostream.hpp"
+#include <array>
+#include <cstdint>
 #include <cstring>
 #include <hip/hip_runtime_api.h>
 #include <sstream>
 #include <string>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 class KernelArguments
 {
@@ -50,8 +53,17 @@ public:
     template <typename T>
     void bind(std::string const& name, T value);
 
+    // Appends a run of arguments, names[i] names the i-th value.
+    template <typename... Ts>
+    void appendFields(std::array<char const*, sizeof...(Ts)> const& names, Ts... values);
+
     bool isFullyBound() const;
 
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+    // Byte offset of an argument within data(), or npos if there is no such argument.
+    size_t offsetOf(std::string const& name) const;
+
     void const* data() const;
     size_t      size() const;
 
@@ -129,6 +141,14 @@ inline void KernelArguments::append(std::string const& name, T value)
     append(name, value, true);
 }
 
+template <typename... Ts>
+inline void KernelArguments::appendFields(std::array<char const*, sizeof...(Ts)> const& names,
+                                         Ts... values)
+{
+    size_t i = 0;
+    (append(names[i++], values), ...);
+}
+
 template <typename T>
 inline void KernelArguments::appendUnbound(std::string const& name)
 {
@@ -249,6 +269,101 @@ KernelArguments::const_iterator::operator T() const
     return *reinterpret_cast<T*>(const_cast<void*>(m_value.first));
 }
 
+/**
+ * Compile-time layout of a run of kernel arguments. Offsets are relative to the
+ * start of the run, which is aligned to the first field. The first field must
+ * have the largest alignment, so the layout matches appending the fields one by
+ * one with KernelArguments.
+ */
+template <typename... Ts>
+struct KernelArgumentLayout
+{
+    static constexpr size_t count = sizeof...(Ts);
+    static_assert(count > 0, "Empty kernel argument layout.");
+
+    static constexpr std::array<size_t, count> sizes      = {sizeof(Ts)...};
+    static constexpr std::array<size_t, count> alignments = {alignof(Ts)...};
+
+    static constexpr std::array<size_t, count> computeOffsets()
+    {
+        std::array<size_t, count> result{};
+        size_t                    offset = 0;
+        for(size_t i = 0; i < count; i++)
+        {
+            offset    = (offset + alignments[i] - 1) / alignments[i] * alignments[i];
+            result[i] = offset;
+            offset += sizes[i];
+        }
+        return result;
+    }
+
+    static constexpr bool firstIsWidest()
+    {
+        for(size_t i = 1; i < count; i++)
+            if(alignments[i] > alignments[0])
+                return false;
+        return true;
+    }
+    static_assert(firstIsWidest(), "The first field of a run must have the largest alignment.");
+
+    static constexpr std::array<size_t, count> offsets   = computeOffsets();
+    static constexpr size_t                    alignment = alignments[0];
+    static constexpr size_t                    size      = offsets[count - 1] + sizes[count - 1];
+};
+
+/**
+ * Release-mode counterpart of KernelArguments. Arguments are written into a
+ * fixed-capacity inline buffer using KernelArgumentLayout, and no names or
+ * value strings are recorded. It produces the same bytes as KernelArguments
+ * for the same sequence of appends.
+ */
+class KernelArgumentsBinary
+{
+public:
+    static constexpr size_t capacity = 1024;
+
+    // names are accepted for interface parity with KernelArguments and ignored.
+    template <typename... Ts>
+    void appendFields(std::array<char const*, sizeof...(Ts)> const& names, Ts... values)
+    {
+        using Layout = KernelArgumentLayout<Ts...>;
+
+        size_t start = (m_size + Layout::alignment - 1) / Layout::alignment * Layout::alignment;
+        if(start + Layout::size > capacity)
+            throw std::runtime_error("Kernel arguments exceed the inline buffer capacity.");
+
+        std::memset(m_data + m_size, 0, start + Layout::size - m_size);
+        writeFields<Layout>(start, std::index_sequence_for<Ts...>{}, values...);
+        m_size = start + Layout::size;
+    }
+
+    template <typename T>
+    void append(char const* name, T value)
+    {
+        appendFields<T>({name}, value);
+    }
+
+    void const* data() const
+    {
+        return m_data;
+    }
+
+    size_t size() const
+    {
+        return m_size;
+    }
+
+private:
+    template <typename Layout, size_t... Is, typename... Ts>
+    void writeFields(size_t start, std::index_sequence<Is...>, Ts... values)
+    {
+        (std::memcpy(m_data + start + Layout::offsets[Is], &values, sizeof(Ts)), ...);
+    }
+
+    alignas(8) uint8_t m_data[capacity];
+    size_t m_size = 0;
+};
+
 /**
  * \ingroup Launching
  * Describes a single kernel invocation including kernel name, launch
@@ -292,3 +407,14 @@ struct KernelParams
     bool         ActivationHPA;
     char         ActivationType[32];
 };
+
+/**
+ * The key of the kernels of a problem in the tables generated by addKernels.py,
+ * from the types of the kernel YAML files and the transposes of A and B.
+ */
+constexpr uint32_t kernel_category_key(
+    int dataType, int destDataType, int computeDataType, bool transA, bool transB)
+{
+    return uint32_t(dataType) << 24 | uint32_t(destDataType) << 16
+           | uint32_t(computeDataType) << 8 | uint32_t(transA) << 1 | uint32_t(transB);
+}
@@ -502,19 +502,38 @@ struct RocsparseltContractionProblem
     };
 };
 
+struct rocsparselt_search_options;
+
 template <typename Ti, typename To, typename Tc>
 rocsparselt_status runContractionProblem(RocsparseltContractionProblem<Ti, To, Tc> const& problem,
+                                         _rocsparselt_matmul_config*                      configs,
                                          int*                                             config_id,
-                                         const int config_max_id,
-                                         const int search_iterations);
+                                         const int                         config_max_id,
+                                         const int                         search_iterations,
+                                         const rocsparselt_search_options* search_options,
+                                         _rocsparselt_matmul_exec_cache*   exec_cache = nullptr,
+                                         int                               exec_slot  = 0);
+
+/*******************************************************************************
+ * validateContractionProblem() tells whether the selected config can run a    *
+ * part of a problem split across streams on its own, see spmm_stream_parts()  *
+ *******************************************************************************/
+template <typename Ti, typename To, typename Tc>
+bool validateContractionProblem(const RocsparseltContractionProblem<Ti, To, Tc>& problem,
+                                const _rocsparselt_matmul_config*                configs,
+                                int                                              config_id,
+                                _rocsparselt_matmul_exec_cache*                  exec_cache,
+                                int                                              exec_slot,
+                                bool                                             whole_tiles);
+
 template <typename Ti, typename To, typename Tc>
-rocsparselt_status initSolutions(const _rocsparselt_handle* handle,
-                                 rocsparselt_operation      opA,
-                                 rocsparselt_operation      opB,
-                                 int*                       kernel_counts);
+rocsparselt_status initSolutions(const _rocsparselt_handle*               handle,
+                                 rocsparselt_operation                    opA,
+                                 rocsparselt_operation                    opB,
+                                 std::vector<_rocsparselt_matmul_config>* configs);
 
 template <typename Ti, typename To, typename Tc>
-std::string generate_kernel_category_str(rocsparselt_operation opA, rocsparselt_operation opB);
+uint32_t kernel_category(rocsparselt_operation opA, rocsparselt_operation opB);
 
 /***********************************************************************************
  * Whether Kernel Launcher has been initialized for at least one device (used for testing) *
@@ -0,0 +1,117 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#pragma once
+#ifndef ROCSPARSELT_LRU_CACHE_HPP
+#define ROCSPARSELT_LRU_CACHE_HPP
+
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+/*******************************************************************************
+ * A map of at most capacity entries, which drops the least recently used entry
+ * to make room for a new one. A capacity of 0 disables it. Entries are copied
+ * in and out under a mutex, so that threads may share it.
+ *
+ * This part only depends on the host.
+ *******************************************************************************/
+template <typename Key, typename Value, typename Hash = std::hash<Key>>
+class rocsparselt_lru_cache
+{
+public:
+    explicit rocsparselt_lru_cache(size_t capacity)
+        : max_size(capacity)
+    {
+    }
+
+    // Copies the value of key to value and makes it the most recently used entry.
+    // Returns false if there is no entry for key.
+    bool get(const Key& key, Value* value)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto                        it = index.find(key);
+        if(it == index.end())
+            return false;
+        entries.splice(entries.begin(), entries, it->second);
+        *value = it->second->second;
+        return true;
+    }
+
+    // Sets the value of key, it becomes the most recently used entry.
+    void put(const Key& key, Value value)
+    {
+        if(max_size == 0)
+            return;
+
+        std::lock_guard<std::mutex> lock(mutex);
+        auto                        it = index.find(key);
+        if(it != index.end())
+        {
+            it->second->second = std::move(value);
+            entries.splice(entries.begin(), entries, it->second);
+            return;
+        }
+
+        if(entries.size() == max_size)
+        {
+            index.erase(entries.back().first);
+            entries.pop_back();
+        }
+        entries.emplace_front(key, std::move(value));
+        index.emplace(key, entries.begin());
+    }
+
+    void clear()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        index.clear();
+        entries.clear();
+    }
+
+    size_t size() const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return entries.size();
+    }
+
+    size_t capacity() const
+    {
+        return max_size;
+    }
+
+private:
+    using entry_list = std::list<std::pair<Key, Value>>;
+
+    const size_t                                                 max_size;
+    mutable std::mutex                                           mutex;
+    entry_list                                                   entries; // most recent first
+    std::unordered_map<Key, typename entry_list::iterator, Hash> index;
+};
+
+#endif // ROCSPARSELT_LRU_CACHE_HPP
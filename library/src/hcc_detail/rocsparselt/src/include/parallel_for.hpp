@@ -0,0 +1,78 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+/*******************************************************************************
+ * rocsparselt_parallel_for calls f(i) for each i in [0, count) on up to
+ * workers threads, the calling thread being one of them, and returns when all
+ * the calls are done. f must not throw.
+ ******************************************************************************/
+template <typename F>
+void rocsparselt_parallel_for(size_t count, size_t workers, F&& f)
+{
+    workers = std::min(workers, count);
+    if(workers <= 1)
+    {
+        for(size_t i = 0; i < count; i++)
+            f(i);
+        return;
+    }
+
+    std::atomic<size_t> next{0};
+    auto                work = [&] {
+        for(size_t i; (i = next.fetch_add(1)) < count;)
+            f(i);
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(workers - 1);
+    for(size_t w = 1; w < workers; w++)
+        threads.emplace_back(work);
+    work();
+    for(auto& t : threads)
+        t.join();
+}
+
+/*******************************************************************************
+ * The number of threads loading the libraries at initialization, from
+ * HIPSPARSELT_INIT_THREADS, or the hardware threads up to 8.
+ ******************************************************************************/
+inline size_t rocsparselt_init_workers()
+{
+    static const size_t workers = [] {
+        const char* env = getenv("HIPSPARSELT_INIT_THREADS");
+        if(env && atoi(env) > 0)
+            return size_t(atoi(env));
+        return std::clamp<size_t>(std::thread::hardware_concurrency(), 1, 8);
+    }();
+    return workers;
+}
@@ -0,0 +1,104 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#pragma once
+#ifndef ROCSPARSELT_PERF_MODEL_HPP
+#define ROCSPARSELT_PERF_MODEL_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/*******************************************************************************
+ * The performance model ranks the kernel solutions of a problem which no search
+ * has timed. The Tensile logic files end with the fastest solution and its GFLOPS
+ * for each size [M, N, B, K] they were tuned with; utils/addPerfTables.py copies
+ * these tables into rocsparselt_perf_tables when the library is built.
+ *
+ * A solution is ranked by the distance from the problem to the nearest size it
+ * was the fastest for, measured in log2 of M, N, B and K, so that a tuned size
+ * ranks its own solution first. Solutions which never were the fastest keep
+ * their order after the others.
+ *
+ * This part only depends on the host.
+ *******************************************************************************/
+
+struct rocsparselt_perf_entry
+{
+    int64_t size[4]; // M, N, B and K
+    int32_t solution; // index into the solutions of the table
+    float   gflops;
+};
+
+struct rocsparselt_perf_table
+{
+    const char*                   arch; // e.g. "gfx942"
+    const char*                   logic; // name of the logic file
+    const char* const*            solutions; // kernel names, by solution index
+    size_t                        solution_count;
+    const rocsparselt_perf_entry* entries;
+    size_t                        entry_count;
+};
+
+extern const rocsparselt_perf_table rocsparselt_perf_tables[];
+extern const size_t                 rocsparselt_perf_table_count;
+
+class rocsparselt_perf_model
+{
+public:
+    rocsparselt_perf_model(const rocsparselt_perf_entry* entries, size_t count);
+
+    // Sets order to the positions of solutions, the most promising one first.
+    void rank(const int64_t               size[4],
+              const std::vector<int32_t>& solutions,
+              std::vector<size_t>*        order) const;
+
+private:
+    struct point
+    {
+        float   x[4]; // log2 of the size
+        int32_t solution;
+        float   gflops;
+    };
+
+    std::vector<point> points;
+};
+
+// Orders names, the kernel names of the solutions found for a problem of size
+// on arch (e.g. "gfx942"), by the table of arch which knows most of them.
+// Returns false if no table knows any of them.
+bool rocsparselt_perf_model_rank(const std::string&              arch,
+                                 const int64_t                   size[4],
+                                 const std::vector<std::string>& names,
+                                 std::vector<size_t>*            order);
+
+// The same, for names kept elsewhere, such as the names cached for the solutions.
+bool rocsparselt_perf_model_rank(const std::string&                     arch,
+                                 const int64_t                          size[4],
+                                 const std::vector<const std::string*>& names,
+                                 std::vector<size_t>*                   order);
+
+#endif // ROCSPARSELT_PERF_MODEL_HPP
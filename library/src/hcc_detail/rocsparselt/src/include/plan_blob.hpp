@@ -0,0 +1,174 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#pragma once
+#ifndef ROCSPARSELT_PLAN_BLOB_HPP
+#define ROCSPARSELT_PLAN_BLOB_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/*******************************************************************************
+ * A plan blob is what rocsparselt_matmul_plan_serialize() writes, so that
+ * rocsparselt_matmul_plan_deserialize() can make the plan again without
+ * validating the descriptors or selecting the algorithm. It is a header with
+ * the matmul descriptor and the attributes of the alg selection, followed by
+ * the configs of the alg selection.
+ *
+ * The configs are only valid for the GPU arch and the kernel library they were
+ * selected with, a blob of another arch or version is rejected. The checksum
+ * covers the whole blob, with the checksum field set to 0.
+ *
+ * This part only depends on the host, the blob of a plan is filled in by
+ * rocsparselt_auxiliary.cpp.
+ *******************************************************************************/
+
+constexpr char     rocsparselt_plan_blob_magic[8] = {'R', 'S', 'L', 'T', 'P', 'L', 'A', 'N'};
+constexpr uint32_t rocsparselt_plan_blob_format   = 1;
+
+struct rocsparselt_plan_blob_matrix
+{
+    int32_t m_type;
+    int32_t type;
+    int32_t order;
+    int32_t sparsity;
+    int32_t num_batches;
+    int32_t alignment;
+    int32_t is_hipsparselt_datatype;
+    int32_t reserved;
+    int64_t m;
+    int64_t n;
+    int64_t ld;
+    int64_t batch_stride;
+    int64_t c_k;
+    int64_t c_ld;
+    int64_t c_n;
+};
+
+struct rocsparselt_plan_blob_config
+{
+    int32_t  index; // index of the kernel solution
+    int32_t  use_bias;
+    int32_t  use_scale_alpha_vec;
+    int32_t  split_k;
+    int32_t  split_k_mode;
+    int32_t  atomics;
+    uint64_t max_workspace_bytes;
+};
+
+struct rocsparselt_plan_blob_header
+{
+    char     magic[8];
+    uint32_t format;
+    uint32_t config_count;
+    uint64_t size; // of the whole blob
+    uint64_t checksum;
+    char     arch[32]; // GPU arch name, without the target features
+    char     version[64]; // library and kernel library version
+
+    // the matmul descriptor, A, B, C and D
+    rocsparselt_plan_blob_matrix matrices[4];
+    int32_t                      op_a;
+    int32_t                      op_b;
+    int32_t                      compute_type;
+    int32_t                      activation;
+    float                        activation_relu_upperbound;
+    float                        activation_relu_threshold;
+    float                        activation_leakyrelu_alpha;
+    float                        activation_tanh_alpha;
+    float                        activation_tanh_beta;
+    float                        activation_gelu_scaling;
+    int32_t                      bias_type;
+    int32_t                      bias_is_hipsparselt_datatype;
+    int64_t                      bias_stride;
+    int32_t                      alpha_vector_scaling;
+    int32_t                      is_sparse_a;
+    int32_t                      pointer_mode;
+    int32_t                      swap_ab;
+    int64_t                      m;
+    int64_t                      n;
+    int64_t                      k;
+    // the problem the kernels run, after A and B are swapped for the row order
+    int32_t _op_a;
+    int32_t _op_b;
+    int64_t _m;
+    int64_t _n;
+    int64_t _k;
+    int64_t _lda;
+    int64_t _ldb;
+    int32_t _is_sparse_a;
+
+    // the alg selection
+    int32_t alg;
+    int32_t config_id;
+    int32_t search_iterations;
+    int32_t candidates;
+    int32_t search_statistic;
+    int32_t search_flush_cache;
+    float   search_min_time;
+    int32_t split_k;
+    int32_t split_k_mode;
+    int32_t atomics;
+    int32_t workspace_streams;
+};
+
+static_assert(sizeof(rocsparselt_plan_blob_matrix) == 88, "the matrix is part of the blob format");
+static_assert(sizeof(rocsparselt_plan_blob_config) == 32, "the config is part of the blob format");
+static_assert(sizeof(rocsparselt_plan_blob_header) == 672,
+              "the header is part of the blob format");
+
+enum class rocsparselt_plan_blob_error
+{
+    none,
+    invalid, // not a plan blob, truncated or corrupted
+    version, // written by another library or kernel library version
+    arch, // written on another GPU arch
+};
+
+// Zeroes header, so that the unused bytes of the strings are deterministic.
+void rocsparselt_plan_blob_clear(rocsparselt_plan_blob_header* header);
+
+// Size of the blob of a plan with config_count configs.
+size_t rocsparselt_plan_blob_size(uint32_t config_count);
+
+// Writes the blob of header and its header.config_count configs to data, which
+// holds rocsparselt_plan_blob_size(header.config_count) bytes. The magic, the
+// format, the size and the checksum are filled in.
+void rocsparselt_plan_blob_write(const rocsparselt_plan_blob_header& header,
+                                 const rocsparselt_plan_blob_config* configs,
+                                 void*                               data);
+
+// Reads the blob of size bytes at data, which must have been written for arch
+// and version.
+rocsparselt_plan_blob_error
+    rocsparselt_plan_blob_read(const void*                                data,
+                               size_t                                     size,
+                               const char*                                arch,
+                               const char*                                version,
+                               rocsparselt_plan_blob_header*              header,
+                               std::vector<rocsparselt_plan_blob_config>* configs);
+
+#endif // ROCSPARSELT_PLAN_BLOB_HPP
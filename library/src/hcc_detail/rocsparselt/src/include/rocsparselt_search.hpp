@@ -0,0 +1,246 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#pragma once
+#ifndef ROCSPARSELT_SEARCH_HPP
+#define ROCSPARSELT_SEARCH_HPP
+
+#include "definitions.h"
+#include "status.h"
+
+#include <algorithm>
+#include <cmath>
+#include <hip/hip_runtime_api.h>
+#include <numeric>
+#include <vector>
+
+/*******************************************************************************
+ * rocsparselt_search_options holds how rocsparselt_matmul_search() times the
+ * candidates, from the attributes of the alg selection.
+ *******************************************************************************/
+struct rocsparselt_search_options
+{
+    int statistic = rocsparselt_search_statistic_mean;
+    // Device memory overwritten before each timed run, so that the run does not find its
+    // inputs in the L2 cache. 0 to not flush.
+    size_t flush_bytes = 0;
+    // Least time in ms each candidate is timed for.
+    float       min_ms = 0.0f;
+    hipStream_t stream = nullptr;
+};
+
+// Fraction of the fastest and of the slowest samples a trimmed mean leaves out.
+constexpr double rocsparselt_search_trim = 0.1;
+
+/*******************************************************************************
+ * rocsparselt_search_stats_of() sums up the samples of a candidate, each the
+ * time of one run, which took total_ms over runs runs.
+ *******************************************************************************/
+inline rocsparselt_matmul_search_result rocsparselt_search_stats_of(std::vector<float> samples,
+                                                                    int                statistic,
+                                                                    float              total_ms,
+                                                                    int                runs)
+{
+    rocsparselt_matmul_search_result stats = {};
+    if(samples.empty() || runs <= 0)
+        return stats;
+
+    std::sort(samples.begin(), samples.end());
+    size_t n        = samples.size();
+    stats.min_ms    = samples.front();
+    stats.max_ms    = samples.back();
+    stats.median_ms = n % 2 ? samples[n / 2] : (samples[n / 2 - 1] + samples[n / 2]) / 2;
+    stats.runs      = runs;
+
+    switch(statistic)
+    {
+    case rocsparselt_search_statistic_median:
+        stats.ms = stats.median_ms;
+        break;
+    case rocsparselt_search_statistic_trimmed_mean:
+    {
+        size_t trim = static_cast<size_t>(n * rocsparselt_search_trim);
+        stats.ms    = std::accumulate(samples.begin() + trim, samples.end() - trim, 0.0)
+                   / (n - 2 * trim);
+        break;
+    }
+    default:
+        stats.ms = total_ms / runs;
+        break;
+    }
+    return stats;
+}
+
+/*******************************************************************************
+ * rocsparselt_search_candidates() times the candidates of a
+ * rocsparselt_matmul_search() by successive halving, and returns the position
+ * of the fastest one in *best and the times of each in *stats.
+ *
+ * launch(i, start, stop, iters) enqueues iters runs of candidate i between the
+ * events start and stop, it records the events which are not nullptr.
+ *
+ * Every candidate runs once to warm up. Then each round enqueues all the
+ * candidates left and waits for the device once. The faster half goes on to
+ * the next round with twice the runs, until one is left or the candidates left
+ * ran search_iterations times. The first round is shortened so that the last
+ * one ends near search_iterations. A round is repeated with more runs, before
+ * any candidate drops out, until all of them were timed for options.min_ms.
+ *
+ * The runs of a candidate in a round are timed together, unless the cache is
+ * flushed before each run or the statistic is not the mean, then each run is
+ * timed on its own and is one sample.
+ *******************************************************************************/
+template <typename Launch>
+rocsparselt_status
+    rocsparselt_search_candidates(int                                            count,
+                                  int                                            search_iterations,
+                                  const rocsparselt_search_options&              options,
+                                  Launch&&                                       launch,
+                                  std::vector<rocsparselt_matmul_search_result>* stats,
+                                  int*                                           best)
+{
+    struct search_resources
+    {
+        ~search_resources()
+        {
+            for(auto event : events)
+                (void)hipEventDestroy(event);
+            if(flush != nullptr)
+                (void)hipFree(flush);
+        }
+        std::vector<hipEvent_t> events;
+        void*                   flush = nullptr;
+    } res;
+
+    if(count <= 0)
+        return rocsparselt_status_internal_error;
+    search_iterations = std::max(search_iterations, 1);
+
+    bool per_run
+        = options.flush_bytes > 0 || options.statistic != rocsparselt_search_statistic_mean;
+    // Bounds the events a round of single runs needs.
+    constexpr int max_round_samples = 4096;
+    constexpr int max_iters         = 1 << 20;
+
+    if(options.flush_bytes > 0)
+        RETURN_IF_HIP_ERROR(hipMalloc(&res.flush, options.flush_bytes));
+
+    auto timed_run = [&](int i, hipEvent_t start, hipEvent_t stop, int iters) {
+        if(res.flush != nullptr)
+        {
+            hipError_t err = hipMemsetAsync(res.flush, 0, options.flush_bytes, options.stream);
+            if(err != hipSuccess)
+                return err;
+        }
+        return launch(i, start, stop, iters);
+    };
+
+    for(int i = 0; i < count; i++)
+        RETURN_IF_HIP_ERROR(launch(i, nullptr, nullptr, 1));
+
+    int rounds = 0;
+    while((1 << rounds) < count)
+        rounds++;
+    // A single candidate is only timed for its statistics.
+    int iters = count == 1 ? 1 : std::max(search_iterations >> rounds, 1);
+
+    std::vector<std::vector<float>> samples(count);
+    std::vector<float>              total_ms(count, 0.0f);
+    std::vector<int>                runs(count, 0);
+    std::vector<int>                left(count);
+    std::iota(left.begin(), left.end(), 0);
+    stats->assign(count, rocsparselt_matmul_search_result());
+
+    while(true)
+    {
+        if(per_run)
+            iters = std::min<int>(iters, std::max<int>(max_round_samples / left.size(), 1));
+        int sample_runs = per_run ? 1 : iters;
+        int sample_size = per_run ? iters : 1;
+
+        size_t pairs = left.size() * sample_size;
+        while(res.events.size() < 2 * pairs)
+        {
+            hipEvent_t event;
+            RETURN_IF_HIP_ERROR(hipEventCreate(&event));
+            res.events.push_back(event);
+        }
+
+        size_t pair = 0;
+        for(int i : left)
+            for(int s = 0; s < sample_size; s++, pair++)
+                RETURN_IF_HIP_ERROR(
+                    timed_run(i, res.events[2 * pair], res.events[2 * pair + 1], sample_runs));
+
+        // One host round trip per round, the stream runs the candidates in order.
+        RETURN_IF_HIP_ERROR(hipEventSynchronize(res.events[2 * pair - 1]));
+        pair = 0;
+        for(int i : left)
+        {
+            for(int s = 0; s < sample_size; s++, pair++)
+            {
+                float sample_ms;
+                RETURN_IF_HIP_ERROR(hipEventElapsedTime(
+                    &sample_ms, res.events[2 * pair], res.events[2 * pair + 1]));
+                total_ms[i] += sample_ms;
+                samples[i].push_back(sample_ms / sample_runs);
+            }
+            runs[i] += iters;
+            (*stats)[i]
+                = rocsparselt_search_stats_of(samples[i], options.statistic, total_ms[i], runs[i]);
+        }
+
+        std::stable_sort(left.begin(), left.end(), [stats](int a, int b) {
+            return (*stats)[a].ms < (*stats)[b].ms;
+        });
+
+        // Runs the round again, so that the candidates left are timed for long enough.
+        int more = 0;
+        for(int i : left)
+        {
+            // A candidate too fast for the events to time never gets there.
+            if(total_ms[i] >= options.min_ms || total_ms[i] <= 0)
+                continue;
+            float ms = total_ms[i] / runs[i];
+            more     = std::max<int>(more, std::ceil((options.min_ms - total_ms[i]) / ms));
+        }
+        if(more > 0)
+        {
+            iters = std::min(more, max_iters);
+            continue;
+        }
+
+        if(left.size() == 1 || runs[left[0]] >= search_iterations)
+            break;
+
+        left.resize((left.size() + 1) / 2);
+        iters = std::max(std::min(iters * 2, search_iterations - runs[left[0]]), 1);
+    }
+
+    *best = left[0];
+    return rocsparselt_status_success;
+}
+
+#endif // ROCSPARSELT_SEARCH_HPP
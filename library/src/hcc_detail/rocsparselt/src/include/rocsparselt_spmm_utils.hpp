@@ -28,6 +28,7 @@
 #define ROCSPARSELT_SPMM_UTILS_HPP
 #include "handle.h"
 #include "hipsparselt_ostream.hpp"
+#include "tuning_db.hpp"
 #include "utility.hpp"
 #if BUILD_WITH_TENSILE
 #include "tensile_host.hpp"
@@ -35,6 +36,7 @@
 #include "kernel_launcher.hpp"
 #endif
 #include <cxxabi.h>
+#include <optional>
 
 inline rocsparselt_status getOriginalSizes(rocsparselt_operation opA,
                                            rocsparselt_operation opB,
@@ -95,6 +97,29 @@ inline void initSparseMatrixLayout(rocsparselt_operation          op,
             std::swap(_sparseMatDescr->c_ld, _sparseMatDescr->c_n);
     }
 }
+/*******************************************************************************
+ * Returns count events of the calling thread, created on first use on the
+ * current HIP device. They fork and join the streams of a multi-stream matmul.
+ *******************************************************************************/
+rocsparselt_status rocsparselt_internal_stream_events(int device, int count, hipEvent_t** events);
+
+/*******************************************************************************
+ * Returns the GPU arch name of the device of the handle, without the target
+ * features, and the version of the library and of its kernel library, which the
+ * solution indices of the configs are valid for.
+ *******************************************************************************/
+rocsparselt_status rocsparselt_internal_arch_and_version(const _rocsparselt_handle* handle,
+                                                         std::string*               arch,
+                                                         std::string*               version);
+
+/*******************************************************************************
+ * Fills in the tuning database key of a matmul descriptor on the device of the
+ * handle.
+ *******************************************************************************/
+rocsparselt_status rocsparselt_internal_tuning_key(const _rocsparselt_handle*       handle,
+                                                   const _rocsparselt_matmul_descr* matmulDescr,
+                                                   rocsparselt_tuning_key*          key);
+
 /*******************************************************************************
  * Get the offset of the metatdata (in bytes)
  ******************************************************************************/
@@ -408,9 +433,10 @@ inline rocsparselt_status validateMatmulDescrArgs(const _rocsparselt_handle* han
 }
 
 template <typename Ti, typename To, typename Tc>
-rocsparselt_status ConstructRocSparseLtProblem(const char*                                 caller,
-                                               RocsparseltContractionProblem<Ti, To, Tc>** prob,
-                                               const _rocsparselt_matmul_descr*            matDescr,
+rocsparselt_status
+    ConstructRocSparseLtProblem(const char*                                               caller,
+                                std::optional<RocsparseltContractionProblem<Ti, To, Tc>>* prob,
+                                const _rocsparselt_matmul_descr*                          matDescr,
                                                const Tc*    alpha         = nullptr,
                                                const Tc*    beta          = nullptr,
                                                const Ti*    a             = nullptr,
@@ -424,20 +450,18 @@ rocsparselt_status ConstructRocSparseLtProblem(const char*
                                                int32_t      numStreams    = 0);
 
 template <typename Ti, typename To, typename Tc>
-rocsparselt_status findTopConfigs(const _rocsparselt_matmul_descr* matmulDescr,
-                                  _rocsparselt_matmul_config*      configs,
-                                  int*                             config_max_id,
-                                  const int                        requestConfigs = 10)
+rocsparselt_status findTopConfigs(const _rocsparselt_matmul_descr*         matmulDescr,
+                                  std::vector<_rocsparselt_matmul_config>* configs,
+                                  const int                                requestConfigs)
 {
-    RocsparseltContractionProblem<Ti, To, Tc>* prob;
-    Tc                                         alpha = static_cast<Tc>(1.0f);
-    Tc                                         beta  = static_cast<Tc>(1.0f);
-    auto                                       status
+    std::optional<RocsparseltContractionProblem<Ti, To, Tc>> prob;
+    Tc                                                       alpha = static_cast<Tc>(1.0f);
+    Tc                                                       beta  = static_cast<Tc>(1.0f);
+    auto                                                     status
         = ConstructRocSparseLtProblem<Ti, To, Tc>(__func__, &prob, matmulDescr, &alpha, &beta);
     if(status != rocsparselt_status_success)
         return status;
-    getBestSolutions<Ti, To, Tc>(*prob, requestConfigs, configs, config_max_id);
-    delete prob;
+    getBestSolutions<Ti, To, Tc>(*prob, requestConfigs, configs);
     return status;
 }
 #endif
@@ -0,0 +1,126 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#pragma once
+#ifndef ROCSPARSELT_STARTUP_TIMING_HPP
+#define ROCSPARSELT_STARTUP_TIMING_HPP
+
+#include <chrono>
+#include <string>
+
+/*******************************************************************************
+ * The startup timing records how long the library spends in each phase before
+ * the first matmul of the process: finding its kernel files, loading them and
+ * querying the devices, then the first solution query and the first launch.
+ * The phases are indexed by the values of rocsparselt_startup_phase, which
+ * rocsparselt_get_startup_timing() reports.
+ *
+ * A phase may happen several times, e.g. a code object load per file and
+ * device, possibly on several threads at once, so the total of a phase is
+ * the sum over its occurrences and may exceed the wall time it took.
+ *
+ * This part only depends on the host.
+ *******************************************************************************/
+
+constexpr int rocsparselt_startup_phase_count = 7;
+
+struct rocsparselt_startup_time
+{
+    double first_ms = 0; // time of the first occurrence
+    double total_ms = 0; // sum of the times of all the occurrences
+    int    count    = 0; // number of occurrences
+};
+
+// Adds an occurrence of the phase
+void rocsparselt_startup_record(int phase, double ms);
+
+// Records an occurrence only if the phase has none, returns whether it did
+bool rocsparselt_startup_record_first(int phase, double ms);
+
+// Whether the phase has an occurrence, without locking
+bool rocsparselt_startup_recorded(int phase);
+
+rocsparselt_startup_time rocsparselt_startup_get(int phase);
+
+// Name of the phase in the summary, nullptr for an invalid phase
+const char* rocsparselt_startup_phase_name(int phase);
+
+// One line with the phases which happened, e.g.
+// "path_discovery 0.412 ms, code_object_load 153.020 ms (96), ..."
+std::string rocsparselt_startup_summary();
+
+// Whether HIPSPARSELT_STARTUP_SUMMARY asks for the summary to be logged
+bool rocsparselt_startup_summary_enabled();
+
+// Forgets all the occurrences, for the tests
+void rocsparselt_startup_reset();
+
+/*******************************************************************************
+ * rocsparselt_startup_timer times a phase from its construction to stop() or
+ * its destruction. With once, it does nothing if the phase already has an
+ * occurrence, so that a hot path such as a launch only pays an atomic load.
+ *******************************************************************************/
+class rocsparselt_startup_timer
+{
+public:
+    explicit rocsparselt_startup_timer(int phase, bool once = false)
+        : phase(phase)
+        , once(once)
+        , active(!once || !rocsparselt_startup_recorded(phase))
+    {
+        if(active)
+            start = std::chrono::steady_clock::now();
+    }
+
+    rocsparselt_startup_timer(const rocsparselt_startup_timer&) = delete;
+    rocsparselt_startup_timer& operator=(const rocsparselt_startup_timer&) = delete;
+
+    ~rocsparselt_startup_timer()
+    {
+        stop();
+    }
+
+    // Records the time of the phase, returns whether this timer recorded it
+    bool stop()
+    {
+        if(!active)
+            return false;
+        active       = false;
+        auto   elapsed = std::chrono::steady_clock::now() - start;
+        double ms      = std::chrono::duration<double, std::milli>(elapsed).count();
+        if(once)
+            return rocsparselt_startup_record_first(phase, ms);
+        rocsparselt_startup_record(phase, ms);
+        return true;
+    }
+
+private:
+    int                                   phase;
+    bool                                  once;
+    bool                                  active;
+    std::chrono::steady_clock::time_point start;
+};
+
+#endif // ROCSPARSELT_STARTUP_TIMING_HPP
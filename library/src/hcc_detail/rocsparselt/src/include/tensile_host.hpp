@@ -431,7 +431,7 @@ struct RocsparseltContractionProblem
                             "K",
                             prob.k,
                             "alpha",
-                            *prob.alpha,
+                            prob.alpha_vector_scaling ? static_cast<Tc>(1) : *prob.alpha,
                             "row_stride_a",
                             prob.row_stride_a,
                             "col_stride_a",
@@ -482,18 +482,34 @@ struct RocsparseltContractionProblem
 /*******************************************************************************
  * runContractionProblem() solves a RocsparseltContractionProblem                  *
  *******************************************************************************/
+struct rocsparselt_search_options;
+
 template <typename Ti, typename To, typename Tc>
 rocsparselt_status runContractionProblem(RocsparseltContractionProblem<Ti, To, Tc> const& problem,
                                          _rocsparselt_matmul_config*                      configs,
                                          int*                                             config_id,
-                                         const int config_max_id,
-                                         const int search_iterations);
+                                         const int                         config_max_id,
+                                         const int                         search_iterations,
+                                         const rocsparselt_search_options* search_options,
+                                         _rocsparselt_matmul_exec_cache*   exec_cache = nullptr,
+                                         int                               exec_slot  = 0);
+
+/*******************************************************************************
+ * validateContractionProblem() tells whether the selected config can run a    *
+ * part of a problem split across streams on its own, see spmm_stream_parts()  *
+ *******************************************************************************/
+template <typename Ti, typename To, typename Tc>
+bool validateContractionProblem(const RocsparseltContractionProblem<Ti, To, Tc>& problem,
+                                const _rocsparselt_matmul_config*                configs,
+                                int                                              config_id,
+                                _rocsparselt_matmul_exec_cache*                  exec_cache,
+                                int                                              exec_slot,
+                                bool                                             whole_tiles);
 
 template <typename Ti, typename To, typename Tc>
 rocsparselt_status getBestSolutions(const RocsparseltContractionProblem<Ti, To, Tc>& prob,
                                     int                                              requestConfigs,
-                                    _rocsparselt_matmul_config*                      configs,
-                                    int*                                             foundConfigs);
+                                    std::vector<_rocsparselt_matmul_config>*         configs);
 
 /***********************************************************************************
  * Whether Tensile has been initialized for at least one device (used for testing) *
@@ -0,0 +1,151 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#pragma once
+#ifndef ROCSPARSELT_TUNING_DB_HPP
+#define ROCSPARSELT_TUNING_DB_HPP
+
+#include <cstdint>
+#include <ctime>
+#include <mutex>
+#include <string>
+#include <sys/types.h>
+#include <vector>
+
+/*******************************************************************************
+ * The tuning database remembers the config rocsparselt_matmul_search() picked
+ * for a problem, so that rocsparselt_matmul_alg_selection_init() selects it again,
+ * in this and in later processes. HIPSPARSELT_TUNING_DB names the file.
+ *
+ * The file is a header followed by the entries sorted by key. Readers map it and
+ * search it in place. Writers take turns on "<file>.lock", write the merged
+ * entries into a temporary file and rename it over the old one, so a reader
+ * always maps a complete file, and many processes can share one.
+ *
+ * This part only depends on the host, the key of a matmul descriptor is made by
+ * rocsparselt_internal_tuning_key().
+ *******************************************************************************/
+
+constexpr char     rocsparselt_tuning_db_magic[8] = {'R', 'S', 'L', 'T', 'T', 'U', 'N', 'E'};
+constexpr uint32_t rocsparselt_tuning_db_format   = 2;
+
+// Keys are compared with memcmp, rocsparselt_tuning_key_clear() zeroes the
+// unused bytes of the strings before a key is filled in.
+struct rocsparselt_tuning_key
+{
+    char    arch[32]; // GPU arch name, without the target features
+    char    version[64]; // library and kernel library version
+    int32_t op_a;
+    int32_t op_b;
+    int32_t compute_type;
+    int32_t sparse_a; // 1 if A is the structured matrix, 0 if B is
+    int32_t activation;
+    int32_t bias_type; // -1 without a bias vector
+    int32_t alpha_vector_scaling;
+    int32_t reserved;
+    int32_t type[4]; // A, B, C and D
+    int32_t order[4];
+    int64_t rows[4];
+    int64_t cols[4];
+    int64_t ld[4];
+    int64_t batches[4];
+    int64_t batch_stride[4];
+};
+
+struct rocsparselt_tuning_entry
+{
+    rocsparselt_tuning_key key;
+    int32_t                solution_index; // index of the kernel solution of the selected config
+    int32_t                split_k; // how the selected config splits the K loop
+    int32_t                split_k_mode; // a rocsparselt_split_k_mode
+    int32_t                atomics; // 1 if the selected config uses atomics
+    int32_t                reserved;
+    float                  ms; // time of one run of the selected config
+};
+
+struct rocsparselt_tuning_db_header
+{
+    char     magic[8];
+    uint32_t format;
+    uint32_t entry_size;
+    uint64_t count;
+};
+
+static_assert(sizeof(rocsparselt_tuning_key) == 320, "the key is part of the file format");
+static_assert(sizeof(rocsparselt_tuning_entry) == 344, "the entry is part of the file format");
+static_assert(sizeof(rocsparselt_tuning_db_header) == 24,
+              "the header is part of the file format");
+
+void rocsparselt_tuning_key_clear(rocsparselt_tuning_key* key);
+bool operator<(const rocsparselt_tuning_key& lhs, const rocsparselt_tuning_key& rhs);
+bool operator==(const rocsparselt_tuning_key& lhs, const rocsparselt_tuning_key& rhs);
+
+class rocsparselt_tuning_db
+{
+public:
+    explicit rocsparselt_tuning_db(std::string path);
+    ~rocsparselt_tuning_db();
+
+    rocsparselt_tuning_db(const rocsparselt_tuning_db&) = delete;
+    rocsparselt_tuning_db& operator=(const rocsparselt_tuning_db&) = delete;
+
+    const std::string& path() const
+    {
+        return db_path;
+    }
+
+    // Finds key in the current file. Returns false if it is not there, or if the
+    // file does not exist or is not a tuning database.
+    bool lookup(const rocsparselt_tuning_key& key, rocsparselt_tuning_entry* entry);
+
+    // Reads all entries of the current file.
+    bool read(std::vector<rocsparselt_tuning_entry>* entries);
+
+    // Adds the entries to the file, or replaces the ones with the same key.
+    // Returns false and leaves errno set if the file could not be written.
+    bool update(const rocsparselt_tuning_entry* entries, size_t count);
+
+private:
+    // Maps the file again if it was replaced since it was mapped.
+    void refresh();
+    void unmap();
+
+    const rocsparselt_tuning_entry* begin() const;
+    const rocsparselt_tuning_entry* end() const;
+
+    std::string db_path;
+    std::mutex  mutex;
+
+    const void*     map       = nullptr;
+    size_t          map_size  = 0;
+    dev_t           map_dev   = 0;
+    ino_t           map_ino   = 0;
+    struct timespec map_mtime = {};
+};
+
+// The database named by HIPSPARSELT_TUNING_DB, or nullptr if it is not set.
+rocsparselt_tuning_db* rocsparselt_internal_tuning_db();
+
+#endif // ROCSPARSELT_TUNING_DB_HPP
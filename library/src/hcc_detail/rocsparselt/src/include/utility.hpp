@@ -32,8 +32,10 @@
 #include "auxiliary.hpp"
 #include "handle.h"
 #include "logging.h"
+#include "startup_timing.hpp"
 #include <algorithm>
 #include <exception>
+#include <sstream>
 
 #pragma STDC CX_LIMITED_RANGE ON
 
@@ -123,11 +125,11 @@ void log_base(const _rocsparselt_handle* handle,
         {
             std::string comma_separator = ",";
 
-            std::ostream* os = handle->log_trace_os;
-
             std::string prefix_str = prefix(rocsparselt_layer_mode2string(layer_mode), func);
 
-            log_arguments(*os, comma_separator, prefix_str, head, std::forward<Ts>(xs)...);
+            std::ostringstream line;
+            log_arguments(line, comma_separator, prefix_str, head, std::forward<Ts>(xs)...);
+            rocsparselt_internal_log_write(handle->log_trace_os, line.str());
         }
     }
 }
@@ -187,6 +189,35 @@ void log_api(const _rocsparselt_handle* handle, const char* func, H head, Ts&&..
     log_base(handle, rocsparselt_layer_mode_log_api, func, head, std::forward<Ts>(xs)...);
 }
 
+// if logging is turned on for the process with HIPSPARSELT_LOG_LEVEL or
+// HIPSPARSELT_LOG_MASK, log_process logs where there is no handle, such as
+// the initialization of the devices.
+template <typename H, typename... Ts>
+void log_process(rocsparselt_layer_mode layer_mode, const char* func, H head, Ts&&... xs)
+{
+    static const int process_layer_mode = rocsparselt_internal_env_layer_mode();
+    if(process_layer_mode & layer_mode)
+    {
+        std::string comma_separator = ",";
+        std::string prefix_str      = prefix(rocsparselt_layer_mode2string(layer_mode), func);
+
+        std::ostringstream line;
+        log_arguments(line, comma_separator, prefix_str, head, std::forward<Ts>(xs)...);
+        rocsparselt_internal_log_write(rocsparselt_internal_log_trace_os(), line.str());
+    }
+}
+
+// with HIPSPARSELT_STARTUP_SUMMARY set, log_startup_summary logs the times of
+// the startup phases in one line, whatever the log level. It is called once,
+// by the first launch of a matmul.
+inline void log_startup_summary(const char* func)
+{
+    if(rocsparselt_startup_summary_enabled())
+        rocsparselt_internal_log_write(rocsparselt_internal_log_trace_os(),
+                                       prefix("startup", func) + " "
+                                           + rocsparselt_startup_summary() + "\n");
+}
+
 // if bench logging is turned on with
 // (handle->layer_mode & rocsparselt_layer_mode_log_bench) == true
 // then
@@ -202,11 +233,11 @@ void log_bench(
         {
             std::string comma_separator = " ";
 
-            std::ostream* os = handle->log_bench_os;
-
             std::string prefix_str = prefix("Bench", func);
 
-            log_arguments(*os, comma_separator, prefix_str, head, std::forward<Ts>(xs)...);
+            std::ostringstream line;
+            log_arguments(line, comma_separator, prefix_str, head, std::forward<Ts>(xs)...);
+            rocsparselt_internal_log_write(handle->log_bench_os, line.str());
         }
     }
 }
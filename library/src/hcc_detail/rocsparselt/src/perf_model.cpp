@@ -0,0 +1,176 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include "perf_model.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+static void perf_model_log2(const int64_t size[4], float x[4])
+{
+    for(int i = 0; i < 4; i++)
+        x[i] = std::log2(float(std::max<int64_t>(size[i], 1)));
+}
+
+rocsparselt_perf_model::rocsparselt_perf_model(const rocsparselt_perf_entry* entries,
+                                               size_t                        count)
+{
+    points.resize(count);
+    for(size_t i = 0; i < count; i++)
+    {
+        perf_model_log2(entries[i].size, points[i].x);
+        points[i].solution = entries[i].solution;
+        points[i].gflops   = entries[i].gflops;
+    }
+}
+
+void rocsparselt_perf_model::rank(const int64_t               size[4],
+                                  const std::vector<int32_t>& solutions,
+                                  std::vector<size_t>*        order) const
+{
+    float x[4];
+    perf_model_log2(size, x);
+
+    // The nearest size each solution was the fastest for, and its GFLOPS
+    struct nearest
+    {
+        float distance = std::numeric_limits<float>::infinity();
+        float gflops   = 0;
+    };
+    std::unordered_map<int32_t, nearest> best;
+    for(auto solution : solutions)
+        best.emplace(solution, nearest());
+
+    for(auto& p : points)
+    {
+        auto it = best.find(p.solution);
+        if(it == best.end())
+            continue;
+        float distance = 0;
+        for(int i = 0; i < 4; i++)
+            distance += (p.x[i] - x[i]) * (p.x[i] - x[i]);
+        auto& b = it->second;
+        if(distance < b.distance || (distance == b.distance && p.gflops > b.gflops))
+        {
+            b.distance = distance;
+            b.gflops   = p.gflops;
+        }
+    }
+
+    order->resize(solutions.size());
+    for(size_t i = 0; i < order->size(); i++)
+        (*order)[i] = i;
+    std::stable_sort(order->begin(), order->end(), [&](size_t lhs, size_t rhs) {
+        auto& l = best[solutions[lhs]];
+        auto& r = best[solutions[rhs]];
+        return l.distance < r.distance || (l.distance == r.distance && l.gflops > r.gflops);
+    });
+}
+
+namespace
+{
+    // A model and the solution indices by kernel name of one table
+    struct perf_table_model
+    {
+        explicit perf_table_model(const rocsparselt_perf_table& table)
+            : model(table.entries, table.entry_count)
+        {
+            for(size_t i = 0; i < table.solution_count; i++)
+                if(*table.solutions[i])
+                    solutions.emplace(table.solutions[i], int32_t(i));
+        }
+
+        rocsparselt_perf_model                   model;
+        std::unordered_map<std::string, int32_t> solutions;
+    };
+
+    const perf_table_model& perf_model_of(const rocsparselt_perf_table& table)
+    {
+        // Built the first time a problem uses the table, and kept for the process.
+        using models_t = std::map<const rocsparselt_perf_table*, std::unique_ptr<perf_table_model>>;
+        static std::mutex mutex;
+        static models_t   models;
+
+        std::lock_guard<std::mutex> lock(mutex);
+        auto&                       model = models[&table];
+        if(!model)
+            model = std::make_unique<perf_table_model>(table);
+        return *model;
+    }
+}
+
+bool rocsparselt_perf_model_rank(const std::string&              arch,
+                                 const int64_t                   size[4],
+                                 const std::vector<std::string>& names,
+                                 std::vector<size_t>*            order)
+{
+    std::vector<const std::string*> name_ptrs;
+    name_ptrs.reserve(names.size());
+    for(auto& name : names)
+        name_ptrs.push_back(&name);
+    return rocsparselt_perf_model_rank(arch, size, name_ptrs, order);
+}
+
+bool rocsparselt_perf_model_rank(const std::string&                     arch,
+                                 const int64_t                          size[4],
+                                 const std::vector<const std::string*>& names,
+                                 std::vector<size_t>*                   order)
+{
+    const perf_table_model* best       = nullptr;
+    size_t                  best_known = 0;
+    for(size_t t = 0; t < rocsparselt_perf_table_count; t++)
+    {
+        auto& table = rocsparselt_perf_tables[t];
+        if(arch != table.arch)
+            continue;
+        auto&  model = perf_model_of(table);
+        size_t known = std::count_if(names.begin(), names.end(), [&](const std::string* name) {
+            return model.solutions.count(*name) != 0;
+        });
+        if(known > best_known)
+        {
+            best       = &model;
+            best_known = known;
+        }
+    }
+    if(best == nullptr)
+        return false;
+
+    // Names the table does not know get an index no entry has.
+    std::vector<int32_t> solutions;
+    solutions.reserve(names.size());
+    for(auto name : names)
+    {
+        auto it = best->solutions.find(*name);
+        solutions.push_back(it == best->solutions.end() ? -1 : it->second);
+    }
+    best->model.rank(size, solutions, order);
+    return true;
+}
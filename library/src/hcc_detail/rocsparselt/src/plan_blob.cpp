@@ -0,0 +1,110 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include "plan_blob.hpp"
+
+#include <cstring>
+
+// FNV-1a of the blob, with the checksum field read as 0.
+static uint64_t plan_blob_checksum(const void* data, size_t size)
+{
+    constexpr size_t skip_begin = offsetof(rocsparselt_plan_blob_header, checksum);
+    constexpr size_t skip_end   = skip_begin + sizeof(uint64_t);
+
+    auto     bytes = static_cast<const unsigned char*>(data);
+    uint64_t hash  = 14695981039346656037ull;
+    for(size_t i = 0; i < size; i++)
+    {
+        hash ^= i >= skip_begin && i < skip_end ? 0 : bytes[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+void rocsparselt_plan_blob_clear(rocsparselt_plan_blob_header* header)
+{
+    memset(header, 0, sizeof(*header));
+}
+
+size_t rocsparselt_plan_blob_size(uint32_t config_count)
+{
+    return sizeof(rocsparselt_plan_blob_header)
+           + size_t(config_count) * sizeof(rocsparselt_plan_blob_config);
+}
+
+void rocsparselt_plan_blob_write(const rocsparselt_plan_blob_header& header,
+                                 const rocsparselt_plan_blob_config* configs,
+                                 void*                               data)
+{
+    rocsparselt_plan_blob_header h = header;
+    memcpy(h.magic, rocsparselt_plan_blob_magic, sizeof(h.magic));
+    h.format   = rocsparselt_plan_blob_format;
+    h.size     = rocsparselt_plan_blob_size(h.config_count);
+    h.checksum = 0;
+
+    auto bytes = static_cast<char*>(data);
+    memcpy(bytes, &h, sizeof(h));
+    memcpy(bytes + sizeof(h), configs, h.config_count * sizeof(rocsparselt_plan_blob_config));
+
+    h.checksum = plan_blob_checksum(data, h.size);
+    memcpy(bytes + offsetof(rocsparselt_plan_blob_header, checksum),
+           &h.checksum,
+           sizeof(h.checksum));
+}
+
+rocsparselt_plan_blob_error
+    rocsparselt_plan_blob_read(const void*                                data,
+                               size_t                                     size,
+                               const char*                                arch,
+                               const char*                                version,
+                               rocsparselt_plan_blob_header*              header,
+                               std::vector<rocsparselt_plan_blob_config>* configs)
+{
+    if(data == nullptr || size < sizeof(*header))
+        return rocsparselt_plan_blob_error::invalid;
+
+    // The blob may come from a file, it is not necessarily aligned.
+    memcpy(header, data, sizeof(*header));
+    if(memcmp(header->magic, rocsparselt_plan_blob_magic, sizeof(header->magic)) != 0
+       || header->format != rocsparselt_plan_blob_format
+       || header->size != rocsparselt_plan_blob_size(header->config_count) || header->size > size
+       || header->checksum != plan_blob_checksum(data, header->size))
+        return rocsparselt_plan_blob_error::invalid;
+
+    // The strings are terminated when they are written.
+    if(header->arch[sizeof(header->arch) - 1] != '\0'
+       || header->version[sizeof(header->version) - 1] != '\0')
+        return rocsparselt_plan_blob_error::invalid;
+    if(strcmp(header->version, version) != 0)
+        return rocsparselt_plan_blob_error::version;
+    if(strcmp(header->arch, arch) != 0)
+        return rocsparselt_plan_blob_error::arch;
+
+    configs->resize(header->config_count);
+    memcpy(configs->data(),
+           static_cast<const char*>(data) + sizeof(*header),
+           header->config_count * sizeof(rocsparselt_plan_blob_config));
+    return rocsparselt_plan_blob_error::none;
+}
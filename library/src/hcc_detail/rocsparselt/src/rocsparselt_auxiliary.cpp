@@ -31,12 +31,17 @@
 #else
 #include "kernel_launcher.hpp"
 #endif
+#include "plan_blob.hpp"
 #include "rocsparselt.h"
 #include "rocsparselt_spmm_utils.hpp"
+#include "startup_timing.hpp"
 #include "status.h"
+#include "tuning_db.hpp"
 #include "utility.hpp"
 
+#include <algorithm>
 #include <hip/hip_runtime_api.h>
+#include <hipsparselt/hipsparselt-version.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -165,6 +170,131 @@ rocsparselt_status rocsparselt_destroy(const rocsparselt_handle* handle)
     return rocsparselt_status_success;
 }
 
+/********************************************************************************
+ * \brief set the pointer mode of alpha and beta
+ *******************************************************************************/
+rocsparselt_status rocsparselt_set_pointer_mode(rocsparselt_handle*      handle,
+                                               rocsparselt_pointer_mode mode)
+{
+    if(handle == nullptr)
+    {
+        hipsparselt_cerr << "handle is a NULL pointer" << std::endl;
+        return rocsparselt_status_invalid_handle;
+    }
+
+    auto _handle = reinterpret_cast<_rocsparselt_handle*>(handle);
+    if(!_handle->isInit())
+    {
+        hipsparselt_cerr << "handle did not initialized or already destroyed" << std::endl;
+        return rocsparselt_status_invalid_handle;
+    }
+
+    if(mode != rocsparselt_pointer_mode_host && mode != rocsparselt_pointer_mode_device)
+    {
+        log_error(_handle, __func__, "mode is invalid", mode);
+        return rocsparselt_status_invalid_value;
+    }
+
+    log_api(_handle, __func__, "handle[in]", _handle, "mode[in]", mode);
+    _handle->pointer_mode = mode;
+    return rocsparselt_status_success;
+}
+
+/********************************************************************************
+ * \brief get the pointer mode of alpha and beta
+ *******************************************************************************/
+rocsparselt_status rocsparselt_get_pointer_mode(const rocsparselt_handle* handle,
+                                               rocsparselt_pointer_mode* mode)
+{
+    if(handle == nullptr)
+    {
+        hipsparselt_cerr << "handle is a NULL pointer" << std::endl;
+        return rocsparselt_status_invalid_handle;
+    }
+
+    auto _handle = reinterpret_cast<const _rocsparselt_handle*>(handle);
+    if(!_handle->isInit())
+    {
+        hipsparselt_cerr << "handle did not initialized or already destroyed" << std::endl;
+        return rocsparselt_status_invalid_handle;
+    }
+
+    if(mode == nullptr)
+    {
+        log_error(_handle, __func__, "mode is a NULL pointer");
+        return rocsparselt_status_invalid_pointer;
+    }
+
+    *mode = _handle->pointer_mode;
+    log_api(_handle, __func__, "handle[in]", _handle, "mode[out]", *mode);
+    return rocsparselt_status_success;
+}
+
+/********************************************************************************
+ * \brief enable or disable the workspace pool of the handle
+ *******************************************************************************/
+rocsparselt_status rocsparselt_set_workspace_pool(rocsparselt_handle* handle, int enable)
+{
+    if(handle == nullptr)
+    {
+        hipsparselt_cerr << "handle is a NULL pointer" << std::endl;
+        return rocsparselt_status_invalid_handle;
+    }
+
+    auto _handle = reinterpret_cast<_rocsparselt_handle*>(handle);
+    if(!_handle->isInit())
+    {
+        hipsparselt_cerr << "handle did not initialized or already destroyed" << std::endl;
+        return rocsparselt_status_invalid_handle;
+    }
+
+    if(enable != 0 && enable != 1)
+    {
+        log_error(_handle, __func__, "enable is invalid", enable);
+        return rocsparselt_status_invalid_value;
+    }
+
+    log_api(_handle, __func__, "handle[in]", _handle, "enable[in]", enable);
+    if(enable && _handle->workspace_pool == nullptr)
+        _handle->workspace_pool = new _rocsparselt_workspace_pool;
+    else if(!enable)
+    {
+        delete _handle->workspace_pool;
+        _handle->workspace_pool = nullptr;
+    }
+    return rocsparselt_status_success;
+}
+
+/********************************************************************************
+ * \brief get the device memory held by the workspace pool of the handle
+ *******************************************************************************/
+rocsparselt_status rocsparselt_get_workspace_pool_size(const rocsparselt_handle* handle,
+                                                       size_t*                   size)
+{
+    if(handle == nullptr)
+    {
+        hipsparselt_cerr << "handle is a NULL pointer" << std::endl;
+        return rocsparselt_status_invalid_handle;
+    }
+
+    auto _handle = reinterpret_cast<const _rocsparselt_handle*>(handle);
+    if(!_handle->isInit())
+    {
+        hipsparselt_cerr << "handle did not initialized or already destroyed" << std::endl;
+        return rocsparselt_status_invalid_handle;
+    }
+
+    if(size == nullptr)
+    {
+        log_error(_handle, __func__, "size is a NULL pointer");
+        return rocsparselt_status_invalid_pointer;
+    }
+
+    *size = _handle->workspace_pool == nullptr ? 0 : _handle->workspace_pool->size();
+    log_api(_handle, __func__, "handle[in]", _handle, "size[out]", *size);
+    return rocsparselt_status_success;
+}
+
 /********************************************************************************
  * \brief rocsparse_mat_descr is a structure holding the rocsparselt matrix
  * content. It must be initialized using rocsparselt_dense_descr_init() or
@@ -745,6 +875,15 @@ rocsparselt_status rocsparselt_matmul_descr_init(const rocsparselt_handle*    ha
             if(status != rocsparselt_status_success)
                 return status;
 
+#if !BUILD_WITH_TENSILE
+            // the kernels of the launcher only take alpha by value, see spmm_device_scalars()
+            if(_handle->pointer_mode == rocsparselt_pointer_mode_device)
+            {
+                log_error(_handle, __func__, "device pointer mode requires the Tensile backend");
+                return rocsparselt_status_not_implemented;
+            }
+#endif
+
             auto _matmulDescr = reinterpret_cast<_rocsparselt_matmul_descr*>(matmulDescr);
             _rocsparselt_matmul_descr tmpDescr(_handle);
             memcpy(_matmulDescr, &tmpDescr, sizeof(_rocsparselt_matmul_descr));
@@ -801,6 +940,7 @@ rocsparselt_status rocsparselt_matmul_descr_init(const rocsparselt_handle*    ha
             _matmulDescr->m            = m;
             _matmulDescr->n            = n;
             _matmulDescr->k            = k;
+            _matmulDescr->pointer_mode = _handle->pointer_mode;
             switch(_matA->type)
             {
             case HIP_R_16BF:
@@ -1232,6 +1372,217 @@ rocsparselt_status
     }
 }
 
+/********************************************************************************
+ * \brief keeps the best candidates of the ranked configs, but at least the best
+ * one of each split-K factor, so that the search times all of the factors.
+ *******************************************************************************/
+static void rocsparselt_alg_selection_pick(int                                      candidates,
+                                           std::vector<_rocsparselt_matmul_config>* configs)
+{
+    if(candidates <= 0 || configs->size() <= size_t(candidates))
+        return;
+
+    std::vector<bool> picked(configs->size(), false);
+    std::vector<int>  factors;
+    int               count = 0;
+    for(size_t i = 0; i < configs->size() && count < candidates; i++)
+    {
+        int split_k = (*configs)[i].split_k;
+        if(std::find(factors.begin(), factors.end(), split_k) == factors.end())
+        {
+            factors.push_back(split_k);
+            picked[i] = true;
+            count++;
+        }
+    }
+    for(size_t i = 0; i < configs->size() && count < candidates; i++)
+    {
+        if(!picked[i])
+        {
+            picked[i] = true;
+            count++;
+        }
+    }
+
+    std::vector<_rocsparselt_matmul_config> best;
+    best.reserve(candidates);
+    for(size_t i = 0; i < configs->size(); i++)
+        if(picked[i])
+            best.push_back((*configs)[i]);
+    configs->swap(best);
+}
+
+/********************************************************************************
+ * \brief checks whether config is the one a tuning database entry remembers. A
+ * kernel solution can be run with several split-K settings.
+ *******************************************************************************/
+static bool rocsparselt_tuning_entry_matches(const rocsparselt_tuning_entry&   entry,
+                                             const _rocsparselt_matmul_config& config)
+{
+    return config.index == entry.solution_index && config.split_k == entry.split_k
+           && config.split_k_mode == entry.split_k_mode && config.atomics == entry.atomics;
+}
+
+/********************************************************************************
+ * \brief collects the configs of an alg selection for matmulDescr, the ones
+ * which match its split-K and atomics attributes, the best candidates of them or
+ * all of them if candidates is 0. The one a search picked before comes first if
+ * the tuning database remembers it, it is kept whatever the candidates are.
+ *******************************************************************************/
+static rocsparselt_status
+    rocsparselt_alg_selection_collect(const _rocsparselt_handle*               _handle,
+                                      const _rocsparselt_matmul_descr*         _matmulDescr,
+                                      const _rocsparselt_matmul_alg_selection& selection,
+                                      std::vector<_rocsparselt_matmul_config>* configs)
+{
+    auto in_type      = _matmulDescr->matrix_A->type;
+    auto out_type     = _matmulDescr->matrix_D->type;
+    auto compute_type = _matmulDescr->compute_type;
+
+    configs->clear();
+
+    // The config a search picked before, if the tuning database remembers one.
+    auto                     db     = rocsparselt_internal_tuning_db();
+    bool                     stored = false;
+    rocsparselt_tuning_entry entry;
+    if(db != nullptr)
+    {
+        rocsparselt_tuning_key key;
+        RETURN_IF_ROCSPARSELT_ERROR(rocsparselt_internal_tuning_key(_handle, _matmulDescr, &key));
+        stored = db->lookup(key, &entry);
+    }
+
+#if BUILD_WITH_TENSILE
+    // Only the candidates are asked for, unless the split-K attributes filter the configs or the
+    // stored config has to be found. Then all applicable configs are, they are picked below.
+    const bool filtered = selection.split_k > 0 || selection.split_k_mode >= 0
+                          || selection.atomics == rocsparselt_atomics_not_allowed;
+    const int requestConfigs = filtered || stored ? 0 : std::max(selection.candidates, 0);
+
+    rocsparselt_status status = rocsparselt_status_success;
+
+    if(in_type == HIP_R_16F && out_type == HIP_R_16F && compute_type == rocsparselt_compute_f32)
+    {
+        status = findTopConfigs<__half, __half, float>(_matmulDescr, configs, requestConfigs);
+    }
+    else if(in_type == HIP_R_16BF && out_type == HIP_R_16BF
+            && compute_type == rocsparselt_compute_f32)
+    {
+        status = findTopConfigs<hip_bfloat16, hip_bfloat16, float>(
+            _matmulDescr, configs, requestConfigs);
+    }
+    else if(in_type == HIP_R_8I && out_type == HIP_R_8I && compute_type == rocsparselt_compute_i32)
+    {
+        status = findTopConfigs<int8_t, int8_t, float>(_matmulDescr, configs, requestConfigs);
+    }
+    else if(in_type == HIP_R_8I && out_type == HIP_R_16F && compute_type == rocsparselt_compute_i32)
+    {
+        status = findTopConfigs<int8_t, __half, float>(_matmulDescr, configs, requestConfigs);
+    }
+    else if(in_type == HIP_R_8I && out_type == HIP_R_16BF
+            && compute_type == rocsparselt_compute_i32)
+    {
+        status = findTopConfigs<int8_t, hip_bfloat16, float>(
+            _matmulDescr, configs, requestConfigs);
+    }
+    if(status != rocsparselt_status_success)
+        return status;
+#else
+    if(in_type == HIP_R_16F && out_type == HIP_R_16F && compute_type == rocsparselt_compute_f32)
+        initSolutions<__half, __half, float>(
+            _handle, _matmulDescr->op_A, _matmulDescr->op_B, configs);
+    else if(in_type == HIP_R_16BF && out_type == HIP_R_16BF
+            && compute_type == rocsparselt_compute_f32)
+        initSolutions<hip_bfloat16, hip_bfloat16, float>(
+            _handle, _matmulDescr->op_A, _matmulDescr->op_B, configs);
+    else if(in_type == HIP_R_8I && out_type == HIP_R_8I && compute_type == rocsparselt_compute_i32)
+        initSolutions<int8_t, int8_t, float>(
+            _handle, _matmulDescr->op_A, _matmulDescr->op_B, configs);
+#endif
+    if(configs->empty())
+    {
+        hipsparselt_cerr << "There are no solutions for this problem size" << std::endl;
+        log_error(_handle, __func__, "There are no solutions for this problem size");
+        return rocsparselt_status_not_implemented;
+    }
+
+    // The split-K mode only tells apart the configs which split K.
+    configs->erase(std::remove_if(configs->begin(),
+                                  configs->end(),
+                                  [&](const _rocsparselt_matmul_config& config) {
+                                      return (selection.split_k > 0
+                                              && config.split_k != selection.split_k)
+                                             || (selection.split_k_mode >= 0 && config.split_k > 1
+                                                 && config.split_k_mode != selection.split_k_mode)
+                                             || (selection.atomics
+                                                     == rocsparselt_atomics_not_allowed
+                                                 && config.atomics);
+                                  }),
+                   configs->end());
+    if(configs->empty())
+    {
+        hipsparselt_cerr << "There are no solutions for this problem size with split-K factor "
+                         << selection.split_k << ", split-K mode " << selection.split_k_mode
+                         << " and atomics mode " << selection.atomics << std::endl;
+        log_error(_handle, __func__, "There are no solutions with these split-K attributes");
+        return rocsparselt_status_not_implemented;
+    }
+    // Start from the config a search picked before, if it is one of the configs. It is moved
+    // first, before the candidates are picked, so that it is always kept.
+    if(stored)
+    {
+        auto it = std::find_if(
+            configs->begin(), configs->end(), [&](const _rocsparselt_matmul_config& config) {
+                return rocsparselt_tuning_entry_matches(entry, config);
+            });
+        if(it != configs->end())
+            std::rotate(configs->begin(), it, it + 1);
+        log_info(_handle,
+                 __func__,
+                 "tuning database",
+                 db->path(),
+                 "solution index",
+                 entry.solution_index,
+                 "split_k",
+                 entry.split_k,
+                 "found",
+                 it != configs->end());
+    }
+    rocsparselt_alg_selection_pick(selection.candidates, configs);
+    return rocsparselt_status_success;
+}
+
+/********************************************************************************
+ * \brief collects the configs of an alg selection again, for the descriptor of
+ * its last init and the attributes of settings. The alg selection only takes
+ * the attributes if there are configs for them.
+ *******************************************************************************/
+static rocsparselt_status
+    rocsparselt_alg_selection_recollect(const _rocsparselt_handle*               _handle,
+                                        _rocsparselt_matmul_alg_selection*       _algSelection,
+                                        const _rocsparselt_matmul_alg_selection& settings)
+{
+    auto matmulDescr = _handle->config_storage->matmul_descr(_algSelection);
+    if(matmulDescr == nullptr)
+    {
+        log_error(_handle, __func__, "algSelection has no matmul descriptor");
+        return rocsparselt_status_invalid_handle;
+    }
+    std::vector<_rocsparselt_matmul_config> configs;
+    RETURN_IF_ROCSPARSELT_ERROR(
+        rocsparselt_alg_selection_collect(_handle, matmulDescr, settings, &configs));
+
+    _algSelection->candidates    = settings.candidates;
+    _algSelection->split_k       = settings.split_k;
+    _algSelection->split_k_mode  = settings.split_k_mode;
+    _algSelection->atomics       = settings.atomics;
+    _algSelection->config_id     = 0;
+    _algSelection->config_max_id = configs.size();
+    _algSelection->configs
+        = _handle->config_storage->assign(_algSelection, *matmulDescr, std::move(configs));
+    return rocsparselt_status_success;
+}
+
 /********************************************************************************
  * \brief
  *******************************************************************************/
@@ -1280,77 +1631,16 @@ rocsparselt_status
 
             auto _algSelection = reinterpret_cast<_rocsparselt_matmul_alg_selection*>(algSelection);
 
-            auto in_type      = _matmulDescr->matrix_A->type;
-            auto out_type     = _matmulDescr->matrix_D->type;
-            auto compute_type = _matmulDescr->compute_type;
+            _rocsparselt_matmul_alg_selection       tmpAlgSelection(_handle);
+            std::vector<_rocsparselt_matmul_config> configs;
+            RETURN_IF_ROCSPARSELT_ERROR(rocsparselt_alg_selection_collect(
+                _handle, _matmulDescr, tmpAlgSelection, &configs));
 
-            int                               config_max_id = 0;
-            _rocsparselt_matmul_alg_selection tmpAlgSelection(_handle);
-
-#if BUILD_WITH_TENSILE
-            constexpr int requestConfigs = 10; // find top 10 configs.
-
-            rocsparselt_status status = rocsparselt_status_success;
-
-            if(in_type == HIP_R_16F && out_type == HIP_R_16F
-               && compute_type == rocsparselt_compute_f32)
-            {
-                status = findTopConfigs<__half, __half, float>(
-                    _matmulDescr, &(tmpAlgSelection.configs[0]), &config_max_id, requestConfigs);
-            }
-            else if(in_type == HIP_R_16BF && out_type == HIP_R_16BF
-                    && compute_type == rocsparselt_compute_f32)
-            {
-                status = findTopConfigs<hip_bfloat16, hip_bfloat16, float>(
-                    _matmulDescr, &(tmpAlgSelection.configs[0]), &config_max_id, requestConfigs);
-            }
-            else if(in_type == HIP_R_8I && out_type == HIP_R_8I
-                    && compute_type == rocsparselt_compute_i32)
-            {
-                status = findTopConfigs<int8_t, int8_t, float>(
-                    _matmulDescr, &(tmpAlgSelection.configs[0]), &config_max_id, requestConfigs);
-            }
-            else if(in_type == HIP_R_8I && out_type == HIP_R_16F
-                    && compute_type == rocsparselt_compute_i32)
-            {
-                status = findTopConfigs<int8_t, __half, float>(
-                    _matmulDescr, &(tmpAlgSelection.configs[0]), &config_max_id, requestConfigs);
-            }
-            else if(in_type == HIP_R_8I && out_type == HIP_R_16BF
-                    && compute_type == rocsparselt_compute_i32)
-            {
-                status = findTopConfigs<int8_t, hip_bfloat16, float>(
-                    _matmulDescr, &(tmpAlgSelection.configs[0]), &config_max_id, requestConfigs);
-            }
-            if(status != rocsparselt_status_success)
-                return status;
-#else
-            if(in_type == HIP_R_16F && out_type == HIP_R_16F
-               && compute_type == rocsparselt_compute_f32)
-                initSolutions<__half, __half, float>(
-                    _handle, _matmulDescr->op_A, _matmulDescr->op_B, &config_max_id);
-            else if(in_type == HIP_R_16BF && out_type == HIP_R_16BF
-                    && compute_type == rocsparselt_compute_f32)
-                initSolutions<hip_bfloat16, hip_bfloat16, float>(
-                    _handle, _matmulDescr->op_A, _matmulDescr->op_B, &config_max_id);
-            else if(in_type == HIP_R_8I && out_type == HIP_R_8I
-                    && compute_type == rocsparselt_compute_i32)
-                initSolutions<int8_t, int8_t, float>(
-                    _handle, _matmulDescr->op_A, _matmulDescr->op_B, &config_max_id);
-            for(int i = 0; i < config_max_id; i++)
-            {
-                configs[i].max_workspace_bytes = 0;
-            }
-#endif
-            if(!config_max_id)
-            {
-                hipsparselt_cerr << "There are no solutions for this problem size" << std::endl;
-                log_error(_handle, __func__, "There are no solutions for this problem size");
-                return rocsparselt_status_not_implemented;
-            }
+            tmpAlgSelection.alg           = alg;
+            tmpAlgSelection.config_max_id = configs.size();
+            tmpAlgSelection.configs
+                = _handle->config_storage->assign(_algSelection, *_matmulDescr, std::move(configs));
             memcpy(_algSelection, &tmpAlgSelection, sizeof(_rocsparselt_matmul_alg_selection));
-            _algSelection->alg           = alg;
-            _algSelection->config_max_id = config_max_id;
             log_api(_handle,
                     __func__,
                     "algSelection[out]",
@@ -1466,80 +1756,270 @@ rocsparselt_status
                 _algSelection->search_iterations = *search_iterations;
                 break;
             }
-            default:
-                return rocsparselt_status_not_implemented;
-            }
-            log_api(_handle,
-                    __func__,
-                    "algSelection[out]",
-                    algSelection,
-                    "attribute[in]",
-                    attribute,
-                    "data[in]",
-                    data,
-                    "dataSize[in]",
-                    dataSize);
-        }
-        catch(const rocsparselt_status& status)
-        {
-            log_info(_handle, __func__, "status", status);
-            return status;
-        }
-        return rocsparselt_status_success;
-    }
-}
-
-/********************************************************************************
- * \brief
- *******************************************************************************/
-rocsparselt_status
-    rocsparselt_matmul_alg_get_attribute(const rocsparselt_handle*               handle,
-                                         const rocsparselt_matmul_alg_selection* algSelection,
-                                         rocsparselt_matmul_alg_attribute        attribute,
-                                         void*                                   data,
-                                         size_t                                  dataSize)
+            case rocsparselt_matmul_alg_candidates:
+            {
+                if((status = validateSetAttributeDataSize<int>(dataSize))
+                   != rocsparselt_status_success)
+                {
+                    log_error(_handle, __func__, "dataSize is invalid");
+                    return status;
+                }
 
-{
-    if(handle == nullptr)
-    {
-        hipsparselt_cerr << "handle is a NULL pointer" << std::endl;
-        return rocsparselt_status_invalid_handle;
-    }
-    auto _handle = reinterpret_cast<const _rocsparselt_handle*>(handle);
-    if(!_handle->isInit())
-    {
-        hipsparselt_cerr << "handle did not initialized or already destroyed" << std::endl;
-        return rocsparselt_status_invalid_handle;
-    }
+                const int* candidates = reinterpret_cast<const int*>(data);
+                if(*candidates < 0)
+                {
+                    hipsparselt_cerr << "The candidates must be greater or equal to 0, current: "
+                                     << *candidates << std::endl;
+                    log_error(_handle, __func__, "candidates must >= 0");
+                    return rocsparselt_status_invalid_value;
+                }
 
-    if(algSelection == nullptr)
-    {
-        log_error(_handle, __func__, "algSelection is a NULL pointer");
-        return rocsparselt_status_invalid_handle;
-    }
-    else if(data == nullptr)
-    {
-        log_error(_handle, __func__, "data is a NULL pointer");
-        return rocsparselt_status_invalid_pointer;
-    }
-    else
-    {
-        try
-        {
-            auto _algSelection
-                = reinterpret_cast<const _rocsparselt_matmul_alg_selection*>(algSelection);
-            if(!_algSelection->isInit())
-            {
-                log_error(
-                    _handle, __func__, "algSelection did not initialized or already destroyed");
-                return rocsparselt_status_invalid_handle;
+                _rocsparselt_matmul_alg_selection settings(*_algSelection);
+                settings.candidates = *candidates;
+                RETURN_IF_ROCSPARSELT_ERROR(
+                    rocsparselt_alg_selection_recollect(_handle, _algSelection, settings));
+                break;
             }
-
-            rocsparselt_status status;
-            if((status = validateGetAttributeDataSize<int>(dataSize)) != rocsparselt_status_success)
+            case rocsparselt_matmul_split_k:
             {
-                log_error(_handle, __func__, "dataSize is invalid");
-                return status;
+                if((status = validateSetAttributeDataSize<int>(dataSize))
+                   != rocsparselt_status_success)
+                {
+                    log_error(_handle, __func__, "dataSize is invalid");
+                    return status;
+                }
+
+                const int* split_k = reinterpret_cast<const int*>(data);
+                if(*split_k < 0)
+                {
+                    hipsparselt_cerr
+                        << "The split-K factor must be greater or equal to 0, current: "
+                        << *split_k << std::endl;
+                    log_error(_handle, __func__, "split-K factor must >= 0");
+                    return rocsparselt_status_invalid_value;
+                }
+
+                _rocsparselt_matmul_alg_selection settings(*_algSelection);
+                settings.split_k = *split_k;
+                RETURN_IF_ROCSPARSELT_ERROR(
+                    rocsparselt_alg_selection_recollect(_handle, _algSelection, settings));
+                break;
+            }
+            case rocsparselt_matmul_split_k_mode:
+            {
+                if((status = validateSetAttributeDataSize<int>(dataSize))
+                   != rocsparselt_status_success)
+                {
+                    log_error(_handle, __func__, "dataSize is invalid");
+                    return status;
+                }
+
+                const int* split_k_mode = reinterpret_cast<const int*>(data);
+                if(*split_k_mode != rocsparselt_splik_k_mode_one_kernel
+                   && *split_k_mode != rocsparselt_split_k_mode_two_kernels)
+                {
+                    hipsparselt_cerr << "The split-K mode " << *split_k_mode << " is invalid"
+                                     << std::endl;
+                    log_error(_handle, __func__, "split-K mode is invalid");
+                    return rocsparselt_status_invalid_value;
+                }
+
+                _rocsparselt_matmul_alg_selection settings(*_algSelection);
+                settings.split_k_mode = *split_k_mode;
+                RETURN_IF_ROCSPARSELT_ERROR(
+                    rocsparselt_alg_selection_recollect(_handle, _algSelection, settings));
+                break;
+            }
+            case rocsparselt_matmul_atomics_mode:
+            {
+                if((status = validateSetAttributeDataSize<int>(dataSize))
+                   != rocsparselt_status_success)
+                {
+                    log_error(_handle, __func__, "dataSize is invalid");
+                    return status;
+                }
+
+                const int* atomics = reinterpret_cast<const int*>(data);
+                if(*atomics != rocsparselt_atomics_not_allowed
+                   && *atomics != rocsparselt_atomics_allowed)
+                {
+                    hipsparselt_cerr << "The atomics mode " << *atomics << " is invalid"
+                                     << std::endl;
+                    log_error(_handle, __func__, "atomics mode is invalid");
+                    return rocsparselt_status_invalid_value;
+                }
+
+                _rocsparselt_matmul_alg_selection settings(*_algSelection);
+                settings.atomics = *atomics;
+                RETURN_IF_ROCSPARSELT_ERROR(
+                    rocsparselt_alg_selection_recollect(_handle, _algSelection, settings));
+                break;
+            }
+            case rocsparselt_matmul_workspace_streams:
+            {
+                if((status = validateSetAttributeDataSize<int>(dataSize))
+                   != rocsparselt_status_success)
+                {
+                    log_error(_handle, __func__, "dataSize is invalid");
+                    return status;
+                }
+
+                const int* streams = reinterpret_cast<const int*>(data);
+                if(*streams < 1 || *streams > rocsparselt_exec_cache_slots)
+                {
+                    hipsparselt_cerr << "The workspace streams must be in [1, "
+                                     << rocsparselt_exec_cache_slots << "], current: " << *streams
+                                     << std::endl;
+                    log_error(_handle, __func__, "workspace streams is out of range");
+                    return rocsparselt_status_invalid_value;
+                }
+                _algSelection->workspace_streams = *streams;
+                break;
+            }
+            case rocsparselt_matmul_search_statistic:
+            {
+                if((status = validateSetAttributeDataSize<int>(dataSize))
+                   != rocsparselt_status_success)
+                {
+                    log_error(_handle, __func__, "dataSize is invalid");
+                    return status;
+                }
+
+                const int* statistic = reinterpret_cast<const int*>(data);
+                if(*statistic != rocsparselt_search_statistic_mean
+                   && *statistic != rocsparselt_search_statistic_median
+                   && *statistic != rocsparselt_search_statistic_trimmed_mean)
+                {
+                    hipsparselt_cerr << "The search statistic " << *statistic << " is invalid"
+                                     << std::endl;
+                    log_error(_handle, __func__, "search statistic is invalid");
+                    return rocsparselt_status_invalid_value;
+                }
+                _algSelection->search_statistic = *statistic;
+                break;
+            }
+            case rocsparselt_matmul_search_flush_cache:
+            {
+                if((status = validateSetAttributeDataSize<int>(dataSize))
+                   != rocsparselt_status_success)
+                {
+                    log_error(_handle, __func__, "dataSize is invalid");
+                    return status;
+                }
+
+                const int* flush_cache = reinterpret_cast<const int*>(data);
+                if(*flush_cache != 0 && *flush_cache != 1)
+                {
+                    hipsparselt_cerr << "The search flush cache must be 0 or 1, current: "
+                                     << *flush_cache << std::endl;
+                    log_error(_handle, __func__, "search flush cache must be 0 or 1");
+                    return rocsparselt_status_invalid_value;
+                }
+                _algSelection->search_flush_cache = *flush_cache;
+                break;
+            }
+            case rocsparselt_matmul_search_min_time:
+            {
+                if((status = validateSetAttributeDataSize<float>(dataSize))
+                   != rocsparselt_status_success)
+                {
+                    log_error(_handle, __func__, "dataSize is invalid");
+                    return status;
+                }
+
+                const float* min_time = reinterpret_cast<const float*>(data);
+                if(!(*min_time >= 0.0f))
+                {
+                    hipsparselt_cerr
+                        << "The search min time must be greater or equal to 0, current: "
+                        << *min_time << std::endl;
+                    log_error(_handle, __func__, "search min time must >= 0");
+                    return rocsparselt_status_invalid_value;
+                }
+                _algSelection->search_min_time = *min_time;
+                break;
+            }
+            case rocsparselt_matmul_search_results:
+            {
+                hipsparselt_cerr << "rocsparselt_matmul_search_results is only for query."
+                                 << std::endl;
+                log_error(_handle, __func__, "search_results is only for query");
+                return rocsparselt_status_invalid_value;
+            }
+            default:
+                return rocsparselt_status_not_implemented;
+            }
+            log_api(_handle,
+                    __func__,
+                    "algSelection[out]",
+                    algSelection,
+                    "attribute[in]",
+                    attribute,
+                    "data[in]",
+                    data,
+                    "dataSize[in]",
+                    dataSize);
+        }
+        catch(const rocsparselt_status& status)
+        {
+            log_info(_handle, __func__, "status", status);
+            return status;
+        }
+        return rocsparselt_status_success;
+    }
+}
+
+/********************************************************************************
+ * \brief
+ *******************************************************************************/
+rocsparselt_status
+    rocsparselt_matmul_alg_get_attribute(const rocsparselt_handle*               handle,
+                                         const rocsparselt_matmul_alg_selection* algSelection,
+                                         rocsparselt_matmul_alg_attribute        attribute,
+                                         void*                                   data,
+                                         size_t                                  dataSize)
+
+{
+    if(handle == nullptr)
+    {
+        hipsparselt_cerr << "handle is a NULL pointer" << std::endl;
+        return rocsparselt_status_invalid_handle;
+    }
+    auto _handle = reinterpret_cast<const _rocsparselt_handle*>(handle);
+    if(!_handle->isInit())
+    {
+        hipsparselt_cerr << "handle did not initialized or already destroyed" << std::endl;
+        return rocsparselt_status_invalid_handle;
+    }
+
+    if(algSelection == nullptr)
+    {
+        log_error(_handle, __func__, "algSelection is a NULL pointer");
+        return rocsparselt_status_invalid_handle;
+    }
+    else if(data == nullptr)
+    {
+        log_error(_handle, __func__, "data is a NULL pointer");
+        return rocsparselt_status_invalid_pointer;
+    }
+    else
+    {
+        try
+        {
+            auto _algSelection
+                = reinterpret_cast<const _rocsparselt_matmul_alg_selection*>(algSelection);
+            if(!_algSelection->isInit())
+            {
+                log_error(
+                    _handle, __func__, "algSelection did not initialized or already destroyed");
+                return rocsparselt_status_invalid_handle;
+            }
+
+            rocsparselt_status status;
+            if((status = validateGetAttributeDataSize<int>(dataSize)) != rocsparselt_status_success)
+            {
+                log_error(_handle, __func__, "dataSize is invalid");
+                return status;
             }
 
             switch(attribute)
@@ -1553,6 +2033,52 @@ rocsparselt_status
             case rocsparselt_matmul_search_iterations:
                 *reinterpret_cast<int*>(data) = _algSelection->search_iterations;
                 break;
+            case rocsparselt_matmul_alg_candidates:
+                *reinterpret_cast<int*>(data) = _algSelection->candidates;
+                break;
+            case rocsparselt_matmul_split_k:
+                // Not set, the factor of the selected config.
+                *reinterpret_cast<int*>(data)
+                    = _algSelection->split_k > 0 || _algSelection->config_max_id == 0
+                          ? _algSelection->split_k
+                          : _algSelection->configs[_algSelection->config_id].split_k;
+                break;
+            case rocsparselt_matmul_split_k_mode:
+                *reinterpret_cast<int*>(data)
+                    = _algSelection->split_k_mode >= 0 || _algSelection->config_max_id == 0
+                          ? _algSelection->split_k_mode
+                          : _algSelection->configs[_algSelection->config_id].split_k_mode;
+                break;
+            case rocsparselt_matmul_atomics_mode:
+                *reinterpret_cast<int*>(data) = _algSelection->atomics;
+                break;
+            case rocsparselt_matmul_workspace_streams:
+                *reinterpret_cast<int*>(data) = _algSelection->workspace_streams;
+                break;
+            case rocsparselt_matmul_search_statistic:
+                *reinterpret_cast<int*>(data) = _algSelection->search_statistic;
+                break;
+            case rocsparselt_matmul_search_flush_cache:
+                *reinterpret_cast<int*>(data) = _algSelection->search_flush_cache;
+                break;
+            case rocsparselt_matmul_search_min_time:
+                *reinterpret_cast<float*>(data) = _algSelection->search_min_time;
+                break;
+            case rocsparselt_matmul_search_results:
+            {
+                if((status = validateGetAttributeDataSize<void>(
+                        dataSize,
+                        _algSelection->config_max_id * sizeof(rocsparselt_matmul_search_result)))
+                   != rocsparselt_status_success)
+                {
+                    log_error(_handle, __func__, "dataSize is invalid");
+                    return status;
+                }
+                auto results = reinterpret_cast<rocsparselt_matmul_search_result*>(data);
+                for(int i = 0; i < _algSelection->config_max_id; i++)
+                    results[i] = _algSelection->configs[i].search;
+                break;
+            }
             default:
                 log_error(_handle, __func__, "attribute", attribute, "is not supported");
                 return rocsparselt_status_not_implemented;
@@ -1577,6 +2103,36 @@ rocsparselt_status
     }
 }
 
+/********************************************************************************
+ * \brief destroys an alg selection, it frees the configs it collected.
+ *******************************************************************************/
+rocsparselt_status
+    rocsparselt_matmul_alg_selection_destroy(const rocsparselt_matmul_alg_selection* algSelection)
+{
+    if(algSelection == nullptr)
+    {
+        hipsparselt_cerr << "algSelection is a NULL pointer" << std::endl;
+        return rocsparselt_status_invalid_handle;
+    }
+
+    auto _algSelection = reinterpret_cast<_rocsparselt_matmul_alg_selection*>(
+        const_cast<rocsparselt_matmul_alg_selection*>(algSelection));
+    if(!_algSelection->isInit())
+    {
+        hipsparselt_cerr << "algSelection did not initialized or already destroyed" << std::endl;
+        return rocsparselt_status_invalid_handle;
+    }
+
+    log_api(_algSelection->handle, __func__, "algSelection[in]", algSelection);
+    if(_algSelection->handle->config_storage != nullptr)
+        _algSelection->handle->config_storage->release(_algSelection);
+    _algSelection->configs       = nullptr;
+    _algSelection->config_id     = 0;
+    _algSelection->config_max_id = 0;
+    _algSelection->is_init       = 0;
+    return rocsparselt_status_success;
+}
+
 /********************************************************************************
  * \brief
  *******************************************************************************/
@@ -1647,12 +2203,40 @@ rocsparselt_status
             return rocsparselt_status_invalid_size;
         }
 
+        // The stream rocsparselt_matmul_capture() records on, created here rather than
+        // while a capture is in progress.
+        auto capture = new _rocsparselt_matmul_capture;
+        auto status  = capture->init();
+        if(status != rocsparselt_status_success)
+        {
+            delete capture;
+            return status;
+        }
+
+        // A device alpha is broadcast into a vector of the plan and applied by the kernel as
+        // alpha vector scaling, so it is never read on the host. The compute type is float.
+        _rocsparselt_workspace_pool* device_alpha = nullptr;
+        if(_matmulDescr->pointer_mode == rocsparselt_pointer_mode_device
+           && !_matmulDescr->alpha_vector_scaling)
+        {
+            device_alpha = new _rocsparselt_workspace_pool;
+            device_alpha->reserve(_matmulDescr->m * sizeof(float));
+        }
+
         auto                     _plan = reinterpret_cast<_rocsparselt_matmul_plan*>(plan);
         _rocsparselt_matmul_plan tmpPlan(_handle);
         memcpy(_plan, &tmpPlan, sizeof(_rocsparselt_matmul_plan));
 
         _plan->matmul_descr  = new _rocsparselt_matmul_descr(*_matmulDescr);
         _plan->alg_selection = const_cast<_rocsparselt_matmul_alg_selection*>(_algSelection);
+        _plan->exec_cache    = rocsparselt_internal_exec_cache_create(_handle);
+        _plan->device_alpha  = device_alpha;
+        _plan->capture       = capture;
+
+        // The pool grows to the workspace of the selected config, a search grows the slice of
+        // its stream to the one of all configs.
+        if(_handle->workspace_pool != nullptr)
+            _handle->workspace_pool->reserve(_algSelection->selected_workspace_bytes());
         log_api(_handle,
                 __func__,
                 "plan[out]",
@@ -1670,6 +2254,520 @@ rocsparselt_status
     return rocsparselt_status_success;
 }
 
+/********************************************************************************
+ * \brief sets the M of a copy of a matmul descriptor with a dense A. The leading
+ * dimensions and batch strides stay the ones of the original M.
+ *******************************************************************************/
+static void rocsparselt_matmul_descr_set_m(_rocsparselt_matmul_descr* descr, int64_t m)
+{
+    descr->m = m;
+    if(descr->op_A == rocsparselt_operation_none)
+        descr->matrix_A->m = m;
+    else
+        descr->matrix_A->n = m;
+    descr->matrix_C->m = m;
+    descr->matrix_D->m = m;
+    if(descr->_swap_ab)
+        descr->_n = m;
+    else
+        descr->_m = m;
+}
+
+/********************************************************************************
+ * \brief fills bucket, the plan of M m of a dynamic-M plan, with configs collected
+ * for m and the attributes of algSelection. The dynamic-M plan frees it, even if
+ * this fails half way.
+ *******************************************************************************/
+static rocsparselt_status
+    rocsparselt_matmul_plan_bucket(const _rocsparselt_handle*               _handle,
+                                   const _rocsparselt_matmul_descr*         _matmulDescr,
+                                   const _rocsparselt_matmul_alg_selection& _algSelection,
+                                   int64_t                                  m,
+                                   _rocsparselt_matmul_plan*                bucket)
+{
+    bucket->matmul_descr = new _rocsparselt_matmul_descr(*_matmulDescr);
+    rocsparselt_matmul_descr_set_m(bucket->matmul_descr, m);
+
+    auto selection             = new _rocsparselt_matmul_alg_selection(_algSelection);
+    bucket->alg_selection      = selection;
+    bucket->owns_alg_selection = true;
+    bucket->config_storage     = _handle->config_storage->retain();
+    std::vector<_rocsparselt_matmul_config> configs;
+    RETURN_IF_ROCSPARSELT_ERROR(
+        rocsparselt_alg_selection_collect(_handle, bucket->matmul_descr, *selection, &configs));
+    selection->config_id     = 0;
+    selection->config_max_id = configs.size();
+    selection->configs
+        = _handle->config_storage->assign(selection, *bucket->matmul_descr, std::move(configs));
+
+    bucket->exec_cache = rocsparselt_internal_exec_cache_create(_handle);
+    if(bucket->matmul_descr->pointer_mode == rocsparselt_pointer_mode_device
+       && !bucket->matmul_descr->alpha_vector_scaling)
+    {
+        bucket->device_alpha = new _rocsparselt_workspace_pool;
+        bucket->device_alpha->reserve(m * sizeof(float));
+    }
+
+    if(_handle->workspace_pool != nullptr)
+        _handle->workspace_pool->reserve(selection->selected_workspace_bytes());
+    return rocsparselt_status_success;
+}
+
+/********************************************************************************
+ * \brief
+ *******************************************************************************/
+rocsparselt_status
+    rocsparselt_matmul_plan_init_dynamic_m(const rocsparselt_handle*               handle,
+                                           rocsparselt_matmul_plan*                plan,
+                                           const rocsparselt_matmul_descr*         matmulDescr,
+                                           const rocsparselt_matmul_alg_selection* algSelection,
+                                           int64_t                                 minM)
+{
+    RETURN_IF_ROCSPARSELT_ERROR(
+        rocsparselt_matmul_plan_init(handle, plan, matmulDescr, algSelection));
+
+    auto _handle       = reinterpret_cast<const _rocsparselt_handle*>(handle);
+    auto _matmulDescr  = reinterpret_cast<const _rocsparselt_matmul_descr*>(matmulDescr);
+    auto _algSelection = reinterpret_cast<const _rocsparselt_matmul_alg_selection*>(algSelection);
+    auto _plan         = reinterpret_cast<_rocsparselt_matmul_plan*>(plan);
+
+    // The compressed matrix and its metadata are laid out for the size they were compressed
+    // with, only the dense A may have fewer rows.
+    if(_matmulDescr->is_sparse_a)
+    {
+        _plan->clear();
+        log_error(_handle, __func__, "a dynamic M requires a structured matrix B");
+        return rocsparselt_status_not_implemented;
+    }
+    if(minM < 1 || minM > _matmulDescr->m)
+    {
+        _plan->clear();
+        log_error(_handle, __func__, "minM must be in [1, M] but is", minM);
+        return rocsparselt_status_invalid_size;
+    }
+
+    int64_t first = 1;
+    while(first < minM)
+        first *= 2;
+    int count = 0;
+    for(int64_t m = first; m < _matmulDescr->m; m *= 2)
+        count++;
+
+    try
+    {
+        _plan->min_m = minM;
+        if(count > 0)
+            _plan->buckets = new _rocsparselt_matmul_plan*[count];
+        for(int64_t m = first; m < _matmulDescr->m; m *= 2)
+        {
+            auto bucket                           = new _rocsparselt_matmul_plan(_handle);
+            _plan->buckets[_plan->bucket_count++] = bucket;
+
+            auto status = rocsparselt_matmul_plan_bucket(
+                _handle, _matmulDescr, *_algSelection, m, bucket);
+            if(status != rocsparselt_status_success)
+            {
+                _plan->clear();
+                return status;
+            }
+        }
+        log_api(_handle,
+                __func__,
+                "plan[out]",
+                plan,
+                "matmulDescr[in]",
+                matmulDescr,
+                "algSelection[in]",
+                algSelection,
+                "minM[in]",
+                minM,
+                "buckets",
+                _plan->bucket_count);
+    }
+    catch(const rocsparselt_status& status)
+    {
+        _plan->clear();
+        log_info(_handle, __func__, "status", status);
+        return status;
+    }
+    return rocsparselt_status_success;
+}
+
+/********************************************************************************
+ * \brief copies a matrix descriptor to and from its record in a plan blob.
+ *******************************************************************************/
+static void rocsparselt_plan_blob_from_matrix(const _rocsparselt_mat_descr& matrix,
+                                              rocsparselt_plan_blob_matrix* record)
+{
+    record->m_type                  = matrix.m_type;
+    record->type                    = matrix.type;
+    record->order                   = matrix.order;
+    record->sparsity                = matrix.sparsity;
+    record->num_batches             = matrix.num_batches;
+    record->alignment               = matrix.alignment;
+    record->is_hipsparselt_datatype = matrix.is_hipsparselt_datatype;
+    record->m                       = matrix.m;
+    record->n                       = matrix.n;
+    record->ld                      = matrix.ld;
+    record->batch_stride            = matrix.batch_stride;
+    record->c_k                     = matrix.c_k;
+    record->c_ld                    = matrix.c_ld;
+    record->c_n                     = matrix.c_n;
+}
+
+static void rocsparselt_plan_blob_to_matrix(const rocsparselt_plan_blob_matrix& record,
+                                            _rocsparselt_mat_descr*             matrix)
+{
+    matrix->m_type                  = static_cast<rocsparselt_matrix_type>(record.m_type);
+    matrix->type                    = static_cast<hipDataType>(record.type);
+    matrix->order                   = static_cast<rocsparselt_order>(record.order);
+    matrix->sparsity                = static_cast<rocsparselt_sparsity>(record.sparsity);
+    matrix->num_batches             = record.num_batches;
+    matrix->alignment               = record.alignment;
+    matrix->is_hipsparselt_datatype = record.is_hipsparselt_datatype;
+    matrix->m                       = record.m;
+    matrix->n                       = record.n;
+    matrix->ld                      = record.ld;
+    matrix->batch_stride            = record.batch_stride;
+    matrix->c_k                     = record.c_k;
+    matrix->c_ld                    = record.c_ld;
+    matrix->c_n                     = record.c_n;
+}
+
+/********************************************************************************
+ * \brief
+ *******************************************************************************/
+rocsparselt_status rocsparselt_matmul_plan_serialize(const rocsparselt_handle*      handle,
+                                                     const rocsparselt_matmul_plan* plan,
+                                                     void*                          data,
+                                                     size_t*                        dataSize)
+{
+    if(handle == nullptr)
+    {
+        hipsparselt_cerr << "handle is a NULL pointer" << std::endl;
+        return rocsparselt_status_invalid_handle;
+    }
+    auto _handle = reinterpret_cast<const _rocsparselt_handle*>(handle);
+    if(!_handle->isInit())
+    {
+        hipsparselt_cerr << "handle did not initialized or already destroyed" << std::endl;
+        return rocsparselt_status_invalid_handle;
+    }
+
+    if(plan == nullptr)
+    {
+        log_error(_handle, __func__, "plan is a NULL pointer");
+        return rocsparselt_status_invalid_handle;
+    }
+    else if(dataSize == nullptr)
+    {
+        log_error(_handle, __func__, "dataSize is a NULL pointer");
+        return rocsparselt_status_invalid_pointer;
+    }
+
+    auto _plan = reinterpret_cast<const _rocsparselt_matmul_plan*>(plan);
+    if(!_plan->isInit())
+    {
+        log_error(_handle, __func__, "plan did not initialized or already destroyed");
+        return rocsparselt_status_invalid_handle;
+    }
+
+    auto descr     = _plan->matmul_descr;
+    auto selection = _plan->alg_selection;
+    // The bias vector is an address of this process, and the buckets of a dynamic-M plan
+    // are plans of their own.
+    if(descr->bias_pointer != nullptr)
+    {
+        log_error(_handle, __func__, "a plan with a bias vector can not be serialized");
+        return rocsparselt_status_not_implemented;
+    }
+    if(_plan->min_m != 0)
+    {
+        log_error(_handle, __func__, "a dynamic-M plan can not be serialized");
+        return rocsparselt_status_not_implemented;
+    }
+
+    size_t size = rocsparselt_plan_blob_size(selection->config_max_id);
+    if(data == nullptr)
+    {
+        *dataSize = size;
+        log_api(_handle, __func__, "plan[in]", plan, "data[out]", data, "dataSize[out]", size);
+        return rocsparselt_status_success;
+    }
+    if(*dataSize < size)
+    {
+        log_error(_handle, __func__, "dataSize must be at least", size, "but is", *dataSize);
+        return rocsparselt_status_invalid_size;
+    }
+
+    try
+    {
+        std::string arch, version;
+        RETURN_IF_ROCSPARSELT_ERROR(
+            rocsparselt_internal_arch_and_version(_handle, &arch, &version));
+
+        rocsparselt_plan_blob_header header;
+        rocsparselt_plan_blob_clear(&header);
+        header.config_count = selection->config_max_id;
+        strncpy(header.arch, arch.c_str(), sizeof(header.arch) - 1);
+        strncpy(header.version, version.c_str(), sizeof(header.version) - 1);
+
+        const _rocsparselt_mat_descr* matrices[]
+            = {descr->matrix_A, descr->matrix_B, descr->matrix_C, descr->matrix_D};
+        for(int i = 0; i < 4; i++)
+            rocsparselt_plan_blob_from_matrix(*matrices[i], &header.matrices[i]);
+        header.op_a                         = descr->op_A;
+        header.op_b                         = descr->op_B;
+        header.compute_type                 = descr->compute_type;
+        header.activation                   = descr->activation;
+        header.activation_relu_upperbound   = descr->activation_relu_upperbound;
+        header.activation_relu_threshold    = descr->activation_relu_threshold;
+        header.activation_leakyrelu_alpha   = descr->activation_leakyrelu_alpha;
+        header.activation_tanh_alpha        = descr->activation_tanh_alpha;
+        header.activation_tanh_beta         = descr->activation_tanh_beta;
+        header.activation_gelu_scaling      = descr->activation_gelu_scaling;
+        header.bias_type                    = descr->bias_type;
+        header.bias_is_hipsparselt_datatype = descr->bias_is_hipsparselt_datatype;
+        header.bias_stride                  = descr->bias_stride;
+        header.alpha_vector_scaling         = descr->alpha_vector_scaling;
+        header.is_sparse_a                  = descr->is_sparse_a;
+        header.pointer_mode                 = descr->pointer_mode;
+        header.swap_ab                      = descr->_swap_ab;
+        header.m                            = descr->m;
+        header.n                            = descr->n;
+        header.k                            = descr->k;
+        header._op_a                        = descr->_op_A;
+        header._op_b                        = descr->_op_B;
+        header._m                           = descr->_m;
+        header._n                           = descr->_n;
+        header._k                           = descr->_k;
+        header._lda                         = descr->_lda;
+        header._ldb                         = descr->_ldb;
+        header._is_sparse_a                 = descr->_is_sparse_a;
+
+        header.alg                = selection->alg;
+        header.config_id          = selection->config_id;
+        header.search_iterations  = selection->search_iterations;
+        header.candidates         = selection->candidates;
+        header.search_statistic   = selection->search_statistic;
+        header.search_flush_cache = selection->search_flush_cache;
+        header.search_min_time    = selection->search_min_time;
+        header.split_k            = selection->split_k;
+        header.split_k_mode       = selection->split_k_mode;
+        header.atomics            = selection->atomics;
+        header.workspace_streams  = selection->workspace_streams;
+
+        std::vector<rocsparselt_plan_blob_config> configs(selection->config_max_id);
+        for(int i = 0; i < selection->config_max_id; i++)
+        {
+            auto& config                   = selection->configs[i];
+            configs[i].index               = config.index;
+            configs[i].use_bias            = config.use_bias;
+            configs[i].use_scale_alpha_vec = config.use_scale_alpha_vec;
+            configs[i].split_k             = config.split_k;
+            configs[i].split_k_mode        = config.split_k_mode;
+            configs[i].atomics             = config.atomics;
+            configs[i].max_workspace_bytes = config.max_workspace_bytes;
+        }
+        rocsparselt_plan_blob_write(header, configs.data(), data);
+        *dataSize = size;
+
+        log_api(_handle, __func__, "plan[in]", plan, "data[out]", data, "dataSize[out]", size);
+    }
+    catch(const rocsparselt_status& status)
+    {
+        log_info(_handle, __func__, "status", status);
+        return status;
+    }
+    return rocsparselt_status_success;
+}
+
+/********************************************************************************
+ * \brief
+ *******************************************************************************/
+rocsparselt_status rocsparselt_matmul_plan_deserialize(const rocsparselt_handle* handle,
+                                                       rocsparselt_matmul_plan*  plan,
+                                                       const void*               data,
+                                                       size_t                    dataSize)
+{
+    if(handle == nullptr)
+    {
+        hipsparselt_cerr << "handle is a NULL pointer" << std::endl;
+        return rocsparselt_status_invalid_handle;
+    }
+    auto _handle = reinterpret_cast<const _rocsparselt_handle*>(handle);
+    if(!_handle->isInit())
+    {
+        hipsparselt_cerr << "handle did not initialized or already destroyed" << std::endl;
+        return rocsparselt_status_invalid_handle;
+    }
+
+    if(plan == nullptr)
+    {
+        log_error(_handle, __func__, "plan is a NULL pointer");
+        return rocsparselt_status_invalid_pointer;
+    }
+    else if(data == nullptr)
+    {
+        log_error(_handle, __func__, "data is a NULL pointer");
+        return rocsparselt_status_invalid_pointer;
+    }
+
+    auto _plan = reinterpret_cast<_rocsparselt_matmul_plan*>(plan);
+    try
+    {
+        std::string arch, version;
+        RETURN_IF_ROCSPARSELT_ERROR(
+            rocsparselt_internal_arch_and_version(_handle, &arch, &version));
+
+        rocsparselt_plan_blob_header              header;
+        std::vector<rocsparselt_plan_blob_config> blob_configs;
+        switch(rocsparselt_plan_blob_read(
+            data, dataSize, arch.c_str(), version.c_str(), &header, &blob_configs))
+        {
+        case rocsparselt_plan_blob_error::none:
+            break;
+        case rocsparselt_plan_blob_error::invalid:
+            log_error(_handle, __func__, "data is not a plan, or it is truncated or corrupted");
+            return rocsparselt_status_invalid_value;
+        case rocsparselt_plan_blob_error::version:
+            log_error(_handle, __func__, "the plan is of version", header.version, "not", version);
+            return rocsparselt_status_invalid_value;
+        case rocsparselt_plan_blob_error::arch:
+            log_error(_handle, __func__, "the plan is for", header.arch, "not", arch);
+            return rocsparselt_status_arch_mismatch;
+        }
+        if(header.config_count == 0 || header.config_id < 0
+           || header.config_id >= int(header.config_count))
+        {
+            log_error(_handle, __func__, "the plan has no config", header.config_id);
+            return rocsparselt_status_invalid_value;
+        }
+#if !BUILD_WITH_TENSILE
+        if(header.pointer_mode == rocsparselt_pointer_mode_device)
+        {
+            log_error(_handle, __func__, "device pointer mode requires the Tensile backend");
+            return rocsparselt_status_not_implemented;
+        }
+#endif
+
+        // The matrices of the descriptor are the ones of the plan, see plan_init.
+        _rocsparselt_mat_descr  matA(_handle), matB(_handle), matC(_handle), matD(_handle);
+        _rocsparselt_mat_descr* matrices[] = {&matA, &matB, &matC, &matD};
+        for(int i = 0; i < 4; i++)
+            rocsparselt_plan_blob_to_matrix(header.matrices[i], matrices[i]);
+
+        _rocsparselt_matmul_descr descr(_handle);
+        descr.matrix_A     = &matA;
+        descr.matrix_B     = &matB;
+        descr.matrix_C     = &matC;
+        descr.matrix_D     = &matD;
+        descr.op_A         = static_cast<rocsparselt_operation>(header.op_a);
+        descr.op_B         = static_cast<rocsparselt_operation>(header.op_b);
+        descr.compute_type = static_cast<rocsparselt_compute_type>(header.compute_type);
+        descr.activation   = static_cast<rocsparselt_matmul_descr_attribute>(header.activation);
+        descr.pointer_mode = static_cast<rocsparselt_pointer_mode>(header.pointer_mode);
+
+        descr.activation_relu_upperbound   = header.activation_relu_upperbound;
+        descr.activation_relu_threshold    = header.activation_relu_threshold;
+        descr.activation_leakyrelu_alpha   = header.activation_leakyrelu_alpha;
+        descr.activation_tanh_alpha        = header.activation_tanh_alpha;
+        descr.activation_tanh_beta         = header.activation_tanh_beta;
+        descr.activation_gelu_scaling      = header.activation_gelu_scaling;
+        descr.bias_type                    = static_cast<hipDataType>(header.bias_type);
+        descr.bias_is_hipsparselt_datatype = header.bias_is_hipsparselt_datatype;
+        descr.bias_stride                  = header.bias_stride;
+        descr.alpha_vector_scaling         = header.alpha_vector_scaling;
+        descr.is_sparse_a                  = header.is_sparse_a;
+        descr._swap_ab                     = header.swap_ab;
+        descr.m                            = header.m;
+        descr.n                            = header.n;
+        descr.k                            = header.k;
+        descr._op_A                        = static_cast<rocsparselt_operation>(header._op_a);
+        descr._op_B                        = static_cast<rocsparselt_operation>(header._op_b);
+        descr._m                           = header._m;
+        descr._n                           = header._n;
+        descr._k                           = header._k;
+        descr._lda                         = header._lda;
+        descr._ldb                         = header._ldb;
+        descr._is_sparse_a                 = header._is_sparse_a;
+
+        std::vector<_rocsparselt_matmul_config> configs(blob_configs.size());
+        for(size_t i = 0; i < configs.size(); i++)
+        {
+            configs[i].index               = blob_configs[i].index;
+            configs[i].use_bias            = blob_configs[i].use_bias;
+            configs[i].use_scale_alpha_vec = blob_configs[i].use_scale_alpha_vec;
+            configs[i].split_k             = blob_configs[i].split_k;
+            configs[i].split_k_mode        = blob_configs[i].split_k_mode;
+            configs[i].atomics             = blob_configs[i].atomics;
+            configs[i].max_workspace_bytes = blob_configs[i].max_workspace_bytes;
+        }
+
+        auto capture = new _rocsparselt_matmul_capture;
+        auto status  = capture->init();
+        if(status != rocsparselt_status_success)
+        {
+            delete capture;
+            return status;
+        }
+
+        _rocsparselt_workspace_pool* device_alpha = nullptr;
+        if(descr.pointer_mode == rocsparselt_pointer_mode_device && !descr.alpha_vector_scaling)
+        {
+            device_alpha = new _rocsparselt_workspace_pool;
+            device_alpha->reserve(descr.m * sizeof(float));
+        }
+
+        _rocsparselt_matmul_plan tmpPlan(_handle);
+        memcpy(_plan, &tmpPlan, sizeof(_rocsparselt_matmul_plan));
+
+        auto selection                = new _rocsparselt_matmul_alg_selection(_handle);
+        selection->alg                = static_cast<rocsparselt_matmul_alg>(header.alg);
+        selection->config_id          = header.config_id;
+        selection->search_iterations  = header.search_iterations;
+        selection->candidates         = header.candidates;
+        selection->search_statistic   = header.search_statistic;
+        selection->search_flush_cache = header.search_flush_cache;
+        selection->search_min_time    = header.search_min_time;
+        selection->split_k            = header.split_k;
+        selection->split_k_mode       = header.split_k_mode;
+        selection->atomics            = header.atomics;
+        selection->workspace_streams  = std::max(header.workspace_streams, 1);
+
+        _plan->matmul_descr       = new _rocsparselt_matmul_descr(descr);
+        _plan->alg_selection      = selection;
+        _plan->owns_alg_selection = true;
+        _plan->config_storage     = _handle->config_storage->retain();
+        _plan->exec_cache         = rocsparselt_internal_exec_cache_create(_handle);
+        _plan->device_alpha       = device_alpha;
+        _plan->capture            = capture;
+
+        selection->config_max_id = configs.size();
+        selection->configs
+            = _handle->config_storage->assign(selection, *_plan->matmul_descr, std::move(configs));
+
+        if(_handle->workspace_pool != nullptr)
+            _handle->workspace_pool->reserve(selection->selected_workspace_bytes());
+        log_api(_handle,
+                __func__,
+                "plan[out]",
+                plan,
+                "data[in]",
+                data,
+                "dataSize[in]",
+                dataSize,
+                "configs",
+                selection->config_max_id);
+    }
+    catch(const rocsparselt_status& status)
+    {
+        log_info(_handle, __func__, "status", status);
+        return status;
+    }
+    return rocsparselt_status_success;
+}
+
 /********************************************************************************
  * \brief destroy matrix multiplication plan descriptor
  *******************************************************************************/
@@ -1703,6 +2801,34 @@ rocsparselt_status rocsparselt_matmul_plan_destroy(const rocsparselt_matmul_plan
     return rocsparselt_status_success;
 }
 
+// The startup timing is indexed by the phases.
+static_assert(rocsparselt_startup_first_launch + 1 == rocsparselt_startup_phase_count,
+              "startup phases must match");
+
+/********************************************************************************
+ * \brief get the time spent in a phase of the startup
+ *******************************************************************************/
+rocsparselt_status rocsparselt_get_startup_timing(rocsparselt_startup_phase   phase,
+                                                  rocsparselt_startup_timing* timing)
+{
+    if(timing == nullptr)
+    {
+        hipsparselt_cerr << "timing is a NULL pointer" << std::endl;
+        return rocsparselt_status_invalid_pointer;
+    }
+    if(rocsparselt_startup_phase_name(phase) == nullptr)
+    {
+        hipsparselt_cerr << "invalid startup phase " << phase << std::endl;
+        return rocsparselt_status_invalid_value;
+    }
+
+    auto time        = rocsparselt_startup_get(phase);
+    timing->first_ms = time.first_ms;
+    timing->total_ms = time.total_ms;
+    timing->count    = time.count;
+    return rocsparselt_status_success;
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -1730,3 +2856,68 @@ std::string rocsparselt_internal_get_arch_name()
     THROW_IF_HIP_ERROR(hipGetDeviceProperties(&deviceProperties, deviceId));
     return ArchName{}(deviceProperties);
 }
+
+/*******************************************************************************
+ * Arch and version guards of the tuning database and of the plan blobs
+ ******************************************************************************/
+#define TO_STR2(x) #x
+#define TO_STR(x) TO_STR2(x)
+
+#if BUILD_WITH_TENSILE
+#ifndef HIPSPARSELT_TENSILE_VERSION
+#define HIPSPARSELT_TENSILE_VERSION "unknown"
+#endif
+#define HIPSPARSELT_KERNEL_LIBRARY "tensile-" HIPSPARSELT_TENSILE_VERSION
+#else
+#define HIPSPARSELT_KERNEL_LIBRARY "hip"
+#endif
+
+rocsparselt_status rocsparselt_internal_arch_and_version(const _rocsparselt_handle* handle,
+                                                         std::string*               arch,
+                                                         std::string*               version)
+{
+    // The handle queried the properties of its device once, at its initialization.
+    *arch = ArchName{}(handle->properties);
+
+    // The solution indices are only valid for the kernel library they come from.
+    *version = std::to_string(hipsparseltVersionMajor) + "."
+               + std::to_string(hipsparseltVersionMinor) + "."
+               + std::to_string(hipsparseltVersionPatch) + "-" + TO_STR(hipsparseltVersionTweak)
+               + "/" + HIPSPARSELT_KERNEL_LIBRARY;
+    return rocsparselt_status_success;
+}
+
+rocsparselt_status rocsparselt_internal_tuning_key(const _rocsparselt_handle*       handle,
+                                                   const _rocsparselt_matmul_descr* matmulDescr,
+                                                   rocsparselt_tuning_key*          key)
+{
+    std::string arch, version;
+    RETURN_IF_ROCSPARSELT_ERROR(rocsparselt_internal_arch_and_version(handle, &arch, &version));
+
+    rocsparselt_tuning_key_clear(key);
+    strncpy(key->arch, arch.c_str(), sizeof(key->arch) - 1);
+    strncpy(key->version, version.c_str(), sizeof(key->version) - 1);
+    key->op_a                 = matmulDescr->op_A;
+    key->op_b                 = matmulDescr->op_B;
+    key->compute_type         = matmulDescr->compute_type;
+    key->sparse_a             = matmulDescr->is_sparse_a;
+    key->activation           = matmulDescr->activation;
+    key->bias_type            = matmulDescr->bias_pointer ? matmulDescr->bias_type : -1;
+    key->alpha_vector_scaling = matmulDescr->alpha_vector_scaling;
+
+    const _rocsparselt_mat_descr* matrices[] = {matmulDescr->matrix_A,
+                                                matmulDescr->matrix_B,
+                                                matmulDescr->matrix_C,
+                                                matmulDescr->matrix_D};
+    for(int i = 0; i < 4; i++)
+    {
+        key->type[i]         = matrices[i]->type;
+        key->order[i]        = matrices[i]->order;
+        key->rows[i]         = matrices[i]->m;
+        key->cols[i]         = matrices[i]->n;
+        key->ld[i]           = matrices[i]->ld;
+        key->batches[i]      = matrices[i]->num_batches;
+        key->batch_stride[i] = matrices[i]->batch_stride;
+    }
+    return rocsparselt_status_success;
+}
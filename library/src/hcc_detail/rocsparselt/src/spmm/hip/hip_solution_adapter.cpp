@@ -33,6 +33,7 @@
 #include "definitions.h"
 #include "hip_solution_adapter.hpp"
 #include "hipsparselt_ostream.hpp"
+#include "startup_timing.hpp"
 #include "utility.hpp"
 
 #define HIP_CHECK_RETURN(expr)                \
@@ -98,7 +99,7 @@ hipError_t SolutionAdapter::loadLibrary(std::string const& path)
     }
 
     function_table funcs
-        = {{"get_kernel_byte", NULL}, {"get_kernel_params", NULL}, {"get_kernel_counts", NULL}};
+        = {{"get_kernel_byte", NULL}, {"get_kernel_table", NULL}};
     hipError_t status;
     for(auto& func : funcs)
     {
@@ -107,7 +108,7 @@ hipError_t SolutionAdapter::loadLibrary(std::string const& path)
     }
 
     {
-        std::lock_guard<std::mutex> guard(m_access);
+        std::lock_guard<std::shared_mutex> guard(m_access);
         m_lib_handles.push_back(handle);
         m_lib_functions.push_back(funcs);
         m_loadedLibNames.push_back(concatenate(path));
@@ -126,8 +127,11 @@ hipError_t SolutionAdapter::loadCodeObject(const _rocsparselt_handle* handle,
                                            std::string const&         name)
 {
     //check if the module already exist.
-    if(m_modules.find(name) != m_modules.end())
-        return hipSuccess;
+    {
+        std::shared_lock<std::shared_mutex> guard(m_access);
+        if(m_modules.find(name) != m_modules.end())
+            return hipSuccess;
+    }
 
     for(auto& fucs : m_lib_functions)
     {
@@ -135,7 +139,8 @@ hipError_t SolutionAdapter::loadCodeObject(const _rocsparselt_handle* handle,
         if(it == fucs.end())
             continue;
 
-        unsigned char* (*get_kernel_byte)(const char*);
+        // A pointer into the packed blob of the library, see utils/kernel_blob.hpp
+        const unsigned char* (*get_kernel_byte)(const char*);
         *(void**)(&get_kernel_byte) = it->second;
         auto k_bytes                = get_kernel_byte(name.c_str());
 
@@ -151,12 +156,14 @@ hipError_t SolutionAdapter::loadCodeObject(const _rocsparselt_handle* handle,
                                            const void*                image,
                                            std::string const&         name)
 {
-    std::lock_guard<std::mutex> guard(m_access);
-    auto                        it = m_modules.find(name);
+    std::lock_guard<std::shared_mutex> guard(m_access);
+    auto                               it = m_modules.find(name);
     if(it == m_modules.end())
     {
-        hipModule_t module;
+        hipModule_t               module;
+        rocsparselt_startup_timer timer(rocsparselt_startup_code_object_load);
         HIP_CHECK_RETURN(hipModuleLoadData(&module, image));
+        timer.stop();
         //hipsparselt_cout << "load module " << name << " success" << std::endl;
         m_modules[name] = module;
     }
@@ -171,9 +178,21 @@ hipError_t SolutionAdapter::initKernel(std::string const& name)
 
 hipError_t SolutionAdapter::getKernel(hipFunction_t& rv, std::string const& name)
 {
-    std::unique_lock<std::mutex> guard(m_access);
-    hipError_t                   err = hipSuccess;
+    {
+        std::shared_lock<std::shared_mutex> guard(m_access);
 
+        auto it_k = m_kernels.find(name);
+        if(it_k != m_kernels.end())
+        {
+            rv = it_k->second;
+            return hipSuccess;
+        }
+    }
+
+    std::unique_lock<std::shared_mutex> guard(m_access);
+    hipError_t                          err = hipSuccess;
+
+    // another thread may have resolved it in the meantime
     auto it_k = m_kernels.find(name);
     if(it_k != m_kernels.end())
     {
@@ -232,16 +251,93 @@ hipError_t SolutionAdapter::launchKernel(const _rocsparselt_handle* handle,
         log_trace(handle, __func__, stream.str());
     }
 
-    HIP_CHECK_RETURN(loadCodeObject(handle, kernel.kernelName));
+    return launchKernel(handle,
+                        kernel,
+                        const_cast<void*>(kernel.args.data()),
+                        kernel.args.size(),
+                        stream,
+                        startEvent,
+                        stopEvent,
+                        iter);
+}
 
+// Launches kernel with an argument buffer supplied by the caller, e.g. a pre-bound buffer
+// patched with the per-call inputs. kernel.args is not read.
+hipError_t SolutionAdapter::launchKernel(const _rocsparselt_handle* handle,
+                                         KernelInvocation const&    kernel,
+                                         void*                      args,
+                                         size_t                     argsSize,
+                                         hipStream_t                stream,
+                                         hipEvent_t                 startEvent,
+                                         hipEvent_t                 stopEvent,
+                                         int                        iter)
+{
     hipFunction_t function;
-    HIP_CHECK_RETURN(getKernel(function, kernel.kernelName));
+    HIP_CHECK_RETURN(resolveKernel(handle, kernel.kernelName, function));
+
+    return launchKernel(
+        handle, function, kernel, args, argsSize, stream, startEvent, stopEvent, iter);
+}
+
+// Loads the code object of a kernel if needed and returns its function handle. Callers that
+// launch the same kernel repeatedly can keep the handle and skip the name lookups.
+hipError_t SolutionAdapter::resolveKernel(const _rocsparselt_handle* handle,
+                                          std::string const&         name,
+                                          hipFunction_t&             function)
+{
+    HIP_CHECK_RETURN(loadCodeObject(handle, name));
+    HIP_CHECK_RETURN(getKernel(function, name));
+    return hipSuccess;
+}
+
+// Launches a kernel resolved beforehand with resolveKernel(). Only the launch geometry of
+// kernel is read.
+hipError_t SolutionAdapter::launchKernel(const _rocsparselt_handle* handle,
+                                         hipFunction_t              function,
+                                         KernelInvocation const&    kernel,
+                                         void*                      args,
+                                         size_t                     argsSize,
+                                         hipStream_t                stream,
+                                         hipEvent_t                 startEvent,
+                                         hipEvent_t                 stopEvent,
+                                         int                        iter)
+{
+    return launchKernel(handle,
+                        function,
+                        kernel.numWorkItems,
+                        kernel.workGroupSize,
+                        kernel.sharedMemBytes,
+                        args,
+                        argsSize,
+                        stream,
+                        startEvent,
+                        stopEvent,
+                        iter);
+}
 
-    void*  kernelArgs = const_cast<void*>(kernel.args.data());
-    size_t argsSize   = kernel.args.size();
+// Launches a kernel resolved beforehand with resolveKernel() with the given geometry, for
+// callers which patch the sizes of a problem into a kept argument buffer.
+hipError_t SolutionAdapter::launchKernel(const _rocsparselt_handle* handle,
+                                         hipFunction_t              function,
+                                         dim3                       numWorkItems,
+                                         dim3                       workGroupSize,
+                                         size_t                     sharedMemBytes,
+                                         void*                      args,
+                                         size_t                     argsSize,
+                                         hipStream_t                stream,
+                                         hipEvent_t                 startEvent,
+                                         hipEvent_t                 stopEvent,
+                                         int                        iter)
+{
+    if(auto sink = rocsparselt_internal_launch_sink())
+    {
+        auto bytes = static_cast<const uint8_t*>(args);
+        sink->kernel_args.emplace_back(bytes, bytes + argsSize);
+        return hipSuccess;
+    }
 
     void* hipLaunchParams[] = {HIP_LAUNCH_PARAM_BUFFER_POINTER,
-                               kernelArgs,
+                               args,
                                HIP_LAUNCH_PARAM_BUFFER_SIZE,
                                &argsSize,
                                HIP_LAUNCH_PARAM_END};
@@ -250,13 +346,13 @@ hipError_t SolutionAdapter::launchKernel(const _rocsparselt_handle* handle,
         HIP_CHECK_RETURN(hipEventRecord(startEvent, stream));
     for(int i = 0; i < iter; i++)
         HIP_CHECK_RETURN(hipExtModuleLaunchKernel(function,
-                                                  kernel.numWorkItems.x,
-                                                  kernel.numWorkItems.y,
-                                                  kernel.numWorkItems.z,
-                                                  kernel.workGroupSize.x,
-                                                  kernel.workGroupSize.y,
-                                                  kernel.workGroupSize.z,
-                                                  kernel.sharedMemBytes, // sharedMem
+                                                  numWorkItems.x,
+                                                  numWorkItems.y,
+                                                  numWorkItems.z,
+                                                  workGroupSize.x,
+                                                  workGroupSize.y,
+                                                  workGroupSize.z,
+                                                  sharedMemBytes, // sharedMem
                                                   stream, // stream
                                                   nullptr,
                                                   (void**)&hipLaunchParams,
@@ -324,33 +420,20 @@ hipError_t SolutionAdapter::launchKernels(const _rocsparselt_handle*           h
     return hipSuccess;
 }
 
-size_t SolutionAdapter::getKernelCounts(std::string const& category)
-{
-    for(auto& fucs : m_lib_functions)
-    {
-        auto it = fucs.find("get_kernel_counts");
-        if(it == fucs.end())
-            continue;
-
-        int (*get_kernel_counts)(const char*);
-        *(void**)(&get_kernel_counts) = it->second;
-        return get_kernel_counts(category.c_str());
-    }
-    return 0;
-}
-
-KernelParams* SolutionAdapter::getKernelParams(std::string const& category)
+const KernelParams* SolutionAdapter::getKernelParams(uint32_t category, size_t* count)
 {
     for(auto& fucs : m_lib_functions)
     {
-        auto it = fucs.find("get_kernel_params");
+        auto it = fucs.find("get_kernel_table");
         if(it == fucs.end())
             continue;
 
-        KernelParams* (*get_kernel_params)(const char*);
-        *(void**)(&get_kernel_params) = it->second;
-        return get_kernel_params(category.c_str());
+        const KernelParams* (*get_kernel_table)(uint32_t, size_t*);
+        *(void**)(&get_kernel_table) = it->second;
+        if(auto kernels = get_kernel_table(category, count))
+            return kernels;
     }
+    *count = 0;
     return nullptr;
 }
 
@@ -110,6 +110,18 @@ bool KernelArguments::isFullyBound() const
     return true;
 }
 
+size_t KernelArguments::offsetOf(std::string const& name) const
+{
+    if(!m_log)
+        throw std::runtime_error("KernelArguments::offsetOf requires m_log=true");
+
+    auto it = m_argRecords.find(name);
+    if(it == m_argRecords.end())
+        return npos;
+
+    return std::get<ArgOffset>(it->second);
+}
+
 void const* KernelArguments::data() const
 {
     if(!isFullyBound())
@@ -29,13 +29,19 @@
 #include "handle.h"
 #include "hip_solution_adapter.hpp"
 #include "hipsparselt_ostream.hpp"
+#include "parallel_for.hpp"
 #include "rocsparselt-types.h"
 #include "rocsparselt.h"
+#include "rocsparselt_search.hpp"
+#include "startup_timing.hpp"
 #include "status.h"
 #include "utility.hpp"
 
+#include <array>
 #include <atomic>
+#include <chrono>
 #include <complex>
+#include <cstring>
 #include <exception>
 #include <iomanip>
 #include <memory>
@@ -68,233 +74,226 @@ namespace
     }
 #endif
 
-    size_t totalAllcoatedElement(std::vector<size_t>& sizes,
-                                 std::vector<size_t>& strides,
-                                 size_t               offset)
-    {
+    using TensorSizes = std::array<size_t, 3>;
 
+    size_t totalAllcoatedElement(const TensorSizes& sizes, const TensorSizes& strides)
+    {
         size_t totalAllocatedElements = 1;
-        for(int i = 0; i < sizes.size(); i++)
+        for(size_t i = 0; i < sizes.size(); i++)
             totalAllocatedElements += strides[i] * (sizes[i] - 1);
-        totalAllocatedElements += offset;
         return totalAllocatedElements;
     }
 
-    size_t totalAllcoatedElementNonBatch(std::vector<size_t>& sizes,
-                                         std::vector<size_t>& strides,
-                                         BatchIndices&        batchIndex)
+    // The batch is the last index of every tensor.
+    size_t totalAllcoatedElementNonBatch(const TensorSizes& sizes, const TensorSizes& strides)
     {
         size_t totalAllocatedElementsNonBatch = 1;
-        for(int idx = 0; idx < sizes.size(); idx++)
-        {
-            bool isBatch = batchIndex.end()
-                           != std::find_if(batchIndex.begin(),
-                                           batchIndex.end(),
-                                           [idx](const BatchIndex& bi) { return bi.a == idx; });
-            if(!isBatch)
-                totalAllocatedElementsNonBatch += strides[idx] * (sizes[idx] - 1);
-        }
+        for(size_t i = 0; i + 1 < sizes.size(); i++)
+            totalAllocatedElementsNonBatch += strides[i] * (sizes[i] - 1);
         return totalAllocatedElementsNonBatch;
+    }
+
+    /**************************************************************************
+    * The launch geometry and the kernel arguments which follow the sizes    *
+    * and the strides of a problem. They are computed for each call without  *
+    * touching the heap, so that a plan can patch them into the argument     *
+    * buffer of its config when a dynamic-M bucket or a stream part changes  *
+    * M, N or the batch count.                                               *
+    **************************************************************************/
+    struct KernelGeometry
+    {
+        dim3     numWorkGroups;
+        dim3     numWorkItems;
+        uint64_t tensor2dSizeC;
+        uint64_t tensor2dSizeA;
+        uint64_t tensor2dSizeB;
+        uint32_t sizes[4];      // M, N, batch and K
+        uint32_t strides[4][3]; // D, C, A and B
+        int32_t  staggerUIter;
+        uint32_t problemNumGroupTiles0;
+        uint32_t problemNumGroupTiles1;
+        uint32_t numFullBlocks;
+        uint32_t wgmRemainder1;
+        uint32_t magicNumberWgmRemainder1;
     };
 
+    // The free index of A is M, the one of B is N, and C and D are M x N, so the work groups
+    // are never transposed. The bound index is K, the batch index is the last one of all.
     template <typename Ti, typename To, typename Tc>
-    auto ConstructKernelInvoke(const RocsparseltContractionProblem<Ti, To, Tc>& prob,
-                               const KernelParams&                              kernel)
+    KernelGeometry ComputeKernelGeometry(const RocsparseltContractionProblem<Ti, To, Tc>& prob,
+                                         const KernelParams&                              kernel)
     {
-        KernelInvocation ki;
-
-        ki.args = KernelArguments();
-
-        ki.args.reserve(1024, 128);
-
-        ki.kernelName = kernel.SolutionNameMin;
-
-        ki.workGroupSize.x = kernel.WorkGroup[0] * kernel.WorkGroup[1] * kernel.WorkGroup[2];
-        ki.workGroupSize.y = 1;
-        ki.workGroupSize.z = 1;
-
-        ki.numWorkGroups.x = 1;
-        ki.numWorkGroups.y = 1;
-
-        // Indices for contraction problem
-        FreeIndices  freeIndex(2);
-        BoundIndices boundIndex(1);
-        BatchIndices batchIndex{{2, 2, 2, 2}};
-
-        // Set up GEMM indices
-        freeIndex[0].isA = true;
-        freeIndex[1].isA = false;
-        freeIndex[0].c = freeIndex[0].d = 0;
-        freeIndex[1].c = freeIndex[1].d = 1;
+        KernelGeometry g;
 
         // We set K=0 when alpha==0.
         // This makes alpha==0 a change in the problem, and not just a change in the inputs.
         // It optimizes all problems with alpha==0 into K=0 and alpha=(don't care)
-        auto k  = prob.k && *prob.alpha ? prob.k : 0;
-        auto ck = prob.sparseA ? k / 2 : k;
-
-        std::vector<size_t> sizes_a(3), sizes_b(3), sizes_c(3), sizes_d(3);
-        std::vector<size_t> strides_a = {prob.row_stride_a, prob.col_stride_a, prob.batch_stride_a};
-        std::vector<size_t> strides_b = {prob.row_stride_b, prob.col_stride_b, prob.batch_stride_b};
-        std::vector<size_t> strides_c = {prob.row_stride_c, prob.col_stride_c, prob.batch_stride_c};
-        std::vector<size_t> strides_d = {prob.row_stride_d, prob.col_stride_d, prob.batch_stride_d};
-
-        // If A is transposed, swap the free and bound dimensions and their ranks
-        if(prob.trans_a != rocsparselt_operation_none)
+        size_t k  = prob.k && *prob.alpha ? prob.k : 0;
+        size_t ck = prob.sparseA ? k / 2 : k;
+
+        // If A or B is transposed, its free and bound dimensions are swapped
+        TensorSizes sizes_a = prob.trans_a != rocsparselt_operation_none
+                                  ? TensorSizes{ck, prob.m, prob.batch_count}
+                                  : TensorSizes{prob.m, ck, prob.batch_count};
+        TensorSizes sizes_b = prob.trans_b != rocsparselt_operation_none
+                                  ? TensorSizes{prob.n, k, prob.batch_count}
+                                  : TensorSizes{k, prob.n, prob.batch_count};
+        TensorSizes sizes_c = {prob.m, prob.n, prob.batch_count};
+
+        TensorSizes strides_a = {prob.row_stride_a, prob.col_stride_a, prob.batch_stride_a};
+        TensorSizes strides_b = {prob.row_stride_b, prob.col_stride_b, prob.batch_stride_b};
+        TensorSizes strides_c = {prob.row_stride_c, prob.col_stride_c, prob.batch_stride_c};
+        TensorSizes strides_d = {prob.row_stride_d, prob.col_stride_d, prob.batch_stride_d};
+
+        // spmm_device_scalars() points C at D, which changes the strides of C
+        for(size_t i = 0; i < 3; i++)
         {
-            sizes_a[0] = ck;
-            sizes_a[1] = prob.m;
-            sizes_a[2] = prob.batch_count;
-
-            freeIndex[0].i  = 1;
-            boundIndex[0].a = 0;
+            g.strides[0][i] = strides_d[i];
+            g.strides[1][i] = strides_c[i];
+            g.strides[2][i] = strides_a[i];
+            g.strides[3][i] = strides_b[i];
         }
-        else
-        {
-            sizes_a[0] = prob.m;
-            sizes_a[1] = ck;
-            sizes_a[2] = prob.batch_count;
 
-            freeIndex[0].i  = 0;
-            boundIndex[0].a = 1;
-        }
+        g.numWorkGroups.x = prob.m;
+        g.numWorkGroups.y = prob.n;
+        g.numWorkGroups.z = 1;
+        if(kernel.PackBatchDims & 0x1)
+            g.numWorkGroups.x *= prob.batch_count;
+        if(kernel.PackBatchDims & 0x2)
+            g.numWorkGroups.y *= prob.batch_count;
+        if(!kernel.PackBatchDims)
+            g.numWorkGroups.z *= prob.batch_count;
+
+        g.numWorkGroups.x = CeilDivide(g.numWorkGroups.x, kernel.MacroTile[0]);
+        g.numWorkGroups.y = CeilDivide(g.numWorkGroups.y, kernel.MacroTile[1]);
+
+        g.problemNumGroupTiles0 = g.numWorkGroups.x;
+        g.problemNumGroupTiles1 = g.numWorkGroups.y;
+
+        g.numWorkGroups.y *= kernel.GlobalSplitU;
+
+        uint32_t workGroupSize = kernel.WorkGroup[0] * kernel.WorkGroup[1] * kernel.WorkGroup[2];
+        g.numWorkItems.x       = workGroupSize * g.numWorkGroups.x;
+        g.numWorkItems.y       = g.numWorkGroups.y;
+        g.numWorkItems.z       = g.numWorkGroups.z;
+
+        g.tensor2dSizeC = totalAllcoatedElement(sizes_c, strides_c);
+        g.tensor2dSizeA = (kernel.PackBatchDims & 0x1)
+                              ? totalAllcoatedElement(sizes_a, strides_a)
+                              : totalAllcoatedElementNonBatch(sizes_a, strides_a);
+        g.tensor2dSizeB = (kernel.PackBatchDims & 0x2)
+                              ? totalAllcoatedElement(sizes_b, strides_b)
+                              : totalAllcoatedElementNonBatch(sizes_b, strides_b);
+
+        // The bound size is the larger K of A and B
+        uint32_t sizeL = std::max(ck, k);
+        g.sizes[0]     = prob.m;
+        g.sizes[1]     = prob.n;
+        g.sizes[2]     = prob.batch_count;
+        g.sizes[3]     = sizeL;
 
-        // If B is transposed, swap the free and bound dimensions and their ranks
-        if(prob.trans_b != rocsparselt_operation_none)
-        {
-            sizes_b[0] = prob.n;
-            sizes_b[1] = k;
-            sizes_b[2] = prob.batch_count;
-
-            freeIndex[1].i  = 0;
-            boundIndex[0].b = 1;
-        }
-        else
-        {
-            sizes_b[0] = k;
-            sizes_b[1] = prob.n;
-            sizes_b[2] = prob.batch_count;
-
-            freeIndex[1].i  = 1;
-            boundIndex[0].b = 0;
-        }
-
-        sizes_c[0] = prob.m;
-        sizes_c[1] = prob.n;
-        sizes_c[2] = prob.batch_count;
+        // Caculate staggerU
+        // how many stride-sized clicks to stagger start offset
+        unsigned int staggerUIter = kernel.StaggerU;
 
-        sizes_d[0] = prob.m;
-        sizes_d[1] = prob.n;
-        sizes_d[2] = prob.batch_count;
+        // /DepthU/GSU
+        int unrollLoopIters = sizeL / kernel.DepthU / kernel.GlobalSplitU;
 
-        FreeIndices         freeIndicesA;
-        FreeIndices         freeIndicesB;
-        std::vector<size_t> freeSizesA;
-        std::vector<size_t> freeSizesB;
+        unsigned int shifted = 1 << kernel.StaggerStrideShift;
 
-        freeIndicesA.reserve(freeIndex.size());
-        freeIndicesB.reserve(freeIndex.size());
-        freeSizesA.reserve(freeIndex.size());
-        freeSizesB.reserve(freeIndex.size());
-        for(int i = 0; i < freeIndex.size(); i++)
+        while(staggerUIter > 1)
         {
-            size_t mySize = sizes_d[freeIndex[i].d];
-            if(freeIndex[i].isA)
-            {
-                freeIndicesA.push_back(freeIndex[i]);
-                freeSizesA.push_back(mySize);
-            }
-            else
-            {
-                freeIndicesB.push_back(freeIndex[i]);
-                freeSizesB.push_back(mySize);
-            }
-        }
+            if(unrollLoopIters >= (staggerUIter * shifted))
+                break;
 
-        for(size_t i = 0; i < freeIndicesA.size(); i++)
-        {
-            ki.numWorkGroups.x *= freeSizesA[i];
-        }
-        for(size_t i = 0; i < freeIndicesB.size(); i++)
-        {
-            ki.numWorkGroups.y *= freeSizesB[i];
+            staggerUIter /= 2; // step down to smaller stagger
         }
 
-        ki.numWorkGroups.z = 1;
+        if(staggerUIter >= 1)
+            staggerUIter -= 1;
+        g.staggerUIter = staggerUIter;
 
-        std::vector<size_t> batchSizes(batchIndex.size());
-        std::vector<size_t> boundSizes(boundIndex.size());
-        for(int i = 0; i < batchIndex.size(); i++)
-        {
-            batchSizes[i] = std::max({sizes_a[batchIndex[i].a],
-                                      sizes_b[batchIndex[i].b],
-                                      sizes_c.empty() ? 0 : sizes_c[batchIndex[i].c],
-                                      sizes_d[batchIndex[i].d]});
-        }
+        g.numFullBlocks            = g.problemNumGroupTiles1;
+        g.wgmRemainder1            = 0;
+        g.magicNumberWgmRemainder1 = 0;
 
-        for(int i = 0; i < boundIndex.size(); i++)
+        if(kernel.WorkGroupMapping != 0)
         {
-            boundSizes[i] = std::max(sizes_a[boundIndex[i].a], sizes_b[boundIndex[i].b]);
-        }
+            g.numFullBlocks = g.problemNumGroupTiles1 / kernel.WorkGroupMapping;
+            g.wgmRemainder1 = g.problemNumGroupTiles1 % kernel.WorkGroupMapping;
+            if(g.wgmRemainder1 == 0)
+                g.wgmRemainder1 = kernel.WorkGroupMapping;
 
-        for(size_t i = 0; i < batchIndex.size(); i++)
-        {
-            if(kernel.PackBatchDims & 0x1)
-                ki.numWorkGroups.x *= batchSizes[i];
-            if(kernel.PackBatchDims & 0x2)
-                ki.numWorkGroups.y *= batchSizes[i];
-            if(!kernel.PackBatchDims)
-                ki.numWorkGroups.z *= batchSizes[i];
+            uint64_t  magicNum;
+            const int smallMagicShift = 31;
+            magicNum                  = (1L << smallMagicShift) / g.wgmRemainder1 + 1;
+            assert(magicNum >> 32 == 0); // ensure magic number fits
+            g.magicNumberWgmRemainder1 = static_cast<uint32_t>(magicNum);
         }
+        return g;
+    }
 
-        // CD always contain index0.  if this is in the B free indices, then need to
-        // transposing the output tensor.
-        bool transposeC01 = freeIndicesB.end()
-                            != std::find_if(freeIndicesB.begin(),
-                                            freeIndicesB.end(),
-                                            [](const FreeIndex& fi) { return fi.c == 0 /*idx0*/; });
-
-        if(transposeC01)
-            std::swap(ki.numWorkGroups.x, ki.numWorkGroups.y);
-
-        ki.numWorkGroups.x = CeilDivide(ki.numWorkGroups.x, kernel.MacroTile[0]);
-        ki.numWorkGroups.y = CeilDivide(ki.numWorkGroups.y, kernel.MacroTile[1]);
+    // The per-call inputs. KernelArguments can leave them unbound, KernelArgumentsBinary has
+    // no notion of binding and always writes the value.
+    template <typename T>
+    inline void AppendInput(KernelArguments& args, char const* name, T value, bool bind)
+    {
+        if(bind)
+            args.append<T>(name, value);
+        else
+            args.appendUnbound<T>(name);
+    }
 
-        uint32_t problemNumGroupTiles0 = ki.numWorkGroups.x;
-        uint32_t problemNumGroupTiles1 = ki.numWorkGroups.y;
+    template <typename T>
+    inline void AppendInput(KernelArgumentsBinary& args, char const* name, T value, bool)
+    {
+        args.append<T>(name, value);
+    }
 
-        ki.numWorkGroups.y *= kernel.GlobalSplitU;
+    constexpr std::array<char const*, 3> strideDNames = {"strideD0", "strideD1", "strideD2"};
+    constexpr std::array<char const*, 3> strideCNames = {"strideC0", "strideC1", "strideC2"};
+    constexpr std::array<char const*, 3> strideANames = {"strideA0", "strideA1", "strideA2"};
+    constexpr std::array<char const*, 3> strideBNames = {"strideB0", "strideB1", "strideB2"};
+    constexpr std::array<char const*, 4> sizeNames    = {"size_0", "size_1", "size_2", "size_3"};
+
+    // Fills the launch geometry of ki and appends the kernel arguments to args, which is
+    // either ki.args or a KernelArgumentsBinary. With bindInputs=false, the pointers,
+    // alpha/beta and the activation arguments are left unbound in a KernelArguments, so
+    // that the result can be used as a template for ConstructPreboundKernel().
+    template <typename Ti, typename To, typename Tc, typename Args>
+    void BuildKernelInvoke(const RocsparseltContractionProblem<Ti, To, Tc>& prob,
+                           const KernelParams&                              kernel,
+                           KernelInvocation&                                ki,
+                           Args&                                            args,
+                           bool                                             bindInputs)
+    {
+        ki.kernelName = kernel.SolutionNameMin;
 
-        ki.numWorkItems.x = ki.workGroupSize.x * ki.numWorkGroups.x;
-        ki.numWorkItems.y = ki.workGroupSize.y * ki.numWorkGroups.y;
-        ki.numWorkItems.z = ki.workGroupSize.z * ki.numWorkGroups.z;
+        ki.workGroupSize.x = kernel.WorkGroup[0] * kernel.WorkGroup[1] * kernel.WorkGroup[2];
+        ki.workGroupSize.y = 1;
+        ki.workGroupSize.z = 1;
 
+        auto g            = ComputeKernelGeometry<Ti, To, Tc>(prob, kernel);
+        ki.numWorkGroups  = g.numWorkGroups;
+        ki.numWorkItems   = g.numWorkItems;
         ki.sharedMemBytes = 0;
 
-        uint64_t tensor2dSizeC = totalAllcoatedElement(sizes_c, strides_c, (size_t)0);
-        uint64_t tensor2dSizeA
-            = (kernel.PackBatchDims & 0x1)
-                  ? totalAllcoatedElement(sizes_a, strides_a, (size_t)0)
-                  : totalAllcoatedElementNonBatch(sizes_a, strides_a, batchIndex);
-        uint64_t tensor2dSizeB
-            = (kernel.PackBatchDims & 0x2)
-                  ? totalAllcoatedElement(sizes_b, strides_b, (size_t)0)
-                  : totalAllcoatedElementNonBatch(sizes_b, strides_b, batchIndex);
-
-        ki.args.append<uint64_t>("tensor2dSizeC", tensor2dSizeC);
-        ki.args.append<uint64_t>("tensor2dSizeA", tensor2dSizeA);
-        ki.args.append<uint64_t>("tensor2dSizeB", tensor2dSizeB);
-
-        ki.args.append<To const*>("d", prob.D);
-        ki.args.append<To const*>("c", prob.C);
-        ki.args.append<Ti const*>("a", prob.A);
-        ki.args.append<Ti const*>("b", prob.B);
+        args.template appendFields<uint64_t, uint64_t, uint64_t>(
+            {"tensor2dSizeC", "tensor2dSizeA", "tensor2dSizeB"},
+            g.tensor2dSizeC,
+            g.tensor2dSizeA,
+            g.tensor2dSizeB);
+
+        AppendInput<To const*>(args, "d", prob.D, bindInputs);
+        AppendInput<To const*>(args, "c", prob.C, bindInputs);
+        AppendInput<Ti const*>(args, "a", prob.A, bindInputs);
+        AppendInput<Ti const*>(args, "b", prob.B, bindInputs);
 
         if(prob.sparseA)
-            ki.args.append<unsigned char const*>("metadata", prob.metadata);
+            AppendInput<unsigned char const*>(args, "metadata", prob.metadata, bindInputs);
 
-        ki.args.append<float>("alpha", *prob.alpha);
-        ki.args.append<float>("beta", *prob.beta);
+        AppendInput<float>(args, "alpha", *prob.alpha, bindInputs);
+        AppendInput<float>(args, "beta", *prob.beta, bindInputs);
 
         hipsparselt_activation_type act_type
             = string_to_hipsparselt_activation_type(kernel.ActivationType);
@@ -304,99 +303,66 @@ namespace
             if(kernel.ActivationHPA)
             {
                 //same as the alpha/beta type.
-                ki.args.append<float>("activation_0", prob.act_arg0);
-                ki.args.append<float>("activation_1", prob.act_arg1);
+                AppendInput<float>(args, "activation_0", prob.act_arg0, bindInputs);
+                AppendInput<float>(args, "activation_1", prob.act_arg1, bindInputs);
             }
             else
             {
-                ki.args.append<To>("activation_0", static_cast<To>(prob.act_arg0));
-                ki.args.append<To>("activation_1", static_cast<To>(prob.act_arg1));
+                AppendInput<To>(args, "activation_0", static_cast<To>(prob.act_arg0), bindInputs);
+                AppendInput<To>(args, "activation_1", static_cast<To>(prob.act_arg1), bindInputs);
             }
-            ki.args.append<uint32_t>("activationType", static_cast<uint32_t>(prob.act_type));
+            args.template append<uint32_t>("activationType", static_cast<uint32_t>(prob.act_type));
         }
 
         size_t startStrideCD = kernel.UseInitialStridesCD ? 0 : 1;
         size_t startStrideAB = kernel.UseInitialStridesAB ? 0 : 1;
 
-        for(size_t i = startStrideCD; i < sizes_d.size(); i++)
-            ki.args.append<uint32_t>(concatenate_if<true>("strideD", i), strides_d[i]);
+        for(size_t i = startStrideCD; i < strideDNames.size(); i++)
+            args.template append<uint32_t>(strideDNames[i], g.strides[0][i]);
 
-        for(size_t i = startStrideCD; i < sizes_c.size(); i++)
-            ki.args.append<uint32_t>(concatenate_if<true>("strideC", i), strides_c[i]);
+        for(size_t i = startStrideCD; i < strideCNames.size(); i++)
+            args.template append<uint32_t>(strideCNames[i], g.strides[1][i]);
 
-        for(size_t i = startStrideAB; i < sizes_a.size(); i++)
-            ki.args.append<uint32_t>(concatenate_if<true>("strideA", i), strides_a[i]);
+        for(size_t i = startStrideAB; i < strideANames.size(); i++)
+            args.template append<uint32_t>(strideANames[i], g.strides[2][i]);
 
-        for(size_t i = startStrideAB; i < sizes_b.size(); i++)
-            ki.args.append<uint32_t>(concatenate_if<true>("strideB", i), strides_b[i]);
+        for(size_t i = startStrideAB; i < strideBNames.size(); i++)
+            args.template append<uint32_t>(strideBNames[i], g.strides[3][i]);
 
-        std::vector<size_t> problemSizes;
-        problemSizes.resize(0);
-        problemSizes.reserve(sizes_c.size() + boundSizes.size());
-        problemSizes.insert(problemSizes.end(), sizes_c.begin(), sizes_c.end());
-        problemSizes.insert(problemSizes.end(), boundSizes.begin(), boundSizes.end());
+        for(size_t i = 0; i < sizeNames.size(); i++)
+            args.template append<uint32_t>(sizeNames[i], g.sizes[i]);
 
-        int idx = 0;
-        for(auto size : problemSizes)
-        {
-            ki.args.append<uint32_t>(concatenate_if<true>("size_", idx), size);
-            idx++;
-        }
+        args.template appendFields<int32_t, uint32_t, uint32_t>(
+            {"staggerUIter", "problemNumGroupTiles0", "problemNumGroupTiles1"},
+            g.staggerUIter,
+            g.problemNumGroupTiles0,
+            g.problemNumGroupTiles1);
 
-        // Caculate staggerU
-        uint32_t sizeL = boundSizes[0];
-
-        // how many stride-sized clicks to stagger start offset
-        unsigned int staggerUIter = kernel.StaggerU;
+        args.template appendFields<uint32_t, uint32_t, uint32_t>(
+            {"numFullBlocks", "wgmRemainder1", "magicNumberWgmRemainder1"},
+            g.numFullBlocks,
+            g.wgmRemainder1,
+            g.magicNumberWgmRemainder1);
 
-        // /DepthU/GSU
-        int unrollLoopIters = sizeL / kernel.DepthU / kernel.GlobalSplitU;
-
-        unsigned int shifted = 1 << kernel.StaggerStrideShift;
-
-        while(staggerUIter > 1)
-        {
-            if(unrollLoopIters >= (staggerUIter * shifted))
-                break;
-
-            staggerUIter /= 2; // step down to smaller stagger
-        }
-
-        if(staggerUIter >= 1)
-            staggerUIter -= 1;
-
-        ki.args.append<int32_t>("staggerUIter", staggerUIter);
-        ki.args.append<uint32_t>("problemNumGroupTiles0", problemNumGroupTiles0);
-        ki.args.append<uint32_t>("problemNumGroupTiles1", problemNumGroupTiles1);
-
-        uint32_t numFullBlocks            = problemNumGroupTiles1;
-        uint32_t wgmRemainder1            = 0;
-        uint32_t magicNumberWgmRemainder1 = 0;
-
-        if(kernel.WorkGroupMapping != 0)
-        {
-            numFullBlocks = problemNumGroupTiles1 / kernel.WorkGroupMapping;
-            wgmRemainder1 = problemNumGroupTiles1 % kernel.WorkGroupMapping;
-            if(wgmRemainder1 == 0)
-                wgmRemainder1 = kernel.WorkGroupMapping;
-
-            uint64_t  magicNum;
-            const int smallMagicShift = 31;
-            magicNum                  = (1L << smallMagicShift) / wgmRemainder1 + 1;
-            assert(magicNum >> 32 == 0); // ensure magic number fits
-            magicNumberWgmRemainder1 = static_cast<uint32_t>(magicNum);
-        }
+        args.template appendFields<uint32_t, uint32_t, uint32_t, uint32_t, uint32_t>(
+            {"offsetD", "offsetC", "offsetA", "offsetB", "pad"},
+            prob.buffer_offset_b,
+            prob.buffer_offset_c,
+            prob.buffer_offset_a,
+            prob.buffer_offset_b,
+            0);
+    }
 
-        ki.args.append<uint32_t>("numFullBlocks", numFullBlocks);
-        ki.args.append<uint32_t>("wgmRemainder1", wgmRemainder1);
-        ki.args.append<uint32_t>("magicNumberWgmRemainder1", magicNumberWgmRemainder1);
+    template <typename Ti, typename To, typename Tc>
+    auto ConstructKernelInvoke(const RocsparseltContractionProblem<Ti, To, Tc>& prob,
+                               const KernelParams&                              kernel,
+                               bool                                             bindInputs = true)
+    {
+        KernelInvocation ki;
 
-        ki.args.append<uint32_t>("offsetD", prob.buffer_offset_b);
-        ki.args.append<uint32_t>("offsetC", prob.buffer_offset_c);
-        ki.args.append<uint32_t>("offsetA", prob.buffer_offset_a);
-        ki.args.append<uint32_t>("offsetB", prob.buffer_offset_b);
+        ki.args.reserve(1024, 128);
 
-        ki.args.append<uint32_t>("pad", 0);
+        BuildKernelInvoke<Ti, To, Tc>(prob, kernel, ki, ki.args, bindInputs);
         return ki;
     }
 
@@ -405,14 +371,13 @@ namespace
      **************************************************/
     class KernelLauncher
     {
-        std::shared_ptr<hipDeviceProp_t> m_deviceProp;
-
         // The adapter object. mutable is used to allow adapters to be modified
         // even when they are stored in a const vector which is immutable in size
         struct adapter_s
         {
-            mutable std::atomic<SolutionAdapter*> adapter{nullptr};
-            mutable std::mutex                    mutex;
+            mutable std::atomic<SolutionAdapter*>    adapter{nullptr};
+            mutable std::mutex                       mutex;
+            mutable std::shared_ptr<hipDeviceProp_t> deviceProp;
         };
 
         // Each device contains an adapter
@@ -451,9 +416,9 @@ namespace
                 delete a.adapter;
         }
 
-        auto& get_device_property() const
+        auto& get_device_property(int device) const
         {
-            return m_deviceProp;
+            return m_adapters.at(device).deviceProp;
         }
 
         auto& get_adapters() const
@@ -479,6 +444,8 @@ namespace
          *********************************************************************/
         void initialize(SolutionAdapter& adapter, int32_t deviceId)
         {
+            rocsparselt_startup_timer path_discovery(rocsparselt_startup_path_discovery);
+
             std::string path;
 #ifndef WIN32
             path.reserve(PATH_MAX);
@@ -513,9 +480,12 @@ namespace
                 else
                     path += "/hipsparselt/library";
             }
+            path_discovery.stop();
 
-            auto dir      = path + "/libspmm_kernels_" + processor + ".so";
-            bool no_match = false;
+            auto                      start = std::chrono::steady_clock::now();
+            rocsparselt_startup_timer library_load(rocsparselt_startup_library_load);
+            auto                      dir      = path + "/libspmm_kernels_" + processor + ".so";
+            bool                      no_match = false;
             if(TestPath(dir))
             {
                 if(adapter.loadLibrary(dir) != hipSuccess)
@@ -523,6 +493,13 @@ namespace
             }
             else
                 no_match = true;
+            library_load.stop();
+            log_process(rocsparselt_layer_mode_log_info,
+                        "KernelLauncher::initialize",
+                        "device",
+                        deviceId,
+                        "library_ms",
+                        ElapsedMs(start));
 
             if(no_match)
             {
@@ -533,11 +510,18 @@ namespace
                       << std::endl;
             }
 
-            hipDeviceProp_t prop;
-
+            hipDeviceProp_t           prop;
+            rocsparselt_startup_timer timer(rocsparselt_startup_device_properties);
             THROW_IF_HIP_ERROR(hipGetDeviceProperties(&prop, deviceId));
+            timer.stop();
 
-            m_deviceProp = std::make_shared<hipDeviceProp_t>(prop);
+            m_adapters.at(deviceId).deviceProp = std::make_shared<hipDeviceProp_t>(prop);
+        }
+
+        static double ElapsedMs(std::chrono::steady_clock::time_point start)
+        {
+            using ms = std::chrono::duration<double, std::milli>;
+            return ms(std::chrono::steady_clock::now() - start).count();
         }
     };
 
@@ -577,7 +561,7 @@ namespace
             }
 
             if(deviceProp)
-                *deviceProp = host.get_device_property();
+                *deviceProp = host.get_device_property(device);
 
             return *adapter;
         }
@@ -617,6 +601,262 @@ namespace
             hipsparselt_cerr << msg << std::endl;
     }
 
+    /**************************************************************************
+    * A kernel invocation whose argument buffer was built once for a plan    *
+    * and a config. The per-call slots (pointers, alpha/beta and the         *
+    * activation arguments) and the arguments which follow M, N and the     *
+    * batch count are patched in by fixed offsets at launch time, so a       *
+    * dynamic-M bucket or a stream part does not rebuild the entry.          *
+    * Entries are immutable once published.                                  *
+    **************************************************************************/
+    struct PreboundKernel
+    {
+        static constexpr size_t npos     = KernelArguments::npos;
+        static constexpr size_t capacity = 1024;
+
+        int    config_id;
+        bool   zero_alpha; // alpha==0 is folded into K, see ConstructKernelInvoke()
+
+        KernelInvocation     kernel;
+        hipFunction_t        function = nullptr; // resolved once, see SolutionAdapter
+        std::vector<uint8_t> args;
+
+        // the arguments of KernelGeometry, see PatchKernelGeometry()
+        size_t tensor2d_size_c       = npos;
+        size_t tensor2d_size_a       = npos;
+        size_t tensor2d_size_b       = npos;
+        size_t sizes[4]              = {npos, npos, npos, npos};
+        size_t strides[4][3]; // set by ConstructPreboundKernel(), npos if not an argument
+        size_t stagger_u_iter        = npos;
+        size_t num_group_tiles_0     = npos;
+        size_t num_group_tiles_1     = npos;
+        size_t num_full_blocks       = npos;
+        size_t wgm_remainder_1       = npos;
+        size_t magic_wgm_remainder_1 = npos;
+
+        size_t d        = npos;
+        size_t c        = npos;
+        size_t a        = npos;
+        size_t b        = npos;
+        size_t metadata = npos;
+        size_t alpha    = npos;
+        size_t beta     = npos;
+        size_t act_0    = npos;
+        size_t act_1    = npos;
+        bool   act_hpa  = false;
+    };
+
+    template <typename T>
+    inline void PatchKernelArgument(uint8_t* args, size_t offset, T value)
+    {
+        if(offset != PreboundKernel::npos)
+            std::memcpy(args + offset, &value, sizeof(T));
+    }
+
+    template <typename Ti, typename To, typename Tc>
+    std::shared_ptr<const PreboundKernel>
+        ConstructPreboundKernel(SolutionAdapter&                                 adapter,
+                                const RocsparseltContractionProblem<Ti, To, Tc>& prob,
+                                const KernelParams&                              kernel,
+                                int                                              config_id)
+    {
+        auto pk        = std::make_shared<PreboundKernel>();
+        pk->config_id  = config_id;
+        pk->zero_alpha = !*prob.alpha;
+        pk->kernel     = ConstructKernelInvoke<Ti, To, Tc>(prob, kernel, false);
+        pk->act_hpa    = kernel.ActivationHPA;
+
+        THROW_IF_HIP_ERROR(adapter.resolveKernel(prob.handle, pk->kernel.kernelName, pk->function));
+
+        // Record where each unbound slot lives, then bind it to a placeholder so that the
+        // template is a complete argument buffer.
+        auto& args = pk->kernel.args;
+        auto  slot = [&args](const char* name, auto placeholder) {
+            size_t offset = args.offsetOf(name);
+            if(offset != PreboundKernel::npos)
+                args.bind(name, placeholder);
+            return offset;
+        };
+        pk->d        = slot("d", static_cast<To const*>(nullptr));
+        pk->c        = slot("c", static_cast<To const*>(nullptr));
+        pk->a        = slot("a", static_cast<Ti const*>(nullptr));
+        pk->b        = slot("b", static_cast<Ti const*>(nullptr));
+        pk->metadata = slot("metadata", static_cast<unsigned char const*>(nullptr));
+        pk->alpha    = slot("alpha", 0.0f);
+        pk->beta     = slot("beta", 0.0f);
+        if(pk->act_hpa)
+        {
+            pk->act_0 = slot("activation_0", 0.0f);
+            pk->act_1 = slot("activation_1", 0.0f);
+        }
+        else
+        {
+            pk->act_0 = slot("activation_0", static_cast<To>(0));
+            pk->act_1 = slot("activation_1", static_cast<To>(0));
+        }
+
+        pk->tensor2d_size_c = args.offsetOf("tensor2dSizeC");
+        pk->tensor2d_size_a = args.offsetOf("tensor2dSizeA");
+        pk->tensor2d_size_b = args.offsetOf("tensor2dSizeB");
+        for(size_t i = 0; i < sizeNames.size(); i++)
+            pk->sizes[i] = args.offsetOf(sizeNames[i]);
+        for(size_t i = 0; i < 3; i++)
+        {
+            pk->strides[0][i] = args.offsetOf(strideDNames[i]);
+            pk->strides[1][i] = args.offsetOf(strideCNames[i]);
+            pk->strides[2][i] = args.offsetOf(strideANames[i]);
+            pk->strides[3][i] = args.offsetOf(strideBNames[i]);
+        }
+        pk->stagger_u_iter        = args.offsetOf("staggerUIter");
+        pk->num_group_tiles_0     = args.offsetOf("problemNumGroupTiles0");
+        pk->num_group_tiles_1     = args.offsetOf("problemNumGroupTiles1");
+        pk->num_full_blocks       = args.offsetOf("numFullBlocks");
+        pk->wgm_remainder_1       = args.offsetOf("wgmRemainder1");
+        pk->magic_wgm_remainder_1 = args.offsetOf("magicNumberWgmRemainder1");
+
+        if(args.size() > PreboundKernel::capacity)
+            throw std::runtime_error("Kernel arguments exceed the pre-bound buffer capacity.");
+
+        auto data = static_cast<uint8_t const*>(args.data());
+        pk->args.assign(data, data + args.size());
+        return pk;
+    }
+
+    // Writes the per-call inputs of prob into a copy of pk.args
+    template <typename Ti, typename To, typename Tc>
+    void PatchKernelArguments(const PreboundKernel&                            pk,
+                              const RocsparseltContractionProblem<Ti, To, Tc>& prob,
+                              uint8_t*                                         args)
+    {
+        PatchKernelArgument<To const*>(args, pk.d, prob.D);
+        PatchKernelArgument<To const*>(args, pk.c, prob.C);
+        PatchKernelArgument<Ti const*>(args, pk.a, prob.A);
+        PatchKernelArgument<Ti const*>(args, pk.b, prob.B);
+        PatchKernelArgument<unsigned char const*>(args, pk.metadata, prob.metadata);
+        PatchKernelArgument<float>(args, pk.alpha, *prob.alpha);
+        PatchKernelArgument<float>(args, pk.beta, *prob.beta);
+        if(pk.act_hpa)
+        {
+            PatchKernelArgument<float>(args, pk.act_0, prob.act_arg0);
+            PatchKernelArgument<float>(args, pk.act_1, prob.act_arg1);
+        }
+        else
+        {
+            PatchKernelArgument<To>(args, pk.act_0, static_cast<To>(prob.act_arg0));
+            PatchKernelArgument<To>(args, pk.act_1, static_cast<To>(prob.act_arg1));
+        }
+    }
+
+    // Writes the arguments of g, which follow the sizes of the call, into a copy of pk.args
+    inline void
+        PatchKernelGeometry(const PreboundKernel& pk, const KernelGeometry& g, uint8_t* args)
+    {
+        PatchKernelArgument<uint64_t>(args, pk.tensor2d_size_c, g.tensor2dSizeC);
+        PatchKernelArgument<uint64_t>(args, pk.tensor2d_size_a, g.tensor2dSizeA);
+        PatchKernelArgument<uint64_t>(args, pk.tensor2d_size_b, g.tensor2dSizeB);
+        for(size_t i = 0; i < sizeNames.size(); i++)
+            PatchKernelArgument<uint32_t>(args, pk.sizes[i], g.sizes[i]);
+        for(size_t t = 0; t < 4; t++)
+            for(size_t i = 0; i < 3; i++)
+                PatchKernelArgument<uint32_t>(args, pk.strides[t][i], g.strides[t][i]);
+        PatchKernelArgument<int32_t>(args, pk.stagger_u_iter, g.staggerUIter);
+        PatchKernelArgument<uint32_t>(args, pk.num_group_tiles_0, g.problemNumGroupTiles0);
+        PatchKernelArgument<uint32_t>(args, pk.num_group_tiles_1, g.problemNumGroupTiles1);
+        PatchKernelArgument<uint32_t>(args, pk.num_full_blocks, g.numFullBlocks);
+        PatchKernelArgument<uint32_t>(args, pk.wgm_remainder_1, g.wgmRemainder1);
+        PatchKernelArgument<uint32_t>(args, pk.magic_wgm_remainder_1, g.magicNumberWgmRemainder1);
+    }
+
+    // Builds and launches the kernel of a config. The named KernelArguments are only built
+    // when the launch is traced, otherwise the arguments go into an inline binary buffer.
+    template <typename Ti, typename To, typename Tc>
+    hipError_t LaunchKernelInvoke(SolutionAdapter&                                 adapter,
+                                  const RocsparseltContractionProblem<Ti, To, Tc>& prob,
+                                  const KernelParams&                              kernel,
+                                  hipEvent_t                                       startEvent,
+                                  hipEvent_t                                       stopEvent,
+                                  int                                              iter = 1)
+    {
+        if(prob.handle->layer_mode & rocsparselt_layer_mode_log_trace)
+        {
+            auto ki = ConstructKernelInvoke<Ti, To, Tc>(prob, kernel);
+            return adapter.launchKernel(
+                prob.handle, ki, prob.streams[0], startEvent, stopEvent, iter);
+        }
+
+        KernelInvocation      ki;
+        KernelArgumentsBinary args;
+        BuildKernelInvoke<Ti, To, Tc>(prob, kernel, ki, args, true);
+        return adapter.launchKernel(prob.handle,
+                                    ki,
+                                    const_cast<void*>(args.data()),
+                                    args.size(),
+                                    prob.streams[0],
+                                    startEvent,
+                                    stopEvent,
+                                    iter);
+    }
+
+} // namespace
+
+/******************************************************************************
+ * _rocsparselt_matmul_exec_cache keeps the adapter and the kernel table of a  *
+ * plan, so that a steady-state rocsparselt_matmul() does not have to rebuild  *
+ * the category string and look the kernels up again.                         *
+ ******************************************************************************/
+struct _rocsparselt_matmul_exec_cache
+{
+    explicit _rocsparselt_matmul_exec_cache(int device)
+        : adapter(&get_adapter(nullptr, device))
+    {
+    }
+
+    std::shared_ptr<const PreboundKernel> load_prebound(int slot) const
+    {
+        return std::atomic_load(&prebound[slot]);
+    }
+
+    void store_prebound(int slot, std::shared_ptr<const PreboundKernel> p)
+    {
+        std::atomic_store(&prebound[slot], std::move(p));
+    }
+
+    SolutionAdapter* adapter;
+    // resolved on the first run, the category only depends on the plan
+    std::once_flag resolved;
+    size_t              kernel_counts = 0;
+    const KernelParams* kernels       = nullptr;
+
+private:
+    // accessed with std::atomic_load/store, a plan may be shared between threads
+    std::shared_ptr<const PreboundKernel> prebound[rocsparselt_exec_cache_slots];
+};
+
+_rocsparselt_matmul_exec_cache*
+    rocsparselt_internal_exec_cache_create(const _rocsparselt_handle* handle)
+{
+    return new _rocsparselt_matmul_exec_cache(handle->device);
+}
+
+void rocsparselt_internal_exec_cache_destroy(_rocsparselt_matmul_exec_cache* cache)
+{
+    delete cache;
+}
+
+namespace
+{
+    // The kernel table of a plan, looked up once, the category only depends on the plan
+    template <typename Ti, typename To, typename Tc>
+    const KernelParams* ResolveKernels(_rocsparselt_matmul_exec_cache*                  exec_cache,
+                                       const RocsparseltContractionProblem<Ti, To, Tc>& prob)
+    {
+        std::call_once(exec_cache->resolved, [&] {
+            auto category       = kernel_category<Ti, To, Tc>(prob.trans_a, prob.trans_b);
+            auto adapter        = exec_cache->adapter;
+            exec_cache->kernels = adapter->getKernelParams(category, &exec_cache->kernel_counts);
+        });
+        return exec_cache->kernels;
+    }
 } // namespace
 
 /******************************************************************************
@@ -625,26 +865,37 @@ namespace
  ******************************************************************************/
 template <typename Ti, typename To, typename Tc>
 rocsparselt_status runContractionProblem(const RocsparseltContractionProblem<Ti, To, Tc>& prob,
+                                         _rocsparselt_matmul_config*                      configs,
                                          int*                                             config_id,
-                                         const int config_max_id,
-                                         const int search_iterations)
+                                         const int                         config_max_id,
+                                         const int                         search_iterations,
+                                         const rocsparselt_search_options* search_options,
+                                         _rocsparselt_matmul_exec_cache*   exec_cache,
+                                         int                               exec_slot)
 {
     rocsparselt_status status  = rocsparselt_status_internal_error;
     size_t             max_cid = 0;
     try
     {
-        std::shared_ptr<hipDeviceProp_t> deviceProp;
+        // A plan always owns a cache, fall back on a temporary one otherwise.
+        std::unique_ptr<_rocsparselt_matmul_exec_cache> local_cache;
+        if(exec_cache == nullptr)
+        {
+            local_cache.reset(new _rocsparselt_matmul_exec_cache(prob.handle->device));
+            exec_cache = local_cache.get();
+        }
 
-        auto&       adapter = get_adapter(&deviceProp, prob.handle->device);
-        std::string str     = generate_kernel_category_str<Ti, To, Tc>(prob.trans_a, prob.trans_b);
-        max_cid             = adapter.getKernelCounts(str);
-        KernelParams* solution = adapter.getKernelParams(str);
+        auto&               adapter  = *exec_cache->adapter;
+        const KernelParams* solution = ResolveKernels<Ti, To, Tc>(exec_cache, prob);
+        max_cid                      = exec_cache->kernel_counts;
 
-        if(config_max_id != max_cid)
+        if(config_max_id > max_cid)
         {
             hipsparselt_cerr << "config_max_id (" << config_max_id << ") is out of range ("
                              << max_cid << ") used this value to instead." << std::endl;
         }
+        // The search only times the candidates of the alg selection.
+        int candidates = config_max_id > 0 ? std::min<int>(max_cid, config_max_id) : max_cid;
 
         if(!max_cid)
         {
@@ -656,44 +907,70 @@ rocsparselt_status runContractionProblem(const RocsparseltContractionProblem<Ti,
         {
             if(!search_iterations)
             {
-                RETURN_IF_HIP_ERROR(adapter.launchKernel(
-                    prob.handle,
-                    ConstructKernelInvoke<Ti, To, Tc>(prob, solution[*config_id]),
-                    prob.streams[0],
-                    nullptr,
-                    nullptr));
-            }
-            else
-            {
-                float      min_ms = std::numeric_limits<float>::max();
-                hipEvent_t startEvent, stopEvent;
-                float      ms;
-                RETURN_IF_HIP_ERROR(hipEventCreate(&startEvent));
-                RETURN_IF_HIP_ERROR(hipEventCreate(&stopEvent));
-                for(int id = 0; id < max_cid; id++)
-                {
-                    auto ki = ConstructKernelInvoke<Ti, To, Tc>(prob, solution[id]);
-                    //warm up
-                    RETURN_IF_HIP_ERROR(
-                        adapter.launchKernel(prob.handle, ki, prob.streams[0], nullptr, nullptr));
+                // The first launch of the process includes binding its arguments
+                rocsparselt_startup_timer first_launch(rocsparselt_startup_first_launch, true);
 
-                    RETURN_IF_HIP_ERROR(adapter.launchKernel(prob.handle,
-                                                             ki,
-                                                             prob.streams[0],
-                                                             startEvent,
-                                                             stopEvent,
-                                                             search_iterations));
-                    RETURN_IF_HIP_ERROR(hipEventSynchronize(stopEvent));
-                    RETURN_IF_HIP_ERROR(hipEventElapsedTime(&ms, startEvent, stopEvent));
-                    if(ms < min_ms)
+                if(prob.handle->layer_mode & rocsparselt_layer_mode_log_trace)
+                {
+                    // Traced launches keep the named arguments, so the log shows real values.
+                    RETURN_IF_HIP_ERROR(LaunchKernelInvoke<Ti, To, Tc>(
+                        adapter, prob, solution[*config_id], nullptr, nullptr));
+                }
+                else
+                {
+                    bool zero_alpha = !*prob.alpha;
+                    auto prebound   = exec_cache->load_prebound(exec_slot);
+                    // M, N and the batch count are patched in, a dynamic-M bucket or a
+                    // stream part keeps the entry of its slot.
+                    if(!prebound || prebound->config_id != *config_id
+                       || prebound->zero_alpha != zero_alpha)
                     {
-                        *config_id = id;
-                        min_ms = ms;
+                        prebound = ConstructPreboundKernel<Ti, To, Tc>(
+                            adapter, prob, solution[*config_id], *config_id);
+                        exec_cache->store_prebound(exec_slot, prebound);
                     }
 
+                    alignas(8) uint8_t args[PreboundKernel::capacity];
+                    size_t             argsSize = prebound->args.size();
+                    std::memcpy(args, prebound->args.data(), argsSize);
+                    PatchKernelArguments<Ti, To, Tc>(*prebound, prob, args);
+
+                    auto geometry
+                        = ComputeKernelGeometry<Ti, To, Tc>(prob, solution[*config_id]);
+                    PatchKernelGeometry(*prebound, geometry, args);
+
+                    RETURN_IF_HIP_ERROR(adapter.launchKernel(prob.handle,
+                                                             prebound->function,
+                                                             geometry.numWorkItems,
+                                                             prebound->kernel.workGroupSize,
+                                                             prebound->kernel.sharedMemBytes,
+                                                             args,
+                                                             argsSize,
+                                                             prob.streams[0],
+                                                             nullptr,
+                                                             nullptr));
                 }
-                RETURN_IF_HIP_ERROR(hipEventDestroy(startEvent));
-                RETURN_IF_HIP_ERROR(hipEventDestroy(stopEvent));
+                if(first_launch.stop())
+                    log_startup_summary("runContractionProblem");
+            }
+            else
+            {
+                auto launch = [&](int id, hipEvent_t start, hipEvent_t stop, int iters) {
+                    return LaunchKernelInvoke<Ti, To, Tc>(
+                        adapter, prob, solution[id], start, stop, iters);
+                };
+
+                std::vector<rocsparselt_matmul_search_result> results;
+                RETURN_IF_ROCSPARSELT_ERROR(
+                    rocsparselt_search_candidates(candidates,
+                                                  search_iterations,
+                                                  search_options ? *search_options
+                                                                 : rocsparselt_search_options(),
+                                                  launch,
+                                                  &results,
+                                                  config_id));
+                for(int id = 0; configs != nullptr && id < candidates; id++)
+                    configs[id].search = results[id];
             }
             status = rocsparselt_status_success;
         }
@@ -716,36 +993,105 @@ rocsparselt_status runContractionProblem(const RocsparseltContractionProblem<Ti,
 
 /******************************************************************************
  * initSolutions used to initialize specific type's solutions at the early stage.               *
+ * It returns a config per kernel, with the way the kernel splits the K loop. *
  * ****************************************************************************/
+/******************************************************************************
+ * validateContractionProblem checks that the selected config runs a part of  *
+ * a problem split across streams. The kernels have no predicates of their    *
+ * own: the workspace of the config must fit the slice of the part, and with  *
+ * whole_tiles the N of the part must be a multiple of the macro tile, so     *
+ * that no tile, nor its global split, straddles two parts.                   *
+ ******************************************************************************/
+template <typename Ti, typename To, typename Tc>
+bool validateContractionProblem(const RocsparseltContractionProblem<Ti, To, Tc>& prob,
+                                const _rocsparselt_matmul_config*                configs,
+                                int                                              config_id,
+                                _rocsparselt_matmul_exec_cache*                  exec_cache,
+                                int /*exec_slot*/,
+                                bool whole_tiles)
+{
+    if(configs[config_id].max_workspace_bytes > prob.workspaceSize)
+        return false;
+
+    try
+    {
+        const KernelParams* kernels = ResolveKernels<Ti, To, Tc>(exec_cache, prob);
+        if(config_id < 0 || size_t(config_id) >= exec_cache->kernel_counts)
+            return false;
+        return !whole_tiles || prob.n % std::max(kernels[config_id].MacroTile[1], 1u) == 0;
+    }
+    catch(...)
+    {
+        return false;
+    }
+}
+
 template <typename Ti, typename To, typename Tc>
-rocsparselt_status initSolutions(const _rocsparselt_handle* handle,
-                                 rocsparselt_operation      opA,
-                                 rocsparselt_operation      opB,
-                                 int*                       kernel_counts)
+rocsparselt_status initSolutions(const _rocsparselt_handle*               handle,
+                                 rocsparselt_operation                    opA,
+                                 rocsparselt_operation                    opB,
+                                 std::vector<_rocsparselt_matmul_config>* configs)
 {
     std::shared_ptr<hipDeviceProp_t> deviceProp;
     auto&                            adapter = get_adapter(&deviceProp, handle->device);
-    std::string                      str     = generate_kernel_category_str<Ti, To, Tc>(opA, opB);
 
-    *kernel_counts = adapter.getKernelCounts(str);
-    if(*kernel_counts <= 0)
+    rocsparselt_startup_timer first_query(rocsparselt_startup_first_solution_query, true);
+    size_t                    kernel_counts;
+    const KernelParams*       solution
+        = adapter.getKernelParams(kernel_category<Ti, To, Tc>(opA, opB), &kernel_counts);
+    first_query.stop();
+    if(kernel_counts == 0)
         return rocsparselt_status_not_implemented;
 
-    KernelParams* solution = adapter.getKernelParams(str);
-    for(int i = 0; i < *kernel_counts; i++)
+    configs->resize(kernel_counts);
+    for(size_t i = 0; i < kernel_counts; i++)
+    {
         PRINT_IF_HIP_ERROR(handle, adapter.loadCodeObject(handle, solution[i].SolutionNameMin));
+
+        // Same as Tensile's global accumulation, 2 gives each split a buffer of its own.
+        int   gsu                  = std::max<int>(solution[i].GlobalSplitU, 1);
+        auto& config               = (*configs)[i];
+        config.index               = i;
+        config.max_workspace_bytes = 0;
+        config.split_k             = gsu;
+        config.split_k_mode        = solution[i].GlobalAccumulation
+                                         ? rocsparselt_split_k_mode_two_kernels
+                                         : rocsparselt_splik_k_mode_one_kernel;
+        config.atomics             = gsu > 1 && solution[i].GlobalAccumulation != 2;
+    }
     return rocsparselt_status_success;
 }
 
 /***************************************************************
- * ! \brief  Initialize rocsparselt for the current HIP device, to *
- * avoid costly startup time at the first call on that device. *
+ * ! \brief  Initialize rocsparselt for all the visible devices, *
+ * to avoid costly startup time at the first call on a device.  *
  ***************************************************************/
 extern "C" void rocsparselt_initialize()
 {
-    get_adapter();
+    // The devices are initialized at once, each on a thread of its own
+    auto start = std::chrono::steady_clock::now();
+    int  count = KernelLauncher::GetDeviceCount();
+    rocsparselt_parallel_for(count, count, [](size_t device) {
+        int current;
+        if(hipGetDevice(&current) != hipSuccess || hipSetDevice(device) != hipSuccess)
+            return;
+        get_adapter(nullptr, device);
+        (void)hipSetDevice(current);
+    });
+    log_process(rocsparselt_layer_mode_log_info,
+                "rocsparselt_initialize",
+                "devices",
+                count,
+                "ms",
+                KernelLauncher::ElapsedMs(start));
 }
 
+/*****************************************************************************
+ * ! \brief  The kernels of the HIP backend are already loaded per solution *
+ * when an algorithm is selected, there is nothing to defer.                *
+ *****************************************************************************/
+extern "C" void rocsparselt_set_lazy_loading(int enable) {}
+
 /*******************************************************************************************
  * Whether Kernel Launcher has been initialized for at least one device (used for testing) *
  *******************************************************************************************/
@@ -759,23 +1105,39 @@ std::atomic_bool& rocsparselt_internal_kl_is_initialized()
  * Intantiate the cases of runContractionProblem / initSolutions which are    *
  * needed to satisfy rocsparselt dependencies.                                *
  ******************************************************************************/
-#define GENERATE_DEFINITIONS(Ti, To, Tc, Ca)                                           \
+#define GENERATE_DEFINITIONS(Ti, To, Tc, DataType, DestDataType, ComputeDataType)      \
     template <>                                                                        \
-    std::string generate_kernel_category_str<Ti, To, Tc>(rocsparselt_operation opA,    \
-                                                         rocsparselt_operation opB)    \
+    uint32_t kernel_category<Ti, To, Tc>(rocsparselt_operation opA,                    \
+                                         rocsparselt_operation opB)                    \
     {                                                                                  \
-        std::string str = Ca;                                                          \
-        str += "_";                                                                    \
-        str += (opA == rocsparselt_operation_none ? "N" : "T");                        \
-        str += "_";                                                                    \
-        str += (opB == rocsparselt_operation_none ? "N" : "T");                        \
-        return str;                                                                    \
+        return kernel_category_key(DataType,                                           \
+                                   DestDataType,                                       \
+                                   ComputeDataType,                                    \
+                                   opA != rocsparselt_operation_none,                  \
+                                   opB != rocsparselt_operation_none);                 \
     }                                                                                  \
     template rocsparselt_status runContractionProblem<Ti, To, Tc>(                     \
-        const RocsparseltContractionProblem<Ti, To, Tc>&, int*, const int, const int); \
+        const RocsparseltContractionProblem<Ti, To, Tc>&,                              \
+        _rocsparselt_matmul_config*,                                                   \
+        int*,                                                                          \
+        const int,                                                                     \
+        const int,                                                                     \
+        const rocsparselt_search_options*,                                             \
+        _rocsparselt_matmul_exec_cache*,                                               \
+        int);                                                                          \
+    template bool validateContractionProblem<Ti, To, Tc>(                              \
+        const RocsparseltContractionProblem<Ti, To, Tc>&,                              \
+        const _rocsparselt_matmul_config*,                                             \
+        int,                                                                           \
+        _rocsparselt_matmul_exec_cache*,                                               \
+        int,                                                                           \
+        bool);                                                                         \
     template rocsparselt_status initSolutions<Ti, To, Tc>(                             \
-        const _rocsparselt_handle*, rocsparselt_operation, rocsparselt_operation, int*);
-
-GENERATE_DEFINITIONS(__half, __half, float, "4_4_0")
-GENERATE_DEFINITIONS(hip_bfloat16, hip_bfloat16, float, "7_7_0")
-GENERATE_DEFINITIONS(int8_t, int8_t, float, "8_8_0")
+        const _rocsparselt_handle*,                                                    \
+        rocsparselt_operation,                                                         \
+        rocsparselt_operation,                                                         \
+        std::vector<_rocsparselt_matmul_config>*);
+
+GENERATE_DEFINITIONS(__half, __half, float, 4, 4, 0)
+GENERATE_DEFINITIONS(hip_bfloat16, hip_bfloat16, float, 7, 7, 0)
+GENERATE_DEFINITIONS(int8_t, int8_t, float, 8, 8, 0)
@@ -31,6 +31,10 @@
 #include "utility.hpp"
 
 #include <hip/hip_runtime_api.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <vector>
 
 #ifdef __cplusplus
 extern "C" {
@@ -77,45 +81,27 @@ rocsparselt_status rocsparselt_matmul_get_workspace(const rocsparselt_handle*
     }
 
     {
-        if(_plan->alg_selection->config_max_id == 0)
-            *workspaceSize = 0;
-        else
-        {
-            *workspaceSize = _plan->alg_selection->configs[_plan->alg_selection->config_id]
-                                 .max_workspace_bytes;
-        }
+        // a dynamic-M plan may run any of its buckets
+        *workspaceSize = _plan->alg_selection->matmul_workspace_bytes();
+        for(int i = 0; i < _plan->bucket_count; i++)
+            *workspaceSize = std::max(*workspaceSize,
+                                      _plan->buckets[i]->alg_selection->matmul_workspace_bytes());
         log_api(_handle, __func__, *workspaceSize);
         return rocsparselt_status_success;
     }
 }
 
-rocsparselt_status rocsparselt_matmul_impl(const char*                    caller,
-                                           const rocsparselt_handle*      handle,
-                                           const rocsparselt_matmul_plan* plan,
-                                           const void*                    alpha,
-                                           const void*                    d_A,
-                                           const void*                    d_B,
-                                           const void*                    beta,
-                                           const void*                    d_C,
-                                           void*                          d_D,
-                                           void*                          workspace,
-                                           hipStream_t*                   streams,
-                                           int32_t                        numStreams,
-                                           bool                           search = false)
+static rocsparselt_status rocsparselt_matmul_check(const char*                    caller,
+                                                   const _rocsparselt_handle*     _handle,
+                                                   const rocsparselt_matmul_plan* plan,
+                                                   const void*                    alpha,
+                                                   const void*                    d_A,
+                                                   const void*                    d_B,
+                                                   const void*                    beta,
+                                                   const void*                    d_C,
+                                                   void*                          d_D,
+                                                   void*                          workspace)
 {
-    // Check if handle is valid
-    if(handle == nullptr)
-    {
-        hipsparselt_cerr << "handle is a NULL pointer" << std::endl;
-        return rocsparselt_status_invalid_handle;
-    }
-    auto _handle = reinterpret_cast<const _rocsparselt_handle*>(handle);
-    if(!_handle->isInit())
-    {
-        hipsparselt_cerr << "handle did not initialized or already destroyed" << std::endl;
-        return rocsparselt_status_invalid_handle;
-    }
-
     if(plan == nullptr)
     {
         log_error(_handle, caller, "plan is a NULL pointer");
@@ -165,11 +151,16 @@ rocsparselt_status rocsparselt_matmul_impl(const char*                    caller
         return rocsparselt_status_invalid_pointer;
     }
 
-    size_t workspaceSize
-        = _plan->alg_selection->config_max_id == 0
-              ? 0
-              : _plan->alg_selection->configs[_plan->alg_selection->config_id].max_workspace_bytes;
-    if(workspace == nullptr && workspaceSize != 0)
+    if(_handle->pointer_mode != _plan->matmul_descr->pointer_mode)
+    {
+        log_error(_handle,
+                  caller,
+                  "the pointer mode of the handle differs from the one of the plan's descriptor");
+        return rocsparselt_status_invalid_value;
+    }
+
+    size_t workspaceSize = _plan->alg_selection->selected_workspace_bytes();
+    if(workspace == nullptr && workspaceSize != 0 && _handle->workspace_pool == nullptr)
     {
         hipsparselt_cerr << "The parameter number 9 (workspace) had an illegal value "
                             "expected a device memroy with "
@@ -177,7 +168,14 @@ rocsparselt_status rocsparselt_matmul_impl(const char*                    caller
         log_error(_handle, caller, "expected workspace is not a NULL pointer");
         return rocsparselt_status_invalid_value;
     }
+    return rocsparselt_status_success;
+}
 
+static rocsparselt_status rocsparselt_matmul_check_streams(const char*                caller,
+                                                           const _rocsparselt_handle* _handle,
+                                                           hipStream_t*               streams,
+                                                           int32_t                    numStreams)
+{
     if(numStreams < 0)
     {
         hipsparselt_cerr << "The parameter number 11 (numStreams) had an illegal value: "
@@ -194,6 +192,33 @@ rocsparselt_status rocsparselt_matmul_impl(const char*                    caller
                   "streams should not be a NULL pointer because the numStreams is not 0");
         return rocsparselt_status_invalid_value;
     }
+    return rocsparselt_status_success;
+}
+
+// Runs a matmul whose arguments passed rocsparselt_matmul_check() and
+// rocsparselt_matmul_check_streams(). An m other than 0 replaces the M of the plan, which
+// must be a bucket of a dynamic-M plan.
+static rocsparselt_status rocsparselt_matmul_run(const char*                     caller,
+                                                 const _rocsparselt_handle*      _handle,
+                                                 const _rocsparselt_matmul_plan* _plan,
+                                                 const void*                     alpha,
+                                                 const void*                     d_A,
+                                                 const void*                     d_B,
+                                                 const void*                     beta,
+                                                 const void*                     d_C,
+                                                 void*                           d_D,
+                                                 void*                           workspace,
+                                                 hipStream_t*                    streams,
+                                                 int32_t                         numStreams,
+                                                 bool                            search,
+                                                 int64_t                         m = 0)
+{
+    // The search needs room for every config, spmm_typecasting() allocates it if the workspace
+    // of the caller is only sized for the selected one. rocsparselt_matmul_check() let a NULL
+    // workspace through only with a pool, or if the selected config needs none,
+    // spmm_typecasting() takes the pool slices of the streams the matmul runs on.
+    size_t workspaceSize = search ? _plan->alg_selection->workspace_bytes()
+                                  : _plan->alg_selection->selected_workspace_bytes();
 
     // algorithm selection
     int config_id         = _plan->alg_selection->config_id;
@@ -202,7 +227,7 @@ rocsparselt_status rocsparselt_matmul_impl(const char*                    caller
 
 #define EX_PARM                                                                              \
     caller, _handle, _plan, alpha, beta, d_A, d_B, d_C, d_D, workspace, streams, numStreams, \
-        &config_id, config_max_id, search_iterations
+        &config_id, config_max_id, search_iterations, m
 
     log_api(_handle,
             caller,
@@ -234,8 +259,77 @@ rocsparselt_status rocsparselt_matmul_impl(const char*                    caller
     {
         log_info(_handle, caller, "found the best config_id", config_id);
         _plan->alg_selection->config_id = config_id;
+
+        // Remember the winner for the processes which select an algorithm later.
+        if(auto db = rocsparselt_internal_tuning_db())
+        {
+            const auto&              config = _plan->alg_selection->configs[config_id];
+            rocsparselt_tuning_entry entry;
+            RETURN_IF_ROCSPARSELT_ERROR(
+                rocsparselt_internal_tuning_key(_handle, _plan->matmul_descr, &entry.key));
+            entry.solution_index = config.index;
+            entry.split_k        = config.split_k;
+            entry.split_k_mode   = config.split_k_mode;
+            entry.atomics        = config.atomics;
+            entry.reserved       = 0;
+            entry.ms             = config.search.ms;
+            if(!db->update(&entry, 1))
+                log_error(_handle,
+                          caller,
+                          "failed to update the tuning database",
+                          db->path(),
+                          strerror(errno));
+        }
     }
     return status;
+#undef EX_PARM
+}
+
+rocsparselt_status rocsparselt_matmul_impl(const char*                    caller,
+                                           const rocsparselt_handle*      handle,
+                                           const rocsparselt_matmul_plan* plan,
+                                           const void*                    alpha,
+                                           const void*                    d_A,
+                                           const void*                    d_B,
+                                           const void*                    beta,
+                                           const void*                    d_C,
+                                           void*                          d_D,
+                                           void*                          workspace,
+                                           hipStream_t*                   streams,
+                                           int32_t                        numStreams,
+                                           bool                           search = false)
+{
+    // Check if handle is valid
+    if(handle == nullptr)
+    {
+        hipsparselt_cerr << "handle is a NULL pointer" << std::endl;
+        return rocsparselt_status_invalid_handle;
+    }
+    auto _handle = reinterpret_cast<const _rocsparselt_handle*>(handle);
+    if(!_handle->isInit())
+    {
+        hipsparselt_cerr << "handle did not initialized or already destroyed" << std::endl;
+        return rocsparselt_status_invalid_handle;
+    }
+
+    RETURN_IF_ROCSPARSELT_ERROR(rocsparselt_matmul_check(
+        caller, _handle, plan, alpha, d_A, d_B, beta, d_C, d_D, workspace));
+    RETURN_IF_ROCSPARSELT_ERROR(
+        rocsparselt_matmul_check_streams(caller, _handle, streams, numStreams));
+
+    return rocsparselt_matmul_run(caller,
+                                  _handle,
+                                  reinterpret_cast<const _rocsparselt_matmul_plan*>(plan),
+                                  alpha,
+                                  d_A,
+                                  d_B,
+                                  beta,
+                                  d_C,
+                                  d_D,
+                                  workspace,
+                                  streams,
+                                  numStreams,
+                                  search);
 }
 
 /********************************************************************************
@@ -288,32 +382,646 @@ rocsparselt_status rocsparselt_matmul_search(const rocsparselt_handle* handle,
                                    numStreams,
                                    true);
 }
+
+static rocsparselt_status
+    rocsparselt_matmul_dynamic_m_impl(const char*                    caller,
+                                      const rocsparselt_handle*      handle,
+                                      const rocsparselt_matmul_plan* plan,
+                                      int64_t                        m,
+                                      const void*                    alpha,
+                                      const void*                    d_A,
+                                      const void*                    d_B,
+                                      const void*                    beta,
+                                      const void*                    d_C,
+                                      void*                          d_D,
+                                      void*                          workspace,
+                                      hipStream_t*                   streams,
+                                      int32_t                        numStreams,
+                                      bool                           search)
+{
+    // Check if handle is valid
+    if(handle == nullptr)
+    {
+        hipsparselt_cerr << "handle is a NULL pointer" << std::endl;
+        return rocsparselt_status_invalid_handle;
+    }
+    auto _handle = reinterpret_cast<const _rocsparselt_handle*>(handle);
+    if(!_handle->isInit())
+    {
+        hipsparselt_cerr << "handle did not initialized or already destroyed" << std::endl;
+        return rocsparselt_status_invalid_handle;
+    }
+
+    RETURN_IF_ROCSPARSELT_ERROR(rocsparselt_matmul_check(
+        caller, _handle, plan, alpha, d_A, d_B, beta, d_C, d_D, workspace));
+    RETURN_IF_ROCSPARSELT_ERROR(
+        rocsparselt_matmul_check_streams(caller, _handle, streams, numStreams));
+
+    auto _plan = reinterpret_cast<const _rocsparselt_matmul_plan*>(plan);
+    if(_plan->min_m == 0)
+    {
+        log_error(_handle, caller, "plan was not initialized with a dynamic M");
+        return rocsparselt_status_invalid_value;
+    }
+    if(m < _plan->min_m || m > _plan->matmul_descr->m)
+    {
+        log_error(_handle,
+                  caller,
+                  "m must be in [minM, M] of the plan but is",
+                  m,
+                  "minM",
+                  _plan->min_m,
+                  "M",
+                  _plan->matmul_descr->m);
+        return rocsparselt_status_invalid_size;
+    }
+
+    // The smallest bucket that holds m, the plan itself holds them all.
+    const _rocsparselt_matmul_plan* bucket = _plan;
+    for(int i = 0; i < _plan->bucket_count; i++)
+    {
+        if(m <= _plan->buckets[i]->matmul_descr->m)
+        {
+            bucket = _plan->buckets[i];
+            break;
+        }
+    }
+    if(bucket != _plan)
+        RETURN_IF_ROCSPARSELT_ERROR(
+            rocsparselt_matmul_check(caller,
+                                     _handle,
+                                     reinterpret_cast<const rocsparselt_matmul_plan*>(bucket),
+                                     alpha,
+                                     d_A,
+                                     d_B,
+                                     beta,
+                                     d_C,
+                                     d_D,
+                                     workspace));
+
+    return rocsparselt_matmul_run(caller,
+                                  _handle,
+                                  bucket,
+                                  alpha,
+                                  d_A,
+                                  d_B,
+                                  beta,
+                                  d_C,
+                                  d_D,
+                                  workspace,
+                                  streams,
+                                  numStreams,
+                                  search,
+                                  m);
+}
+
+/********************************************************************************
+ * \brief
+ *******************************************************************************/
+rocsparselt_status rocsparselt_matmul_dynamic_m(const rocsparselt_handle*      handle,
+                                                const rocsparselt_matmul_plan* plan,
+                                                int64_t                        m,
+                                                const void*                    alpha,
+                                                const void*                    d_A,
+                                                const void*                    d_B,
+                                                const void*                    beta,
+                                                const void*                    d_C,
+                                                void*                          d_D,
+                                                void*                          workspace,
+                                                hipStream_t*                   streams,
+                                                int32_t                        numStreams)
+{
+    return rocsparselt_matmul_dynamic_m_impl(__func__,
+                                             handle,
+                                             plan,
+                                             m,
+                                             alpha,
+                                             d_A,
+                                             d_B,
+                                             beta,
+                                             d_C,
+                                             d_D,
+                                             workspace,
+                                             streams,
+                                             numStreams,
+                                             false);
+}
+
+/********************************************************************************
+ * \brief
+ *******************************************************************************/
+rocsparselt_status rocsparselt_matmul_search_dynamic_m(const rocsparselt_handle* handle,
+                                                       rocsparselt_matmul_plan*  plan,
+                                                       int64_t                   m,
+                                                       const void*               alpha,
+                                                       const void*               d_A,
+                                                       const void*               d_B,
+                                                       const void*               beta,
+                                                       const void*               d_C,
+                                                       void*                     d_D,
+                                                       void*                     workspace,
+                                                       hipStream_t*              streams,
+                                                       int32_t                   numStreams)
+{
+    return rocsparselt_matmul_dynamic_m_impl(__func__,
+                                             handle,
+                                             plan,
+                                             m,
+                                             alpha,
+                                             d_A,
+                                             d_B,
+                                             beta,
+                                             d_C,
+                                             d_D,
+                                             workspace,
+                                             streams,
+                                             numStreams,
+                                             true);
+}
+
+/********************************************************************************
+ * \brief
+ *******************************************************************************/
+rocsparselt_status rocsparselt_matmul_grouped(const rocsparselt_handle*             handle,
+                                              const rocsparselt_matmul_plan* const* plans,
+                                              const void* const*                    alpha,
+                                              const void* const*                    d_A,
+                                              const void* const*                    d_B,
+                                              const void* const*                    beta,
+                                              const void* const*                    d_C,
+                                              void* const*                          d_D,
+                                              void* const*                          workspace,
+                                              int32_t                               groupCount,
+                                              hipStream_t*                          streams,
+                                              int32_t                               numStreams)
+{
+    // Check if handle is valid
+    if(handle == nullptr)
+    {
+        hipsparselt_cerr << "handle is a NULL pointer" << std::endl;
+        return rocsparselt_status_invalid_handle;
+    }
+    auto _handle = reinterpret_cast<const _rocsparselt_handle*>(handle);
+    if(!_handle->isInit())
+    {
+        hipsparselt_cerr << "handle did not initialized or already destroyed" << std::endl;
+        return rocsparselt_status_invalid_handle;
+    }
+
+    if(groupCount < 0)
+    {
+        log_error(_handle, __func__, "groupCount should >= 0");
+        return rocsparselt_status_invalid_value;
+    }
+
+    RETURN_IF_ROCSPARSELT_ERROR(
+        rocsparselt_matmul_check_streams(__func__, _handle, streams, numStreams));
+
+    if(groupCount == 0)
+        return rocsparselt_status_success;
+
+    if(plans == nullptr || alpha == nullptr || d_A == nullptr || d_B == nullptr
+       || beta == nullptr || d_C == nullptr || d_D == nullptr)
+    {
+        log_error(_handle, __func__, "plans, alpha, d_A, d_B, beta, d_C and d_D must not be NULL");
+        return rocsparselt_status_invalid_pointer;
+    }
+
+    // Check every group before anything is queued, so a bad group does not leave
+    // the groups in front of it running.
+    for(int32_t g = 0; g < groupCount; g++)
+    {
+        rocsparselt_status status = rocsparselt_matmul_check(__func__,
+                                                             _handle,
+                                                             plans[g],
+                                                             alpha[g],
+                                                             d_A[g],
+                                                             d_B[g],
+                                                             beta[g],
+                                                             d_C[g],
+                                                             d_D[g],
+                                                             workspace ? workspace[g] : nullptr);
+        if(status != rocsparselt_status_success)
+        {
+            log_error(_handle, __func__, "group", g, "is invalid");
+            return status;
+        }
+    }
+
+    // None of the solutions of the kernel libraries is a grouped GEMM, so every
+    // group is launched on its own. The groups are dealt round-robin to the
+    // streams, which are forked off and joined back into streams[0].
+    int32_t     parts  = std::min(numStreams, groupCount);
+    hipEvent_t* events = nullptr;
+    if(parts > 1)
+    {
+        RETURN_IF_ROCSPARSELT_ERROR(
+            rocsparselt_internal_stream_events(_handle->device, parts, &events));
+        RETURN_IF_HIP_ERROR(hipEventRecord(events[0], streams[0]));
+        for(int32_t i = 1; i < parts; i++)
+            RETURN_IF_HIP_ERROR(hipStreamWaitEvent(streams[i], events[0], 0));
+    }
+
+    // streams[0] is joined even if a group fails, the groups before it are queued.
+    rocsparselt_status status = rocsparselt_status_success;
+    for(int32_t g = 0; g < groupCount && status == rocsparselt_status_success; g++)
+    {
+        status = rocsparselt_matmul_run(__func__,
+                                        _handle,
+                                        reinterpret_cast<const _rocsparselt_matmul_plan*>(plans[g]),
+                                        alpha[g],
+                                        d_A[g],
+                                        d_B[g],
+                                        beta[g],
+                                        d_C[g],
+                                        d_D[g],
+                                        workspace ? workspace[g] : nullptr,
+                                        numStreams > 0 ? streams + g % numStreams : nullptr,
+                                        numStreams > 0 ? 1 : 0,
+                                        false);
+    }
+
+    for(int32_t i = 1; i < parts; i++)
+    {
+        RETURN_IF_HIP_ERROR(hipEventRecord(events[i], streams[i]));
+        RETURN_IF_HIP_ERROR(hipStreamWaitEvent(streams[0], events[i], 0));
+    }
+    return status;
+}
+
+// Returns the nodes of a graph recorded from a single stream, in launch order. They must all
+// be kernels.
+static rocsparselt_status rocsparselt_recorded_kernels(const char*                  caller,
+                                                       const _rocsparselt_handle*   _handle,
+                                                       hipGraph_t                   graph,
+                                                       std::vector<hipGraphNode_t>* nodes)
+{
+    size_t         count = 0;
+    hipGraphNode_t node  = nullptr;
+    RETURN_IF_HIP_ERROR(hipGraphGetRootNodes(graph, nullptr, &count));
+    if(count > 1)
+        return rocsparselt_status_internal_error;
+    if(count == 1)
+        RETURN_IF_HIP_ERROR(hipGraphGetRootNodes(graph, &node, &count));
+
+    nodes->clear();
+    while(node != nullptr)
+    {
+        hipGraphNodeType type;
+        RETURN_IF_HIP_ERROR(hipGraphNodeGetType(node, &type));
+        if(type != hipGraphNodeTypeKernel)
+        {
+            log_error(_handle, caller, "the matmul recorded a node which is not a kernel", type);
+            return rocsparselt_status_not_implemented;
+        }
+        nodes->push_back(node);
+
+        RETURN_IF_HIP_ERROR(hipGraphNodeGetDependentNodes(node, nullptr, &count));
+        if(count > 1)
+            return rocsparselt_status_internal_error;
+        node = nullptr;
+        if(count == 1)
+            RETURN_IF_HIP_ERROR(hipGraphNodeGetDependentNodes(nodes->back(), &node, &count));
+    }
+    return rocsparselt_status_success;
+}
+
+// Checks the arguments of a captured matmul.
+static rocsparselt_status rocsparselt_matmul_capture_check(const char*                    caller,
+                                                           const _rocsparselt_handle*     _handle,
+                                                           const rocsparselt_matmul_plan* plan,
+                                                           const void*                    alpha,
+                                                           const void*                    d_A,
+                                                           const void*                    d_B,
+                                                           const void*                    beta,
+                                                           const void*                    d_C,
+                                                           void*                          d_D,
+                                                           void*                          workspace)
+{
+    RETURN_IF_ROCSPARSELT_ERROR(rocsparselt_matmul_check(
+        caller, _handle, plan, alpha, d_A, d_B, beta, d_C, d_D, workspace));
+
+    // The slices of the workspace pool belong to streams, a graph may be launched on any.
+    auto   _plan = reinterpret_cast<const _rocsparselt_matmul_plan*>(plan);
+    size_t workspaceSize = _plan->alg_selection->selected_workspace_bytes();
+    if(workspace == nullptr && workspaceSize != 0)
+    {
+        log_error(_handle, caller, "a captured matmul needs a workspace of", workspaceSize);
+        return rocsparselt_status_invalid_value;
+    }
+    return rocsparselt_status_success;
+}
+
+// Records the kernels of a matmul into a graph of their own. They are launched on the capture
+// stream of the plan in capture mode, so nothing runs on the device. The arguments are checked by
+// the caller with rocsparselt_matmul_capture_check().
+static rocsparselt_status rocsparselt_matmul_record(const char*                    caller,
+                                                    const _rocsparselt_handle*     _handle,
+                                                    const rocsparselt_matmul_plan* plan,
+                                                    const void*                    alpha,
+                                                    const void*                    d_A,
+                                                    const void*                    d_B,
+                                                    const void*                    beta,
+                                                    const void*                    d_C,
+                                                    void*                          d_D,
+                                                    void*                          workspace,
+                                                    std::vector<hipGraphNode_t>*   nodes,
+                                                    hipGraph_t*                    recorded)
+{
+    auto        _plan  = reinterpret_cast<const _rocsparselt_matmul_plan*>(plan);
+    hipStream_t stream = _plan->capture->stream;
+
+    std::lock_guard<std::mutex> lock(_plan->capture->mutex);
+
+    // The alpha vector of the device pointer mode is allocated on the first use of a stream,
+    // which must not happen while it captures. The workspace is the caller's, the pool is not
+    // used.
+    if(_plan->device_alpha != nullptr)
+    {
+        void* alpha_vector = nullptr;
+        RETURN_IF_ROCSPARSELT_ERROR(_plan->device_alpha->acquire(stream, 0, &alpha_vector));
+    }
+
+    RETURN_IF_HIP_ERROR(hipStreamBeginCapture(stream, hipStreamCaptureModeThreadLocal));
+    auto status = rocsparselt_matmul_run(
+        caller, _handle, _plan, alpha, d_A, d_B, beta, d_C, d_D, workspace, &stream, 1, false);
+
+    // The capture is ended even if the run failed, the stream is reused.
+    hipGraph_t graph = nullptr;
+    hipError_t err   = hipStreamEndCapture(stream, &graph);
+    if(status == rocsparselt_status_success && err != hipSuccess)
+        status = get_rocsparselt_status_for_hip_status(err);
+
+    if(status == rocsparselt_status_success)
+        status = rocsparselt_recorded_kernels(caller, _handle, graph, nodes);
+
+    if(status != rocsparselt_status_success)
+    {
+        if(graph != nullptr)
+            (void)hipGraphDestroy(graph);
+        return status;
+    }
+    *recorded = graph;
+    return rocsparselt_status_success;
+}
+
+/********************************************************************************
+ * \brief
+ *******************************************************************************/
+rocsparselt_status rocsparselt_matmul_capture(const rocsparselt_handle*      handle,
+                                              const rocsparselt_matmul_plan* plan,
+                                              const void*                    alpha,
+                                              const void*                    d_A,
+                                              const void*                    d_B,
+                                              const void*                    beta,
+                                              const void*                    d_C,
+                                              void*                          d_D,
+                                              void*                          workspace,
+                                              hipGraph_t                     graph,
+                                              const hipGraphNode_t*          dependencies,
+                                              size_t                         numDependencies,
+                                              hipGraphNode_t*                nodes,
+                                              int32_t*                       numNodes)
+{
+    // Check if handle is valid
+    if(handle == nullptr)
+    {
+        hipsparselt_cerr << "handle is a NULL pointer" << std::endl;
+        return rocsparselt_status_invalid_handle;
+    }
+    auto _handle = reinterpret_cast<const _rocsparselt_handle*>(handle);
+    if(!_handle->isInit())
+    {
+        hipsparselt_cerr << "handle did not initialized or already destroyed" << std::endl;
+        return rocsparselt_status_invalid_handle;
+    }
+
+    if(graph == nullptr || numNodes == nullptr || (nodes == nullptr && *numNodes > 0)
+       || (dependencies == nullptr && numDependencies > 0))
+    {
+        log_error(_handle, __func__, "graph, numNodes, nodes or dependencies is a NULL pointer");
+        return rocsparselt_status_invalid_pointer;
+    }
+    if(*numNodes < 0)
+    {
+        log_error(_handle, __func__, "numNodes is negative", *numNodes);
+        return rocsparselt_status_invalid_value;
+    }
+
+    RETURN_IF_ROCSPARSELT_ERROR(rocsparselt_matmul_capture_check(
+        __func__, _handle, plan, alpha, d_A, d_B, beta, d_C, d_D, workspace));
+
+    std::vector<hipGraphNode_t> recorded_nodes;
+    hipGraph_t                  recorded;
+    RETURN_IF_ROCSPARSELT_ERROR(rocsparselt_matmul_record(__func__,
+                                                          _handle,
+                                                          plan,
+                                                          alpha,
+                                                          d_A,
+                                                          d_B,
+                                                          beta,
+                                                          d_C,
+                                                          d_D,
+                                                          workspace,
+                                                          &recorded_nodes,
+                                                          &recorded));
+
+    rocsparselt_status status = rocsparselt_status_success;
+    if(recorded_nodes.size() > size_t(*numNodes))
+    {
+        log_error(_handle, __func__, "nodes needs room for", recorded_nodes.size(), "nodes");
+        status = rocsparselt_status_invalid_size;
+    }
+
+    // The parameters, including the kernel arguments, are copied into the new nodes, which
+    // keeps them valid after the recorded graph is gone.
+    int32_t count = 0;
+    for(size_t i = 0; i < recorded_nodes.size() && status == rocsparselt_status_success; i++)
+    {
+        // the first kernel waits for the dependencies, the others for the kernel before them
+        const hipGraphNode_t* deps    = i == 0 ? dependencies : nodes + i - 1;
+        size_t                numDeps = i == 0 ? numDependencies : 1;
+
+        hipKernelNodeParams params;
+        hipError_t          err = hipGraphKernelNodeGetParams(recorded_nodes[i], &params);
+        if(err == hipSuccess)
+            err = hipGraphAddKernelNode(nodes + i, graph, deps, numDeps, &params);
+        if(err != hipSuccess)
+            status = get_rocsparselt_status_for_hip_status(err);
+        else
+            count++;
+    }
+    *numNodes = status == rocsparselt_status_invalid_size ? recorded_nodes.size() : count;
+
+    (void)hipGraphDestroy(recorded);
+    return status;
+}
+
+/********************************************************************************
+ * \brief
+ *******************************************************************************/
+rocsparselt_status rocsparselt_matmul_capture_update(const rocsparselt_handle*      handle,
+                                                     const rocsparselt_matmul_plan* plan,
+                                                     const void*                    alpha,
+                                                     const void*                    d_A,
+                                                     const void*                    d_B,
+                                                     const void*                    beta,
+                                                     const void*                    d_C,
+                                                     void*                          d_D,
+                                                     void*                          workspace,
+                                                     hipGraphExec_t                 graphExec,
+                                                     const hipGraphNode_t*          nodes,
+                                                     int32_t                        numNodes)
+{
+    // Check if handle is valid
+    if(handle == nullptr)
+    {
+        hipsparselt_cerr << "handle is a NULL pointer" << std::endl;
+        return rocsparselt_status_invalid_handle;
+    }
+    auto _handle = reinterpret_cast<const _rocsparselt_handle*>(handle);
+    if(!_handle->isInit())
+    {
+        hipsparselt_cerr << "handle did not initialized or already destroyed" << std::endl;
+        return rocsparselt_status_invalid_handle;
+    }
+
+    if(graphExec == nullptr || (nodes == nullptr && numNodes > 0))
+    {
+        log_error(_handle, __func__, "graphExec or nodes is a NULL pointer");
+        return rocsparselt_status_invalid_pointer;
+    }
+    if(numNodes < 0)
+    {
+        log_error(_handle, __func__, "numNodes is negative", numNodes);
+        return rocsparselt_status_invalid_value;
+    }
+
+    RETURN_IF_ROCSPARSELT_ERROR(rocsparselt_matmul_capture_check(
+        __func__, _handle, plan, alpha, d_A, d_B, beta, d_C, d_D, workspace));
+    auto _plan = reinterpret_cast<const _rocsparselt_matmul_plan*>(plan);
+
+    // The kernels only change with the plan or its config, new pointers and scalars only
+    // change their arguments. The backends patch them into the arguments they keep for the
+    // plan and hand them to a sink instead of launching them. The kernels of the device
+    // pointer mode which prepare alpha and beta are not launched by the backends, such a
+    // matmul is recorded again.
+    std::vector<std::vector<uint8_t>> kernel_args;
+    std::vector<hipGraphNode_t>       recorded_nodes;
+    hipGraph_t                        recorded = nullptr;
+    if(_plan->matmul_descr->pointer_mode != rocsparselt_pointer_mode_device)
+    {
+        // nothing is queued on the stream, the matmul only needs one
+        hipStream_t stream = _plan->capture->stream;
+
+        _rocsparselt_launch_sink sink;
+        rocsparselt_internal_launch_sink() = &sink;
+
+        auto status = rocsparselt_matmul_run(__func__,
+                                             _handle,
+                                             _plan,
+                                             alpha,
+                                             d_A,
+                                             d_B,
+                                             beta,
+                                             d_C,
+                                             d_D,
+                                             workspace,
+                                             &stream,
+                                             1,
+                                             false);
+        rocsparselt_internal_launch_sink() = nullptr;
+        RETURN_IF_ROCSPARSELT_ERROR(status);
+        kernel_args = std::move(sink.kernel_args);
+    }
+    else
+    {
+        RETURN_IF_ROCSPARSELT_ERROR(rocsparselt_matmul_record(__func__,
+                                                              _handle,
+                                                              plan,
+                                                              alpha,
+                                                              d_A,
+                                                              d_B,
+                                                              beta,
+                                                              d_C,
+                                                              d_D,
+                                                              workspace,
+                                                              &recorded_nodes,
+                                                              &recorded));
+    }
+
+    size_t             count  = recorded != nullptr ? recorded_nodes.size() : kernel_args.size();
+    rocsparselt_status status = rocsparselt_status_success;
+    if(count != size_t(numNodes))
+    {
+        log_error(_handle,
+                  __func__,
+                  "the plan needs",
+                  count,
+                  "nodes, but numNodes is",
+                  numNodes);
+        status = rocsparselt_status_invalid_value;
+    }
+
+    for(int32_t i = 0; i < numNodes && status == rocsparselt_status_success; i++)
+    {
+        hipKernelNodeParams params;
+        hipError_t          err;
+        size_t              argsSize = 0;
+        void*               extra[]  = {HIP_LAUNCH_PARAM_BUFFER_POINTER,
+                                        nullptr,
+                                        HIP_LAUNCH_PARAM_BUFFER_SIZE,
+                                        &argsSize,
+                                        HIP_LAUNCH_PARAM_END};
+        if(recorded != nullptr)
+            err = hipGraphKernelNodeGetParams(recorded_nodes[i], &params);
+        else
+        {
+            // The node keeps its kernel and launch geometry, only the argument buffer is new.
+            err                 = hipGraphKernelNodeGetParams(nodes[i], &params);
+            argsSize            = kernel_args[i].size();
+            extra[1]            = kernel_args[i].data();
+            params.kernelParams = nullptr;
+            params.extra        = extra;
+        }
+        if(err == hipSuccess)
+            err = hipGraphExecKernelNodeSetParams(graphExec, nodes[i], &params);
+        if(err != hipSuccess)
+            status = get_rocsparselt_status_for_hip_status(err);
+    }
+
+    if(recorded != nullptr)
+        (void)hipGraphDestroy(recorded);
+    return status;
+}
 #ifdef __cplusplus
 }
 #endif
 
 template <typename Ti, typename To, typename Tc>
-rocsparselt_status ConstructRocSparseLtProblem(const char*                                 caller,
-                                               RocsparseltContractionProblem<Ti, To, Tc>** prob,
-                                               const _rocsparselt_matmul_descr* matmul_descr,
-                                               const Tc*                        alpha,
-                                               const Tc*                        beta,
-                                               const Ti*                        a,
-                                               const Ti*                        b,
-                                               const To*                        c,
-                                               To*                              d,
-                                               bool                             strided_batch,
-                                               void*                            workspace,
-                                               size_t                           workspaceSize,
-                                               hipStream_t*                     streams,
-                                               int32_t                          numStreams)
+rocsparselt_status
+    ConstructRocSparseLtProblem(const char*                                               caller,
+                                std::optional<RocsparseltContractionProblem<Ti, To, Tc>>* prob,
+                                const _rocsparselt_matmul_descr* matmul_descr,
+                                const Tc*                        alpha,
+                                const Tc*                        beta,
+                                const Ti*                        a,
+                                const Ti*                        b,
+                                const To*                        c,
+                                To*                              d,
+                                bool                             strided_batch,
+                                void*                            workspace,
+                                size_t                           workspaceSize,
+                                hipStream_t*                     streams,
+                                int32_t                          numStreams)
 {
-    std::shared_ptr<Tc> _one = std::make_shared<Tc>(static_cast<Tc>(1));
+    // the problem only keeps the pointer, so the default has to outlive it.
+    static const Tc _one = static_cast<Tc>(1);
     if(alpha == nullptr)
-        alpha = _one.get();
+        alpha = &_one;
 
     if(beta == nullptr)
-        beta = _one.get();
+        beta = &_one;
 
     int64_t              metadata_offset;
     const unsigned char* metadata;
@@ -416,57 +1124,208 @@ rocsparselt_status ConstructRocSparseLtProblem(const char*
         _b              = a;
     }
 
-    (*prob) = new RocsparseltContractionProblem<Ti, To, Tc>(matmul_descr->handle,
-                                                            matmul_descr->_op_A,
-                                                            matmul_descr->_op_B,
-                                                            matmul_descr->matrix_D->order,
-                                                            matmul_descr->_m,
-                                                            matmul_descr->_n,
-                                                            matmul_descr->_k,
-                                                            alpha,
-                                                            _a,
-                                                            nullptr,
-                                                            matmul_descr->_lda,
-                                                            _batch_stride_a,
-                                                            _offset_a,
-                                                            _b,
-                                                            nullptr,
-                                                            matmul_descr->_ldb,
-                                                            _batch_stride_b,
-                                                            _offset_b,
-                                                            beta,
-                                                            c,
-                                                            nullptr,
-                                                            matmul_descr->matrix_C->ld,
-                                                            matmul_descr->matrix_C->batch_stride,
-                                                            offset_c,
-                                                            d,
-                                                            nullptr,
-                                                            matmul_descr->matrix_D->ld,
-                                                            matmul_descr->matrix_D->batch_stride,
-                                                            offset_d,
-                                                            num_batches_a,
-                                                            strided_batch,
-                                                            matmul_descr->_is_sparse_a,
-                                                            metadata,
-                                                            act_type,
-                                                            act_args[0],
-                                                            act_args[1],
-                                                            matmul_descr->bias_pointer,
-                                                            matmul_descr->bias_stride,
-                                                            matmul_descr->bias_type,
-                                                            matmul_descr->alpha_vector_scaling,
-                                                            workspace,
-                                                            workspaceSize,
-                                                            streams,
-                                                            numStreams);
+    prob->emplace(matmul_descr->handle,
+                  matmul_descr->_op_A,
+                  matmul_descr->_op_B,
+                  matmul_descr->matrix_D->order,
+                  matmul_descr->_m,
+                  matmul_descr->_n,
+                  matmul_descr->_k,
+                  alpha,
+                  _a,
+                  nullptr,
+                  matmul_descr->_lda,
+                  _batch_stride_a,
+                  _offset_a,
+                  _b,
+                  nullptr,
+                  matmul_descr->_ldb,
+                  _batch_stride_b,
+                  _offset_b,
+                  beta,
+                  c,
+                  nullptr,
+                  matmul_descr->matrix_C->ld,
+                  matmul_descr->matrix_C->batch_stride,
+                  offset_c,
+                  d,
+                  nullptr,
+                  matmul_descr->matrix_D->ld,
+                  matmul_descr->matrix_D->batch_stride,
+                  offset_d,
+                  num_batches_a,
+                  strided_batch,
+                  matmul_descr->_is_sparse_a,
+                  metadata,
+                  act_type,
+                  act_args[0],
+                  act_args[1],
+                  matmul_descr->bias_pointer,
+                  matmul_descr->bias_stride,
+                  matmul_descr->bias_type,
+                  // the device pointer mode applies alpha as a broadcast vector
+                  matmul_descr->alpha_vector_scaling
+                      || matmul_descr->pointer_mode == rocsparselt_pointer_mode_device,
+                  workspace,
+                  workspaceSize,
+                  streams,
+                  numStreams);
     return rocsparselt_status_success;
 }
 
+rocsparselt_status rocsparselt_internal_stream_events(int device, int count, hipEvent_t** events)
+{
+    // Each thread owns its events, so concurrent matmuls never wait on each other's records.
+    thread_local struct event_pool
+    {
+        ~event_pool()
+        {
+            for(auto& device_events : devices)
+                for(auto event : device_events)
+                    (void)hipEventDestroy(event);
+        }
+        std::vector<std::vector<hipEvent_t>> devices;
+    } pool;
+
+    if(device >= pool.devices.size())
+        pool.devices.resize(device + 1);
+
+    auto& device_events = pool.devices[device];
+    while(device_events.size() < count)
+    {
+        hipEvent_t event;
+        RETURN_IF_HIP_ERROR(hipEventCreateWithFlags(&event, hipEventDisableTiming));
+        device_events.push_back(event);
+    }
+
+    *events = device_events.data();
+    return rocsparselt_status_success;
+}
+
+constexpr int spmm_scalars_block = 256;
+
+__global__ void spmm_broadcast_alpha_kernel(const float* alpha, float* alpha_vector, int64_t m)
+{
+    int64_t i = int64_t(blockIdx.x) * blockDim.x + threadIdx.x;
+    if(i < m)
+        alpha_vector[i] = *alpha;
+}
+
+template <typename To>
+__device__ To spmm_scale_cast(float v)
+{
+    return static_cast<To>(v);
+}
+
+template <>
+__device__ int8_t spmm_scale_cast<int8_t>(float v)
+{
+    return static_cast<int8_t>(fminf(fmaxf(rintf(v), -128.0f), 127.0f));
+}
+
+template <typename To>
+__global__ void spmm_scale_c_kernel(int64_t      m,
+                                    int64_t      n,
+                                    const float* beta,
+                                    const To*    C,
+                                    int64_t      ld_c,
+                                    int64_t      stride_c,
+                                    To*          D,
+                                    int64_t      ld_d,
+                                    int64_t      stride_d)
+{
+    int64_t row = int64_t(blockIdx.x) * blockDim.x + threadIdx.x;
+    if(row >= m)
+        return;
+
+    float b = *beta;
+    C += blockIdx.z * stride_c;
+    D += blockIdx.z * stride_d;
+    for(int64_t col = blockIdx.y; col < n; col += gridDim.y)
+    {
+        // beta == 0 must not read C, it may hold NaNs
+        float v = b == 0 ? 0.0f : b * static_cast<float>(C[col * ld_c + row]);
+        D[col * ld_d + row] = spmm_scale_cast<To>(v);
+    }
+}
+
+rocsparselt_status rocsparselt_spmm_broadcast_alpha(hipStream_t  stream,
+                                                    const float* alpha,
+                                                    float*       alpha_vector,
+                                                    int64_t      m)
+{
+    hipLaunchKernelGGL(spmm_broadcast_alpha_kernel,
+                       dim3((m - 1) / spmm_scalars_block + 1),
+                       dim3(spmm_scalars_block),
+                       0 /*dynamic shared*/,
+                       stream,
+                       alpha,
+                       alpha_vector,
+                       m);
+    RETURN_IF_HIP_ERROR(hipGetLastError());
+    return rocsparselt_status_success;
+}
+
+template <typename To>
+rocsparselt_status rocsparselt_spmm_scale_c(hipStream_t  stream,
+                                            int64_t      m,
+                                            int64_t      n,
+                                            int64_t      batch_count,
+                                            const float* beta,
+                                            const To*    C,
+                                            int64_t      ld_c,
+                                            int64_t      stride_c,
+                                            To*          D,
+                                            int64_t      ld_d,
+                                            int64_t      stride_d)
+{
+    if(!m || !n || !batch_count)
+        return rocsparselt_status_success;
+
+    hipLaunchKernelGGL((spmm_scale_c_kernel<To>),
+                       dim3((m - 1) / spmm_scalars_block + 1,
+                            std::min<int64_t>(n, 65535),
+                            batch_count),
+                       dim3(spmm_scalars_block),
+                       0 /*dynamic shared*/,
+                       stream,
+                       m,
+                       n,
+                       beta,
+                       C,
+                       ld_c,
+                       stride_c,
+                       D,
+                       ld_d,
+                       stride_d);
+    RETURN_IF_HIP_ERROR(hipGetLastError());
+    return rocsparselt_status_success;
+}
+
+#define GENERATE_DEFINITIONS(To)                              \
+    template rocsparselt_status rocsparselt_spmm_scale_c<To>( \
+        hipStream_t,                                          \
+        int64_t,                                              \
+        int64_t,                                              \
+        int64_t,                                              \
+        const float*,                                         \
+        const To*,                                            \
+        int64_t,                                              \
+        int64_t,                                              \
+        To*,                                                  \
+        int64_t,                                              \
+        int64_t);
+
+GENERATE_DEFINITIONS(__half)
+GENERATE_DEFINITIONS(hip_bfloat16)
+GENERATE_DEFINITIONS(int8_t)
+
+#undef GENERATE_DEFINITIONS
+
 #define GENERATE_DEFINITIONS(Ti, To, Tc)                                 \
     template rocsparselt_status ConstructRocSparseLtProblem<Ti, To, Tc>( \
         const char*,                                                     \
-        RocsparseltContractionProblem<Ti, To, Tc>**,                     \
+        std::optional<RocsparseltContractionProblem<Ti, To, Tc>>*,       \
         const _rocsparselt_matmul_descr*,                                \
         const Tc*,                                                       \
         const Tc*,                                                       \
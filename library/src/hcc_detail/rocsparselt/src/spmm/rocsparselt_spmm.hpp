@@ -30,14 +30,304 @@
 
 //#include "gemm_tensile.hpp"
 
+#include "definitions.h"
 #include "handle.h"
 #include "hipsparselt_ostream.hpp"
+#include "rocsparselt_search.hpp"
+#include "rocsparselt_spmm_utils.hpp"
 #include "utility.hpp"
 #if BUILD_WITH_TENSILE
 #include "tensile_host.hpp"
 #else
 #include "kernel_launcher.hpp"
 #endif
+#include <algorithm>
+#include <optional>
+
+// A stream part of a split N dimension gets at least spmm_stream_min_cols columns of D,
+// rounded to spmm_stream_col_align so that the parts stay aligned to the macro tiles.
+constexpr size_t spmm_stream_min_cols  = 256;
+constexpr size_t spmm_stream_col_align = 64;
+
+// Fill alpha_vector[0:m] with *alpha.
+rocsparselt_status rocsparselt_spmm_broadcast_alpha(hipStream_t  stream,
+                                                    const float* alpha,
+                                                    float*       alpha_vector,
+                                                    int64_t      m);
+
+// D = *beta * C for the column major m x n matrices of a strided batch.
+template <typename To>
+rocsparselt_status rocsparselt_spmm_scale_c(hipStream_t  stream,
+                                            int64_t      m,
+                                            int64_t      n,
+                                            int64_t      batch_count,
+                                            const float* beta,
+                                            const To*    C,
+                                            int64_t      ld_c,
+                                            int64_t      stride_c,
+                                            To*          D,
+                                            int64_t      ld_d,
+                                            int64_t      stride_d);
+
+/*******************************************************************************
+ * Returns how many parts spmm_stream_part() splits prob into, one per stream,
+ * and the batches or columns of each part in chunk. Returns 1 if the problem
+ * runs as a whole on streams[0]. Strided batched problems spread their batches
+ * across the streams, other problems with a sparse A split N into column
+ * blocks. The parts of the workspace pool get a slice per stream. The workspace
+ * of the caller holds a slice for each of workspace_streams parts, see
+ * _rocsparselt_matmul_alg_selection::matmul_workspace_bytes().
+ *******************************************************************************/
+template <typename Ti, typename To, typename Tc>
+int spmm_stream_parts(const RocsparseltContractionProblem<Ti, To, Tc>& prob,
+                      int                                              workspace_streams,
+                      size_t*                                          chunk)
+{
+    size_t streams = std::min(prob.numStreams, rocsparselt_exec_cache_slots);
+    if(prob.workspaceSize > 0 && prob.workspace != nullptr)
+        streams = std::min(streams, size_t(workspace_streams));
+    if(streams < 2)
+        return 1;
+
+    if(prob.batch_count > 1)
+    {
+        // a batch of the bias can not be addressed without its element type
+        if(prob.bias_vector != nullptr && prob.bias_stride != 0)
+            return 1;
+
+        *chunk = (prob.batch_count + streams - 1) / streams;
+        return (prob.batch_count + *chunk - 1) / *chunk;
+    }
+
+    // the metadata of a sparse B is laid out along N
+    if(!prob.sparseA || prob.n < 2 * spmm_stream_min_cols)
+        return 1;
+
+    // so are the bias and alpha vectors of a row major problem
+    if(prob.bias_vector != nullptr)
+        return 1;
+#if BUILD_WITH_TENSILE
+    if(prob.alpha_vector_scaling)
+        return 1;
+#endif
+
+    streams = std::min(streams, prob.n / spmm_stream_min_cols);
+    *chunk  = (prob.n + streams - 1) / streams;
+    *chunk  = (*chunk + spmm_stream_col_align - 1) / spmm_stream_col_align * spmm_stream_col_align;
+    return (prob.n + *chunk - 1) / *chunk;
+}
+
+/*******************************************************************************
+ * Returns part `part` of prob, as split by spmm_stream_parts(). It runs on
+ * streams[part], with slice `part` of the workspace of the caller.
+ *******************************************************************************/
+template <typename Ti, typename To, typename Tc>
+RocsparseltContractionProblem<Ti, To, Tc>
+    spmm_stream_part(const RocsparseltContractionProblem<Ti, To, Tc>& prob, size_t chunk, int part)
+{
+    auto sub       = prob;
+    sub.streams    = prob.streams + part;
+    sub.numStreams = 1;
+    if(prob.workspace != nullptr)
+        sub.workspace = static_cast<char*>(prob.workspace)
+                        + part * rocsparselt_workspace_slice_bytes(prob.workspaceSize);
+
+    size_t first = part * chunk;
+    if(prob.batch_count > 1)
+    {
+        sub.batch_count = std::min(chunk, prob.batch_count - first);
+        sub.A += first * prob.batch_stride_a;
+        sub.B += first * prob.batch_stride_b;
+        sub.C += first * prob.batch_stride_c;
+        sub.D += first * prob.batch_stride_d;
+
+        // the metadata of a compressed batch takes a quarter of its stride, in bytes
+        size_t sparse_stride = prob.sparseA ? prob.batch_stride_a : prob.batch_stride_b;
+        sub.metadata += first * sparse_stride / 4;
+    }
+    else
+    {
+        sub.n = std::min(chunk, prob.n - first);
+        sub.B += first
+                 * (prob.trans_b == rocsparselt_operation_none ? prob.col_stride_b
+                                                               : prob.row_stride_b);
+        sub.C += first * prob.col_stride_c;
+        sub.D += first * prob.col_stride_d;
+    }
+    return sub;
+}
+
+/*******************************************************************************
+ * Gives prob the workspace pool slice of the stream it runs on, with the
+ * workspace it needs, if it was called without a workspace.
+ *******************************************************************************/
+template <typename Ti, typename To, typename Tc>
+rocsparselt_status spmm_pool_workspace(RocsparseltContractionProblem<Ti, To, Tc>& prob)
+{
+    auto pool = prob.handle->workspace_pool;
+    if(prob.workspace != nullptr || prob.workspaceSize == 0 || pool == nullptr)
+        return rocsparselt_status_success;
+    return pool->acquire(
+        prob.numStreams ? prob.streams[0] : nullptr, prob.workspaceSize, &prob.workspace);
+}
+
+template <typename Ti, typename To, typename Tc>
+rocsparselt_status spmm_run(const RocsparseltContractionProblem<Ti, To, Tc>& prob,
+                            const _rocsparselt_matmul_plan*                  plan,
+                            int*                                             config_id,
+                            const int                                        config_max_id,
+                            const int                                        search_iterations,
+                            int                                              exec_slot)
+{
+    rocsparselt_search_options search_options;
+    if(search_iterations)
+    {
+        const auto* alg_selection = plan->alg_selection;
+        search_options.statistic  = alg_selection->search_statistic;
+        search_options.min_ms     = alg_selection->search_min_time;
+        search_options.stream     = prob.streams[0];
+        // Twice the L2 cache, so that none of the inputs is left in it.
+        if(alg_selection->search_flush_cache)
+            search_options.flush_bytes = 2 * size_t(prob.handle->properties.l2CacheSize);
+    }
+    return runContractionProblem<Ti, To, Tc>(prob,
+                                             &plan->alg_selection->configs[0],
+                                             config_id,
+                                             config_max_id,
+                                             search_iterations,
+                                             &search_options,
+                                             plan->exec_cache,
+                                             exec_slot);
+}
+
+/*******************************************************************************
+ * Whether the selected config runs every part of prob, as split by
+ * spmm_stream_parts(), on its own. Otherwise prob runs as a whole.
+ *******************************************************************************/
+template <typename Ti, typename To, typename Tc>
+bool spmm_stream_parts_valid(const RocsparseltContractionProblem<Ti, To, Tc>& prob,
+                             const _rocsparselt_matmul_plan*                  plan,
+                             int                                              config_id,
+                             int                                              parts,
+                             size_t                                           chunk)
+{
+    for(int i = 0; i < parts; i++)
+    {
+        // every column block but the last one must end on a tile boundary
+        bool whole_tiles = prob.batch_count <= 1 && i + 1 < parts;
+        if(!validateContractionProblem<Ti, To, Tc>(spmm_stream_part(prob, chunk, i),
+                                                   &plan->alg_selection->configs[0],
+                                                   config_id,
+                                                   plan->exec_cache,
+                                                   i,
+                                                   whole_tiles))
+            return false;
+    }
+    return true;
+}
+
+/*******************************************************************************
+ * Runs the parts of prob on its streams. The parts wait for the work already
+ * queued on streams[0], and streams[0] waits for all of them, so callers see
+ * the same ordering as for a matmul on streams[0] alone.
+ *******************************************************************************/
+template <typename Ti, typename To, typename Tc>
+rocsparselt_status spmm_multi_stream(const RocsparseltContractionProblem<Ti, To, Tc>& prob,
+                                     const _rocsparselt_matmul_plan*                  plan,
+                                     int*                                             config_id,
+                                     const int                                        config_max_id,
+                                     int                                              parts,
+                                     size_t                                           chunk)
+{
+    hipEvent_t* events;
+    RETURN_IF_ROCSPARSELT_ERROR(
+        rocsparselt_internal_stream_events(prob.handle->device, parts, &events));
+
+    // events[0] forks the parts off streams[0], events[i] joins part i back.
+    RETURN_IF_HIP_ERROR(hipEventRecord(events[0], prob.streams[0]));
+    for(int i = 1; i < parts; i++)
+        RETURN_IF_HIP_ERROR(hipStreamWaitEvent(prob.streams[i], events[0], 0));
+
+    for(int i = 0; i < parts; i++)
+    {
+        auto part = spmm_stream_part(prob, chunk, i);
+        RETURN_IF_ROCSPARSELT_ERROR(spmm_pool_workspace(part));
+        RETURN_IF_ROCSPARSELT_ERROR(spmm_run(part, plan, config_id, config_max_id, 0, i));
+    }
+
+    for(int i = 1; i < parts; i++)
+    {
+        RETURN_IF_HIP_ERROR(hipEventRecord(events[i], prob.streams[i]));
+        RETURN_IF_HIP_ERROR(hipStreamWaitEvent(prob.streams[0], events[i], 0));
+    }
+    return rocsparselt_status_success;
+}
+
+#if BUILD_WITH_TENSILE
+/*******************************************************************************
+ * Prepares prob for a plan in the device pointer mode. The kernels take alpha
+ * and beta by value, so alpha becomes the alpha vector of the plan, filled on
+ * the device in the slice of streams[0], and beta is folded into D = beta * C
+ * ahead of the kernel, which then runs with C = D and beta = 1. The search runs
+ * every config on the same D, it gets beta * C in scaled_c instead, laid out
+ * like D.
+ *
+ * The folding costs a pass over C, and beta * C is rounded to To before the
+ * kernel adds alpha * A * B to it. For a half or int8 D, the result may then
+ * differ from the host pointer mode by one unit in the last place.
+ *******************************************************************************/
+template <typename Ti, typename To, typename Tc>
+rocsparselt_status spmm_device_scalars(RocsparseltContractionProblem<Ti, To, Tc>& prob,
+                                       const _rocsparselt_matmul_plan*            plan,
+                                       To*                                        scaled_c)
+{
+    static const Tc _one   = static_cast<Tc>(1);
+    hipStream_t     stream = prob.numStreams ? prob.streams[0] : nullptr;
+
+    if(!plan->matmul_descr->alpha_vector_scaling)
+    {
+        void* alpha_vector = nullptr;
+        RETURN_IF_ROCSPARSELT_ERROR(plan->device_alpha->acquire(stream, 0, &alpha_vector));
+        RETURN_IF_ROCSPARSELT_ERROR(
+            rocsparselt_spmm_broadcast_alpha(stream,
+                                             prob.alpha,
+                                             reinterpret_cast<Tc*>(alpha_vector),
+                                             plan->matmul_descr->m));
+        prob.alpha = reinterpret_cast<const Tc*>(alpha_vector);
+    }
+
+    To* dst = scaled_c != nullptr ? scaled_c : prob.D;
+    RETURN_IF_ROCSPARSELT_ERROR(rocsparselt_spmm_scale_c<To>(stream,
+                                                             prob.m,
+                                                             prob.n,
+                                                             prob.batch_count,
+                                                             prob.beta,
+                                                             prob.C,
+                                                             prob.col_stride_c,
+                                                             prob.batch_stride_c,
+                                                             dst,
+                                                             prob.col_stride_d,
+                                                             prob.batch_stride_d));
+    prob.C              = dst;
+    prob.col_stride_c   = prob.col_stride_d;
+    prob.batch_stride_c = prob.batch_stride_d;
+    prob.beta           = &_one;
+    return rocsparselt_status_success;
+}
+#endif
+
+/*******************************************************************************
+ * Device memory of a single matmul, hipFree() waits for the kernels using it.
+ *******************************************************************************/
+struct spmm_scratch
+{
+    ~spmm_scratch()
+    {
+        if(ptr != nullptr)
+            (void)hipFree(ptr);
+    }
+    void* ptr = nullptr;
+};
 
 template <typename Ti, typename To = Ti, typename Tc = To>
 rocsparselt_status spmm_typecasting(const char*                     caller,
@@ -54,7 +344,8 @@ rocsparselt_status spmm_typecasting(const char*                     caller,
                                     int32_t                         numStreams,
                                     int*                            config_id,
                                     const int                       config_max_id,
-                                    const int                       search_iterations)
+                                    const int                       search_iterations,
+                                    const int64_t                   m)
 {
     // check alignment of pointers before casting
     if(!isAligned(a, sizeof(Ti)) || !isAligned(b, sizeof(Ti)) || !isAligned(c, sizeof(Ti))
@@ -64,7 +355,8 @@ rocsparselt_status spmm_typecasting(const char*                     caller,
         return rocsparselt_status_invalid_size;
     }
 
-    RocsparseltContractionProblem<Ti, To, Tc>* problem;
+    // The problem lives on the stack, rocsparselt_matmul() must not touch the heap.
+    std::optional<RocsparseltContractionProblem<Ti, To, Tc>> problem;
 
     auto status = ConstructRocSparseLtProblem(
         caller,
@@ -78,26 +370,55 @@ rocsparselt_status spmm_typecasting(const char*                     caller,
         (To*)d,
         true,
         workspace,
-        plan->alg_selection->config_max_id == 0
-            ? 0
-            : plan->alg_selection->configs[plan->alg_selection->config_id].max_workspace_bytes,
+        search_iterations ? plan->alg_selection->workspace_bytes()
+                          : plan->alg_selection->selected_workspace_bytes(),
         streams,
         numStreams);
 
     if(status != rocsparselt_status_success)
         return status;
 
-    status = runContractionProblem<Ti, To, Tc>(*problem,
+    // A bucket of a dynamic-M plan runs with the M of the call.
+    if(m != 0)
+        (plan->matmul_descr->_swap_ab ? problem->n : problem->m) = m;
+
+    // The workspace of the caller only fits the selected config, the search runs all of them.
+    // A pool slice grows instead.
+    spmm_scratch search_workspace;
+    if(search_iterations
+       && problem->workspaceSize > plan->alg_selection->selected_workspace_bytes()
+       && (problem->workspace != nullptr || handle->workspace_pool == nullptr))
+    {
+        RETURN_IF_HIP_ERROR(hipMalloc(&search_workspace.ptr, problem->workspaceSize));
+        problem->workspace = search_workspace.ptr;
+    }
+
 #if BUILD_WITH_TENSILE
-                                               &plan->alg_selection->configs[0],
+    // The copy of beta * C the search reads.
+    spmm_scratch scaled_c;
+    if(plan->matmul_descr->pointer_mode == rocsparselt_pointer_mode_device)
+    {
+        if(search_iterations && problem->m && problem->n && problem->batch_count)
+        {
+            size_t elements = (problem->batch_count - 1) * problem->batch_stride_d
+                              + (problem->n - 1) * problem->col_stride_d + problem->m;
+            RETURN_IF_HIP_ERROR(hipMalloc(&scaled_c.ptr, elements * sizeof(To)));
+        }
+        RETURN_IF_ROCSPARSELT_ERROR(
+            spmm_device_scalars(*problem, plan, static_cast<To*>(scaled_c.ptr)));
+    }
 #endif
-                                               config_id,
-                                               config_max_id,
-                                               search_iterations);
 
-    delete problem;
+    // The search times the configs on streams[0] alone.
+    size_t chunk = 0;
+    int    parts = 1;
+    if(!search_iterations)
+        parts = spmm_stream_parts(*problem, plan->alg_selection->workspace_streams, &chunk);
+    if(parts > 1 && spmm_stream_parts_valid(*problem, plan, *config_id, parts, chunk))
+        return spmm_multi_stream(*problem, plan, config_id, config_max_id, parts, chunk);
 
-    return status;
+    RETURN_IF_ROCSPARSELT_ERROR(spmm_pool_workspace(*problem));
+    return spmm_run(*problem, plan, config_id, config_max_id, search_iterations, 0);
 }
 
 inline rocsparselt_status rocsparselt_spmm_template(const char*                     caller,
@@ -114,13 +435,14 @@ inline rocsparselt_status rocsparselt_spmm_template(const char*
                                                     int32_t                         numStreams,
                                                     int*                            config_id,
                                                     const int                       config_max_id,
-                                                    const int search_iterations)
+                                                    const int     search_iterations,
+                                                    const int64_t m)
 {
     rocsparselt_status rs_status = rocsparselt_status_not_implemented;
 
 #define EX_TYPECASTING_PARM                                                                   \
     caller, handle, plan, alpha, beta, a, b, c, d, workspace, streams, numStreams, config_id, \
-        config_max_id, search_iterations
+        config_max_id, search_iterations, m
 
     hipDataType              a_type       = plan->matmul_descr->matrix_A->type;
     hipDataType              b_type       = plan->matmul_descr->matrix_B->type;
@@ -0,0 +1,139 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include "startup_timing.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <iomanip>
+#include <mutex>
+#include <sstream>
+
+namespace
+{
+    const char* const startup_phase_names[rocsparselt_startup_phase_count] = {
+        "path_discovery",
+        "code_object_glob",
+        "code_object_load",
+        "library_load",
+        "device_properties",
+        "first_solution_query",
+        "first_launch",
+    };
+
+    std::mutex               startup_mutex;
+    rocsparselt_startup_time startup_times[rocsparselt_startup_phase_count];
+    std::atomic_bool         startup_recorded[rocsparselt_startup_phase_count];
+
+    bool startup_valid(int phase)
+    {
+        return phase >= 0 && phase < rocsparselt_startup_phase_count;
+    }
+
+    // Expects startup_mutex to be held
+    void startup_add(int phase, double ms)
+    {
+        auto& time = startup_times[phase];
+        if(time.count == 0)
+            time.first_ms = ms;
+        time.total_ms += ms;
+        time.count++;
+        startup_recorded[phase].store(true, std::memory_order_release);
+    }
+}
+
+void rocsparselt_startup_record(int phase, double ms)
+{
+    if(!startup_valid(phase))
+        return;
+    std::lock_guard<std::mutex> lock(startup_mutex);
+    startup_add(phase, ms);
+}
+
+bool rocsparselt_startup_record_first(int phase, double ms)
+{
+    if(!startup_valid(phase))
+        return false;
+    std::lock_guard<std::mutex> lock(startup_mutex);
+    if(startup_times[phase].count != 0)
+        return false;
+    startup_add(phase, ms);
+    return true;
+}
+
+bool rocsparselt_startup_recorded(int phase)
+{
+    return startup_valid(phase) && startup_recorded[phase].load(std::memory_order_acquire);
+}
+
+rocsparselt_startup_time rocsparselt_startup_get(int phase)
+{
+    if(!startup_valid(phase))
+        return {};
+    std::lock_guard<std::mutex> lock(startup_mutex);
+    return startup_times[phase];
+}
+
+const char* rocsparselt_startup_phase_name(int phase)
+{
+    return startup_valid(phase) ? startup_phase_names[phase] : nullptr;
+}
+
+std::string rocsparselt_startup_summary()
+{
+    std::ostringstream line;
+    line << std::fixed << std::setprecision(3);
+    for(int phase = 0; phase < rocsparselt_startup_phase_count; phase++)
+    {
+        auto time = rocsparselt_startup_get(phase);
+        if(time.count == 0)
+            continue;
+        if(line.tellp() > 0)
+            line << ", ";
+        line << startup_phase_names[phase] << " " << time.total_ms << " ms";
+        if(time.count > 1)
+            line << " (" << time.count << ")";
+    }
+    return line.str();
+}
+
+bool rocsparselt_startup_summary_enabled()
+{
+    static const bool enabled = [] {
+        const char* env = getenv("HIPSPARSELT_STARTUP_SUMMARY");
+        return env && atoi(env) > 0;
+    }();
+    return enabled;
+}
+
+void rocsparselt_startup_reset()
+{
+    std::lock_guard<std::mutex> lock(startup_mutex);
+    for(int phase = 0; phase < rocsparselt_startup_phase_count; phase++)
+    {
+        startup_times[phase] = {};
+        startup_recorded[phase].store(false, std::memory_order_release);
+    }
+}
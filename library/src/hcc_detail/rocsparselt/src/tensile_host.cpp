@@ -29,7 +29,12 @@
 #include "tensile_host.hpp"
 #include "activation.hpp"
 #include "definitions.h"
+#include "lru_cache.hpp"
+#include "parallel_for.hpp"
+#include "perf_model.hpp"
+#include "rocsparselt_search.hpp"
 #include "rocsparselt_spmm_utils.hpp"
+#include "startup_timing.hpp"
 #include "status.h"
 #include "utility.hpp"
 /*****************************************************************************
@@ -47,14 +52,22 @@
 #include <Tensile/hip/HipHardware.hpp>
 #include <Tensile/hip/HipSolutionAdapter.hpp>
 #include <Tensile/hip/HipUtils.hpp>
+#include <algorithm>
 #include <atomic>
+#include <chrono>
 #include <complex>
+#include <cstring>
 #include <exception>
+#include <future>
 #include <iomanip>
+#include <map>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <string>
+#include <thread>
 #include <type_traits>
+#include <unordered_map>
 #include <vector>
 
 #include <glob.h>
@@ -197,7 +210,8 @@ namespace
         // We set K=0 when alpha==0.
         // This makes alpha==0 a change in the problem, and not just a change in the inputs.
         // It optimizes all problems with alpha==0 into K=0 and alpha=(don't care)
-        auto k = prob.k && *prob.alpha ? prob.k : 0;
+        // An alpha vector is never zero, it may also live on the device.
+        auto k = prob.k && (prob.alpha_vector_scaling || *prob.alpha) ? prob.k : 0;
 
         // clang-format off
 
@@ -450,6 +464,69 @@ namespace
         return inputs;
     }
 
+    /**************************************************************************
+     * Whether the code objects are loaded when a plan first selects one of   *
+     * their solutions, from HIPSPARSELT_TENSILE_LAZY_LOAD or                 *
+     * rocsparselt_set_lazy_loading(). It is read at the first initialization *
+     **************************************************************************/
+    std::atomic_bool& rocsparselt_internal_lazy_loading()
+    {
+        static std::atomic_bool lazy{[] {
+            const char* env = getenv("HIPSPARSELT_TENSILE_LAZY_LOAD");
+            return env && atoi(env) != 0;
+        }()};
+        return lazy;
+    }
+
+    /*************************************************************************
+     * LazyCodeObjects loads the code object of a solution of one device the *
+     * first time it is selected, when the library is loaded lazily. Each    *
+     * file is loaded once, and threads selecting it meanwhile wait for it.  *
+     *************************************************************************/
+    class LazyCodeObjects
+    {
+        struct entry
+        {
+            std::once_flag once;
+            hipError_t     status = hipSuccess;
+        };
+
+        std::string                  m_directory;
+        bool                         m_enabled = false;
+        std::mutex                   m_mutex;
+        std::map<std::string, entry> m_entries;
+
+    public:
+        void enable(const std::string& directory)
+        {
+            m_directory = directory;
+            m_enabled   = true;
+        }
+
+        hipError_t load(Tensile::hip::SolutionAdapter&      adapter,
+                        const Tensile::ContractionSolution& solution)
+        {
+            if(!m_enabled || solution.codeObjectFilename.empty())
+                return hipSuccess;
+
+            entry* e;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                e = &m_entries[solution.codeObjectFilename];
+            }
+            std::call_once(e->once, [&] {
+                auto                      file = m_directory + "/" + solution.codeObjectFilename;
+                rocsparselt_startup_timer timer(rocsparselt_startup_code_object_load);
+                e->status = adapter.loadCodeObjectFile(file);
+                timer.stop();
+                if(e->status != hipSuccess)
+                    hipsparselt_cerr << "\nhipsparselt_error: Could not load " << file << ": "
+                                     << hipGetErrorString(e->status) << std::endl;
+            });
+            return e->status;
+        }
+    };
+
     /**************************************************
      * The TensileHost struct interfaces with Tensile *
      **************************************************/
@@ -457,7 +534,6 @@ namespace
     {
         // The library object
         std::shared_ptr<Tensile::MasterSolutionLibrary<Tensile::ContractionProblemGemm>> m_library;
-        std::shared_ptr<hipDeviceProp_t> m_deviceProp;
 
         // The adapter object. mutable is used to allow adapters to be modified
         // even when they are stored in a const vector which is immutable in size
@@ -465,6 +541,8 @@ namespace
         {
             mutable std::atomic<Tensile::hip::SolutionAdapter*> adapter{nullptr};
             mutable std::mutex                                  mutex;
+            mutable LazyCodeObjects                             lazy;
+            mutable std::shared_ptr<hipDeviceProp_t>            deviceProp;
         };
 
         // Each device contains an adapter
@@ -508,9 +586,9 @@ namespace
             return m_library;
         }
 
-        auto& get_device_property() const
+        auto& get_device_property(int device) const
         {
-            return m_deviceProp;
+            return m_adapters.at(device).deviceProp;
         }
 
         auto& get_adapters() const
@@ -534,8 +612,12 @@ namespace
          * Initialize adapter and library according to environment variables *
          * and default paths based on librocsparselt.so location and GPU         *
          *********************************************************************/
-        void initialize(Tensile::hip::SolutionAdapter& adapter, int32_t deviceId)
+        void initialize(Tensile::hip::SolutionAdapter& adapter,
+                        LazyCodeObjects&               lazy_objects,
+                        int32_t                        deviceId)
         {
+            rocsparselt_startup_timer path_discovery(rocsparselt_startup_path_discovery);
+
             std::string path;
 #ifndef WIN32
             path.reserve(PATH_MAX);
@@ -573,10 +655,123 @@ namespace
                 if(TestPath(path + "/" + processor))
                     path += "/" + processor;
             }
+            path_discovery.stop();
+
+#ifdef TENSILE_YAML
+            const std::string ext = ".yaml";
+#else
+            const std::string ext = ".dat";
+#endif
+            // The index of a library built with Tensile_LAZY_LIBRARY_LOADING
+            auto lazy_index = path + "/TensileLibrary_lazy_" + processor + ext;
+
+            // The library is loaded once for the process, so the first
+            // initialization decides whether it is loaded lazily.
+            static const bool lazy = [&] {
+                if(!rocsparselt_internal_lazy_loading())
+                    return false;
+                if(TestPath(lazy_index))
+                    return true;
+                hipsparselt_cerr << "\nrocsparselt warning: " << lazy_index
+                                 << " not found, loading all the code objects." << std::endl;
+                return false;
+            }();
+
+            // We initialize a local static variable with a lambda function call to avoid
+            // race conditions when multiple threads with different device IDs try to
+            // initialize library. This ensures that only one thread initializes library,
+            // and other threads trying to initialize library wait for it to complete.
+            // It is parsed on a worker while the code objects are loaded.
+            auto library = std::async(std::launch::async, [&] {
+                static int once = [&] {
+                    auto                      start = std::chrono::steady_clock::now();
+                    rocsparselt_startup_timer timer(rocsparselt_startup_library_load);
+
+                    // A library built for lazy loading may only have the lazy index
+                    auto file = path + "/TensileLibrary" + ext;
+                    if(lazy || (!TestPath(file) && TestPath(lazy_index)))
+                        file = lazy_index;
+                    if(!TestPath(file))
+                    {
+                        hipsparselt_cerr << "\nhipsparselt_error: Cannot read " << file << ": "
+                                         << strerror(errno) << std::endl;
+                        //rocsparselt_abort();
+                    }
+
+                    auto lib = Tensile::LoadLibraryFile<Tensile::ContractionProblemGemm>(file);
+                    if(!lib)
+                    {
+                        hipsparselt_cerr << "\nhipsparselt_error: Could not load " << file
+                                         << std::endl;
+                        return -1;
+                    }
+                    else
+                    {
+                        using MSL = Tensile::MasterSolutionLibrary<Tensile::ContractionProblemGemm>;
+                        m_library = std::dynamic_pointer_cast<MSL>(lib);
+                    }
+                    log_process(rocsparselt_layer_mode_log_info,
+                                "TensileHost::initialize",
+                                "file",
+                                file,
+                                "library_ms",
+                                ElapsedMs(start));
+                    return 0;
+                }();
+                return once;
+            });
+
+            auto start = std::chrono::steady_clock::now();
+            if(lazy)
+            {
+                // Only the helper kernels are loaded, the others when a plan selects them
+                rocsparselt_startup_timer timer(rocsparselt_startup_code_object_load);
+                (void)adapter.initializeLazyLoading(processor, path);
+                timer.stop();
+                lazy_objects.enable(path);
+            }
+            else
+            {
+                LoadCodeObjects(adapter, path, processor, deviceId);
+            }
+            log_process(rocsparselt_layer_mode_log_info,
+                        "TensileHost::initialize",
+                        "device",
+                        deviceId,
+                        "code_objects_ms",
+                        ElapsedMs(start));
+
+            int once = library.get();
+            if(!m_library && once != 0)
+            {
+                hipsparselt_cerr << "\nhipsparselt_error: Could not initialize Tensile library"
+                                 << std::endl;
+                //rocsparselt_abort();
+            }
+
+            hipDeviceProp_t           prop;
+            rocsparselt_startup_timer timer(rocsparselt_startup_device_properties);
+            THROW_IF_HIP_ERROR(hipGetDeviceProperties(&prop, deviceId));
+            timer.stop();
+
+            m_adapters.at(deviceId).deviceProp = std::make_shared<hipDeviceProp_t>(prop);
+        }
+
+        /**********************************************************
+         * Load all the code objects of the current GPU in a path *
+         **********************************************************/
+        static void LoadCodeObjects(Tensile::hip::SolutionAdapter& adapter,
+                                    const std::string&             path,
+                                    const std::string&             processor,
+                                    int32_t                        deviceId)
+        {
+            std::vector<std::string> files;
 
             // only load modules for the current architecture
             auto dir = path + "/*" + processor + "*co";
 
+            rocsparselt_startup_timer glob_timer(rocsparselt_startup_code_object_glob);
+
             bool no_match = false;
 #ifdef WIN32
             std::replace(dir.begin(), dir.end(), '/', '\\');
@@ -586,8 +781,7 @@ namespace
             {
                 do
                 {
-                    std::string codeObjectFile = path + "\\" + finddata.cFileName;
-                    adapter.loadCodeObjectFile(codeObjectFile.c_str());
+                    files.push_back(path + "\\" + finddata.cFileName);
                 } while(FindNextFileA(hfine, &finddata));
             }
             else
@@ -601,7 +795,7 @@ namespace
             if(!g)
             {
                 for(size_t i = 0; i < glob_result.gl_pathc; ++i)
-                    (void)adapter.loadCodeObjectFile(glob_result.gl_pathv[i]);
+                    files.push_back(glob_result.gl_pathv[i]);
             }
             else if(g == GLOB_NOMATCH)
             {
@@ -621,6 +815,8 @@ namespace
             }
             globfree(&glob_result);
 #endif
+            glob_timer.stop();
+
             if(no_match)
             {
                 static hipsparselt_internal_ostream& once
@@ -631,48 +827,20 @@ namespace
                 (void)once;
             }
 
-            // We initialize a local static variable with a lambda function call to avoid
-            // race conditions when multiple threads with different device IDs try to
-            // initialize library. This ensures that only one thread initializes library,
-            // and other threads trying to initialize library wait for it to complete.
-            static int once = [&] {
-#ifdef TENSILE_YAML
-                path += "/TensileLibrary.yaml";
-#else
-                path += "/TensileLibrary.dat";
-#endif
-                if(!TestPath(path))
-                {
-                    hipsparselt_cerr << "\nhipsparselt_error: Cannot read " << path << ": "
-                                     << strerror(errno) << std::endl;
-                    //rocsparselt_abort();
-                }
-
-                auto lib = Tensile::LoadLibraryFile<Tensile::ContractionProblemGemm>(path);
-                if(!lib)
-                {
-                    hipsparselt_cerr << "\nhipsparselt_error: Could not load " << path << std::endl;
-                    return -1;
-                }
-                else
-                {
-                    using MSL = Tensile::MasterSolutionLibrary<Tensile::ContractionProblemGemm>;
-                    m_library = std::dynamic_pointer_cast<MSL>(lib);
-                }
-                return 0;
-            }();
-
-            if(!m_library && once != 0)
-            {
-                hipsparselt_cerr << "\nhipsparselt_error: Could not initialize Tensile library"
-                                 << std::endl;
-                //rocsparselt_abort();
-            }
-
-            hipDeviceProp_t prop;
-            THROW_IF_HIP_ERROR(hipGetDeviceProperties(&prop, deviceId));
+            // The files are loaded by a few workers, each on the device being initialized
+            auto caller = std::this_thread::get_id();
+            rocsparselt_parallel_for(files.size(), rocsparselt_init_workers(), [&](size_t i) {
+                if(std::this_thread::get_id() != caller)
+                    (void)hipSetDevice(deviceId);
+                rocsparselt_startup_timer timer(rocsparselt_startup_code_object_load);
+                (void)adapter.loadCodeObjectFile(files[i]);
+            });
+        }
 
-            m_deviceProp = std::make_shared<hipDeviceProp_t>(prop);
+        static double ElapsedMs(std::chrono::steady_clock::time_point start)
+        {
+            using ms = std::chrono::duration<double, std::milli>;
+            return ms(std::chrono::steady_clock::now() - start).count();
         }
     };
 
@@ -680,8 +848,9 @@ namespace
     auto& get_library_and_adapter(
         std::shared_ptr<Tensile::MasterSolutionLibrary<Tensile::ContractionProblemGemm>>* library
         = nullptr,
-        std::shared_ptr<hipDeviceProp_t>* deviceProp = nullptr,
-        int                               device     = -1)
+        std::shared_ptr<hipDeviceProp_t>* deviceProp   = nullptr,
+        int                               device       = -1,
+        LazyCodeObjects**                 lazy_objects = nullptr)
     try
     {
         // TensileHost is initialized on the first call
@@ -708,7 +877,7 @@ namespace
                 adapter = new Tensile::hip::SolutionAdapter;
 
                 // Initialize the adapter and possibly the library
-                host.initialize(*adapter, device);
+                host.initialize(*adapter, a.lazy, device);
 
                 // Atomically change the adapter stored for this device ID
                 a.adapter.store(adapter, std::memory_order_release);
@@ -719,7 +888,9 @@ namespace
         if(library)
             *library = host.get_library();
         if(deviceProp)
-            *deviceProp = host.get_device_property();
+            *deviceProp = host.get_device_property(device);
+        if(lazy_objects)
+            *lazy_objects = &a.lazy;
 
         return *adapter;
     }
@@ -758,8 +929,520 @@ namespace
             hipsparselt_cerr << msg << std::endl;
     }
 
+    /**************************************************************************
+    * Classify a scalar the same way Tensile does when it selects a kernel,  *
+    * so that a cached problem can be reused as long as the class is stable. *
+    **************************************************************************/
+    template <typename T>
+    int scalar_class(const T& v)
+    {
+        if(v == static_cast<T>(0))
+            return 0;
+        else if(v == static_cast<T>(1))
+            return 1;
+        else if(v == static_cast<T>(-1))
+            return 2;
+        return 3;
+    }
+
+    /**************************************************************************
+    * Describe how a solution splits the K loop. Tensile's global            *
+    * accumulation is 0 if the kernel adds up the splits in D by itself, 1   *
+    * if it adds them up in the workspace and 2 if each split has a buffer   *
+    * of its own. Both of the latter finish with a second kernel, only the   *
+    * multiple buffers do without atomics.                                   *
+    **************************************************************************/
+    void SetSplitK(const Tensile::ContractionSolution& solution,
+                   _rocsparselt_matmul_config*         config)
+    {
+        const int gsu          = std::max<int>(solution.sizeMapping.globalSplitU, 1);
+        const int accumulation = solution.sizeMapping.globalAccumulation;
+
+        config->split_k      = gsu;
+        config->split_k_mode = accumulation ? rocsparselt_split_k_mode_two_kernels
+                                            : rocsparselt_splik_k_mode_one_kernel;
+        config->atomics      = gsu > 1 && accumulation != 2;
+    }
+
+    /**************************************************************************
+    * The parts of a RocsparseltContractionProblem that are not fixed by the *
+    * plan but still change the Tensile problem (and so the solution). M, N  *
+    * and the batch count are not part of it: a dynamic-M bucket runs with   *
+    * the M of the call and a multi-stream matmul runs parts of the problem  *
+    * of its plan, both with the solution the slot resolved.                 *
+    **************************************************************************/
+    struct ExecCacheKey
+    {
+        int    config_id;
+        int    solution_index;
+        int    use_bias;
+        int    use_scale_alpha_vec;
+        int    alpha_class;
+        int    beta_class;
+        bool   zero_k;
+        bool   c_equals_d;
+        size_t workspace_size;
+
+        bool operator==(const ExecCacheKey& rhs) const
+        {
+            return config_id == rhs.config_id && solution_index == rhs.solution_index
+                   && use_bias == rhs.use_bias && use_scale_alpha_vec == rhs.use_scale_alpha_vec
+                   && alpha_class == rhs.alpha_class && beta_class == rhs.beta_class
+                   && zero_k == rhs.zero_k && c_equals_d == rhs.c_equals_d
+                   && workspace_size == rhs.workspace_size;
+        }
+    };
+
+    template <typename Ti, typename To, typename Tc>
+    ExecCacheKey MakeExecCacheKey(const RocsparseltContractionProblem<Ti, To, Tc>& prob,
+                                  const _rocsparselt_matmul_config&                config,
+                                  int                                              config_id)
+    {
+        // Must follow the alpha/beta handling of ConstructTensileProblem.
+        Tc alpha = prob.k ? (prob.alpha_vector_scaling ? static_cast<Tc>(1) : *prob.alpha)
+                          : static_cast<Tc>(0);
+        return ExecCacheKey{config_id,
+                            config.index,
+                            config.use_bias,
+                            config.use_scale_alpha_vec,
+                            scalar_class(alpha),
+                            scalar_class(*prob.beta),
+                            !(prob.k && (prob.alpha_vector_scaling || *prob.alpha)),
+                            prob.C == prob.D,
+                            prob.workspaceSize};
+    }
+
+    /**************************************************************************
+    * A resolved problem/solution pair. Entries are immutable once published *
+    **************************************************************************/
+    struct ExecCacheEntry
+    {
+        ExecCacheKey                                  key;
+        Tensile::ContractionProblemGemm               problem;
+        std::shared_ptr<Tensile::ContractionSolution> solution;
+        // the sizes problem was built for
+        size_t m;
+        size_t n;
+        size_t batch_count;
+
+        template <typename Ti, typename To, typename Tc>
+        bool same_sizes(const RocsparseltContractionProblem<Ti, To, Tc>& prob) const
+        {
+            return m == prob.m && n == prob.n && batch_count == prob.batch_count;
+        }
+    };
+
+    /**************************************************************************
+    * A part of a split problem that validateContractionProblem() checked.   *
+    **************************************************************************/
+    struct ExecSplitKey
+    {
+        ExecCacheKey key;
+        size_t       m;
+        size_t       n;
+        size_t       batch_count;
+        bool         whole_tiles;
+
+        bool operator==(const ExecSplitKey& rhs) const
+        {
+            return key == rhs.key && m == rhs.m && n == rhs.n && batch_count == rhs.batch_count
+                   && whole_tiles == rhs.whole_tiles;
+        }
+    };
+
+    /**************************************************************************
+    * The per-call inputs of a launch, i.e. what GetTensileInputs reads.     *
+    **************************************************************************/
+    enum ExecInput
+    {
+        exec_input_a,
+        exec_input_b,
+        exec_input_c,
+        exec_input_d,
+        exec_input_metadata,
+        exec_input_bias,
+        exec_input_scale_alpha_vec,
+        exec_input_ws,
+        exec_input_pointers, // the inputs before are pointers, the ones after are scalars
+        exec_input_alpha = exec_input_pointers,
+        exec_input_beta,
+        exec_input_act_arg0,
+        exec_input_act_arg1,
+        exec_input_count
+    };
+
+    struct ExecInputsKey
+    {
+        const void* pointers[exec_input_pointers];
+        double      scalars[exec_input_count - exec_input_pointers];
+
+        bool operator==(const ExecInputsKey& rhs) const
+        {
+            return std::equal(pointers, pointers + exec_input_pointers, rhs.pointers)
+                   && std::equal(scalars, scalars + exec_input_count - exec_input_pointers,
+                                 rhs.scalars);
+        }
+    };
+
+    template <typename Ti, typename To, typename Tc>
+    ExecInputsKey MakeExecInputsKey(const RocsparseltContractionProblem<Ti, To, Tc>& prob)
+    {
+        // Must follow GetTensileInputs.
+        Tc alpha = prob.k ? (prob.alpha_vector_scaling ? static_cast<Tc>(1) : *prob.alpha)
+                          : static_cast<Tc>(0);
+        return ExecInputsKey{{prob.A,
+                              prob.B,
+                              prob.C,
+                              prob.D,
+                              prob.metadata,
+                              prob.bias_vector,
+                              prob.alpha_vector_scaling ? prob.alpha : nullptr,
+                              prob.workspace},
+                             {static_cast<double>(alpha),
+                              static_cast<double>(*prob.beta),
+                              prob.act_arg0,
+                              prob.act_arg1}};
+    }
+
+    /**************************************************************************
+    * What the kernels of a launch were solved for: the problem of the plan  *
+    * at the sizes of the call, and the inputs of the call.                  *
+    **************************************************************************/
+    struct ExecLaunchKey
+    {
+        ExecCacheKey  key;
+        size_t        m;
+        size_t        n;
+        size_t        batch_count;
+        ExecInputsKey inputs;
+
+        bool operator==(const ExecLaunchKey& rhs) const
+        {
+            return key == rhs.key && m == rhs.m && n == rhs.n && batch_count == rhs.batch_count
+                   && inputs == rhs.inputs;
+        }
+    };
+
+    struct ExecLaunchKeyHash
+    {
+        size_t operator()(const ExecLaunchKey& key) const
+        {
+            size_t h       = std::hash<int>()(key.key.config_id);
+            auto   combine = [&h](size_t v) { h ^= v + 0x9e3779b97f4a7c15 + (h << 6) + (h >> 2); };
+            combine(key.key.solution_index);
+            combine(key.key.alpha_class);
+            combine(key.key.beta_class);
+            combine(key.key.workspace_size);
+            combine(key.m);
+            combine(key.n);
+            combine(key.batch_count);
+            for(auto p : key.inputs.pointers)
+                combine(std::hash<const void*>()(p));
+            for(auto v : key.inputs.scalars)
+                combine(std::hash<double>()(v));
+            return h;
+        }
+    };
+
+    /**************************************************************************
+    * The kernels solve() built for an ExecLaunchKey. A call with the same   *
+    * key launches them again without solving, so a caller alternating       *
+    * between buffers, or a dynamic-M plan going through a few M, stays free *
+    * of heap allocations. Entries are immutable once published.            *
+    **************************************************************************/
+    struct ExecLaunchEntry
+    {
+        std::vector<Tensile::KernelInvocation> kernels;
+    };
+
+    // The launches an exec cache keeps, for all its slots. Each slot of a multi-stream matmul
+    // needs one per set of buffers it alternates between.
+    constexpr size_t exec_launch_cache_capacity = 4 * rocsparselt_exec_cache_slots;
+
+    using ExecLaunchCache = rocsparselt_lru_cache<ExecLaunchKey,
+                                                  std::shared_ptr<const ExecLaunchEntry>,
+                                                  ExecLaunchKeyHash>;
+
+    /**************************************************************************
+    * Whether the performance model orders the solutions, with               *
+    * HIPSPARSELT_PERF_MODEL=1. Otherwise they keep the order of the library *
+    **************************************************************************/
+    bool PerfModelEnabled()
+    {
+        static const bool enabled = [] {
+            const char* env = getenv("HIPSPARSELT_PERF_MODEL");
+            return env && atoi(env) != 0;
+        }();
+        return enabled;
+    }
+
+    /**************************************************************************
+    * The kernel name of a solution. Building it allocates, and the          *
+    * solutions live as long as the library of their device, so the name of *
+    * each one is built once.                                                *
+    **************************************************************************/
+    const std::string& SolutionName(const Tensile::ContractionSolution& solution)
+    {
+        static std::mutex mutex;
+        static std::unordered_map<const Tensile::ContractionSolution*, std::string> names;
+
+        std::lock_guard<std::mutex> lock(mutex);
+        auto                        it = names.find(&solution);
+        if(it == names.end())
+            it = names.emplace(&solution, solution.name()).first;
+        return it->second;
+    }
+
+    /**************************************************************************
+    * The solutions of the library whose predicates accept the problem and   *
+    * the hardware, by index, for the performance model to rank. Unlike      *
+    * findTopSolutions it does not match the problem against the sizes of    *
+    * every solution of the library first.                                   *
+    **************************************************************************/
+    template <typename Library>
+    std::vector<std::shared_ptr<Tensile::ContractionSolution>>
+        ApplicableSolutions(const Library&                         library,
+                            const Tensile::ContractionProblemGemm& problem,
+                            const Tensile::Hardware&               hardware)
+    {
+        std::vector<std::shared_ptr<Tensile::ContractionSolution>> solutions;
+        for(auto& entry : library.solutions)
+        {
+            auto& solution = entry.second;
+            if((*solution->hardwarePredicate)(hardware) && (*solution->problemPredicate)(problem))
+                solutions.push_back(solution);
+        }
+        return solutions;
+    }
+
+    /**************************************************************************
+    * Orders the solutions of a problem by the performance model, so that a  *
+    * size which was not tuned starts with the solutions which were the      *
+    * fastest for the tuned sizes nearest to it. The order is kept if the    *
+    * model is not enabled or if no table of the device knows the solutions. *
+    **************************************************************************/
+    template <typename Solutions>
+    void RankSolutions(const hipDeviceProp_t&                 deviceProp,
+                       const Tensile::ContractionProblemGemm& problem,
+                       Solutions*                             solutions)
+    {
+        if(!PerfModelEnabled() || solutions->size() < 2)
+            return;
+
+        std::string arch(deviceProp.gcnArchName);
+        arch = arch.substr(0, arch.find(':'));
+
+        int64_t size[4] = {int64_t(problem.freeSizeA(0)),
+                           int64_t(problem.freeSizeB(0)),
+                           int64_t(problem.batchSize(0)),
+                           int64_t(problem.boundSize(0))};
+
+        std::vector<const std::string*> names;
+        names.reserve(solutions->size());
+        for(auto& solution : *solutions)
+            names.push_back(&SolutionName(*solution));
+
+        std::vector<size_t> order;
+        if(!rocsparselt_perf_model_rank(arch, size, names, &order))
+            return;
+
+        Solutions ranked;
+        ranked.reserve(order.size());
+        for(auto i : order)
+            ranked.push_back((*solutions)[i]);
+        solutions->swap(ranked);
+    }
+
+    /**************************************************************************
+    * What getBestSolutions reads of a RocsparseltContractionProblem, i.e.   *
+    * everything ConstructTensileProblem builds the Tensile problem from.    *
+    **************************************************************************/
+    struct SolutionCacheKey
+    {
+        int                         device;
+        int                         types[3]; // Tensile types of Ti, To and Tc
+        rocsparselt_operation       trans_a;
+        rocsparselt_operation       trans_b;
+        rocsparselt_order           order;
+        size_t                      m;
+        size_t                      n;
+        size_t                      k;
+        size_t                      batch_count;
+        size_t                      strides[12]; // row, col and batch of a, b, c and d
+        bool                        strided_batch;
+        bool                        sparse_a;
+        bool                        c_equals_d;
+        int                         alpha_class;
+        int                         beta_class;
+        hipsparselt_activation_type act_type;
+        bool                        act_arg0_one;
+        bool                        bias;
+        hipDataType                 bias_type;
+        int64_t                     bias_stride;
+        bool                        alpha_vector_scaling;
+        size_t                      workspace_size;
+
+        bool operator==(const SolutionCacheKey& rhs) const
+        {
+            return device == rhs.device && std::equal(types, types + 3, rhs.types)
+                   && trans_a == rhs.trans_a && trans_b == rhs.trans_b && order == rhs.order
+                   && m == rhs.m && n == rhs.n && k == rhs.k && batch_count == rhs.batch_count
+                   && std::equal(strides, strides + 12, rhs.strides)
+                   && strided_batch == rhs.strided_batch && sparse_a == rhs.sparse_a
+                   && c_equals_d == rhs.c_equals_d && alpha_class == rhs.alpha_class
+                   && beta_class == rhs.beta_class && act_type == rhs.act_type
+                   && act_arg0_one == rhs.act_arg0_one && bias == rhs.bias
+                   && bias_type == rhs.bias_type && bias_stride == rhs.bias_stride
+                   && alpha_vector_scaling == rhs.alpha_vector_scaling
+                   && workspace_size == rhs.workspace_size;
+        }
+    };
+
+    struct SolutionCacheKeyHash
+    {
+        size_t operator()(const SolutionCacheKey& key) const
+        {
+            size_t h       = std::hash<int>()(key.device);
+            auto   combine = [&h](size_t v) { h ^= v + 0x9e3779b97f4a7c15 + (h << 6) + (h >> 2); };
+            for(auto t : key.types)
+                combine(t);
+            combine(key.trans_a);
+            combine(key.trans_b);
+            combine(key.order);
+            combine(key.m);
+            combine(key.n);
+            combine(key.k);
+            combine(key.batch_count);
+            for(auto s : key.strides)
+                combine(s);
+            combine(key.sparse_a);
+            combine(key.bias);
+            combine(key.alpha_vector_scaling);
+            combine(size_t(key.act_type));
+            return h;
+        }
+    };
+
+    template <typename Ti, typename To, typename Tc>
+    SolutionCacheKey MakeSolutionCacheKey(const RocsparseltContractionProblem<Ti, To, Tc>& prob)
+    {
+        // Must follow the alpha/beta handling of ConstructTensileProblem.
+        Tc alpha = prob.k ? (prob.alpha_vector_scaling ? static_cast<Tc>(1) : *prob.alpha)
+                          : static_cast<Tc>(0);
+        return SolutionCacheKey{
+            prob.handle->device,
+            {int(tensile_datatype<Ti>), int(tensile_datatype<To>), int(tensile_datatype<Tc>)},
+            prob.trans_a,
+            prob.trans_b,
+            prob.order,
+            prob.m,
+            prob.n,
+            prob.k && (prob.alpha_vector_scaling || *prob.alpha) ? prob.k : 0,
+            prob.batch_count,
+            {prob.row_stride_a,
+             prob.col_stride_a,
+             prob.batch_stride_a,
+             prob.row_stride_b,
+             prob.col_stride_b,
+             prob.batch_stride_b,
+             prob.row_stride_c,
+             prob.col_stride_c,
+             prob.batch_stride_c,
+             prob.row_stride_d,
+             prob.col_stride_d,
+             prob.batch_stride_d},
+            prob.strided_batch,
+            prob.sparseA,
+            prob.C == prob.D,
+            scalar_class(alpha),
+            scalar_class(*prob.beta),
+            prob.act_type,
+            prob.act_arg0 == 1.f,
+            prob.bias_vector != nullptr,
+            prob.bias_type,
+            prob.bias_stride,
+            prob.alpha_vector_scaling,
+            prob.workspaceSize};
+    }
+
+    /**************************************************************************
+    * The configs getBestSolutions found for the problems of the process,    *
+    * so that the alg selections of a problem which was seen before do not   *
+    * search the library again. HIPSPARSELT_SOLUTION_CACHE_SIZE sets how     *
+    * many problems it keeps (1024 by default), 0 disables it. complete is   *
+    * false if the search stopped at the number of configs it was asked for. *
+    **************************************************************************/
+    struct SolutionCacheValue
+    {
+        std::vector<_rocsparselt_matmul_config> configs;
+        bool                                    complete = false;
+    };
+
+    using SolutionCache
+        = rocsparselt_lru_cache<SolutionCacheKey, SolutionCacheValue, SolutionCacheKeyHash>;
+
+    SolutionCache& solution_cache()
+    {
+        static SolutionCache cache([] {
+            const char* env = getenv("HIPSPARSELT_SOLUTION_CACHE_SIZE");
+            return env && *env ? size_t(strtoull(env, nullptr, 10)) : size_t(1024);
+        }());
+        return cache;
+    }
+
 } // namespace
 
+/******************************************************************************
+ * _rocsparselt_matmul_exec_cache keeps the Tensile objects of a plan, so that *
+ * a steady-state rocsparselt_matmul() does not rebuild the problem, query the *
+ * hardware or look the solution up again.                                    *
+ ******************************************************************************/
+struct _rocsparselt_matmul_exec_cache
+{
+    explicit _rocsparselt_matmul_exec_cache(int device)
+    {
+        std::shared_ptr<hipDeviceProp_t> deviceProp;
+        adapter  = &get_library_and_adapter(&library, &deviceProp, device, &lazy_objects);
+        hardware = Tensile::hip::GetDevice(*deviceProp);
+    }
+
+    std::shared_ptr<const ExecCacheEntry> load(int slot) const
+    {
+        return std::atomic_load(&entry[slot]);
+    }
+
+    void store(int slot, std::shared_ptr<const ExecCacheEntry> e)
+    {
+        std::atomic_store(&entry[slot], std::move(e));
+    }
+
+    std::shared_ptr<Tensile::MasterSolutionLibrary<Tensile::ContractionProblemGemm>> library;
+    std::shared_ptr<Tensile::Hardware>                                               hardware;
+    Tensile::hip::SolutionAdapter*                                                   adapter;
+    LazyCodeObjects*                                                                 lazy_objects;
+
+    ExecLaunchCache launches{exec_launch_cache_capacity};
+    // the last part validateContractionProblem() checked on a slot, under split_mutex
+    std::mutex                  split_mutex;
+    std::optional<ExecSplitKey> split[rocsparselt_exec_cache_slots];
+    bool                        split_valid[rocsparselt_exec_cache_slots] = {};
+
+private:
+    // accessed with std::atomic_load/store, a plan may be shared between threads
+    std::shared_ptr<const ExecCacheEntry> entry[rocsparselt_exec_cache_slots];
+};
+
+_rocsparselt_matmul_exec_cache*
+    rocsparselt_internal_exec_cache_create(const _rocsparselt_handle* handle)
+{
+    return new _rocsparselt_matmul_exec_cache(handle->device);
+}
+
+void rocsparselt_internal_exec_cache_destroy(_rocsparselt_matmul_exec_cache* cache)
+{
+    delete cache;
+}
+
 /******************************************************************************
  * runContractionProblem calls Tensile to run a contraction problem described *
  * by RocsparseltContractionProblem                                               *
@@ -768,21 +1451,28 @@ template <typename Ti, typename To, typename Tc>
 rocsparselt_status runContractionProblem(const RocsparseltContractionProblem<Ti, To, Tc>& prob,
                                          _rocsparselt_matmul_config*                      configs,
                                          int*                                             config_id,
-                                         const int config_max_id,
-                                         const int search_iterations)
+                                         const int                         config_max_id,
+                                         const int                         search_iterations,
+                                         const rocsparselt_search_options* search_options,
+                                         _rocsparselt_matmul_exec_cache*   exec_cache,
+                                         int                               exec_slot)
 {
     rocsparselt_status                            status = rocsparselt_status_internal_error;
     std::shared_ptr<Tensile::ContractionSolution> solution;
 
     try
     {
-        std::shared_ptr<Tensile::MasterSolutionLibrary<Tensile::ContractionProblemGemm>> library;
-        std::shared_ptr<hipDeviceProp_t>                                                 deviceProp;
-        std::shared_ptr<Tensile::Hardware>                                               hardware;
-
-        auto& adapter = get_library_and_adapter(&library, &deviceProp, prob.handle->device);
+        // A plan always owns a cache, fall back on a temporary one otherwise.
+        std::unique_ptr<_rocsparselt_matmul_exec_cache> local_cache;
+        if(exec_cache == nullptr)
+        {
+            local_cache.reset(new _rocsparselt_matmul_exec_cache(prob.handle->device));
+            exec_cache = local_cache.get();
+        }
 
-        hardware = Tensile::hip::GetDevice(*deviceProp);
+        auto& library  = exec_cache->library;
+        auto& hardware = exec_cache->hardware;
+        auto& adapter  = *exec_cache->adapter;
 
         if(!config_max_id || configs == nullptr)
         {
@@ -790,6 +1480,73 @@ rocsparselt_status runContractionProblem(const RocsparseltContractionProblem<Ti,
             print_once(msg << "\nhipsparselt_error: No Tensile solution found for " << prob);
             status = rocsparselt_status_not_implemented;
         }
+        else if(!search_iterations)
+        {
+            if(configs[*config_id].max_workspace_bytes > prob.workspaceSize
+               || (configs[*config_id].max_workspace_bytes > 0 && prob.workspace == nullptr))
+            {
+                hipsparselt_cerr << "config " << *config_id << " need extra workspace "
+                                 << configs[*config_id].max_workspace_bytes << " bytes - skip."
+                                 << std::endl;
+                return rocsparselt_status_internal_error;
+            }
+
+            // The first launch of the process includes solving the problem
+            rocsparselt_startup_timer first_launch(rocsparselt_startup_first_launch, true);
+
+            auto          key = MakeExecCacheKey(prob, configs[*config_id], *config_id);
+            ExecLaunchKey launch_key{
+                key, prob.m, prob.n, prob.batch_count, MakeExecInputsKey(prob)};
+
+            std::shared_ptr<const ExecLaunchEntry> launch;
+            if(!exec_cache->launches.get(launch_key, &launch))
+            {
+                auto entry = exec_cache->load(exec_slot);
+                if(!entry || !(entry->key == key) || !entry->same_sizes(prob))
+                {
+                    const auto& config       = configs[*config_id];
+                    auto        tensile_prob = ConstructTensileProblem(
+                        prob, config.use_bias, config.use_scale_alpha_vec);
+
+                    // The sizes are checked against the predicates of the solution again, a
+                    // solution whose code object is loaded is not loaded twice.
+                    solution = library->getSolutionByIndex(tensile_prob, *hardware, config.index);
+                    if(!solution)
+                    {
+                        hipsparselt_cerr << "Solution of config:" << *config_id
+                                         << " does not exists - skip" << std::endl;
+                        return rocsparselt_status_not_implemented;
+                    }
+                    if(!entry || entry->solution != solution)
+                        RETURN_IF_HIP_ERROR(exec_cache->lazy_objects->load(adapter, *solution));
+
+                    entry = std::make_shared<const ExecCacheEntry>(ExecCacheEntry{
+                        key, std::move(tensile_prob), solution, prob.m, prob.n, prob.batch_count});
+                    exec_cache->store(exec_slot, entry);
+                }
+                solution = entry->solution;
+
+                launch = std::make_shared<const ExecLaunchEntry>(ExecLaunchEntry{
+                    solution->solve(entry->problem, GetTensileInputs(prob), *hardware)});
+                exec_cache->launches.put(launch_key, launch);
+            }
+
+            if(auto sink = rocsparselt_internal_launch_sink())
+            {
+                for(auto& kernel : launch->kernels)
+                {
+                    auto bytes = static_cast<const uint8_t*>(kernel.args.data());
+                    sink->kernel_args.emplace_back(bytes, bytes + kernel.args.size());
+                }
+            }
+            else
+                RETURN_IF_HIP_ERROR(
+                    adapter.launchKernels(launch->kernels, prob.streams[0], nullptr, nullptr));
+            if(first_launch.stop())
+                log_startup_summary("runContractionProblem");
+
+            status = rocsparselt_status_success;
+        }
         else
         {
             auto tensile_prob = ConstructTensileProblem(
@@ -797,90 +1554,79 @@ rocsparselt_status runContractionProblem(const RocsparseltContractionProblem<Ti,
 
             auto tensile_inputs = GetTensileInputs(prob);
 
-            if(!search_iterations)
+            // The kernels of each candidate are solved once, the search only launches them.
+            std::vector<int>                                           candidates;
+            std::vector<std::shared_ptr<Tensile::ContractionSolution>> solutions;
+            std::vector<std::vector<Tensile::KernelInvocation>>        kernels;
+            for(int id = 0; id < config_max_id; id++)
             {
-                if(configs[*config_id].max_workspace_bytes > prob.workspaceSize
-                   || (configs[*config_id].max_workspace_bytes > 0 && prob.workspace == nullptr))
+                if(configs[id].max_workspace_bytes > prob.workspaceSize
+                   || (configs[id].max_workspace_bytes > 0 && prob.workspace == nullptr))
                 {
-                    hipsparselt_cerr << "config " << *config_id << " need extra workspace "
-                                     << configs[*config_id].max_workspace_bytes << " bytes - skip."
+                    hipsparselt_cerr << "config " << id << " need extra workspace "
+                                     << configs[id].max_workspace_bytes << " bytes - skip."
                                      << std::endl;
-                    return rocsparselt_status_internal_error;
+                    continue;
                 }
 
-                solution = library->getSolutionByIndex(
-                    tensile_prob, *hardware, configs[*config_id].index);
+                solution = library->getSolutionByIndex(tensile_prob, *hardware, configs[id].index);
                 if(!solution)
                 {
-                    hipsparselt_cerr << "Solution of config:" << *config_id
-                                     << " does not exists - skip" << std::endl;
-                    return rocsparselt_status_not_implemented;
+                    hipsparselt_cerr << "Solution of config:" << id << " does not exists - skip"
+                                     << std::endl;
+                    continue;
                 }
-
-                RETURN_IF_HIP_ERROR(
-                    adapter.launchKernels(solution->solve(tensile_prob, tensile_inputs, *hardware),
-                                          prob.streams[0],
-                                          nullptr,
-                                          nullptr));
+                // Load before the search, so that it is not timed with the first launch
+                if(exec_cache->lazy_objects->load(adapter, *solution) != hipSuccess)
+                    continue;
+                candidates.push_back(id);
+                solutions.push_back(solution);
+                kernels.push_back(solution->solve(tensile_prob, tensile_inputs, *hardware));
             }
-            else
+            if(candidates.empty())
+                return rocsparselt_status_internal_error;
+
+            auto launch = [&](int i, hipEvent_t start, hipEvent_t stop, int iters) {
+                hipError_t err = start ? hipEventRecord(start, prob.streams[0]) : hipSuccess;
+                for(int iter = 0; iter < iters && err == hipSuccess; iter++)
+                    err = adapter.launchKernels(kernels[i], prob.streams[0], nullptr, nullptr);
+                if(err == hipSuccess && stop)
+                    err = hipEventRecord(stop, prob.streams[0]);
+                return err;
+            };
+
+            std::vector<rocsparselt_matmul_search_result> results;
+            int                                           best;
+            RETURN_IF_ROCSPARSELT_ERROR(
+                rocsparselt_search_candidates(candidates.size(),
+                                              search_iterations,
+                                              search_options ? *search_options
+                                                             : rocsparselt_search_options(),
+                                              launch,
+                                              &results,
+                                              &best));
+            for(int id = 0; id < config_max_id; id++)
+                configs[id].search = rocsparselt_matmul_search_result();
+            for(size_t i = 0; i < candidates.size(); i++)
+                configs[candidates[i]].search = results[i];
+
+            *config_id         = candidates[best];
+            auto best_solution = solutions[best];
+
+            // The winner is what the following rocsparselt_matmul() calls will run,
+            // publish it so that they do not have to resolve it again.
+            if(configs[*config_id].use_bias == tensile_prob.useBias()
+               && configs[*config_id].use_scale_alpha_vec == tensile_prob.useScaleAlphaVec())
             {
-                float      min_ms = std::numeric_limits<float>::max();
-                hipEvent_t startEvent, stopEvent;
-                float      ms, sum_ms;
-                RETURN_IF_HIP_ERROR(hipEventCreate(&startEvent));
-                RETURN_IF_HIP_ERROR(hipEventCreate(&stopEvent));
-                for(int id = 0; id < config_max_id; id++)
-                {
-                    if(configs[id].max_workspace_bytes > prob.workspaceSize
-                       || (configs[id].max_workspace_bytes > 0 && prob.workspace == nullptr))
-                    {
-                        hipsparselt_cerr << "config " << id << " need extra workspace "
-                                         << configs[id].max_workspace_bytes << " bytes - skip."
-                                         << std::endl;
-                        continue;
-                    }
-
-                    solution
-                        = library->getSolutionByIndex(tensile_prob, *hardware, configs[id].index);
-                    if(!solution)
-                    {
-                        hipsparselt_cerr << "Solution of config:" << id << " does not exists - skip"
-                                         << std::endl;
-                        continue;
-                    }
-
-                    //warm up
-                    RETURN_IF_HIP_ERROR(adapter.launchKernels(
-                        solution->solve(tensile_prob, tensile_inputs, *hardware),
-                        prob.streams[0],
-                        nullptr,
-                        nullptr));
-
-                    sum_ms = 0.0f;
-                    for(int i = 0; i < search_iterations; i++)
-                    {
-                        RETURN_IF_HIP_ERROR(adapter.launchKernels(
-                            solution->solve(tensile_prob, tensile_inputs, *hardware),
-                            prob.streams[0],
-                            startEvent,
-                            stopEvent));
-                        RETURN_IF_HIP_ERROR(hipEventSynchronize(stopEvent));
-                        RETURN_IF_HIP_ERROR(hipEventElapsedTime(&ms, startEvent, stopEvent));
-                        sum_ms += ms;
-                    }
-
-                    if(sum_ms < min_ms)
-                    {
-                        min_ms     = sum_ms;
-                        *config_id = id;
-                    }
-                }
-                RETURN_IF_HIP_ERROR(hipEventDestroy(startEvent));
-                RETURN_IF_HIP_ERROR(hipEventDestroy(stopEvent));
-
-                if(min_ms == std::numeric_limits<float>::max())
-                    return rocsparselt_status_internal_error;
+                auto key = MakeExecCacheKey(prob, configs[*config_id], *config_id);
+                exec_cache->store(exec_slot,
+                                  std::make_shared<const ExecCacheEntry>(
+                                      ExecCacheEntry{key,
+                                                     std::move(tensile_prob),
+                                                     best_solution,
+                                                     prob.m,
+                                                     prob.n,
+                                                     prob.batch_count}));
             }
 
             status = rocsparselt_status_success;
@@ -902,16 +1648,83 @@ rocsparselt_status runContractionProblem(const RocsparseltContractionProblem<Ti,
     return status;
 }
 
+/******************************************************************************
+ * validateContractionProblem checks that the selected config runs a part of  *
+ * a problem split across streams: the solution must accept the sizes of the  *
+ * part, its workspace must fit the slice of the part, and with whole_tiles   *
+ * the N of the part must be a multiple of the macro tile. The result is kept *
+ * per slot, the steady state does not build the Tensile problem again.       *
+ ******************************************************************************/
+template <typename Ti, typename To, typename Tc>
+bool validateContractionProblem(const RocsparseltContractionProblem<Ti, To, Tc>& prob,
+                                const _rocsparselt_matmul_config*                configs,
+                                int                                              config_id,
+                                _rocsparselt_matmul_exec_cache*                  exec_cache,
+                                int                                              exec_slot,
+                                bool                                             whole_tiles)
+{
+    const auto& config = configs[config_id];
+    if(config.max_workspace_bytes > prob.workspaceSize
+       || (config.max_workspace_bytes > 0 && prob.workspace == nullptr
+           && prob.handle->workspace_pool == nullptr))
+        return false;
+
+    ExecSplitKey key{MakeExecCacheKey(prob, config, config_id),
+                     prob.m,
+                     prob.n,
+                     prob.batch_count,
+                     whole_tiles};
+
+    std::lock_guard<std::mutex> lock(exec_cache->split_mutex);
+    if(exec_cache->split[exec_slot] && *exec_cache->split[exec_slot] == key)
+        return exec_cache->split_valid[exec_slot];
+
+    bool valid = false;
+    try
+    {
+        auto tensile_prob
+            = ConstructTensileProblem(prob, config.use_bias, config.use_scale_alpha_vec);
+        auto solution = exec_cache->library->getSolutionByIndex(
+            tensile_prob, *exec_cache->hardware, config.index);
+        valid = solution && (*solution->problemPredicate)(tensile_prob)
+                && (!whole_tiles || prob.n % std::max(solution->sizeMapping.macroTile.y, 1u) == 0);
+    }
+    catch(...)
+    {
+        valid = false;
+    }
+
+    exec_cache->split[exec_slot]       = key;
+    exec_cache->split_valid[exec_slot] = valid;
+    return valid;
+}
+
 /******************************************************************************
  * getBestSolutions calls Tensile's findTopSolutions and converts to          *
- * _rocsparselt_matmul_config.                                                *
+ * _rocsparselt_matmul_config. requestConfigs 0 asks for all solutions which  *
+ * apply to the problem. The configs are kept in the solution cache.          *
  ******************************************************************************/
 template <typename Ti, typename To, typename Tc>
 rocsparselt_status getBestSolutions(const RocsparseltContractionProblem<Ti, To, Tc>& prob,
                                     int                                              requestConfigs,
-                                    _rocsparselt_matmul_config*                      configs,
-                                    int*                                             foundConfigs)
+                                    std::vector<_rocsparselt_matmul_config>*         configs)
 {
+    // A problem which was seen before gets the configs, and the bias and scale
+    // alpha vector modes of the alternative solutions, which were found for it,
+    // unless fewer were searched than are asked for now.
+    auto&              cache = solution_cache();
+    auto               key   = MakeSolutionCacheKey(prob);
+    SolutionCacheValue cached;
+    if(cache.get(key, &cached)
+       && (cached.complete
+           || (requestConfigs > 0 && cached.configs.size() >= size_t(requestConfigs))))
+    {
+        *configs = std::move(cached.configs);
+        if(requestConfigs > 0 && configs->size() > size_t(requestConfigs))
+            configs->resize(requestConfigs);
+        return rocsparselt_status_success;
+    }
+
     std::shared_ptr<Tensile::MasterSolutionLibrary<Tensile::ContractionProblemGemm>> library;
     std::shared_ptr<hipDeviceProp_t>                                                 deviceProp;
     std::shared_ptr<Tensile::Hardware>                                               hardware;
@@ -921,19 +1734,38 @@ rocsparselt_status getBestSolutions(const RocsparseltContractionProblem<Ti, To,
 
     hardware          = Tensile::hip::GetDevice(*deviceProp);
     auto tensile_prob = ConstructTensileProblem(prob);
+    // No problem has more applicable solutions than the library has. Only the
+    // requested ones are searched, unless the performance model has to rank
+    // all the applicable ones first.
+    int allConfigs = std::max<int>(library->solutions.size(), 1);
+    if(requestConfigs <= 0)
+        requestConfigs = allConfigs;
+    int  searchConfigs = PerfModelEnabled() ? allConfigs : std::min(requestConfigs, allConfigs);
+    auto findSolutions = [&]() {
+        if(PerfModelEnabled())
+        {
+            auto solutions = ApplicableSolutions(*library, tensile_prob, *hardware);
+            RankSolutions(*deviceProp, tensile_prob, &solutions);
+            return solutions;
+        }
+        return library->findTopSolutions(tensile_prob, *hardware, searchConfigs);
+    };
     // auto handle = prob.handle;
-    auto solutions = library->findTopSolutions(tensile_prob, *hardware, requestConfigs);
+    rocsparselt_startup_timer first_query(rocsparselt_startup_first_solution_query, true);
 
-    *foundConfigs = std::min((int)solutions.size(), requestConfigs);
+    auto solutions = findSolutions();
+    first_query.stop();
+
+    int foundConfigs = std::min((int)solutions.size(), searchConfigs);
 
     // Finding alternative solutions.
     auto findAlternativeSolution = [&](int useBias, int useScaleAlphaVec) {
-        tensile_prob  = ConstructTensileProblem(prob, useBias, useScaleAlphaVec);
-        solutions     = library->findTopSolutions(tensile_prob, *hardware, requestConfigs);
-        *foundConfigs = std::min((int)solutions.size(), requestConfigs);
+        tensile_prob = ConstructTensileProblem(prob, useBias, useScaleAlphaVec);
+        solutions    = findSolutions();
+        foundConfigs = std::min((int)solutions.size(), searchConfigs);
     };
 
-    if(*foundConfigs == 0)
+    if(foundConfigs == 0)
     {
         log_info(prob.handle, __func__, "No solution founds, try to find alternative solutions");
 
@@ -950,37 +1782,70 @@ rocsparselt_status getBestSolutions(const RocsparseltContractionProblem<Ti, To,
                     continue; // already try in the first time.
 
                 findAlternativeSolution(useBias, useScaleAlphaVec);
-                if(*foundConfigs != 0)
+                if(foundConfigs != 0)
                     break;
             }
-            if(*foundConfigs != 0)
+            if(foundConfigs != 0)
                 break;
         }
 
-        if(*foundConfigs != 0)
+        if(foundConfigs != 0)
         {
-            log_info(prob.handle, __func__, *foundConfigs, " alternative solutions found");
+            log_info(prob.handle, __func__, foundConfigs, " alternative solutions found");
         }
     }
 
-    for(size_t i = 0; i < *foundConfigs; i++)
+    configs->resize(foundConfigs);
+    for(size_t i = 0; i < foundConfigs; i++)
     {
-        auto solution                  = solutions[i];
-        configs[i].index               = solution->index;
-        configs[i].max_workspace_bytes = solution->requiredWorkspaceSize(tensile_prob, *hardware);
-        configs[i].use_bias            = tensile_prob.useBias();
-        configs[i].use_scale_alpha_vec = tensile_prob.useScaleAlphaVec();
+        auto  solution             = solutions[i];
+        auto& config               = (*configs)[i];
+        config.index               = solution->index;
+        config.max_workspace_bytes = solution->requiredWorkspaceSize(tensile_prob, *hardware);
+        config.use_bias            = tensile_prob.useBias();
+        config.use_scale_alpha_vec = tensile_prob.useScaleAlphaVec();
+        SetSplitK(*solution, &config);
     }
+
+    // Fewer solutions than were searched for are all the applicable ones.
+    bool complete = foundConfigs < searchConfigs || searchConfigs == allConfigs;
+    cache.put(key, SolutionCacheValue{*configs, complete});
+    if(configs->size() > size_t(requestConfigs))
+        configs->resize(requestConfigs);
     return rocsparselt_status_success;
 }
 
 /***************************************************************
- * ! \brief  Initialize rocsparselt for the current HIP device, to *
- * avoid costly startup time at the first call on that device. *
+ * ! \brief  Initialize rocsparselt for all the visible devices, *
+ * to avoid costly startup time at the first call on a device.  *
  ***************************************************************/
 extern "C" void rocsparselt_initialize()
 {
-    get_library_and_adapter();
+    // The devices are initialized at once, each on a thread of its own
+    auto start = std::chrono::steady_clock::now();
+    int  count = TensileHost::GetDeviceCount();
+    rocsparselt_parallel_for(count, count, [](size_t device) {
+        int current;
+        if(hipGetDevice(&current) != hipSuccess || hipSetDevice(device) != hipSuccess)
+            return;
+        get_library_and_adapter(nullptr, nullptr, device);
+        (void)hipSetDevice(current);
+    });
+    log_process(rocsparselt_layer_mode_log_info,
+                "rocsparselt_initialize",
+                "devices",
+                count,
+                "ms",
+                TensileHost::ElapsedMs(start));
+}
+
+/***************************************************************************
+ * ! \brief  Whether the code objects are loaded on first use, or all of    *
+ * them up front. It takes effect if called before the first initialization *
+ ***************************************************************************/
+extern "C" void rocsparselt_set_lazy_loading(int enable)
+{
+    rocsparselt_internal_lazy_loading() = enable != 0;
 }
 
 /***********************************************************************************
@@ -1003,9 +1868,21 @@ std::atomic_bool& rocsparselt_internal_tensile_is_initialized()
         _rocsparselt_matmul_config*,                               \
         int*,                                                      \
         const int,                                                 \
-        const int);                                                \
+        const int,                                                 \
+        const rocsparselt_search_options*,                         \
+        _rocsparselt_matmul_exec_cache*,                           \
+        int);                                                      \
+    template bool validateContractionProblem<Ti, To, Tc>(          \
+        const RocsparseltContractionProblem<Ti, To, Tc>&,          \
+        const _rocsparselt_matmul_config*,                         \
+        int,                                                       \
+        _rocsparselt_matmul_exec_cache*,                           \
+        int,                                                       \
+        bool);                                                     \
     template rocsparselt_status getBestSolutions<Ti, To, Tc>(      \
-        const RocsparseltContractionProblem<Ti, To, Tc>&, int, _rocsparselt_matmul_config*, int*);
+        const RocsparseltContractionProblem<Ti, To, Tc>&,          \
+        int,                                                       \
+        std::vector<_rocsparselt_matmul_config>*);
 
 GENERATE_DEFINITIONS(__half, __half, float)
 GENERATE_DEFINITIONS(hip_bfloat16, hip_bfloat16, float)
@@ -0,0 +1,259 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+
+#include "tuning_db.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <map>
+#include <memory>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+void rocsparselt_tuning_key_clear(rocsparselt_tuning_key* key)
+{
+    memset(key, 0, sizeof(*key));
+}
+
+bool operator<(const rocsparselt_tuning_key& lhs, const rocsparselt_tuning_key& rhs)
+{
+    return memcmp(&lhs, &rhs, sizeof(rocsparselt_tuning_key)) < 0;
+}
+
+bool operator==(const rocsparselt_tuning_key& lhs, const rocsparselt_tuning_key& rhs)
+{
+    return memcmp(&lhs, &rhs, sizeof(rocsparselt_tuning_key)) == 0;
+}
+
+static bool entry_less(const rocsparselt_tuning_entry& lhs, const rocsparselt_tuning_entry& rhs)
+{
+    return lhs.key < rhs.key;
+}
+
+rocsparselt_tuning_db::rocsparselt_tuning_db(std::string path)
+    : db_path(std::move(path))
+{
+}
+
+rocsparselt_tuning_db::~rocsparselt_tuning_db()
+{
+    unmap();
+}
+
+void rocsparselt_tuning_db::unmap()
+{
+    if(map != nullptr)
+        munmap(const_cast<void*>(map), map_size);
+    map      = nullptr;
+    map_size = 0;
+    map_dev  = 0;
+    map_ino  = 0;
+}
+
+const rocsparselt_tuning_entry* rocsparselt_tuning_db::begin() const
+{
+    if(map == nullptr)
+        return nullptr;
+    return reinterpret_cast<const rocsparselt_tuning_entry*>(
+        static_cast<const char*>(map) + sizeof(rocsparselt_tuning_db_header));
+}
+
+const rocsparselt_tuning_entry* rocsparselt_tuning_db::end() const
+{
+    if(map == nullptr)
+        return nullptr;
+    return begin() + static_cast<const rocsparselt_tuning_db_header*>(map)->count;
+}
+
+void rocsparselt_tuning_db::refresh()
+{
+    // Writers replace the file, they never change it in place, so a file with the
+    // same inode and modification time is the one already mapped.
+    struct stat st;
+    if(stat(db_path.c_str(), &st) != 0)
+    {
+        unmap();
+        return;
+    }
+    if(map != nullptr && st.st_dev == map_dev && st.st_ino == map_ino
+       && st.st_mtim.tv_sec == map_mtime.tv_sec && st.st_mtim.tv_nsec == map_mtime.tv_nsec)
+        return;
+    unmap();
+
+    if(st.st_size < (off_t)sizeof(rocsparselt_tuning_db_header))
+        return;
+
+    int fd = open(db_path.c_str(), O_RDONLY | O_CLOEXEC);
+    if(fd < 0)
+        return;
+    void* addr = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if(addr == MAP_FAILED)
+        return;
+
+    // A file which is not a tuning database of this format is treated as empty,
+    // the next update replaces it.
+    auto header = static_cast<const rocsparselt_tuning_db_header*>(addr);
+    if(memcmp(header->magic, rocsparselt_tuning_db_magic, sizeof(header->magic)) != 0
+       || header->format != rocsparselt_tuning_db_format
+       || header->entry_size != sizeof(rocsparselt_tuning_entry)
+       || (uint64_t)st.st_size
+              != sizeof(rocsparselt_tuning_db_header)
+                     + header->count * sizeof(rocsparselt_tuning_entry))
+    {
+        munmap(addr, st.st_size);
+        return;
+    }
+
+    map       = addr;
+    map_size  = st.st_size;
+    map_dev   = st.st_dev;
+    map_ino   = st.st_ino;
+    map_mtime = st.st_mtim;
+}
+
+bool rocsparselt_tuning_db::lookup(const rocsparselt_tuning_key& key,
+                                   rocsparselt_tuning_entry*     entry)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    refresh();
+
+    rocsparselt_tuning_entry probe;
+    probe.key = key;
+    auto it   = std::lower_bound(begin(), end(), probe, entry_less);
+    if(it == end() || !(it->key == key))
+        return false;
+    *entry = *it;
+    return true;
+}
+
+bool rocsparselt_tuning_db::read(std::vector<rocsparselt_tuning_entry>* entries)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    refresh();
+    entries->assign(begin(), end());
+    return map != nullptr;
+}
+
+static bool write_all(int fd, const void* data, size_t size)
+{
+    auto bytes = static_cast<const char*>(data);
+    while(size > 0)
+    {
+        ssize_t written = write(fd, bytes, size);
+        if(written < 0 && errno == EINTR)
+            continue;
+        if(written <= 0)
+            return false;
+        bytes += written;
+        size -= written;
+    }
+    return true;
+}
+
+bool rocsparselt_tuning_db::update(const rocsparselt_tuning_entry* entries, size_t count)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    // Writers of all processes take turns, readers never wait.
+    std::string lock_path = db_path + ".lock";
+    int         lock_fd   = open(lock_path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0666);
+    if(lock_fd < 0)
+        return false;
+    while(flock(lock_fd, LOCK_EX) != 0)
+    {
+        if(errno != EINTR)
+        {
+            close(lock_fd);
+            return false;
+        }
+    }
+
+    // Merge into the entries of the file as it is now, another process may have
+    // replaced it since it was mapped.
+    refresh();
+    std::vector<rocsparselt_tuning_entry> merged(begin(), end());
+    for(size_t i = 0; i < count; i++)
+    {
+        auto it = std::lower_bound(merged.begin(), merged.end(), entries[i], entry_less);
+        if(it != merged.end() && it->key == entries[i].key)
+            *it = entries[i];
+        else
+            merged.insert(it, entries[i]);
+    }
+
+    rocsparselt_tuning_db_header header;
+    memcpy(header.magic, rocsparselt_tuning_db_magic, sizeof(header.magic));
+    header.format     = rocsparselt_tuning_db_format;
+    header.entry_size = sizeof(rocsparselt_tuning_entry);
+    header.count      = merged.size();
+
+    std::string tmp_path = db_path + ".XXXXXX";
+    int         fd       = mkstemp(&tmp_path[0]);
+    bool        ok       = fd >= 0;
+    if(ok)
+    {
+        ok = fchmod(fd, 0644) == 0 && write_all(fd, &header, sizeof(header))
+             && write_all(fd, merged.data(), merged.size() * sizeof(rocsparselt_tuning_entry))
+             && fsync(fd) == 0;
+        ok = close(fd) == 0 && ok;
+        ok = ok && rename(tmp_path.c_str(), db_path.c_str()) == 0;
+        if(!ok)
+        {
+            int err = errno;
+            unlink(tmp_path.c_str());
+            errno = err;
+        }
+    }
+
+    int err = errno;
+    flock(lock_fd, LOCK_UN);
+    close(lock_fd);
+    errno = err;
+    return ok;
+}
+
+rocsparselt_tuning_db* rocsparselt_internal_tuning_db()
+{
+    const char* path = getenv("HIPSPARSELT_TUNING_DB");
+    if(path == nullptr || *path == '\0')
+        return nullptr;
+
+    // One object per file, it keeps its mapping between the calls.
+    static std::mutex                                                   mutex;
+    static std::map<std::string, std::unique_ptr<rocsparselt_tuning_db>> dbs;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto&                       db = dbs[path];
+    if(!db)
+        db = std::make_unique<rocsparselt_tuning_db>(path);
+    return db.get();
+}
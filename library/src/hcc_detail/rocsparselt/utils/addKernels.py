@@ -36,9 +36,6 @@ class KernelArguments:
     ComputeDataType = 0
     TransposeA = False
     TransposeB = False
-    WorkGroup = [1, 1, 1]
-    ThreadTile = [1, 1, 1]
-    MacroTile = [1, 1, 0]
     StaggerU = 0
     DepthU = 32
     GlobalSplitU = 0
@@ -53,32 +50,24 @@ class KernelArguments:
     ActivationHPA = False
     ActivationType = ""
 
+    def __init__(self):
+        # The lists are set item by item, each kernel needs its own
+        self.WorkGroup = [1, 1, 1]
+        self.ThreadTile = [1, 1, 1]
+        self.MacroTile = [1, 1, 0]
+
+def category_key(ka):
+    # Same as kernel_category_key() of kernel_arguments.hpp
+    return (ka.DataType << 24) | (ka.DestDataType << 16) | (ka.ComputeDataType << 8) \
+           | ((1 if ka.TransposeA else 0) << 1) | (1 if ka.TransposeB else 0)
+
 def writefile(filename, kernel_maps):
     with open(filename, 'w') as f:
         try:
-            f.write("#include <map>\n")
-            f.write("#include <vector>\n")
-            f.write("#include <string>\n")
-            f.write("#include \"hip/hip_runtime.h\"\n")
+            f.write("// Generated by addKernels.py, do not edit.\n")
+            f.write("#include <cstddef>\n")
+            f.write("#include <cstdint>\n")
             f.write("\n")
-            f.write("std::map<std::string, int> kernel_count = \n{\n")
-            count_keys = len(kernel_maps.keys())
-            for key in kernel_maps.keys():
-                count = len(kernel_maps[key])
-                count_keys  = count_keys - 1
-                if count_keys == 0:
-                    f.write("    {}\"{}\", {}{}\n".format("{", key, count, "}"))
-                else:
-                    f.write("    {}\"{}\", {}{},\n".format("{", key, count, "}"))
-
-            f.write("};\n")
-            f.write("extern \"C\" size_t get_kernel_counts(const char* name)\n")
-            f.write("{\n")
-            f.write("    auto it = kernel_count.find(name);\n")
-            f.write("    if(it != kernel_count.end())\n")
-            f.write("        return it->second;\n")
-            f.write("    else\n        return 0;\n")
-            f.write("};\n")
 
             f.write("struct KernelParams\n")
             f.write("{\n")
@@ -105,11 +94,19 @@ def writefile(filename, kernel_maps):
             f.write("    bool ActivationHPA;\n")
             f.write("    char ActivationType[32];\n")
             f.write("};\n")
+            f.write("\n")
+            f.write("struct KernelCategory\n")
+            f.write("{\n")
+            f.write("    uint32_t key;\n")
+            f.write("    size_t   first;\n")
+            f.write("    size_t   count;\n")
+            f.write("};\n")
+            f.write("\n")
 
-            f.write("std::map<std::string, std::vector<KernelParams>> kernel_params = \n{\n")
-            count_keys = len(kernel_maps.keys())
-            for key in kernel_maps.keys():
-                f.write("{}\"{}\", {}".format("{", key, "{"))
+            # The kernels of a category are contiguous, the categories are sorted by key
+            keys = sorted(kernel_maps.keys())
+            f.write("static constexpr KernelParams kernel_params[] = \n{\n")
+            for key in keys:
                 for ka in kernel_maps[key]:
                     wg = "{} {}, {}, {}{}".format("{", ka.WorkGroup[0], ka.WorkGroup[1], ka.WorkGroup[2], "}")
                     tt = "{} {}, {}, {}{}".format("{", ka.ThreadTile[0], ka.ThreadTile[1], ka.ThreadTile[2], "}")
@@ -122,16 +119,37 @@ def writefile(filename, kernel_maps):
                             "true" if ka.UseInitialStridesA else "false", "true" if ka.UseInitialStridesCD else "false",
                             "true" if ka.ActivationFused else "false", 0 if not ka.GlobalAccumulation else ka.GlobalAccumulation,
                             "true" if ka.Activation else "false", "true" if ka.ActivationHPA else "false", ka.ActivationType)
-                    f.write("{}{}{},\n".format("{", values, "}"))
-                f.write("}},\n")
+                    f.write("    {}{}{},\n".format("{", values, "}"))
+            if not keys:
+                f.write("    {}\n")
             f.write("};\n")
-            f.write("extern \"C\" KernelParams* get_kernel_params(const char* name)\n")
-            f.write("{\n")
-            f.write("    auto it = kernel_params.find(name);\n")
-            f.write("    if(it != kernel_params.end())\n")
-            f.write("        return it->second.data();\n")
-            f.write("    else\n        return NULL;\n")
+            f.write("\n")
+
+            f.write("static constexpr KernelCategory kernel_categories[] = \n{\n")
+            first = 0
+            for key in keys:
+                count = len(kernel_maps[key])
+                f.write("    {}{:#010x}, {}, {}{},\n".format("{", key, first, count, "}"))
+                first += count
+            if not keys:
+                f.write("    {0, 0, 0}\n")
             f.write("};\n")
+            f.write("\n")
+
+            f.write("// The kernels of a category, resolved once by the plans, see kernel_category_key()\n")
+            f.write("extern \"C\" const KernelParams* get_kernel_table(uint32_t key, size_t* count)\n")
+            f.write("{\n")
+            f.write("    for(auto& category : kernel_categories)\n")
+            f.write("    {\n")
+            f.write("        if(category.key == key && category.count)\n")
+            f.write("        {\n")
+            f.write("            *count = category.count;\n")
+            f.write("            return kernel_params + category.first;\n")
+            f.write("        }\n")
+            f.write("    }\n")
+            f.write("    *count = 0;\n")
+            f.write("    return nullptr;\n")
+            f.write("}\n")
         except Exception as e:
             print(e)
         f.close()
@@ -212,7 +230,7 @@ def main(args):
                             print("Activation=", ka.Activation)
                             print("ActivationHPA=", ka.ActivationHPA)
                             print("ActivationType=", ka.ActivationType)
-                        key="{}_{}_{}_{}_{}".format(ka.DataType, ka.DestDataType, ka.ComputeDataType, 'T' if ka.TransposeA else 'N', 'T' if ka.TransposeB else 'N')
+                        key=category_key(ka)
                         if key in kernel_maps :
                             kernel_maps[key].append(ka)
                         else:
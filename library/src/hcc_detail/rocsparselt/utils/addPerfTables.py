@@ -0,0 +1,120 @@
+#!/usr/bin/python
+# ########################################################################
+# Copyright (c) 2024 Advanced Micro Devices, Inc.
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+# THE SOFTWARE.
+#
+# ########################################################################
+
+# Writes the tables of the performance model (see perf_model.hpp) from the
+# exact logic of the Tensile logic files: the fastest solution and its GFLOPS
+# for each size [M, N, B, K] the logic was tuned with.
+
+import getopt
+import os
+import sys
+import yaml
+
+try:
+    Loader = yaml.CSafeLoader
+except AttributeError:
+    Loader = yaml.SafeLoader
+
+class PerfTable:
+    Arch = ""
+    Logic = ""
+    Solutions = []
+    Entries = []
+
+def readTable(path):
+    with open(path, 'r') as f:
+        contents = yaml.load(f, Loader=Loader)
+
+    # [2] is the architecture, [5] the solutions and [7] the exact logic
+    table = PerfTable()
+    arch = contents[2]
+    table.Arch = arch.get('Architecture') if isinstance(arch, dict) else arch
+    table.Logic = os.path.splitext(os.path.basename(path))[0]
+
+    solutions = {s.get('SolutionIndex'): s.get('SolutionNameMin') for s in contents[5]}
+    table.Solutions = [solutions.get(i, "") for i in range(max(solutions.keys()) + 1)]
+    table.Entries = [(e[0][:4], e[1][0], e[1][1]) for e in contents[7] if e[1][0] >= 0]
+    return table
+
+def writefile(filename, tables):
+    names = sorted({n for t in tables for n in t.Solutions if n})
+    nameIndex = {n: i for i, n in enumerate(names)}
+
+    with open(filename, 'w') as f:
+        f.write("// Generated by addPerfTables.py from the Tensile logic files.\n")
+        f.write("#include \"perf_model.hpp\"\n")
+        f.write("\n")
+        f.write("namespace\n{\n")
+        f.write("    constexpr const char* names[] = {\n")
+        for n in names:
+            f.write("        \"{}\",\n".format(n))
+        if not names:
+            f.write("        \"\",\n")
+        f.write("    };\n")
+        for i, t in enumerate(tables):
+            f.write("\n")
+            f.write("    constexpr const char* solutions_{}[] = {{\n".format(i))
+            for n in t.Solutions:
+                f.write("        names[{}],\n".format(nameIndex[n]) if n else "        \"\",\n")
+            f.write("    };\n")
+            f.write("    constexpr rocsparselt_perf_entry entries_{}[] = {{\n".format(i))
+            for size, solution, gflops in t.Entries:
+                f.write("        {{{{{}, {}, {}, {}}}, {}, {}f}},\n".format(
+                        size[0], size[1], size[2], size[3], solution, float(gflops)))
+            f.write("    };\n")
+        f.write("}\n")
+        f.write("\n")
+        f.write("const rocsparselt_perf_table rocsparselt_perf_tables[] = {\n")
+        for i, t in enumerate(tables):
+            f.write("    {{\"{}\", \"{}\", solutions_{}, {}, entries_{}, {}}},\n".format(
+                    t.Arch, t.Logic, i, len(t.Solutions), i, len(t.Entries)))
+        if not tables:
+            f.write("    {\"\", \"\", nullptr, 0, nullptr, 0},\n")
+        f.write("};\n")
+        f.write("const size_t rocsparselt_perf_table_count = {};\n".format(len(tables)))
+
+def main(args):
+    (opts, rem) = getopt.getopt(args, '', ['filename=', 'logic='])
+    optDict = dict(opts)
+    filename = optDict.get('--filename', '')
+    logic = optDict.get('--logic', '')
+    if not filename or not logic:
+        print("usage: addPerfTables.py --filename <perf_tables.cpp> --logic <logic directory or file>")
+        return 1
+
+    paths = []
+    if os.path.isfile(logic):
+        paths.append(logic)
+    for root, dirs, files in os.walk(logic):
+        dirs.sort()
+        for file_name in sorted(files):
+            if file_name.upper().endswith(".YAML"):
+                paths.append(os.path.join(root, file_name))
+
+    tables = [t for t in (readTable(p) for p in paths) if t.Entries]
+    writefile(filename, tables)
+    return 0
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv[1:]))
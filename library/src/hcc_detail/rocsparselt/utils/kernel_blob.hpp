@@ -0,0 +1,134 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2022 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+
+// The packed kernel blob written by addKernels into libspmm_kernels_<arch>.so.
+//
+// The code objects are laid out one after the other in a single read-only array,
+// each at an offset aligned to kernel_blob_alignment, so that get_kernel_byte()
+// hands hipModuleLoadData() a pointer into the .rodata of the library without a
+// copy. The index of the kernels is sorted by name and searched by bisection.
+
+#pragma once
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+constexpr size_t kernel_blob_alignment = 4096;
+
+struct kernel_blob_file
+{
+    std::string                name; // the file name without its directory and .co
+    std::vector<unsigned char> bytes;
+};
+
+// Read a code object, false if it cannot be read.
+inline bool kernel_blob_read_file(const std::string& path, kernel_blob_file* file)
+{
+    std::ifstream in(path, std::ios_base::binary);
+    if(!in)
+        return false;
+    file->bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    if(in.bad())
+        return false;
+
+    auto name  = path.substr(path.find_last_of("\\/") + 1);
+    file->name = name.size() > 3 && name.compare(name.size() - 3, 3, ".co") == 0
+                     ? name.substr(0, name.size() - 3)
+                     : name;
+    return true;
+}
+
+// Write the C++ source of the blob, the index and the functions looked up by
+// SolutionAdapter::loadLibrary().
+inline void kernel_blob_write_source(std::ostream& out, std::vector<kernel_blob_file> files)
+{
+    std::stable_sort(files.begin(), files.end(), [](auto& l, auto& r) { return l.name < r.name; });
+
+    std::vector<size_t> offsets;
+    size_t              size = 0;
+    for(auto& file : files)
+    {
+        offsets.push_back(size);
+        size += (file.bytes.size() + kernel_blob_alignment - 1) / kernel_blob_alignment
+                * kernel_blob_alignment;
+    }
+
+    out << "// Generated by addKernels, do not edit.\n"
+           "#include <cstddef>\n"
+           "#include <cstring>\n\n"
+           "namespace\n{\n"
+           "    struct kernel_blob_entry\n    {\n"
+           "        const char* name;\n"
+           "        size_t      offset;\n"
+           "        size_t      size;\n"
+           "    };\n\n"
+        << "    constexpr size_t kernel_count = " << files.size() << ";\n\n"
+        << "    alignas(" << kernel_blob_alignment << ") const unsigned char kernel_blob["
+        << std::max<size_t>(size, 1) << "] = {";
+
+    // The padding after the last file is left to the zero-initialization
+    size_t written = 0;
+    auto   put     = [&](unsigned char byte) {
+        out << (written++ % 16 == 0 ? "\n        " : "") << "0x" << std::hex << std::setw(2)
+            << std::setfill('0') << unsigned(byte) << std::dec << ",";
+    };
+    for(size_t f = 0; f < files.size(); f++)
+    {
+        while(written < offsets[f])
+            put(0);
+        for(auto byte : files[f].bytes)
+            put(byte);
+    }
+    out << "\n    };\n\n";
+
+    out << "    // Sorted by name\n"
+           "    const kernel_blob_entry kernel_index["
+        << std::max<size_t>(files.size(), 1) << "] = {\n";
+    for(size_t f = 0; f < files.size(); f++)
+        out << "        {\"" << files[f].name << "\", " << offsets[f] << ", "
+            << files[f].bytes.size() << "},\n";
+    out << "    };\n}\n\n";
+
+    out << "extern \"C\" int get_map_size()\n{\n    return kernel_count;\n}\n\n"
+           "extern \"C\" const unsigned char* get_kernel_byte(const char* name)\n{\n"
+           "    size_t lo = 0, hi = kernel_count;\n"
+           "    while(lo < hi)\n    {\n"
+           "        size_t mid = lo + (hi - lo) / 2;\n"
+           "        int    cmp = strcmp(kernel_index[mid].name, name);\n"
+           "        if(cmp == 0)\n"
+           "            return kernel_blob + kernel_index[mid].offset;\n"
+           "        if(cmp < 0)\n"
+           "            lo = mid + 1;\n"
+           "        else\n"
+           "            hi = mid;\n"
+           "    }\n"
+           "    return nullptr;\n}\n";
+}
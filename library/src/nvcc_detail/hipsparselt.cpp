@@ -546,6 +546,48 @@ hipsparseStatus_t hipsparseLtDestroy(const hipsparseLtHandle_t* handle)
     return hipCUSPARSEStatusToHIPStatus(cusparseLtDestroy((const cusparseLtHandle_t*)handle));
 }
 
+hipsparseStatus_t hipsparseLtSetPointerMode(hipsparseLtHandle_t*   handle,
+                                            hipsparsePointerMode_t mode)
+{
+    // cuSPARSELt only takes alpha and beta from the host.
+    if(handle == nullptr)
+        return HIPSPARSE_STATUS_NOT_INITIALIZED;
+    return mode == HIPSPARSE_POINTER_MODE_HOST ? HIPSPARSE_STATUS_SUCCESS
+                                               : HIPSPARSE_STATUS_NOT_SUPPORTED;
+}
+
+hipsparseStatus_t hipsparseLtGetPointerMode(const hipsparseLtHandle_t* handle,
+                                            hipsparsePointerMode_t*    mode)
+{
+    if(handle == nullptr)
+        return HIPSPARSE_STATUS_NOT_INITIALIZED;
+    if(mode == nullptr)
+        return HIPSPARSE_STATUS_INVALID_VALUE;
+    *mode = HIPSPARSE_POINTER_MODE_HOST;
+    return HIPSPARSE_STATUS_SUCCESS;
+}
+
+hipsparseStatus_t hipsparseLtSetWorkspacePool(hipsparseLtHandle_t* handle, int enable)
+{
+    // cuSPARSELt always takes the workspace from the caller.
+    if(handle == nullptr)
+        return HIPSPARSE_STATUS_NOT_INITIALIZED;
+    if(enable != 0 && enable != 1)
+        return HIPSPARSE_STATUS_INVALID_VALUE;
+    return enable ? HIPSPARSE_STATUS_NOT_SUPPORTED : HIPSPARSE_STATUS_SUCCESS;
+}
+
+hipsparseStatus_t hipsparseLtGetWorkspacePoolSize(const hipsparseLtHandle_t* handle,
+                                                  size_t*                    size)
+{
+    if(handle == nullptr)
+        return HIPSPARSE_STATUS_NOT_INITIALIZED;
+    if(size == nullptr)
+        return HIPSPARSE_STATUS_INVALID_VALUE;
+    *size = 0;
+    return HIPSPARSE_STATUS_SUCCESS;
+}
+
 hipsparseStatus_t hipsparseLtGetVersion(const hipsparseLtHandle_t* handle, int* version)
 {
     return hipCUSPARSEStatusToHIPStatus(
@@ -733,6 +775,13 @@ hipsparseStatus_t
                                         dataSize));
 }
 
+// cuSPARSELt keeps nothing outside of the algorithm selection.
+hipsparseStatus_t
+    hipsparseLtMatmulAlgSelectionDestroy(const hipsparseLtMatmulAlgSelection_t* algSelection)
+{
+    return algSelection == nullptr ? HIPSPARSE_STATUS_INVALID_VALUE : HIPSPARSE_STATUS_SUCCESS;
+}
+
 /* matmul plan */
 hipsparseStatus_t hipsparseLtMatmulGetWorkspace(const hipsparseLtHandle_t*     handle,
                                                 const hipsparseLtMatmulPlan_t* plan,
@@ -754,6 +803,32 @@ hipsparseStatus_t hipsparseLtMatmulPlanInit(const hipsparseLtHandle_t*
                                  (const cusparseLtMatmulAlgSelection_t*)algSelection));
 }
 
+hipsparseStatus_t
+    hipsparseLtMatmulPlanInitDynamicM(const hipsparseLtHandle_t*             handle,
+                                      hipsparseLtMatmulPlan_t*               plan,
+                                      const hipsparseLtMatmulDescriptor_t*   matmulDescr,
+                                      const hipsparseLtMatmulAlgSelection_t* algSelection,
+                                      int64_t                                minM)
+{
+    return HIPSPARSE_STATUS_NOT_SUPPORTED;
+}
+
+hipsparseStatus_t hipsparseLtMatmulPlanSerialize(const hipsparseLtHandle_t*     handle,
+                                                 const hipsparseLtMatmulPlan_t* plan,
+                                                 void*                          data,
+                                                 size_t*                        dataSize)
+{
+    return HIPSPARSE_STATUS_NOT_SUPPORTED;
+}
+
+hipsparseStatus_t hipsparseLtMatmulPlanDeserialize(const hipsparseLtHandle_t* handle,
+                                                   hipsparseLtMatmulPlan_t*   plan,
+                                                   const void*                data,
+                                                   size_t                     dataSize)
+{
+    return HIPSPARSE_STATUS_NOT_SUPPORTED;
+}
+
 hipsparseStatus_t hipsparseLtMatmulPlanDestroy(const hipsparseLtMatmulPlan_t* plan)
 {
     return hipCUSPARSEStatusToHIPStatus(
@@ -811,6 +886,112 @@ hipsparseStatus_t hipsparseLtMatmulSearch(const hipsparseLtHandle_t* handle,
                                                                numStreams));
 }
 
+hipsparseStatus_t hipsparseLtMatmulDynamicM(const hipsparseLtHandle_t*     handle,
+                                            const hipsparseLtMatmulPlan_t* plan,
+                                            int64_t                        m,
+                                            const void*                    alpha,
+                                            const void*                    d_A,
+                                            const void*                    d_B,
+                                            const void*                    beta,
+                                            const void*                    d_C,
+                                            void*                          d_D,
+                                            void*                          workspace,
+                                            hipStream_t*                   streams,
+                                            int32_t                        numStreams)
+{
+    return HIPSPARSE_STATUS_NOT_SUPPORTED;
+}
+
+hipsparseStatus_t hipsparseLtMatmulSearchDynamicM(const hipsparseLtHandle_t* handle,
+                                                  hipsparseLtMatmulPlan_t*   plan,
+                                                  int64_t                    m,
+                                                  const void*                alpha,
+                                                  const void*                d_A,
+                                                  const void*                d_B,
+                                                  const void*                beta,
+                                                  const void*                d_C,
+                                                  void*                      d_D,
+                                                  void*                      workspace,
+                                                  hipStream_t*               streams,
+                                                  int32_t                    numStreams)
+{
+    return HIPSPARSE_STATUS_NOT_SUPPORTED;
+}
+
+hipsparseStatus_t hipsparseLtMatmulGrouped(const hipsparseLtHandle_t*            handle,
+                                           const hipsparseLtMatmulPlan_t* const* plans,
+                                           const void* const*                    alpha,
+                                           const void* const*                    d_A,
+                                           const void* const*                    d_B,
+                                           const void* const*                    beta,
+                                           const void* const*                    d_C,
+                                           void* const*                          d_D,
+                                           void* const*                          workspace,
+                                           int32_t                               groupCount,
+                                           hipStream_t*                          streams,
+                                           int32_t                               numStreams)
+{
+    if(groupCount < 0)
+        return HIPSPARSE_STATUS_INVALID_VALUE;
+    if(groupCount > 0
+       && (plans == nullptr || alpha == nullptr || d_A == nullptr || d_B == nullptr
+           || beta == nullptr || d_C == nullptr || d_D == nullptr))
+        return HIPSPARSE_STATUS_INVALID_VALUE;
+
+    // cuSPARSELt has no grouped matmul, the groups run one after another.
+    for(int32_t g = 0; g < groupCount; g++)
+    {
+        cusparseStatus_t status = cusparseLtMatmul((const cusparseLtHandle_t*)handle,
+                                                   (const cusparseLtMatmulPlan_t*)plans[g],
+                                                   alpha[g],
+                                                   d_A[g],
+                                                   d_B[g],
+                                                   beta[g],
+                                                   d_C[g],
+                                                   d_D[g],
+                                                   workspace ? workspace[g] : nullptr,
+                                                   streams,
+                                                   numStreams);
+        if(status != CUSPARSE_STATUS_SUCCESS)
+            return hipCUSPARSEStatusToHIPStatus(status);
+    }
+    return HIPSPARSE_STATUS_SUCCESS;
+}
+
+hipsparseStatus_t hipsparseLtMatmulCapture(const hipsparseLtHandle_t*     handle,
+                                           const hipsparseLtMatmulPlan_t* plan,
+                                           const void*                    alpha,
+                                           const void*                    d_A,
+                                           const void*                    d_B,
+                                           const void*                    beta,
+                                           const void*                    d_C,
+                                           void*                          d_D,
+                                           void*                          workspace,
+                                           hipGraph_t                     graph,
+                                           const hipGraphNode_t*          dependencies,
+                                           size_t                         numDependencies,
+                                           hipGraphNode_t*                nodes,
+                                           int32_t*                       numNodes)
+{
+    return HIPSPARSE_STATUS_NOT_SUPPORTED;
+}
+
+hipsparseStatus_t hipsparseLtMatmulCaptureUpdate(const hipsparseLtHandle_t*     handle,
+                                                 const hipsparseLtMatmulPlan_t* plan,
+                                                 const void*                    alpha,
+                                                 const void*                    d_A,
+                                                 const void*                    d_B,
+                                                 const void*                    beta,
+                                                 const void*                    d_C,
+                                                 void*                          d_D,
+                                                 void*                          workspace,
+                                                 hipGraphExec_t                 graphExec,
+                                                 const hipGraphNode_t*          nodes,
+                                                 int32_t                        numNodes)
+{
+    return HIPSPARSE_STATUS_NOT_SUPPORTED;
+}
+
 /* helper */
 // prune
 hipsparseStatus_t hipsparseLtSpMMAPrune(const hipsparseLtHandle_t*           handle,
@@ -944,6 +1125,14 @@ hipsparseStatus_t hipsparseLtSpMMACompress2(const hipsparseLtHandle_t*        ha
 
 void hipsparseLtInitialize() {}
 
+void hipsparseLtSetLazyLoading(int enable) {}
+
+hipsparseStatus_t hipsparseLtGetStartupTiming(hipsparseLtStartupPhase_t   phase,
+                                              hipsparseLtStartupTiming_t* timing)
+{
+    return HIPSPARSE_STATUS_NOT_SUPPORTED;
+}
+
 hipsparseStatus_t hipsparseLtGetGitRevision(hipsparseLtHandle_t handle, char* rev)
 try
 {